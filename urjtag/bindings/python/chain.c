@@ -144,13 +144,13 @@ urj_pyc_precheck (urj_chain_t *urc, int checks_needed)
 
     if (checks_needed & UPRC_BUS)
     {
-        if (!urj_bus)   /* why is this a global and not a chain property? */
+        if (!urc->bus)
         {
             PyErr_SetString (PyExc_RuntimeError,
                              _("Bus missing: initbus not called?"));
             return 0;
         }
-        if (!urj_bus->driver)
+        if (!urc->bus->driver)
         {
             PyErr_SetString (PyExc_RuntimeError,
                              _("Bus driver missing: initbus not called?"));
@@ -373,6 +373,48 @@ urj_pyc_get_frequency (urj_pychain_t *self, PyObject *args)
     return Py_BuildValue ("i", (uint32_t) freq);
 }
 
+static PyObject *
+urj_pyc_get_perf (urj_pychain_t *self, PyObject *args)
+{
+    urj_chain_t *urc = self->urchain;
+    urj_cable_perf_t perf;
+    const urj_cable_perf_t *p = &perf;
+    if (!urj_pyc_precheck (urc, UPRC_CBL))
+        return NULL;
+
+    urj_tap_cable_get_perf (urc->cable, &perf);
+    return Py_BuildValue ("{s:K,s:K,s:K,s:i,s:K,s:K,s:K,s:K,s:K,s:K,s:K,s:K,s:d}",
+                          "flushes", (unsigned long long) p->flushes,
+                          "optional_flushes",
+                          (unsigned long long) p->optional_flushes,
+                          "queued", (unsigned long long) p->queued,
+                          "queue_high_water", p->queue_high_water,
+                          "flushed_items",
+                          (unsigned long long) p->flushed_items,
+                          "flush_batches",
+                          (unsigned long long) p->flush_batches,
+                          "cx_xfers", (unsigned long long) p->cx_xfers,
+                          "cx_cmds", (unsigned long long) p->cx_cmds,
+                          "usb_writes", (unsigned long long) p->usb_writes,
+                          "usb_write_bytes",
+                          (unsigned long long) p->usb_write_bytes,
+                          "usb_reads", (unsigned long long) p->usb_reads,
+                          "usb_read_bytes",
+                          (unsigned long long) p->usb_read_bytes,
+                          "usb_read_time", p->usb_read_time);
+}
+
+static PyObject *
+urj_pyc_reset_perf (urj_pychain_t *self, PyObject *args)
+{
+    urj_chain_t *urc = self->urchain;
+    if (!urj_pyc_precheck (urc, UPRC_CBL))
+        return NULL;
+
+    urj_tap_cable_perf_reset (urc->cable);
+    return Py_BuildValue ("");
+}
+
 /* set instruction for the active part
  */
 static PyObject *
@@ -762,7 +804,7 @@ urj_pyc_detectflash (urj_pychain_t *self, PyObject *args)
 
     return Py_BuildValue ("i",
                           urj_flash_detectflash (URJ_LOG_LEVEL_NORMAL,
-                                                 urj_bus, adr));
+                                                 urc->bus, adr));
 }
 
 static PyObject *
@@ -779,9 +821,9 @@ urj_pyc_peek (urj_pychain_t *self, PyObject *args)
     if (!urj_pyc_precheck (urc, UPRC_CBL|UPRC_BUS))
         return NULL;
 
-    URJ_BUS_PREPARE (urj_bus);
-    URJ_BUS_AREA (urj_bus, adr, &area);
-    val = URJ_BUS_READ (urj_bus, adr);
+    URJ_BUS_PREPARE (urc->bus);
+    URJ_BUS_AREA (urc->bus, adr, &area);
+    val = URJ_BUS_READ (urc->bus, adr);
 
     switch (area.width)
     {
@@ -810,9 +852,9 @@ urj_pyc_poke (urj_pychain_t *self, PyObject *args)
     if (!urj_pyc_precheck (urc, UPRC_CBL|UPRC_BUS))
         return NULL;
 
-    URJ_BUS_PREPARE (urj_bus);
-    URJ_BUS_AREA (urj_bus, adr, &area);
-    URJ_BUS_WRITE (urj_bus, adr, val);
+    URJ_BUS_PREPARE (urc->bus);
+    URJ_BUS_AREA (urc->bus, adr, &area);
+    URJ_BUS_WRITE (urc->bus, adr, val);
     return Py_BuildValue ("");
 }
 
@@ -847,9 +889,9 @@ urj_pyc_flashmem (urj_pychain_t *self, PyObject *args)
     }
 
     if (msbin)
-        r = urj_flashmsbin (urj_bus, f, noverify);
+        r = urj_flashmsbin (urc->bus, f, noverify);
     else
-        r = urj_flashmem (urj_bus, f, adr, noverify);
+        r = urj_flashmem (urc->bus, f, adr, noverify);
 
     fclose (f);
     return Py_BuildValue ("i", r);
@@ -943,6 +985,10 @@ static PyMethodDef urj_pyc_methods[] =
      "Change the TCK frequency to be at most the specified value in Hz"},
     {"get_frequency", (PyCFunction) urj_pyc_get_frequency, METH_NOARGS,
      "get the current TCK frequency"},
+    {"get_perf", (PyCFunction) urj_pyc_get_perf, METH_NOARGS,
+     "get the cable performance counters as a dictionary"},
+    {"reset_perf", (PyCFunction) urj_pyc_reset_perf, METH_NOARGS,
+     "reset the cable performance counters"},
     {"set_instruction", (PyCFunction) urj_pyc_set_instruction, METH_VARARGS,
      "Set values in the instruction register holding buffer"},
     {"shift_ir", (PyCFunction) urj_pyc_shift_ir, METH_NOARGS,
@@ -86,6 +86,13 @@ architecture rtl of fjmem_core is
   signal strobe_sync_q : std_logic_vector(1 downto 0);
   signal strobe_edge_q : std_logic;
 
+  signal burst_word_q   : std_logic_vector(data_range_t);
+  signal burst_bit_q    : natural range 0 to max_data_width_c-1;
+  signal burst_cnt_q    : unsigned(data_range_t);
+  signal burst_offs_q   : unsigned(addr_range_t);
+  signal burst_base_q   : unsigned(addr_range_t);
+  signal burst_toggle_q : std_logic;
+
 begin
 
   -----------------------------------------------------------------------------
@@ -118,6 +125,9 @@ begin
   --   query  : Based on the shifted block number, the used bits in the
   --            address and data field are marked with '1'. This reports the
   --            specific addr and data widths of the specified block.
+  --            The ack field is '1', which tells the host that the core
+  --            knows the burst instruction.
+  --   burst  : see process burst
   --
   shift: process (trst_s, clkdr_i)
     variable addr_width_v,
@@ -166,6 +176,10 @@ begin
             -- mark data field with '1'
             shift_q(data_range_t)  <= (others => '1');
 
+          when instr_burst_c =>
+            -- Update-DR after the burst leaves the core idle
+            shift_q <= (others => '0');
+
           when instr_query_c =>
             if idx_v < num_blocks_c then
               shift_q <= (others => '0');
@@ -185,7 +199,8 @@ begin
               -- unused block
               shift_q <= (others => '0');
             end if;
-            shift_q(instr_range_t) <= instr_q;
+            shift_q(instr_range_t)   <= instr_q;
+            shift_q(shift_ack_pos_c) <= '1';
 
           when others =>
             shift_q <= (others => '-');
@@ -199,6 +214,78 @@ begin
   -----------------------------------------------------------------------------
 
 
+  -----------------------------------------------------------------------------
+  -- Process burst
+  --
+  -- Purpose:
+  --   Implements read bursts. A shift with the burst instruction sets the
+  --   start address and, in the data field, the number of words; its
+  --   Update-DR reads the first word. With the burst instruction active,
+  --   tdo_o shows burst_word_q instead of shift_q: Capture-DR loads the first
+  --   word and requests the next one, and after the last bit of a word the
+  --   next one follows on the next clock. The memory has to acknowledge
+  --   within data width TCK cycles.
+  --   burst_offs_q counts the requested words; the dout process rebases it
+  --   with every Update-DR, so that addr_o starts at addr_q again.
+  --
+  burst: process (trst_s, clkdr_i)
+    variable data_width_v : natural;
+  begin
+    if trst_s then
+      burst_word_q   <= (others => '0');
+      burst_bit_q    <= 0;
+      burst_cnt_q    <= (others => '0');
+      burst_offs_q   <= (others => '0');
+      burst_toggle_q <= '0';
+
+    elsif rising_edge(clkdr_i) then
+      if to_integer(unsigned(block_q)) < num_blocks_c then
+        data_width_v := blocks_c(to_integer(unsigned(block_q))).data_width;
+      else
+        data_width_v := max_data_width_c;
+      end if;
+
+      if instr_q = instr_burst_c then
+        if capture_en_s then
+          -- capture mode: first word, request the second one
+          burst_word_q <= din_q;
+          burst_bit_q  <= 0;
+          if unsigned(dout_q) > 1 then
+            burst_cnt_q    <= unsigned(dout_q) - 1;
+            burst_offs_q   <= burst_offs_q + 1;
+            burst_toggle_q <= not burst_toggle_q;
+          else
+            burst_cnt_q    <= (others => '0');
+          end if;
+
+        elsif burst_bit_q = data_width_v-1 then
+          -- shift mode: next word after the last bit of this one
+          burst_bit_q <= 0;
+          if burst_cnt_q /= 0 then
+            burst_word_q <= din_q;
+            burst_cnt_q  <= burst_cnt_q - 1;
+            if burst_cnt_q > 1 then
+              burst_offs_q   <= burst_offs_q + 1;
+              burst_toggle_q <= not burst_toggle_q;
+            end if;
+          else
+            burst_word_q <= (others => '0');
+          end if;
+
+        else
+          burst_word_q(burst_word_q'high-1 downto burst_word_q'low) <=
+            burst_word_q(burst_word_q'high downto burst_word_q'low+1);
+          burst_word_q(burst_word_q'high) <= '0';
+          burst_bit_q <= burst_bit_q + 1;
+
+        end if;
+      end if;
+    end if;
+  end process burst;
+  --
+  -----------------------------------------------------------------------------
+
+
   -----------------------------------------------------------------------------
   -- Process din
   --
@@ -245,6 +332,7 @@ begin
       block_q <= (others => '0');
       addr_q  <= (others => '0');
       dout_q  <= (others => '0');
+      burst_base_q    <= (others => '0');
       strobe_toggle_q <= '0';
 
     elsif rising_edge(update_i) then
@@ -253,6 +341,7 @@ begin
       addr_q  <= shift_q(addr_range_t);
       dout_q  <= shift_q(data_range_t);
 
+      burst_base_q    <= burst_offs_q;
       strobe_toggle_q <= not strobe_toggle_q;
 
     end if;
@@ -275,7 +364,7 @@ begin
       strobe_edge_q <= '0';
 
     elsif rising_edge(clk_i) then
-      strobe_sync_q(1) <= strobe_toggle_q;
+      strobe_sync_q(1) <= strobe_toggle_q xor burst_toggle_q;
       strobe_sync_q(0) <= strobe_sync_q(1);
 
       strobe_edge_q    <= strobe_sync_q(0);
@@ -308,11 +397,13 @@ begin
   -----------------------------------------------------------------------------
   -- Output mapping
   -----------------------------------------------------------------------------
-  tdo_o    <= shift_q(0);
+  tdo_o    <= burst_word_q(burst_word_q'low) when instr_q = instr_burst_c else
+              shift_q(0);
   strobe_o <= strobe_sync_q(0) xor strobe_edge_q;
-  read_o   <= '1' when instr_q = instr_read_c  else '0';
+  read_o   <= '1' when instr_q = instr_read_c or
+                       instr_q = instr_burst_c else '0';
   write_o  <= '1' when instr_q = instr_write_c else '0';
-  addr_o   <= addr_q;
+  addr_o   <= std_logic_vector(unsigned(addr_q) + burst_offs_q - burst_base_q);
   dout_o   <= dout_q;
 
 end rtl;
@@ -60,6 +60,7 @@ package fjmem_pack is
   constant instr_query_c  : std_logic_vector(instr_range_t) := "110";
   constant instr_read_c   : std_logic_vector(instr_range_t) := "001";
   constant instr_write_c  : std_logic_vector(instr_range_t) := "010";
+  constant instr_burst_c  : std_logic_vector(instr_range_t) := "011";
   --
   -----------------------------------------------------------------------------
 
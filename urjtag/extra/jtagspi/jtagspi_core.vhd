@@ -0,0 +1,167 @@
+-------------------------------------------------------------------------------
+--
+-- $Id$
+--
+-- jtagspi_core - a JTAG-to-SPI bridge for programming SPI flashes through
+--                the USER data register of an FPGA
+--
+-- For host software support visit
+--   http://urjtag.org/
+--
+-- This program is free software; you can redistribute it and/or
+-- modify it under the terms of the GNU General Public License
+-- as published by the Free Software Foundation; either version 2
+-- of the License, or (at your option) any later version.
+--
+-- This program is distributed in the hope that it will be useful,
+-- but WITHOUT ANY WARRANTY; without even the implied warranty of
+-- MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+-- GNU General Public License for more details.
+--
+-- You should have received a copy of the GNU General Public License
+-- along with this program; if not, write to the Free Software
+-- Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA
+-- 02111-1307, USA.
+--
+-- Copyright (C) 2026 UrJTAG contributors
+--
+-------------------------------------------------------------------------------
+--
+-- Protocol of one DR scan (all bits in shift order):
+--
+--   0 ... 0    ignored, bits of other parts in BYPASS
+--   1          start bit
+--   N          32 bit clock count, LSB first
+--   N bits     SPI data, MSB first per byte; TDI drives MOSI
+--
+-- SPI_CS_N is low from the first to the last of the N SPI clocks. SPI_SCK
+-- is the gated TCK (SPI mode 0). MISO is sampled on the rising edge of
+-- SPI clock k and shows up on TDO before TCK k + 1. Leaving Shift-DR
+-- releases SPI_CS_N at any time.
+--
+-------------------------------------------------------------------------------
+
+library ieee;
+use ieee.std_logic_1164.all;
+use ieee.numeric_std.all;
+
+entity jtagspi_core is
+
+  port (
+    -- JTAG Interface ---------------------------------------------------------
+    clkdr_i    : in  std_logic;
+    capture_i  : in  std_logic;
+    shift_i    : in  std_logic;
+    sel_i      : in  std_logic;
+    tdi_i      : in  std_logic;
+    tdo_o      : out std_logic;
+    -- SPI Interface ----------------------------------------------------------
+    spi_cs_n_o : out std_logic;
+    spi_sck_o  : out std_logic;
+    spi_mosi_o : out std_logic;
+    spi_miso_i : in  std_logic
+  );
+
+end jtagspi_core;
+
+
+architecture rtl of jtagspi_core is
+
+  type state_t is (WAIT_START, COUNT, DATA, DONE);
+
+  signal state_q : state_t;
+  signal count_q : unsigned(31 downto 0);
+  signal bit_q   : unsigned(4 downto 0);
+  signal miso_q  : std_logic;
+  signal sck_en_q : std_logic;
+
+  signal active_s : std_logic;
+
+begin
+
+  active_s <= sel_i and shift_i;
+
+  -----------------------------------------------------------------------------
+  -- Process seq
+  --
+  -- Purpose:
+  --   Start bit, clock count and the SPI clocks on the rising edge of TCK.
+  --
+  seq: process (clkdr_i)
+  begin
+    if rising_edge(clkdr_i) then
+      if capture_i = '1' then
+        state_q <= WAIT_START;
+        bit_q   <= (others => '0');
+        miso_q  <= '0';
+
+      elsif active_s = '1' then
+        case state_q is
+          when WAIT_START =>
+            if tdi_i = '1' then
+              state_q <= COUNT;
+            end if;
+
+          when COUNT =>
+            count_q <= tdi_i & count_q(31 downto 1);
+            bit_q   <= bit_q + 1;
+            if bit_q = 31 then
+              if tdi_i = '0' and count_q(31 downto 1) = 0 then
+                state_q <= DONE;
+              else
+                state_q <= DATA;
+              end if;
+            end if;
+
+          when DATA =>
+            miso_q  <= spi_miso_i;
+            count_q <= count_q - 1;
+            if count_q = 1 then
+              state_q <= DONE;
+            end if;
+
+          when others =>
+            null;
+        end case;
+
+      end if;
+    end if;
+  end process seq;
+  --
+  -----------------------------------------------------------------------------
+
+
+  -----------------------------------------------------------------------------
+  -- Process sck_en
+  --
+  -- Purpose:
+  --   Enables SPI_SCK on the falling edge of TCK, so that SPI_SCK has
+  --   full pulses only.
+  --
+  sck_en: process (clkdr_i, active_s)
+  begin
+    if active_s = '0' then
+      sck_en_q <= '0';
+    elsif falling_edge(clkdr_i) then
+      if state_q = DATA then
+        sck_en_q <= '1';
+      else
+        sck_en_q <= '0';
+      end if;
+    end if;
+  end process sck_en;
+  --
+  -----------------------------------------------------------------------------
+
+
+  -----------------------------------------------------------------------------
+  -- Output Mapping
+  -----------------------------------------------------------------------------
+  spi_cs_n_o <= '0' when active_s = '1' and
+                         (state_q = DATA or sck_en_q = '1') else
+                '1';
+  spi_sck_o  <= clkdr_i and sck_en_q;
+  spi_mosi_o <= tdi_i;
+  tdo_o      <= miso_q;
+
+end rtl;
@@ -0,0 +1,121 @@
+-------------------------------------------------------------------------------
+--
+-- $Id$
+--
+-- This program is free software; you can redistribute it and/or
+-- modify it under the terms of the GNU General Public License
+-- as published by the Free Software Foundation; either version 2
+-- of the License, or (at your option) any later version.
+--
+-- This program is distributed in the hope that it will be useful,
+-- but WITHOUT ANY WARRANTY; without even the implied warranty of
+-- MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+-- GNU General Public License for more details.
+--
+-- You should have received a copy of the GNU General Public License
+-- along with this program; if not, write to the Free Software
+-- Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA
+-- 02111-1307, USA.
+--
+-- Copyright (C) 2026 UrJTAG contributors
+--
+-------------------------------------------------------------------------------
+--
+-- Toplevel for Spartan 3 devices: jtagspi_core in USER1 (opcode 000010),
+-- connected to the SPI configuration flash pins.
+--
+-------------------------------------------------------------------------------
+
+library ieee;
+use ieee.std_logic_1164.all;
+
+entity jtagspi_spartan3 is
+
+  port (
+    -- SPI configuration flash
+    spi_cs_n                 : out   std_logic;
+    spi_sck                  : out   std_logic;
+    spi_mosi                 : out   std_logic;
+    spi_miso                 : in    std_logic
+  );
+
+end jtagspi_spartan3;
+
+
+architecture struct of jtagspi_spartan3 is
+
+  component BSCAN_SPARTAN3
+    port (
+      CAPTURE : out std_ulogic := 'H';
+      DRCK1   : out std_ulogic := 'L';
+      DRCK2   : out std_ulogic := 'L';
+      RESET   : out std_ulogic := 'L';
+      SEL1    : out std_ulogic := 'L';
+      SEL2    : out std_ulogic := 'L';
+      SHIFT   : out std_ulogic := 'L';
+      TDI     : out std_ulogic := 'L';
+      UPDATE  : out std_ulogic := 'L';
+      TDO1    : in  std_ulogic := 'X';
+      TDO2    : in  std_ulogic := 'X'
+    );
+  end component;
+
+  component jtagspi_core
+    port (
+      clkdr_i    : in  std_logic;
+      capture_i  : in  std_logic;
+      shift_i    : in  std_logic;
+      sel_i      : in  std_logic;
+      tdi_i      : in  std_logic;
+      tdo_o      : out std_logic;
+      spi_cs_n_o : out std_logic;
+      spi_sck_o  : out std_logic;
+      spi_mosi_o : out std_logic;
+      spi_miso_i : in  std_logic
+    );
+  end component;
+
+  signal clkdr_s,
+         capture_s,
+         shift_s,
+         sel_s,
+         tdi_s,
+         tdo_s     : std_logic;
+
+  signal vss_s     : std_logic;
+
+begin
+
+  vss_s <= '0';
+
+  bscan_spartan3_b : BSCAN_SPARTAN3
+    port map (
+      CAPTURE => capture_s,
+      DRCK1   => clkdr_s,
+      DRCK2   => open,
+      RESET   => open,
+      SEL1    => sel_s,
+      SEL2    => open,
+      SHIFT   => shift_s,
+      TDI     => tdi_s,
+      UPDATE  => open,
+      TDO1    => tdo_s,
+      TDO2    => vss_s
+    );
+
+
+  jtagspi_core_b : jtagspi_core
+    port map (
+      clkdr_i    => clkdr_s,
+      capture_i  => capture_s,
+      shift_i    => shift_s,
+      sel_i      => sel_s,
+      tdi_i      => tdi_s,
+      tdo_o      => tdo_s,
+      spi_cs_n_o => spi_cs_n,
+      spi_sck_o  => spi_sck,
+      spi_mosi_o => spi_mosi,
+      spi_miso_i => spi_miso
+    );
+
+end struct;
@@ -115,6 +115,9 @@ struct bfin_part_data
 
     uint32_t emupc;
     uint32_t emupc_orig;
+
+    /* TCKs to wait for an instruction to complete, -1 until calibrated */
+    int wait_clocks;
 };
 
 #define BFIN_PART_DATA(part)       ((struct bfin_part_data *)((part)->params->data))
@@ -130,6 +133,7 @@ struct bfin_part_data
 #define BFIN_PART_EMUDAT_IN(part)  (BFIN_PART_DATA (part)->emudat_in)
 #define BFIN_PART_EMUPC(part)      (BFIN_PART_DATA (part)->emupc)
 #define BFIN_PART_EMUPC_ORIG(part) (BFIN_PART_DATA (part)->emupc_orig)
+#define BFIN_PART_WAIT_CLOCKS(part) (BFIN_PART_DATA (part)->wait_clocks)
 
 #define IDCODE_SCAN                     0
 #define DBGSTAT_SCAN                    1
@@ -183,12 +187,12 @@ enum {
 };
 
 extern int bfin_check_emuready;
-extern int bfin_wait_clocks;
 
 /* From src/bfin/bfin.c */
 
 int part_is_bfin (urj_chain_t *, int);
 int part_scan_select (urj_chain_t *, int, int);
+int chain_scan_select (urj_chain_t *, int);
 
 #define DECLARE_PART_DBGCTL_SET_BIT(name)                               \
     void part_dbgctl_bit_set_##name (urj_chain_t *chain, int n);
@@ -248,6 +252,10 @@ void part_dbgstat_clear_ovfs (urj_chain_t *, int);
 void part_wait_in_reset (urj_chain_t *, int);
 void part_wait_reset (urj_chain_t *, int);
 void part_check_emuready (urj_chain_t *, int);
+void chain_dbgstat_get (urj_chain_t *);
+void chain_emupc_get (urj_chain_t *, int);
+void chain_dbgstat_clear_ovfs (urj_chain_t *);
+void chain_check_emuready (urj_chain_t *);
 void part_emudat_set (urj_chain_t *, int, uint32_t, int);
 uint32_t part_emudat_get (urj_chain_t *, int, int);
 void part_emudat_defer_get (urj_chain_t *, int, int);
@@ -258,6 +266,12 @@ uint32_t part_register_get (urj_chain_t *, int, enum core_regnum);
 void part_register_set (urj_chain_t *, int, enum core_regnum, uint32_t);
 void part_emuir_set (urj_chain_t *, int, uint64_t, int);
 void part_emuir_set_2 (urj_chain_t *, int, uint64_t, uint64_t, int);
+void chain_emuir_set_same (urj_chain_t *, uint64_t, int);
+void chain_emuir_set_same_2 (urj_chain_t *, uint64_t, uint64_t, int);
+void chain_emudat_get (urj_chain_t *, uint32_t *, int);
+void chain_emudat_set (urj_chain_t *, const uint32_t *, int);
+void chain_register_get (urj_chain_t *, enum core_regnum, uint32_t *);
+void chain_register_set (urj_chain_t *, enum core_regnum, const uint32_t *);
 uint32_t part_get_r0 (urj_chain_t *, int);
 uint32_t part_get_p0 (urj_chain_t *, int);
 void part_set_r0 (urj_chain_t *, int, uint32_t);
@@ -266,6 +280,12 @@ void part_emulation_enable (urj_chain_t *, int);
 void part_emulation_disable (urj_chain_t *, int);
 void part_emulation_trigger (urj_chain_t *, int);
 void part_emulation_return (urj_chain_t *, int);
+void part_emulation_singlestep (urj_chain_t *, int);
+void chain_emulation_enable (urj_chain_t *);
+void chain_emulation_disable (urj_chain_t *);
+void chain_emulation_trigger (urj_chain_t *);
+void chain_emulation_return (urj_chain_t *);
+void chain_emulation_singlestep (urj_chain_t *);
 void part_execute_instructions (urj_chain_t *, int n, struct bfin_insn *);
 void chain_system_reset (urj_chain_t *);
 void bfin_core_reset (urj_chain_t *, int);
@@ -275,6 +295,9 @@ uint32_t part_mmr_read_clobber_r0 (urj_chain_t *, int, int32_t, int);
 void part_mmr_write_clobber_r0 (urj_chain_t *, int, int32_t, uint32_t, int);
 uint32_t part_mmr_read (urj_chain_t *, int, uint32_t, int);
 void part_mmr_write (urj_chain_t *, int, uint32_t, uint32_t, int);
+void part_wait_clocks_calibrate (urj_chain_t *, int);
+int part_mem_read (urj_chain_t *, int, uint32_t, uint8_t *, uint32_t);
+int part_mem_write (urj_chain_t *, int, uint32_t, const uint8_t *, uint32_t);
 
 /* From src/bfin/insn-gen.c */
 
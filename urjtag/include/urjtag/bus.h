@@ -31,35 +31,36 @@
 
 #include "bus_driver.h"
 
-extern urj_bus_t *urj_bus;
-
 /** @return URJ_STATUS_OK on success; URJ_STATUS_FAIL on error */
 int urj_bus_readmem (urj_bus_t *bus, FILE *f, uint32_t addr, uint32_t len);
 /** @return URJ_STATUS_OK on success; URJ_STATUS_FAIL on error */
 int urj_bus_writemem (urj_bus_t *bus, FILE *f, uint32_t addr, uint32_t len);
 
-typedef struct
+/** The buses initialized on a chain */
+struct URJ_BUSES
 {
     int len;
     urj_bus_t **buses;
-}
-urj_buses_t;
+};
 
-extern urj_buses_t urj_buses;
 extern const urj_bus_driver_t * const urj_bus_drivers[];
 
-void urj_bus_buses_free (void);
+/** Free all buses of @chain */
+void urj_bus_buses_free (urj_chain_t *chain);
+/** Add @abus to the buses of its chain */
 int urj_bus_buses_add (urj_bus_t *abus);
+/** Remove @abus from the buses of its chain */
 int urj_bus_buses_delete (urj_bus_t *abus);
 
 /**
  * set active bus
  *
- * @param n choose n'th bus in #urj_buses as the active bus
+ * @param chain the chain whose active bus to change
+ * @param n choose n'th bus of @chain as the active bus
  *
  * @return URJ_STATUS_OK on success; URJ_STATUS_FAIL on error
  */
-int urj_bus_buses_set (int n);
+int urj_bus_buses_set (urj_chain_t *chain, int n);
 
 /**
  * Initialize the specified bus.
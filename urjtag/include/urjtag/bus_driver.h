@@ -39,6 +39,7 @@
 
 #include "types.h"
 #include "params.h"
+#include "trace.h"
 
 typedef struct
 {
@@ -83,6 +84,9 @@ typedef enum URJ_BUS_PARAM_KEY
     URJ_BUS_PARAM_KEY_DBGaDDR,  /* bool                         mpc824 */
     URJ_BUS_PARAM_KEY_DBGdATA,  /* bool                         mpc824 */
     URJ_BUS_PARAM_KEY_HWAIT,    /* string (= signal name)       blackfin */
+    URJ_BUS_PARAM_KEY_SCK,      /* string (= signal name)       spi */
+    URJ_BUS_PARAM_KEY_MOSI,     /* string (= signal name)       spi */
+    URJ_BUS_PARAM_KEY_MISO,     /* string (= signal name)       spi */
 }
 urj_bus_param_key_t;
 
@@ -121,6 +125,34 @@ struct URJ_BUS_DRIVER
     int (*enable) (urj_bus_t *bus);
     int (*disable) (urj_bus_t *bus);
     urj_bus_type_t bus_type;
+    /**
+     * Read @adr @n times into @data, each read a bus access of its own, with
+     * the accesses queued together, e.g. to poll a status; optional, see
+     * urj_bus_read_repeat()
+     * @return URJ_STATUS_OK on success; URJ_STATUS_FAIL on error
+     */
+    int (*read_repeat) (urj_bus_t *bus, uint32_t adr, uint32_t *data, int n);
+    /**
+     * URJ_BUS_TYPE_SPI: select the device, send @out_len bytes of @out,
+     * then receive @in_len bytes into @in and deselect the device;
+     * see urj_bus_transfer()
+     * @return URJ_STATUS_OK on success; URJ_STATUS_FAIL on error
+     */
+    int (*transfer) (urj_bus_t *bus, const uint8_t *out, int out_len,
+                     uint8_t *in, int in_len);
+    /**
+     * Read @n consecutive bus words from @adr on into @data; optional, see
+     * urj_bus_read_block()
+     * @return URJ_STATUS_OK on success; URJ_STATUS_FAIL on error
+     */
+    int (*read_block) (urj_bus_t *bus, uint32_t adr, uint32_t *data, int n);
+    /**
+     * Write the @n words of @data to consecutive bus words from @adr on;
+     * optional, see urj_bus_write_block()
+     * @return URJ_STATUS_OK on success; URJ_STATUS_FAIL on error
+     */
+    int (*write_block) (urj_bus_t *bus, uint32_t adr, const uint32_t *data,
+                        int n);
 };
 
 struct URJ_BUS
@@ -131,18 +163,76 @@ struct URJ_BUS
     int initialized;
     int enabled;
     const urj_bus_driver_t *driver;
+    urj_flash_cfi_array_t *cfi_array;   /**< flash found by detectflash */
+    const urj_flash_driver_t *flash_driver;
 };
 
+/* the accesses go through urj_bus_trace_*() while a trace is recorded */
+int urj_bus_trace_read_start (urj_bus_t *bus, uint32_t adr);
+uint32_t urj_bus_trace_read_next (urj_bus_t *bus, uint32_t adr);
+uint32_t urj_bus_trace_read_end (urj_bus_t *bus);
+uint32_t urj_bus_trace_read (urj_bus_t *bus, uint32_t adr);
+int urj_bus_trace_write_start (urj_bus_t *bus, uint32_t adr);
+void urj_bus_trace_write (urj_bus_t *bus, uint32_t adr, uint32_t data);
+
+/**
+ * Read @adr @n times into @data, each read a bus access of its own, with
+ * the bus driver's read_repeat if it has one and with URJ_BUS_READ otherwise
+ *
+ * @return URJ_STATUS_OK on success; URJ_STATUS_FAIL on error
+ */
+int urj_bus_read_repeat (urj_bus_t *bus, uint32_t adr, uint32_t *data, int n);
+
+/**
+ * Read @n consecutive bus words from @adr on into @data, with the bus
+ * driver's read_block if it has one and with URJ_BUS_READ_START/NEXT/END
+ * otherwise
+ *
+ * @return URJ_STATUS_OK on success; URJ_STATUS_FAIL on error
+ */
+int urj_bus_read_block (urj_bus_t *bus, uint32_t adr, uint32_t *data, int n);
+
+/**
+ * Write the @n words of @data to consecutive bus words from @adr on, with
+ * the bus driver's write_block if it has one and with URJ_BUS_WRITE
+ * otherwise
+ *
+ * @return URJ_STATUS_OK on success; URJ_STATUS_FAIL on error
+ */
+int urj_bus_write_block (urj_bus_t *bus, uint32_t adr, const uint32_t *data,
+                         int n);
+
+/**
+ * One transaction on a serial bus: send @out_len bytes of @out, then
+ * receive @in_len bytes into @in, with the device selected throughout
+ *
+ * @return URJ_STATUS_OK on success; URJ_STATUS_FAIL on error, e.g. when the
+ *      bus driver has no transfer
+ */
+int urj_bus_transfer (urj_bus_t *bus, const uint8_t *out, int out_len,
+                      uint8_t *in, int in_len);
 
 #define URJ_BUS_PRINTINFO(ll,bus)       (bus)->driver->printinfo(ll,bus)
 #define URJ_BUS_PREPARE(bus)            (bus)->driver->prepare(bus)
 #define URJ_BUS_AREA(bus,adr,a)         (bus)->driver->area(bus,adr,a)
-#define URJ_BUS_READ_START(bus,adr)     (bus)->driver->read_start(bus,adr)
-#define URJ_BUS_READ_NEXT(bus,adr)      (bus)->driver->read_next(bus,adr)
-#define URJ_BUS_READ_END(bus)           (bus)->driver->read_end(bus)
-#define URJ_BUS_READ(bus,adr)           (bus)->driver->read(bus,adr)
-#define URJ_BUS_WRITE_START(bus,adr)    (bus)->driver->write_start(bus,adr)
-#define URJ_BUS_WRITE(bus,adr,data)     (bus)->driver->write(bus,adr,data)
+#define URJ_BUS_READ_START(bus,adr) \
+    (URJ_TRACE_ON () ? urj_bus_trace_read_start(bus,adr) \
+                     : (bus)->driver->read_start(bus,adr))
+#define URJ_BUS_READ_NEXT(bus,adr) \
+    (URJ_TRACE_ON () ? urj_bus_trace_read_next(bus,adr) \
+                     : (bus)->driver->read_next(bus,adr))
+#define URJ_BUS_READ_END(bus) \
+    (URJ_TRACE_ON () ? urj_bus_trace_read_end(bus) \
+                     : (bus)->driver->read_end(bus))
+#define URJ_BUS_READ(bus,adr) \
+    (URJ_TRACE_ON () ? urj_bus_trace_read(bus,adr) \
+                     : (bus)->driver->read(bus,adr))
+#define URJ_BUS_WRITE_START(bus,adr) \
+    (URJ_TRACE_ON () ? urj_bus_trace_write_start(bus,adr) \
+                     : (bus)->driver->write_start(bus,adr))
+#define URJ_BUS_WRITE(bus,adr,data) \
+    (URJ_TRACE_ON () ? urj_bus_trace_write(bus,adr,data) \
+                     : (bus)->driver->write(bus,adr,data))
 #define URJ_BUS_FREE(bus)               (bus)->driver->free_bus(bus)
 #define URJ_BUS_INIT(bus)               (bus)->driver->init(bus)
 #define URJ_BUS_ENABLE(bus)             (bus)->driver->enable(bus)
@@ -68,6 +68,12 @@ typedef enum URJ_CABLE_PARAM_KEY
     URJ_CABLE_PARAM_KEY_INDEX,          /* lu           ftdi */
     URJ_CABLE_PARAM_KEY_TRST,           /* lu           ft4232_generic */
     URJ_CABLE_PARAM_KEY_RESET,          /* lu           ft4232_generic */
+    URJ_CABLE_PARAM_KEY_CONFIG,         /* string       jim, virtual */
+    URJ_CABLE_PARAM_KEY_PROFILE,        /* string       virtual */
+    URJ_CABLE_PARAM_KEY_LATENCY,        /* lu           virtual */
+    URJ_CABLE_PARAM_KEY_BANDWIDTH,      /* lu           virtual */
+    URJ_CABLE_PARAM_KEY_BUFFER,         /* lu           virtual */
+    URJ_CABLE_PARAM_KEY_REALTIME,       /* lu           virtual */
 }
 urj_cable_param_key_t;
 
@@ -162,6 +168,25 @@ struct URJ_CABLE_QUEUE_INFO
     int next_free;
 };
 
+/** Performance counters of a cable, see the "perf" command */
+typedef struct URJ_CABLE_PERF
+{
+    uint64_t flushes;           /**< flushes that had to send data */
+    uint64_t optional_flushes;  /**< URJ_TAP_CABLE_OPTIONALLY flushes */
+    uint64_t queued;            /**< items added to the todo queue */
+    int queue_high_water;       /**< most items ever waiting in the queue */
+    uint64_t flushed_items;     /**< queue items run by the generic flushes */
+    uint64_t flush_batches;     /**< driver calls they were combined into */
+    uint64_t cx_xfers;          /**< urj_tap_cable_cx_xfer() calls */
+    uint64_t cx_cmds;           /**< commands sent by these */
+    uint64_t usb_writes;        /**< usbconn write calls */
+    uint64_t usb_write_bytes;
+    uint64_t usb_reads;         /**< usbconn read calls, i.e. round trips */
+    uint64_t usb_read_bytes;
+    double usb_read_time;       /**< seconds spent waiting in usbconn reads */
+}
+urj_cable_perf_t;
+
 struct URJ_CABLE
 {
     const urj_cable_driver_t *driver;
@@ -177,6 +202,7 @@ struct URJ_CABLE
     urj_cable_queue_info_t done;
     uint32_t delay;
     uint32_t frequency;
+    urj_cable_perf_t perf;
 };
 
 void urj_tap_cable_free (urj_cable_t *cable);
@@ -187,6 +213,13 @@ const urj_cable_driver_t *urj_tap_cable_find (const char *cname);
 void urj_tap_cable_done (urj_cable_t *cable);
 void urj_tap_cable_flush (urj_cable_t *cable,
                           urj_cable_flush_amount_t);
+/**
+ * Get the performance counters of @cable into @perf, including the
+ * traffic of its USB connection.
+ */
+void urj_tap_cable_get_perf (const urj_cable_t *cable, urj_cable_perf_t *perf);
+/** Clear the performance counters of @cable */
+void urj_tap_cable_perf_reset (urj_cable_t *cable);
 /** @return URJ_STATUS_OK on success; URJ_STATUS_FAIL on failure */
 void urj_tap_cable_clock (urj_cable_t *cable, int tms, int tdi, int n);
 int urj_tap_cable_defer_clock (urj_cable_t *cable, int tms, int tdi, int n);
@@ -254,6 +287,28 @@ urj_cable_t *urj_tap_cable_other_connect (urj_chain_t *chain,
                                           const urj_cable_driver_t *driver,
                                           const urj_param_t *params[]);
 
+/** Link statistics of the "virtual" cable */
+typedef struct
+{
+    uint64_t transactions;      /**< USB transactions sent */
+    uint64_t round_trips;       /**< transactions that had to wait for data */
+    uint64_t bytes_out;         /**< bytes sent to the adapter */
+    uint64_t bytes_in;          /**< bytes read back from the adapter */
+    uint64_t clocks;            /**< TCK cycles */
+    uint64_t link_ns;           /**< modeled time spent on the link */
+}
+urj_cable_virtual_stats_t;
+
+/**
+ * Get (and optionally reset) the link statistics of a "virtual" cable.
+ * Only available if the JIM simulator is enabled.
+ *
+ * @return URJ_STATUS_OK on success; URJ_STATUS_FAIL if @cable is not a
+ *      virtual cable
+ */
+int urj_tap_cable_virtual_stats (urj_cable_t *cable,
+                                 urj_cable_virtual_stats_t *stats, int reset);
+
 extern const urj_cable_driver_t * const urj_tap_cable_drivers[];
 
 /** The list of recognized parameters */
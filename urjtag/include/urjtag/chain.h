@@ -29,6 +29,7 @@
 
 #include "pod.h"
 #include "bsdl.h"
+#include "bus.h"
 #include "error.h"
 
 #define URJ_CHAIN_EXITMODE_SHIFT        0
@@ -45,6 +46,10 @@ struct URJ_CHAIN
     urj_cable_t *cable;
     urj_bsdl_globs_t bsdl;
     int main_part;
+    urj_buses_t buses;          /**< buses initialized on this chain */
+    urj_bus_t *bus;             /**< active bus */
+    urj_chain_t **gang;         /**< other chains of the gang */
+    int gang_len;
 };
 
 urj_chain_t *urj_tap_chain_alloc (void);
@@ -70,6 +75,14 @@ int urj_tap_chain_set_trst (urj_chain_t *chain, int trst);
 int urj_tap_chain_get_trst (urj_chain_t *chain);
 /** @return URJ_STATUS_OK on success; URJ_STATUS_FAIL on error */
 int urj_tap_chain_shift_instructions (urj_chain_t *chain);
+/**
+ * Like urj_tap_chain_shift_instructions(), but leave the shift in the cable
+ * queue, so that it goes out together with the deferred data register
+ * shifts around it.
+ *
+ * @return URJ_STATUS_OK on success; URJ_STATUS_FAIL on error
+ */
+int urj_tap_chain_defer_shift_instructions (urj_chain_t *chain);
 /** @return URJ_STATUS_OK on success; URJ_STATUS_FAIL on error */
 int urj_tap_chain_shift_instructions_mode (urj_chain_t *chain,
                                            int capture_output, int capture,
@@ -81,6 +94,19 @@ int urj_tap_chain_shift_data_registers (urj_chain_t *chain,
 int urj_tap_chain_shift_data_registers_mode (urj_chain_t *chain,
                                              int capture_output, int capture,
                                              int chain_exit);
+/**
+ * The two halves of urj_tap_chain_shift_data_registers_mode(): queue the
+ * shift, and later collect its output into the data registers. Several
+ * shifts may be queued before their outputs are collected in the same
+ * order, so that they all go to the cable in one flush.
+ *
+ * @return URJ_STATUS_OK on success; URJ_STATUS_FAIL on error
+ */
+int urj_tap_chain_defer_shift_data_registers (urj_chain_t *chain,
+                                              int capture_output, int capture,
+                                              int chain_exit);
+void urj_tap_chain_shift_data_registers_output (urj_chain_t *chain,
+                                                int chain_exit);
 void urj_tap_chain_flush (urj_chain_t *chain);
 /** @return 0 or 1 on success; -1 on failure */
 int urj_tap_chain_set_pod_signal (urj_chain_t *chain, int mask, int val);
@@ -101,4 +127,51 @@ typedef struct
 }
 urj_chains_t;
 
+/**
+ * A job on one chain, for urj_tap_chain_run_jobs().
+ */
+typedef struct URJ_CHAIN_JOB
+{
+    urj_chain_t *chain;
+    /** @return URJ_STATUS_OK on success; URJ_STATUS_FAIL on error */
+    int (*run) (urj_chain_t *chain, void *data);
+    void *data;
+    int result;                 /**< return value of run */
+    urj_error_state_t error;    /**< error state left by run */
+}
+urj_chain_job_t;
+
+/**
+ * Run @n jobs at once, each in a thread of its own. No two jobs may use
+ * the same chain. Without thread support the jobs run one after another.
+ *
+ * @return URJ_STATUS_OK if all jobs succeeded; URJ_STATUS_FAIL otherwise,
+ *      with the error state of the first failed job. Jobs that could not
+ *      be started are failed with the error that stopped them.
+ */
+int urj_tap_chain_run_jobs (urj_chain_job_t *jobs, int n);
+
+/**
+ * Add a chain on another cable to the gang of @chain. A gang is a set of
+ * chains with identical targets that are programmed together; @chain
+ * itself is the first member and owns the others.
+ *
+ * @param chain      first chain of the gang
+ * @param drivername name of cable driver
+ * @param params     additional driver-specific parameters
+ *
+ * @return the new chain on success; NULL on error
+ */
+urj_chain_t *urj_tap_chain_gang_add (urj_chain_t *chain,
+                                     const char *drivername, char *params[]);
+/** Disconnect and free all chains that were added to the gang of @chain */
+void urj_tap_chain_gang_free (urj_chain_t *chain);
+/**
+ * Run one job per member of the gang of @chain, all at once. @jobs must
+ * hold 1 + chain->gang_len entries; the chain of each entry is set here.
+ *
+ * @return as urj_tap_chain_run_jobs()
+ */
+int urj_tap_chain_gang_run (urj_chain_t *chain, urj_chain_job_t *jobs);
+
 #endif /* URJ_CHAIN_H */
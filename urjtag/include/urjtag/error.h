@@ -96,7 +96,8 @@ typedef struct URJ_ERROR_STATE
 }
 urj_error_state_t;
 
-extern urj_error_state_t        urj_error_state;
+/** Each thread has its own error state */
+extern URJ_THREAD_LOCAL urj_error_state_t urj_error_state;
 
 /**
  * Descriptive string for error type
@@ -39,12 +39,10 @@
 
 #include "types.h"
 
-typedef struct URJ_FLASH_CFI_ARRAY urj_flash_cfi_array_t;
-
 typedef int (*urj_flash_detect_func_t) (urj_bus_t *bus, uint32_t adr,
                                         urj_flash_cfi_array_t **cfi_array);
 
-typedef struct
+struct URJ_FLASH_DRIVER
 {
     const char *name;
     const char *description;
@@ -62,17 +60,29 @@ typedef struct
     int (*program) (urj_flash_cfi_array_t *cfi_array, uint32_t adr,
                     uint32_t *buffer, int count);
     void (*readarray) (urj_flash_cfi_array_t *cfi_array);
-}
-urj_flash_driver_t;
+};
 
 extern const urj_flash_driver_t * const urj_flash_flash_drivers[];
 
-/** @return URJ_STATUS_OK on success; URJ_STATUS_FAIL on error */
+/**
+ * Detect the flash at @adr on @bus. The result is kept in @bus for the
+ * flash functions below.
+ *
+ * @return URJ_STATUS_OK on success; URJ_STATUS_FAIL on error
+ */
 int urj_flash_detectflash (urj_log_level_t ll, urj_bus_t *bus, uint32_t adr);
-void urj_flash_cleanup (void);
+/** Forget the flash detected on @bus */
+void urj_flash_cleanup (urj_bus_t *bus);
 
 /** @return URJ_STATUS_OK on success; URJ_STATUS_FAIL on error */
 int urj_flashmem (urj_bus_t *bus, FILE *f, uint32_t addr, int);
+/**
+ * Like urj_flashmem(), but leave the blocks alone that already hold the
+ * data, and program only the words of an erased block that are not 0xFF.
+ *
+ * @return URJ_STATUS_OK on success; URJ_STATUS_FAIL on error
+ */
+int urj_flashmem_diff (urj_bus_t *bus, FILE *f, uint32_t addr, int);
 /** @return URJ_STATUS_OK on success; URJ_STATUS_FAIL on error */
 int urj_flashmsbin (urj_bus_t *bus, FILE *f, int);
 
@@ -83,6 +83,7 @@ struct URJ_JIM_DEVICE
     urj_jim_shift_reg_t *sreg;
     int tdo;
     int tdo_buffer;
+    int clocked;                /* hooks see every clock in Shift-DR */
 };
 
 typedef struct URJ_JIM_STATE
@@ -91,6 +92,8 @@ typedef struct URJ_JIM_STATE
     uint8_t *shmem;
     size_t shmem_size;
     urj_jim_device_t *last_device_in_chain;
+    uint32_t *shift_buf;        /* scratch space for urj_jim_shift() */
+    size_t shift_buf_words;
 }
 urj_jim_state_t;
 
@@ -125,9 +128,72 @@ int urj_jim_get_trst (urj_jim_state_t *s);
 int urj_jim_get_tdo (urj_jim_state_t *s);
 void urj_jim_tck_rise (urj_jim_state_t *s, int tms, int tdi);
 void urj_jim_tck_fall (urj_jim_state_t *s);
+/**
+ * Clock n bits through the chain, like n calls of urj_jim_tck_rise() and
+ * urj_jim_tck_fall().  Runs of clocks with TMS = 0 while all devices are in
+ * Shift-DR or Shift-IR are done with word-level shifts; the device tck_rise
+ * and tck_fall hooks are not called for those clocks, unless a device in
+ * Shift-DR has set clocked.
+ *
+ * @param tms TMS value for each clock (one bit per byte), or NULL for all 0
+ * @param tdi TDI value for each clock (one bit per byte)
+ * @param tdo if not NULL, receives TDO as seen before each clock
+ */
+void urj_jim_shift (urj_jim_state_t *s, int n, const char *tms,
+                    const char *tdi, char *tdo);
 urj_jim_device_t *urj_jim_alloc_device (int num_sregs, const int reg_size[]);
 urj_jim_state_t *urj_jim_init (void);
+/**
+ * Like urj_jim_init(), but build the chain from a description file instead
+ * of the single some_cpu (see src/jim/README.jim). NULL gives the default.
+ */
+urj_jim_state_t *urj_jim_init_chain (const char *chain_file);
 void urj_jim_free (urj_jim_state_t *s);
 urj_jim_device_t *urj_jim_some_cpu (void);
+/**
+ * some_cpu with chips CFI NOR flashes of mbytes MByte each instead of the
+ * 28F800B3; two chips sit side by side on D(31)..D(0)
+ */
+urj_jim_device_t *urj_jim_some_cpu_cfi (int mbytes, int chips);
+/**
+ * some_cpu with an SPI NOR flash of mbytes MByte on CS and D(2)..D(0) instead
+ * of the 28F800B3
+ */
+urj_jim_device_t *urj_jim_some_cpu_spi (int mbytes);
+/**
+ * FPGA TAP with a JTAG-to-SPI bridge in USER1 and an SPI NOR flash of mbytes
+ * MByte behind it (see spi_bridge.c)
+ */
+urj_jim_device_t *urj_jim_spi_bridge (int mbytes);
+/**
+ * FPGA TAP with the fjmem core in USER1 and kbytes KByte of 16 bit RAM behind
+ * it; burst enables read bursts (see fjmem_core.c)
+ */
+urj_jim_device_t *urj_jim_fjmem_core (int kbytes, int burst);
+/**
+ * MIPS32 processor with an EJTAG 2.6 TAP and kbytes KByte of RAM, fetching
+ * lag instructions ahead; fastdata = 0 leaves out the FASTDATA register,
+ * dma >= 0 adds DMA transfers of dma TCK cycles (see mips_ejtag.c)
+ */
+urj_jim_device_t *urj_jim_mips_ejtag (int kbytes, int lag, int fastdata,
+                                      int dma);
+/**
+ * Blackfin core with kbytes KByte of RAM; EMUIR takes core TCK cycles to
+ * run, plus mem for each memory access (see bfin_emu.c)
+ */
+urj_jim_device_t *urj_jim_bfin (int kbytes, int core, int mem);
+/**
+ * Altera Cyclone FPGA with kbytes KByte of configuration memory, loaded
+ * through PROGRAM (see fpga_config.c)
+ */
+urj_jim_device_t *urj_jim_cyclone (int kbytes);
+/**
+ * Lattice ECP5 FPGA with kbytes KByte of configuration memory, loaded
+ * through LSC_BITSTREAM_BURST (see fpga_config.c)
+ */
+urj_jim_device_t *urj_jim_ecp5 (int kbytes);
+/** TAP with given IR and BSR lengths, optionally an IDCODE (see generic_device.c) */
+urj_jim_device_t *urj_jim_generic_device (int ir_len, int bsr_len,
+                                          int has_idcode, uint32_t idcode);
 
 #endif
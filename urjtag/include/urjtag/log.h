@@ -47,12 +47,46 @@ int urj_do_log (urj_log_level_t level, const char *file, size_t line,
 #endif
     ;
 
+/**
+ * Messages below this level are compiled out. Builds configured with
+ * --with-log-floor=LEVEL set it; the default keeps every level.
+ */
+#ifndef URJ_LOG_FLOOR
+#define URJ_LOG_FLOOR   URJ_LOG_LEVEL_ALL
+#endif
+
+/**
+ * Nonzero if messages of level @lvl are printed. Use it to guard
+ * diagnostics that need more work than the arguments of a single urj_log.
+ */
+#define urj_log_enabled(lvl) \
+        ((lvl) >= URJ_LOG_FLOOR && (lvl) >= urj_log_state.level)
+
+/**
+ * The arguments are only evaluated if the message is printed, so
+ * formatters such as urj_tap_register_get_string() cost nothing otherwise.
+ */
 #define urj_log(lvl, ...) \
         do { \
-            if ((lvl) >= urj_log_state.level) \
+            if (urj_log_enabled (lvl)) \
                 urj_do_log (lvl, __FILE__, __LINE__, __func__, __VA_ARGS__); \
         } while (0)
 
+void urj_do_log_bits (urj_log_level_t level, const char *file, size_t line,
+                      const char *func, const char *prefix, int len,
+                      const char *vec);
+
+/**
+ * Log a bit vector (one char per bit, zero or nonzero) as a line of
+ * '0' and '1' characters, preceded by @prefix.
+ */
+#define urj_log_bits(lvl, prefix, len, vec) \
+        do { \
+            if (urj_log_enabled (lvl)) \
+                urj_do_log_bits (lvl, __FILE__, __LINE__, __func__, \
+                                 prefix, len, vec); \
+        } while (0)
+
 /**
  * Print warning unless logging level is > URJ_LOG_LEVEL_WARNING
  *
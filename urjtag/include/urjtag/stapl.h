@@ -25,9 +25,28 @@
 #ifndef URJ_STAPL_H
 #define URJ_STAPL_H
 
+#include <stdint.h>
+
 #include "types.h"
 
+/**
+ * Execution statistics of the most recent urj_stapl_run() call
+ */
+typedef struct URJ_STAPL_STATS
+{
+    int exec_result;            /**< player return code, 0 for success */
+    int exit_code;              /**< code passed to the EXIT statement */
+    uint32_t statements;        /**< number of statements executed */
+    uint64_t scan_bits;         /**< number of bits shifted in IR/DR scans */
+}
+urj_stapl_stats_t;
+
 int urj_stapl_run (urj_chain_t *chain, char *STAPL_file_name,
                    char *STAPL_action);
 
+/**
+ * Retrieve the statistics of the most recent urj_stapl_run() call.
+ */
+void urj_stapl_get_stats (urj_stapl_stats_t *stats);
+
 #endif /* URJ_STAPL_H */
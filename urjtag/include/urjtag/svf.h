@@ -53,4 +53,10 @@
 int urj_svf_run (urj_chain_t *chain, FILE *SVF_FILE, int stop_on_mismatch,
                  uint32_t ref_freq);
 
+/**
+ * @return the number of TDO mismatches in the most recent urj_svf_run()
+ *      call of the calling thread
+ */
+int urj_svf_get_mismatches (void);
+
 #endif /* URJ_SVF_H */
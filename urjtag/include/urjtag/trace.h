@@ -0,0 +1,81 @@
+/*
+ * $Id$
+ *
+ * Copyright (C) 2026 UrJTAG contributors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA
+ * 02111-1307, USA.
+ *
+ */
+
+#ifndef URJ_TRACE_H
+#define URJ_TRACE_H
+
+#include <stdio.h>
+
+#include "types.h"
+
+/**
+ * Event trace in the Chrome trace-event JSON format, for chrome://tracing,
+ * Perfetto and the like. Tracing is off unless a trace file is open; then
+ * every hook costs a single pointer test.
+ */
+extern FILE *urj_trace_file;
+
+/** Event phases */
+#define URJ_TRACE_BEGIN         'B'
+#define URJ_TRACE_END           'E'
+#define URJ_TRACE_INSTANT       'i'
+#define URJ_TRACE_COUNTER       'C'
+
+#define URJ_TRACE_ON()          (urj_trace_file != NULL)
+
+/**
+ * Record an event if tracing is on. @args is NULL or a printf format for
+ * the members of the event's "args" object, e.g. "\"bytes\":%d".
+ */
+#define urj_trace(ph, cat, name, ...) \
+    do { \
+        if (URJ_TRACE_ON ()) \
+            urj_trace_event (ph, cat, name, __VA_ARGS__); \
+    } while (0)
+
+void urj_trace_event (char ph, const char *cat, const char *name,
+                      const char *args, ...)
+#ifdef __GNUC__
+                        __attribute__ ((format (printf, 4, 5)))
+#endif
+    ;
+
+/**
+ * Start tracing into @filename, stopping a running trace first.
+ *
+ * @return URJ_STATUS_OK on success; URJ_STATUS_FAIL on failure
+ */
+int urj_trace_start (const char *filename);
+
+/** Stop tracing and complete the trace file. */
+void urj_trace_stop (void);
+
+/**
+ * Start tracing if the environment variable URJ_TRACE names a trace file.
+ * Only the first call looks at the environment.
+ *
+ * @return URJ_STATUS_OK on success or if URJ_TRACE is not set;
+ *      URJ_STATUS_FAIL if the file cannot be created
+ */
+int urj_trace_from_env (void);
+
+#endif /* URJ_TRACE_H */
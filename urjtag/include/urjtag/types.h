@@ -28,6 +28,7 @@
 
 typedef struct URJ_BUS urj_bus_t;
 typedef struct URJ_BUS_DRIVER urj_bus_driver_t;
+typedef struct URJ_BUSES urj_buses_t;
 typedef struct URJ_CHAIN urj_chain_t;
 typedef struct URJ_CABLE urj_cable_t;
 typedef struct URJ_USBCONN urj_usbconn_t;
@@ -42,6 +43,8 @@ typedef struct URJ_PART_INIT urj_part_init_t;
 typedef struct URJ_DATA_REGISTER urj_data_register_t;
 typedef struct URJ_BSBIT urj_bsbit_t;
 typedef struct URJ_TAP_REGISTER urj_tap_register_t;
+typedef struct URJ_FLASH_CFI_ARRAY urj_flash_cfi_array_t;
+typedef struct URJ_FLASH_DRIVER urj_flash_driver_t;
 
 /**
  * Log levels
@@ -63,4 +66,14 @@ urj_log_level_t;
 #define URJ_STATUS_FAIL           1
 #define URJ_STATUS_MUST_QUIT    (-2)
 
+/**
+ * Storage class of the little library state that is per thread rather
+ * than per chain, such as the error state.
+ */
+#ifdef __GNUC__
+#define URJ_THREAD_LOCAL        __thread
+#else
+#define URJ_THREAD_LOCAL
+#endif
+
 #endif /* URJ_URJ_TYPES_H */
@@ -60,11 +60,23 @@ typedef struct
 }
 urj_usbconn_driver_t;
 
+/** USB traffic of a connection, see urj_tap_cable_get_perf() */
+typedef struct URJ_USBCONN_PERF
+{
+    uint64_t writes;            /**< write calls */
+    uint64_t write_bytes;
+    uint64_t reads;             /**< read calls, i.e. round trips */
+    uint64_t read_bytes;
+    double read_time;           /**< seconds spent waiting in reads */
+}
+urj_usbconn_perf_t;
+
 struct URJ_USBCONN
 {
     const urj_usbconn_driver_t *driver;
     void *params;
     urj_cable_t *cable;
+    urj_usbconn_perf_t perf;
 };
 
 int urj_tap_usbconn_open (urj_usbconn_t *conn);
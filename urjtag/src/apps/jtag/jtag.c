@@ -352,12 +352,88 @@ jtag_parse_rc (urj_chain_t *chain)
 static void
 cleanup (urj_chain_t *chain)
 {
-    urj_flash_cleanup ();
-    urj_bus_buses_free ();
+    urj_bus_buses_free (chain);
     urj_tap_chain_free (chain);
     chain = NULL;
 }
 
+/* run the commands of one file on its chain, stopping at the first error */
+static int
+jtag_file_job (urj_chain_t *chain, void *data)
+{
+    const char *filename = data;
+    char *line = NULL;
+    size_t len = 0;
+    char *p;
+    FILE *f;
+    int r = URJ_STATUS_OK;
+
+    f = fopen (filename, FOPEN_R);
+    if (!f)
+    {
+        urj_error_IO_set (_("Unable to open file `%s'"), filename);
+        return URJ_STATUS_FAIL;
+    }
+
+    while (r == URJ_STATUS_OK && getline (&line, &len, f) != -1)
+    {
+        p = strchr (line, '\n');
+        if (p)
+            *p = '\0';
+        r = urj_parse_line (chain, line);
+        urj_tap_chain_flush (chain);
+    }
+
+    free (line);
+    fclose (f);
+
+    return r == URJ_STATUS_MUST_QUIT ? URJ_STATUS_OK : r;
+}
+
+static int
+jtag_run_parallel (int nfiles, char *const files[])
+{
+    urj_chain_job_t *jobs;
+    int i, r;
+
+    jobs = calloc (nfiles, sizeof *jobs);
+    if (!jobs)
+    {
+        printf (_("Out of memory\n"));
+        return -1;
+    }
+
+    for (i = 0; i < nfiles; i++)
+    {
+        jobs[i].chain = urj_tap_chain_alloc ();
+        if (!jobs[i].chain)
+        {
+            printf (_("Out of memory\n"));
+            return -1;
+        }
+        jobs[i].run = jtag_file_job;
+        jobs[i].data = files[i];
+    }
+
+    r = urj_tap_chain_run_jobs (jobs, nfiles);
+
+    for (i = 0; i < nfiles; i++)
+    {
+        if (jobs[i].result == URJ_STATUS_OK)
+            printf (_("%s: ok\n"), files[i]);
+        else
+        {
+            urj_error_state = jobs[i].error;
+            printf (_("%s: failed: %s\n"), files[i], urj_error_describe ());
+        }
+        cleanup (jobs[i].chain);
+    }
+    urj_error_reset ();
+    free (jobs);
+
+    return r;
+}
+
 int
 main (int argc, char *const argv[])
 {
@@ -368,6 +444,7 @@ main (int argc, char *const argv[])
     int help = 0;
     int version = 0;
     int quiet = 0;
+    int parallel = 0;
     urj_chain_t *chain = NULL;
 
     urj_set_argv0 (argv[0]);
@@ -393,13 +470,14 @@ main (int argc, char *const argv[])
             {"interactive", no_argument, 0, 'i'},
             {"help", no_argument, 0, 'h'},
             {"quiet", no_argument, 0, 'q'},
+            {"parallel", no_argument, 0, 'p'},
             {0, 0, 0, 0}
         };
 
         /* `getopt_long' stores the option index here. */
         int option_index = 0;
 
-        c = getopt_long (argc, argv, "vnhiq", long_options, &option_index);
+        c = getopt_long (argc, argv, "vnhiqp", long_options, &option_index);
 
         /* Detect the end of the options. */
         if (c == -1)
@@ -427,6 +505,10 @@ main (int argc, char *const argv[])
         case 'q':
             quiet = 1;
             break;
+
+        case 'p':
+            parallel = 1;
+            break;
         }
     }
 
@@ -445,6 +527,7 @@ main (int argc, char *const argv[])
         printf (_("  -n, --norc          disable reading ~/.jtag/rc on startup\n"));
         printf (_("  -i, --interactive   enter interactive mode after reading files\n"));
         printf (_("  -q, --quiet         Do not print help on startup\n"));
+        printf (_("  -p, --parallel      run all FILEs at once, each on a chain of its own\n"));
         printf ("\n");
         printf (_("  [FILE]              file containing commands to execute\n"));
         printf ("\n");
@@ -481,8 +564,17 @@ main (int argc, char *const argv[])
         exit (0);
     }
 
+    /* input from files, all at once */
+    if (parallel && argc > optind)
+    {
+        if (jtag_run_parallel (argc - optind, argv + optind) != URJ_STATUS_OK)
+            return 1;
+
+        if (!urj_interactive)
+            return 0;
+    }
     /* input from files */
-    if (argc > optind)
+    else if (argc > optind)
     {
         for (i = optind; i < argc; i++)
         {
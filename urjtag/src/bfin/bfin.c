@@ -46,9 +46,15 @@ const char * const scans[] = {
 
 #define SWRST 0xffc00100
 
+/* Accesses in one batch of the block memory engine */
+#define BFIN_MEM_BATCH 1024
+
+/* TCKs to wait for an instruction until they are calibrated, and at most */
+#define BFIN_WAIT_CLOCKS_DEFAULT 30
+#define BFIN_WAIT_CLOCKS_MAX 1024
+
 
 int bfin_check_emuready = 1;
-int bfin_wait_clocks = -1;
 
 static const struct timespec bfin_emu_wait_ts = {0, 5000000};
 
@@ -150,6 +156,42 @@ part_scan_select (urj_chain_t *chain, int n, int scan)
     return 0;
 }
 
+/* Like part_scan_select, but select SCAN in all Blackfin parts, so that
+   one DR scan reaches all of them.  */
+
+int
+chain_scan_select (urj_chain_t *chain, int scan)
+{
+    int i;
+    int changed;
+    urj_part_t *part;
+
+    changed = 0;
+
+    for (i = 0; i < chain->parts->len; i++)
+    {
+        part = chain->parts->parts[i];
+        if (part_is_bfin (chain, i))
+        {
+            changed += bfin_set_scan (part, scan);
+            if (part->active_instruction == NULL)
+            {
+                urj_log (URJ_LOG_LEVEL_ERROR,
+                         _("%s: unknown instruction '%s'\n"), part->part_name,
+                         scans[scan]);
+                return -1;
+            }
+        }
+        else
+            changed += bfin_set_scan (part, BYPASS);
+    }
+
+    if (changed)
+        urj_tap_chain_shift_instructions_mode (chain, 0, 1, URJ_CHAIN_EXITMODE_UPDATE);
+
+    return 0;
+}
+
 /* The helper functions for Blackfin DBGCTL and DBGSTAT operations.  */
 
 static void
@@ -320,6 +362,21 @@ part_dbgstat_get (urj_chain_t *chain, int n)
     BFIN_PART_DBGSTAT (part) = bfin_dbgstat_value (part);
 }
 
+void
+chain_dbgstat_get (urj_chain_t *chain)
+{
+    int i;
+
+    chain_scan_select (chain, DBGSTAT_SCAN);
+
+    urj_tap_chain_shift_data_registers_mode (chain, 1, 1, URJ_CHAIN_EXITMODE_UPDATE);
+
+    for (i = 0; i < chain->parts->len; i++)
+        if (part_is_bfin (chain, i))
+            BFIN_PART_DBGSTAT (chain->parts->parts[i])
+                = bfin_dbgstat_value (chain->parts->parts[i]);
+}
+
 uint32_t
 part_emupc_get (urj_chain_t *chain, int n, int save)
 {
@@ -341,6 +398,30 @@ part_emupc_get (urj_chain_t *chain, int n, int save)
     return BFIN_PART_EMUPC (part);
 }
 
+void
+chain_emupc_get (urj_chain_t *chain, int save)
+{
+    urj_part_t *part;
+    urj_tap_register_t *r;
+    int i;
+
+    chain_scan_select (chain, EMUPC_SCAN);
+
+    urj_tap_chain_shift_data_registers_mode (chain, 1, 1, URJ_CHAIN_EXITMODE_UPDATE);
+
+    for (i = 0; i < chain->parts->len; i++)
+    {
+        if (!part_is_bfin (chain, i))
+            continue;
+
+        part = chain->parts->parts[i];
+        r = part->active_instruction->data_register->out;
+        BFIN_PART_EMUPC (part) = bfin_register_get_value (r);
+        if (save)
+            BFIN_PART_EMUPC_ORIG (part) = BFIN_PART_EMUPC (part);
+    }
+}
+
 void
 part_dbgstat_clear_ovfs (urj_chain_t *chain, int n)
 {
@@ -355,6 +436,32 @@ part_dbgstat_clear_ovfs (urj_chain_t *chain, int n)
     part_dbgstat_bit_clear_emudoovf (chain, n);
 }
 
+void
+chain_dbgstat_clear_ovfs (urj_chain_t *chain)
+{
+    int i;
+
+    chain_scan_select (chain, DBGSTAT_SCAN);
+
+    for (i = 0; i < chain->parts->len; i++)
+    {
+        if (!part_is_bfin (chain, i))
+            continue;
+        part_dbgstat_bit_set_emudiovf (chain, i);
+        part_dbgstat_bit_set_emudoovf (chain, i);
+    }
+
+    urj_tap_chain_shift_data_registers_mode (chain, 0, 1, URJ_CHAIN_EXITMODE_UPDATE);
+
+    for (i = 0; i < chain->parts->len; i++)
+    {
+        if (!part_is_bfin (chain, i))
+            continue;
+        part_dbgstat_bit_clear_emudiovf (chain, i);
+        part_dbgstat_bit_clear_emudoovf (chain, i);
+    }
+}
+
 void
 part_check_emuready (urj_chain_t *chain, int n)
 {
@@ -369,6 +476,21 @@ part_check_emuready (urj_chain_t *chain, int n)
     assert (emuready);
 }
 
+void
+chain_check_emuready (urj_chain_t *chain)
+{
+    int emuready;
+    int i;
+
+    chain_dbgstat_get (chain);
+    emuready = 1;
+    for (i = 0; i < chain->parts->len; i++)
+        if (part_is_bfin (chain, i) && !part_dbgstat_is_emuready (chain, i))
+            emuready = 0;
+
+    assert (emuready);
+}
+
 void
 part_wait_in_reset (urj_chain_t *chain, int n)
 {
@@ -651,6 +773,85 @@ part_emuir_set_2 (urj_chain_t *chain, int n, uint64_t insn1, uint64_t insn2, int
         part_check_emuready (chain, n);
 }
 
+/* Load the same instructions into EMUIR of all Blackfin parts with one
+   DBGCTL scan and one or two EMUIR scans.  INSN2 is only used when
+   EMUIRLPSZ_2 is set.  */
+
+static void
+chain_emuir_set_same_1_or_2 (urj_chain_t *chain, uint64_t insn1,
+                             uint64_t insn2, int two, int exit)
+{
+    int emuir_scan;
+    urj_part_t *part;
+    urj_tap_register_t *r;
+    int i;
+
+    assert (exit == URJ_CHAIN_EXITMODE_UPDATE || exit == URJ_CHAIN_EXITMODE_IDLE);
+
+    if ((insn1 & 0xffffffff00000000ULL) == 0
+        && (!two || (insn2 & 0xffffffff00000000ULL) == 0))
+        emuir_scan = EMUIR_SCAN;
+    else
+        emuir_scan = EMUIR64_SCAN;
+
+    chain_scan_select (chain, DBGCTL_SCAN);
+    for (i = 0; i < chain->parts->len; i++)
+    {
+        if (!part_is_bfin (chain, i))
+            continue;
+        if (emuir_scan == EMUIR_SCAN)
+            part_dbgctl_bit_set_emuirsz_32 (chain, i);
+        else
+            part_dbgctl_bit_set_emuirsz_64 (chain, i);
+    }
+    urj_tap_chain_shift_data_registers_mode (chain, 0, 1, URJ_CHAIN_EXITMODE_UPDATE);
+
+    chain_scan_select (chain, emuir_scan);
+
+    if (two)
+    {
+        for (i = 0; i < chain->parts->len; i++)
+        {
+            if (!part_is_bfin (chain, i))
+                continue;
+
+            part = chain->parts->parts[i];
+            r = part->active_instruction->data_register->in;
+            emuir_init_value (r, insn2);
+            BFIN_PART_EMUIR_B (part) = insn2;
+        }
+        urj_tap_chain_shift_data_registers_mode (chain, 0, 1, URJ_CHAIN_EXITMODE_UPDATE);
+    }
+
+    for (i = 0; i < chain->parts->len; i++)
+    {
+        if (!part_is_bfin (chain, i))
+            continue;
+
+        part = chain->parts->parts[i];
+        r = part->active_instruction->data_register->in;
+        emuir_init_value (r, insn1);
+        BFIN_PART_EMUIR_A (part) = insn1;
+    }
+    urj_tap_chain_shift_data_registers_mode (chain, 0, 1, exit);
+
+    if (exit == URJ_CHAIN_EXITMODE_IDLE && bfin_check_emuready)
+        chain_check_emuready (chain);
+}
+
+void
+chain_emuir_set_same (urj_chain_t *chain, uint64_t insn, int exit)
+{
+    chain_emuir_set_same_1_or_2 (chain, insn, INSN_NOP, 0, exit);
+}
+
+void
+chain_emuir_set_same_2 (urj_chain_t *chain, uint64_t insn1, uint64_t insn2,
+                        int exit)
+{
+    chain_emuir_set_same_1_or_2 (chain, insn1, insn2, 1, exit);
+}
+
 uint64_t
 emudat_value (urj_tap_register_t *r)
 {
@@ -808,6 +1009,80 @@ part_emudat_set (urj_chain_t *chain, int n, uint32_t value, int exit)
         part_check_emuready (chain, n);
 }
 
+/* Capture EMUDAT of all Blackfin parts with one scan.  VALUES is indexed
+   by part number; entries of other parts are left alone.  */
+
+void
+chain_emudat_get (urj_chain_t *chain, uint32_t *values, int exit)
+{
+    urj_part_t *part;
+    urj_tap_register_t *r;
+    int i;
+
+    assert (exit == URJ_CHAIN_EXITMODE_UPDATE || exit == URJ_CHAIN_EXITMODE_IDLE);
+
+    if (exit == URJ_CHAIN_EXITMODE_IDLE)
+    {
+        assert (urj_tap_state (chain) & URJ_TAP_STATE_IDLE);
+        urj_tap_chain_defer_clock (chain, 0, 0, 1);
+        urj_tap_chain_wait_ready (chain);
+    }
+
+    if (chain_scan_select (chain, EMUDAT_SCAN) < 0)
+        return;
+
+    for (i = 0; i < chain->parts->len; i++)
+    {
+        if (!part_is_bfin (chain, i))
+            continue;
+        /* Reads leave EMUDIF alone.  */
+        part = chain->parts->parts[i];
+        bfin_register_set_value (part->active_instruction->data_register->in, 0);
+    }
+
+    urj_tap_chain_shift_data_registers_mode (chain, 1, 1, URJ_CHAIN_EXITMODE_UPDATE);
+
+    for (i = 0; i < chain->parts->len; i++)
+    {
+        if (!part_is_bfin (chain, i))
+            continue;
+        part = chain->parts->parts[i];
+        r = part->active_instruction->data_register->out;
+        values[i] = emudat_value (r);
+    }
+}
+
+/* Set EMUDAT of all Blackfin parts with one scan.  VALUES is indexed by
+   part number.  */
+
+void
+chain_emudat_set (urj_chain_t *chain, const uint32_t *values, int exit)
+{
+    urj_part_t *part;
+    urj_tap_register_t *r;
+    int i;
+
+    assert (exit == URJ_CHAIN_EXITMODE_UPDATE || exit == URJ_CHAIN_EXITMODE_IDLE);
+
+    if (chain_scan_select (chain, EMUDAT_SCAN) < 0)
+        return;
+
+    for (i = 0; i < chain->parts->len; i++)
+    {
+        if (!part_is_bfin (chain, i))
+            continue;
+        part = chain->parts->parts[i];
+        r = part->active_instruction->data_register->in;
+        BFIN_PART_EMUDAT_IN (part) = values[i];
+        emudat_init_value (r, values[i]);
+    }
+
+    urj_tap_chain_shift_data_registers_mode (chain, 0, 1, exit);
+
+    if (exit == URJ_CHAIN_EXITMODE_IDLE && bfin_check_emuready)
+        chain_check_emuready (chain);
+}
+
 /* Forward declarations */
 void part_register_set (urj_chain_t *chain, int n, enum core_regnum reg,
                         uint32_t value);
@@ -886,6 +1161,84 @@ part_register_set (urj_chain_t *chain, int n, enum core_regnum reg, uint32_t val
     }
 }
 
+static void
+chain_emuirlpsz_2 (urj_chain_t *chain, int set)
+{
+    int i;
+
+    chain_scan_select (chain, DBGCTL_SCAN);
+    for (i = 0; i < chain->parts->len; i++)
+    {
+        if (!part_is_bfin (chain, i))
+            continue;
+        if (set)
+            part_dbgctl_bit_set_emuirlpsz_2 (chain, i);
+        else
+            part_dbgctl_bit_clear_emuirlpsz_2 (chain, i);
+    }
+    urj_tap_chain_shift_data_registers_mode (chain, 0, 1, URJ_CHAIN_EXITMODE_UPDATE);
+}
+
+/* Read REG of all Blackfin parts at once, into VALUES indexed by part
+   number.  */
+
+void
+chain_register_get (urj_chain_t *chain, enum core_regnum reg, uint32_t *values)
+{
+    uint32_t *r0 = NULL;
+
+    if (DREG_P (reg) || PREG_P (reg))
+        chain_emuir_set_same (chain, gen_move (BFIN_REG_EMUDAT, reg), URJ_CHAIN_EXITMODE_IDLE);
+    else
+    {
+        r0 = (uint32_t *) malloc (chain->parts->len * sizeof (uint32_t));
+        chain_register_get (chain, BFIN_REG_R0, r0);
+
+        chain_emuirlpsz_2 (chain, 1);
+        chain_emuir_set_same_2 (chain, gen_move (BFIN_REG_R0, reg),
+                                gen_move (BFIN_REG_EMUDAT, BFIN_REG_R0), URJ_CHAIN_EXITMODE_IDLE);
+        chain_emuirlpsz_2 (chain, 0);
+    }
+
+    chain_emudat_get (chain, values, URJ_CHAIN_EXITMODE_UPDATE);
+
+    if (r0)
+    {
+        chain_register_set (chain, BFIN_REG_R0, r0);
+        free (r0);
+    }
+}
+
+/* Write VALUES, indexed by part number, to REG of all Blackfin parts at
+   once.  */
+
+void
+chain_register_set (urj_chain_t *chain, enum core_regnum reg, const uint32_t *values)
+{
+    uint32_t *r0 = NULL;
+
+    if (!DREG_P (reg) && !PREG_P (reg))
+    {
+        r0 = (uint32_t *) malloc (chain->parts->len * sizeof (uint32_t));
+        chain_register_get (chain, BFIN_REG_R0, r0);
+    }
+
+    chain_emudat_set (chain, values, URJ_CHAIN_EXITMODE_UPDATE);
+
+    if (DREG_P (reg) || PREG_P (reg))
+        chain_emuir_set_same (chain, gen_move (reg, BFIN_REG_EMUDAT), URJ_CHAIN_EXITMODE_IDLE);
+    else
+    {
+        chain_emuirlpsz_2 (chain, 1);
+        chain_emuir_set_same_2 (chain, gen_move (BFIN_REG_R0, BFIN_REG_EMUDAT),
+                                gen_move (reg, BFIN_REG_R0), URJ_CHAIN_EXITMODE_IDLE);
+        chain_emuirlpsz_2 (chain, 0);
+
+        chain_register_set (chain, BFIN_REG_R0, r0);
+        free (r0);
+    }
+}
+
 uint32_t
 part_get_r0 (urj_chain_t *chain, int n)
 {
@@ -950,6 +1303,9 @@ part_emulation_trigger (urj_chain_t *chain, int n)
     /* Bring the TAP state to Update-DR */
     urj_tap_chain_defer_clock (chain, 0, 0, 1);
     urj_tap_chain_defer_clock (chain, 1, 0, 2);
+
+    if (BFIN_PART_WAIT_CLOCKS (chain->parts->parts[n]) < 0)
+        part_wait_clocks_calibrate (chain, n);
 }
 
 void
@@ -967,6 +1323,129 @@ part_emulation_return (urj_chain_t *chain, int n)
     part_emuir_set (chain, n, INSN_NOP, URJ_CHAIN_EXITMODE_UPDATE);
 }
 
+void
+part_emulation_singlestep (urj_chain_t *chain, int n)
+{
+    part_scan_select (chain, n, DBGCTL_SCAN);
+    part_dbgctl_bit_set_esstep (chain, n);
+    urj_tap_chain_shift_data_registers_mode (chain, 0, 1, URJ_CHAIN_EXITMODE_UPDATE);
+    part_emuir_set (chain, n, INSN_RTE, URJ_CHAIN_EXITMODE_IDLE);
+    part_scan_select (chain, n, DBGCTL_SCAN);
+    part_dbgctl_bit_clear_esstep (chain, n);
+    urj_tap_chain_shift_data_registers_mode (chain, 0, 1, URJ_CHAIN_EXITMODE_UPDATE);
+}
+
+/* The chain_emulation_* functions do the same as their part_emulation_*
+   counterparts for all Blackfin parts together, e.g. both cores of a
+   BF561, so that they enter and leave emulation at the same TCK.  */
+
+void
+chain_emulation_enable (urj_chain_t *chain)
+{
+    int i;
+
+    chain_scan_select (chain, DBGCTL_SCAN);
+
+    for (i = 0; i < chain->parts->len; i++)
+        if (part_is_bfin (chain, i))
+            part_dbgctl_bit_set_empwr (chain, i);
+    urj_tap_chain_shift_data_registers_mode (chain, 0, 1, URJ_CHAIN_EXITMODE_UPDATE);
+
+    for (i = 0; i < chain->parts->len; i++)
+        if (part_is_bfin (chain, i))
+            part_dbgctl_bit_set_emfen (chain, i);
+    urj_tap_chain_shift_data_registers_mode (chain, 0, 1, URJ_CHAIN_EXITMODE_UPDATE);
+
+    for (i = 0; i < chain->parts->len; i++)
+    {
+        if (!part_is_bfin (chain, i))
+            continue;
+        part_dbgctl_bit_set_emuirsz_32 (chain, i);
+        part_dbgctl_bit_set_emudatsz_40 (chain, i);
+    }
+    urj_tap_chain_shift_data_registers_mode (chain, 0, 1, URJ_CHAIN_EXITMODE_UPDATE);
+}
+
+void
+chain_emulation_disable (urj_chain_t *chain)
+{
+    int i;
+
+    chain_scan_select (chain, DBGCTL_SCAN);
+    for (i = 0; i < chain->parts->len; i++)
+        if (part_is_bfin (chain, i))
+            part_dbgctl_bit_clear_empwr (chain, i);
+    urj_tap_chain_shift_data_registers_mode (chain, 0, 1, URJ_CHAIN_EXITMODE_UPDATE);
+}
+
+void
+chain_emulation_trigger (urj_chain_t *chain)
+{
+    int i;
+
+    chain_emuir_set_same (chain, INSN_NOP, URJ_CHAIN_EXITMODE_UPDATE);
+
+    chain_scan_select (chain, DBGCTL_SCAN);
+    for (i = 0; i < chain->parts->len; i++)
+    {
+        if (!part_is_bfin (chain, i))
+            continue;
+        part_dbgctl_bit_set_wakeup (chain, i);
+        part_dbgctl_bit_set_emeen (chain, i);
+    }
+    urj_tap_chain_shift_data_registers_mode (chain, 0, 1, URJ_CHAIN_EXITMODE_IDLE);
+
+    /* See part_emulation_trigger.  */
+    urj_tap_chain_defer_clock (chain, 1, 0, 1);
+    urj_tap_chain_defer_clock (chain, 0, 0, 1);
+    urj_tap_chain_defer_clock (chain, 1, 0, 2);
+
+    for (i = 0; i < chain->parts->len; i++)
+        if (part_is_bfin (chain, i)
+            && BFIN_PART_WAIT_CLOCKS (chain->parts->parts[i]) < 0)
+            part_wait_clocks_calibrate (chain, i);
+}
+
+void
+chain_emulation_return (urj_chain_t *chain)
+{
+    int i;
+
+    chain_emuir_set_same (chain, INSN_RTE, URJ_CHAIN_EXITMODE_UPDATE);
+
+    chain_scan_select (chain, DBGCTL_SCAN);
+    for (i = 0; i < chain->parts->len; i++)
+    {
+        if (!part_is_bfin (chain, i))
+            continue;
+        part_dbgctl_bit_clear_emeen (chain, i);
+        part_dbgctl_bit_clear_wakeup (chain, i);
+    }
+    urj_tap_chain_shift_data_registers_mode (chain, 0, 1, URJ_CHAIN_EXITMODE_IDLE);
+
+    chain_emuir_set_same (chain, INSN_NOP, URJ_CHAIN_EXITMODE_UPDATE);
+}
+
+void
+chain_emulation_singlestep (urj_chain_t *chain)
+{
+    int i;
+
+    chain_scan_select (chain, DBGCTL_SCAN);
+    for (i = 0; i < chain->parts->len; i++)
+        if (part_is_bfin (chain, i))
+            part_dbgctl_bit_set_esstep (chain, i);
+    urj_tap_chain_shift_data_registers_mode (chain, 0, 1, URJ_CHAIN_EXITMODE_UPDATE);
+
+    chain_emuir_set_same (chain, INSN_RTE, URJ_CHAIN_EXITMODE_IDLE);
+
+    chain_scan_select (chain, DBGCTL_SCAN);
+    for (i = 0; i < chain->parts->len; i++)
+        if (part_is_bfin (chain, i))
+            part_dbgctl_bit_clear_esstep (chain, i);
+    urj_tap_chain_shift_data_registers_mode (chain, 0, 1, URJ_CHAIN_EXITMODE_UPDATE);
+}
+
 void
 part_execute_instructions (urj_chain_t *chain, int n, struct bfin_insn *insns)
 {
@@ -1192,6 +1671,298 @@ part_mmr_write (urj_chain_t *chain, int n, uint32_t addr, uint32_t data, int siz
     part_register_set (chain, n, BFIN_REG_R0, r0);
 }
 
+/* EMUDOF and EMUDIF follow the payload in EMUDAT, if it is larger than 32
+   bits; EMUDOF tells whether the core had written EMUDAT when it was
+   captured, EMUDIF whether the core had not yet read it.  */
+
+static int
+emudat_dof (urj_tap_register_t *r)
+{
+    if (r->len <= 32)
+        return 1;
+    return (bfin_register_get_value (r) >> (r->len - 33)) & 1;
+}
+
+static int
+emudat_dif (urj_tap_register_t *r)
+{
+    if (r->len <= 33)
+        return 0;
+    return (bfin_register_get_value (r) >> (r->len - 34)) & 1;
+}
+
+/* Whether the instruction in EMUIR has written EMUDAT wait TCKs after
+   Run-Test/Idle is entered.  */
+
+static int
+bfin_wait_clocks_try (urj_chain_t *chain, int n, int wait)
+{
+    urj_tap_register_t *r;
+
+    /* Let an earlier run end and drain its EMUDAT.  */
+    urj_tap_chain_defer_clock (chain, 0, 0, 1 + BFIN_WAIT_CLOCKS_MAX);
+    part_emudat_defer_get (chain, n, URJ_CHAIN_EXITMODE_UPDATE);
+    part_emudat_get_done (chain, n, URJ_CHAIN_EXITMODE_UPDATE);
+
+    urj_tap_chain_defer_clock (chain, 0, 0, 1 + wait);
+    part_emudat_defer_get (chain, n, URJ_CHAIN_EXITMODE_UPDATE);
+    part_emudat_get_done (chain, n, URJ_CHAIN_EXITMODE_UPDATE);
+
+    r = chain->parts->parts[n]->active_instruction->data_register->out;
+    return emudat_dof (r);
+}
+
+/* Find the TCKs an instruction needs with this cable and clock: the
+   fewest after which "EMUDAT = R0" has set EMUDOF, plus a margin.  Too few
+   of them make reads return the word before.  The block memory engine
+   raises them again if memory accesses need more.  */
+
+void
+part_wait_clocks_calibrate (urj_chain_t *chain, int n)
+{
+    urj_part_t *part = chain->parts->parts[n];
+    int lo = -1, hi, mid;
+
+    part_dbgstat_get (chain, n);
+    if (!part_dbgstat_is_emuready (chain, n))
+        return;
+
+    part_emuir_set (chain, n, gen_move (BFIN_REG_EMUDAT, BFIN_REG_R0),
+                    URJ_CHAIN_EXITMODE_UPDATE);
+
+    for (hi = 0; hi <= BFIN_WAIT_CLOCKS_MAX; hi = hi ? 2 * hi : 1)
+    {
+        if (bfin_wait_clocks_try (chain, n, hi))
+            break;
+        lo = hi;
+    }
+    if (hi > BFIN_WAIT_CLOCKS_MAX)
+    {
+        urj_warning (_("%s: EMUDAT not written after %d TCKs\n"), "bfin",
+                     BFIN_WAIT_CLOCKS_MAX);
+        hi = BFIN_WAIT_CLOCKS_MAX;
+    }
+    else
+        while (hi - lo > 1)
+        {
+            mid = (lo + hi) / 2;
+            if (bfin_wait_clocks_try (chain, n, mid))
+                hi = mid;
+            else
+                lo = mid;
+        }
+
+    BFIN_PART_WAIT_CLOCKS (part) = hi + hi / 4 + 1;
+    urj_log (URJ_LOG_LEVEL_DETAIL, _("%s: wait_clocks set to %d\n"), "bfin",
+             BFIN_PART_WAIT_CLOCKS (part));
+
+    /* Drain EMUDAT of the last try.  */
+    bfin_wait_clocks_try (chain, n, BFIN_PART_WAIT_CLOCKS (part));
+    part_dbgstat_clear_ovfs (chain, n);
+}
+
+/* Wait until the core has run EMUIR and drain EMUDAT.  */
+
+static void
+bfin_mem_settle (urj_chain_t *chain, int n)
+{
+    urj_part_t *part = chain->parts->parts[n];
+    int timeout = 100;
+
+    do
+        part_dbgstat_get (chain, n);
+    while (!part_dbgstat_is_emuready (chain, n) && --timeout);
+
+    part_scan_select (chain, n, EMUDAT_SCAN);
+    bfin_register_set_value (part->active_instruction->data_register->in, 0);
+    urj_tap_chain_shift_data_registers_mode (chain, 1, 1, URJ_CHAIN_EXITMODE_UPDATE);
+
+    part_dbgstat_clear_ovfs (chain, n);
+}
+
+/* One batch of the block memory engine: cnt accesses of size bytes from
+   addr on, reads into rbuf or writes of wbuf.  EMUIR holds a load with
+   post-increment and a move to EMUDAT, or the other way around, and runs
+   on every entry into Run-Test/Idle, so each access is one deferred scan
+   of EMUDAT.  All of them go out in one flush.  Returns how many accesses
+   EMUDOF or EMUDIF show as done in time.  */
+
+static int
+bfin_mem_batch (urj_chain_t *chain, int n, uint32_t addr, uint8_t *rbuf,
+                const uint8_t *wbuf, int cnt, int size)
+{
+    urj_part_t *part = chain->parts->parts[n];
+    int wait = BFIN_PART_WAIT_CLOCKS (part);
+    urj_tap_register_t *r;
+    uint32_t insn1, insn2, v;
+    int i, j, done = cnt;
+
+    if (wbuf)
+    {
+        insn1 = gen_move (BFIN_REG_R0, BFIN_REG_EMUDAT);
+        insn2 = size == 4 ? gen_store32pi (BFIN_REG_P0, BFIN_REG_R0)
+            : gen_store8pi (BFIN_REG_P0, BFIN_REG_R0);
+    }
+    else
+    {
+        insn1 = size == 4 ? gen_load32pi (BFIN_REG_R0, BFIN_REG_P0)
+            : gen_load8zpi (BFIN_REG_R0, BFIN_REG_P0);
+        insn2 = gen_move (BFIN_REG_EMUDAT, BFIN_REG_R0);
+    }
+
+    part_register_set (chain, n, BFIN_REG_P0, addr);
+
+    part_scan_select (chain, n, DBGCTL_SCAN);
+    part_dbgctl_bit_set_emuirlpsz_2 (chain, n);
+    urj_tap_chain_shift_data_registers_mode (chain, 0, 1, URJ_CHAIN_EXITMODE_UPDATE);
+    part_emuir_set_2 (chain, n, insn1, insn2, URJ_CHAIN_EXITMODE_UPDATE);
+
+    part_scan_select (chain, n, EMUDAT_SCAN);
+    r = part->active_instruction->data_register->in;
+    /* Reads leave EMUDIF alone.  */
+    bfin_register_set_value (r, 0);
+
+    for (i = 0; i < cnt; i++)
+    {
+        if (wbuf)
+        {
+            for (v = 0, j = 0; j < size; j++)
+                v |= (uint32_t) wbuf[i * size + j] << (8 * j);
+            emudat_init_value (r, v);
+            part_emudat_defer_get (chain, n, URJ_CHAIN_EXITMODE_UPDATE);
+            urj_tap_chain_defer_clock (chain, 0, 0, 1 + wait);
+        }
+        else
+        {
+            urj_tap_chain_defer_clock (chain, 0, 0, 1 + wait);
+            part_emudat_defer_get (chain, n, URJ_CHAIN_EXITMODE_UPDATE);
+        }
+    }
+
+    for (i = 0; i < cnt; i++)
+    {
+        v = part_emudat_get_done (chain, n, URJ_CHAIN_EXITMODE_UPDATE);
+        if (i >= done)
+            continue;
+
+        r = part->active_instruction->data_register->out;
+        if (wbuf)
+        {
+            /* The core had not read the word before, so this one
+               replaced it.  */
+            if (i > 0 && emudat_dif (r))
+                done = i - 1;
+        }
+        else if (!emudat_dof (r))
+            done = i;
+        else
+            for (j = 0; j < size; j++)
+                rbuf[i * size + j] = (v >> (8 * j)) & 0xff;
+    }
+
+    bfin_mem_settle (chain, n);
+    if (wbuf && done == cnt && part_dbgstat_is_emudif (chain, n))
+        done = cnt - 1;
+
+    part_scan_select (chain, n, DBGCTL_SCAN);
+    part_dbgctl_bit_clear_emuirlpsz_2 (chain, n);
+    urj_tap_chain_shift_data_registers_mode (chain, 0, 1, URJ_CHAIN_EXITMODE_UPDATE);
+
+    return done;
+}
+
+/* Read or write len bytes of memory at addr in batches, bytes up to the
+   first word boundary and after the last one.  When the core was too slow
+   for the probe, the wait clocks double and the batch goes on from the
+   first access that was late.  */
+
+static int
+bfin_mem_transfer (urj_chain_t *chain, int n, uint32_t addr, uint8_t *rbuf,
+                   const uint8_t *wbuf, uint32_t len)
+{
+    urj_part_t *part = chain->parts->parts[n];
+    uint32_t p0, r0, cnt;
+    int size, done, ret = URJ_STATUS_OK;
+
+    part_dbgstat_get (chain, n);
+    if (!part_dbgstat_is_emuready (chain, n))
+    {
+        urj_error_set (URJ_ERROR_BFIN, "Run '%s' first",
+                       "bfin emulation enter");
+        return URJ_STATUS_FAIL;
+    }
+
+    if (BFIN_PART_WAIT_CLOCKS (part) < 0)
+        part_wait_clocks_calibrate (chain, n);
+    if (BFIN_PART_WAIT_CLOCKS (part) < 0)
+        BFIN_PART_WAIT_CLOCKS (part) = BFIN_WAIT_CLOCKS_DEFAULT;
+
+    p0 = part_register_get (chain, n, BFIN_REG_P0);
+    r0 = part_register_get (chain, n, BFIN_REG_R0);
+
+    while (len > 0)
+    {
+        if ((addr & 3) || len < 4)
+        {
+            size = 1;
+            cnt = (addr & 3) ? 4 - (addr & 3) : len;
+            if (cnt > len)
+                cnt = len;
+        }
+        else
+        {
+            size = 4;
+            cnt = len / 4;
+        }
+        if (cnt > BFIN_MEM_BATCH)
+            cnt = BFIN_MEM_BATCH;
+
+        done = bfin_mem_batch (chain, n, addr, rbuf, wbuf, cnt, size);
+        if (done < (int) cnt)
+        {
+            if (BFIN_PART_WAIT_CLOCKS (part) >= BFIN_WAIT_CLOCKS_MAX)
+            {
+                urj_error_set (URJ_ERROR_BFIN,
+                               "%s at 0x%08lx does not complete",
+                               wbuf ? "write" : "read",
+                               (long unsigned) (addr + done * size));
+                ret = URJ_STATUS_FAIL;
+                break;
+            }
+            BFIN_PART_WAIT_CLOCKS (part) *= 2;
+            urj_log (URJ_LOG_LEVEL_DETAIL,
+                     _("%s: core too slow, wait_clocks set to %d\n"), "bfin",
+                     BFIN_PART_WAIT_CLOCKS (part));
+        }
+
+        addr += done * size;
+        len -= done * size;
+        if (rbuf)
+            rbuf += done * size;
+        else
+            wbuf += done * size;
+    }
+
+    part_register_set (chain, n, BFIN_REG_P0, p0);
+    part_register_set (chain, n, BFIN_REG_R0, r0);
+
+    return ret;
+}
+
+int
+part_mem_read (urj_chain_t *chain, int n, uint32_t addr, uint8_t *buf,
+               uint32_t len)
+{
+    return bfin_mem_transfer (chain, n, addr, buf, NULL, len);
+}
+
+int
+part_mem_write (urj_chain_t *chain, int n, uint32_t addr, const uint8_t *buf,
+                uint32_t len)
+{
+    return bfin_mem_transfer (chain, n, addr, NULL, buf, len);
+}
+
 struct bfin_part_data bfin_part_data_initializer =
 {
     0, /* bypass */
@@ -1241,65 +2012,24 @@ struct bfin_part_data bfin_part_data_initializer =
 
     -1, /* emupc */
     -1, /* emupc_orig */
+
+    -1, /* wait_clocks */
 };
 
 static void
 bfin_wait_ready (void *data)
 {
     urj_chain_t *chain = (urj_chain_t *) data;
+    urj_part_t *part = chain->parts->parts[chain->main_part];
+    int wait_clocks = BFIN_PART_WAIT_CLOCKS (part);
 
-    /* The following default numbers of wait clock for various cables are
-       tested on a BF537 stamp board, on which U-Boot is running.
-       CCLK is set to 62MHz and SCLK is set to 31MHz, which is the lowest
-       frequency I can set in BF537 stamp Linux kernel.
-
-       The test is done by dumping memory from 0x20000000 to 0x20000010 using
-       GDB and gdbproxy:
-
-       (gdb) dump memory u-boot.bin 0x20000000 0x20000010
-       (gdb) shell hexdump -C u-boot.bin
-
-       With an incorrect number of wait clocks, the first 4 bytes will be
-       duplicated by the second 4 bytes.  */
-
-    if (bfin_wait_clocks == -1)
-    {
-        urj_cable_t *cable = chain->cable;
-        uint32_t frequency = cable->frequency;
-        const char *name = cable->driver->name;
-
-        if (strcmp (name, "gnICE+") == 0)
-        {
-            if (frequency <= 6000000)
-                bfin_wait_clocks = 5;
-            else if (frequency <= 15000000)
-                bfin_wait_clocks = 12;
-            else /* <= 30MHz */
-                bfin_wait_clocks = 21;
-        }
-        else if (strcmp (name, "gnICE") == 0)
-            bfin_wait_clocks = 3;
-        else if (strcmp (name, "ICE-100B") == 0)
-        {
-            if (frequency <= 5000000)
-                bfin_wait_clocks = 5;
-            else if (frequency <= 10000000)
-                bfin_wait_clocks = 11;
-            else if (frequency <= 17000000)
-                bfin_wait_clocks = 19;
-            else /* <= 25MHz */
-                bfin_wait_clocks = 30;
-        }
-
-        if (bfin_wait_clocks == -1)
-        {
-            bfin_wait_clocks = 30;
-            urj_warning (_("%s: untested cable, set wait_clocks to %d\n"),
-                         name, bfin_wait_clocks);
-        }
-    }
+    /* Until part_wait_clocks_calibrate () has run at "bfin emulation
+       enter", wait as long as the slowest cable tested on a BF537 stamp
+       board needed.  */
+    if (wait_clocks < 0)
+        wait_clocks = BFIN_WAIT_CLOCKS_DEFAULT;
 
-    urj_tap_chain_defer_clock (chain, 0, 0, bfin_wait_clocks);
+    urj_tap_chain_defer_clock (chain, 0, 0, wait_clocks);
 }
 
 static void
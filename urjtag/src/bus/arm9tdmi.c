@@ -43,6 +43,10 @@
 typedef struct
 {
     uint32_t chain;           /* Chain number */
+    urj_data_register_t *scann;
+    urj_data_register_t *scan1;
+    urj_data_register_t *scan2;
+    uint32_t data_read;       /* value read ahead by read_start/next */
 } bus_params_t;
 
 #define BP              ((bus_params_t *) bus->params)
@@ -55,12 +59,6 @@ typedef struct
 
 #define ARM_NOP 0xE1A00000
 
-static urj_data_register_t *scann = NULL;
-static urj_data_register_t *scan1 = NULL;
-static urj_data_register_t *scan2 = NULL;
-
-static uint32_t _data_read;
-
 /**
  * bus->driver->(*new_bus)
  *
@@ -123,18 +121,18 @@ arm9tdmi_exec_instruction(urj_bus_t *bus, unsigned int c1_inst, unsigned int c1_
     int i;
 
     for (i = 0; i < 32; i++)
-        scan1->in->data[66-i] = (c1_inst >> i) & 1;
-    scan1->in->data[34] = flags;
-    scan1->in->data[33] = 0;
-    scan1->in->data[32] = 0;
+        BP->scan1->in->data[66-i] = (c1_inst >> i) & 1;
+    BP->scan1->in->data[34] = flags;
+    BP->scan1->in->data[33] = 0;
+    BP->scan1->in->data[32] = 0;
     for (i = 0; i < 32; i++)
-        scan1->in->data[i] = (c1_data >> i) & 1;
+        BP->scan1->in->data[i] = (c1_data >> i) & 1;
 #if (ARM9DEBUG)
-    arm9tdmi_debug_in_reg(scan1);
+    arm9tdmi_debug_in_reg(BP->scan1);
 #endif
     urj_tap_chain_shift_data_registers (bus->chain, 1);
 #if (ARM9DEBUG)
-    arm9tdmi_debug_out_reg(scan1);
+    arm9tdmi_debug_out_reg(BP->scan1);
 #endif
 }
 
@@ -146,8 +144,8 @@ arm9tdmi_select_scanchain(urj_bus_t *bus, unsigned int chain)
     urj_part_set_instruction (bus->part, "SCAN_N");
     urj_tap_chain_shift_instructions (bus->chain);
 
-    for (i = 0; i < scann->in->len; i++)
-        scann->in->data[i] = (chain >> i) & 1;
+    for (i = 0; i < BP->scann->in->len; i++)
+        BP->scann->in->data[i] = (chain >> i) & 1;
     urj_tap_chain_shift_data_registers (bus->chain, 0);
 }
 
@@ -157,14 +155,14 @@ arm9tdmi_ice_read(urj_bus_t *bus, unsigned int reg_addr, unsigned int *reg_val)
     int i;
 
     for (i = 0; i < 32; i++)
-        scan2->in->data[i] = 0;
+        BP->scan2->in->data[i] = 0;
     for (i = 0; i < 5; i++)
-        scan2->in->data[i+32] = (reg_addr >> i) & 1;
-    scan2->in->data[37] = 0;
+        BP->scan2->in->data[i+32] = (reg_addr >> i) & 1;
+    BP->scan2->in->data[37] = 0;
     urj_tap_chain_shift_data_registers (bus->chain, 1);
 
     for (i = 0; i < 32; i++)
-        if (scan2->out->data[i])
+        if (BP->scan2->out->data[i])
             *reg_val |= (1 << i);
 }
 
@@ -174,10 +172,10 @@ arm9tdmi_ice_write(urj_bus_t *bus, unsigned int reg_addr, unsigned int reg_val)
     int i;
 
     for (i = 0; i < 32; i++)
-        scan2->in->data[i] = (reg_val >> i) & 1;
+        BP->scan2->in->data[i] = (reg_val >> i) & 1;
     for (i = 0; i < 5; i++)
-        scan2->in->data[i+32] = (reg_addr >> i) & 1;
-    scan2->in->data[37] = 1;
+        BP->scan2->in->data[i+32] = (reg_addr >> i) & 1;
+    BP->scan2->in->data[37] = 1;
     urj_tap_chain_shift_data_registers (bus->chain, 0);
 }
 
@@ -329,7 +327,7 @@ arm9tdmi_read (urj_bus_t *bus, unsigned int addr, unsigned int sz)
     result = 0;
     for (i = 0; i < 32; i++)
     {
-        if (scan1->out->data[i])
+        if (BP->scan1->out->data[i])
             result |= (1 << i);
     }
     arm9tdmi_exec_instruction(bus, c1_inst, c1_data, DEBUG_SPEED);
@@ -354,26 +352,26 @@ arm9tdmi_bus_init (urj_bus_t *bus)
         return URJ_STATUS_OK;
     }
 
-    if (scann == NULL)
-        scann = urj_part_find_data_register (bus->part, "SCANN");
-    if (scan1 == NULL)
-        scan1 = urj_part_find_data_register (bus->part, "SCAN1");
-    if (scan2 == NULL)
-        scan2 = urj_part_find_data_register (bus->part, "SCAN2");
+    if (BP->scann == NULL)
+        BP->scann = urj_part_find_data_register (bus->part, "SCANN");
+    if (BP->scan1 == NULL)
+        BP->scan1 = urj_part_find_data_register (bus->part, "SCAN1");
+    if (BP->scan2 == NULL)
+        BP->scan2 = urj_part_find_data_register (bus->part, "SCAN2");
 
-    if (!(scann))
+    if (!(BP->scann))
     {
         urj_error_set (URJ_ERROR_NOTFOUND,
                        _("SCANN register"));
         return URJ_STATUS_FAIL;
     }
-    if (!(scan1))
+    if (!(BP->scan1))
     {
         urj_error_set (URJ_ERROR_NOTFOUND,
                        _("SCAN1 register"));
         return URJ_STATUS_FAIL;
     }
-    if (!(scan2))
+    if (!(BP->scan2))
     {
         urj_error_set (URJ_ERROR_NOTFOUND,
                        _("SCAN2 register"));
@@ -416,7 +414,7 @@ arm9tdmi_bus_init (urj_bus_t *bus)
     {
         urj_error_set (URJ_ERROR_TIMEOUT,
                        _("Failed to enter debug mode, ctrl=%s"),
-                       urj_tap_register_get_string (scan2->out));
+                       urj_tap_register_get_string (BP->scan2->out));
         return URJ_STATUS_FAIL;
     }
 
@@ -516,9 +514,9 @@ arm9tdmi_bus_read (urj_bus_t *bus, uint32_t adr)
 static int
 arm9tdmi_bus_read_start (urj_bus_t *bus, uint32_t adr)
 {
-    _data_read = arm9tdmi_read (bus, adr, get_sz (adr));
+    BP->data_read = arm9tdmi_read (bus, adr, get_sz (adr));
     urj_log (URJ_LOG_LEVEL_ALL, "%s:adr=0x%lx, got=0x%lx\n", __func__,
-             (long unsigned) adr, (long unsigned) _data_read);
+             (long unsigned) adr, (long unsigned) BP->data_read);
 
     return URJ_STATUS_OK;
 }
@@ -530,10 +528,10 @@ arm9tdmi_bus_read_start (urj_bus_t *bus, uint32_t adr)
 static uint32_t
 arm9tdmi_bus_read_next (urj_bus_t *bus, uint32_t adr)
 {
-    uint32_t tmp_value = _data_read;
-    _data_read = arm9tdmi_read (bus, adr, get_sz (adr));
+    uint32_t tmp_value = BP->data_read;
+    BP->data_read = arm9tdmi_read (bus, adr, get_sz (adr));
     urj_log (URJ_LOG_LEVEL_ALL, "%s:adr=0x%lx, got=0x%lx\n", __func__,
-             (long unsigned) adr, (long unsigned) _data_read);
+             (long unsigned) adr, (long unsigned) BP->data_read);
     return tmp_value;
 }
 
@@ -544,7 +542,7 @@ arm9tdmi_bus_read_next (urj_bus_t *bus, uint32_t adr)
 static uint32_t
 arm9tdmi_bus_read_end (urj_bus_t *bus)
 {
-    return _data_read;
+    return BP->data_read;
 }
 
 
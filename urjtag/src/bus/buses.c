@@ -31,8 +31,10 @@
 #include <urjtag/chain.h>
 #include <urjtag/part.h>
 #include <urjtag/cmd.h>
+#include <urjtag/trace.h>
 
 #include "buses.h"
+#include "generic_bus.h"
 
 const urj_bus_driver_t * const urj_bus_drivers[] = {
 #define _URJ_BUS(bus) &urj_bus_##bus##_bus,
@@ -40,26 +42,24 @@ const urj_bus_driver_t * const urj_bus_drivers[] = {
     NULL                        /* last must be NULL */
 };
 
-urj_bus_t *urj_bus = NULL;
-urj_buses_t urj_buses = { 0, NULL };
-
 void
-urj_bus_buses_free (void)
+urj_bus_buses_free (urj_chain_t *chain)
 {
     int i;
 
-    for (i = 0; i < urj_buses.len; i++)
-        URJ_BUS_FREE (urj_buses.buses[i]);
+    for (i = 0; i < chain->buses.len; i++)
+        URJ_BUS_FREE (chain->buses.buses[i]);
 
-    free (urj_buses.buses);
-    urj_buses.len = 0;
-    urj_buses.buses = NULL;
-    urj_bus = NULL;
+    free (chain->buses.buses);
+    chain->buses.len = 0;
+    chain->buses.buses = NULL;
+    chain->bus = NULL;
 }
 
 int
 urj_bus_buses_add (urj_bus_t *abus)
 {
+    urj_buses_t *buses;
     urj_bus_t **b;
 
     if (abus == NULL)
@@ -68,18 +68,18 @@ urj_bus_buses_add (urj_bus_t *abus)
         return URJ_STATUS_FAIL;
     }
 
-    b = realloc (urj_buses.buses, (urj_buses.len + 1) * sizeof (urj_bus_t *));
+    buses = &abus->chain->buses;
+    b = realloc (buses->buses, (buses->len + 1) * sizeof (urj_bus_t *));
     if (b == NULL)
     {
         urj_error_set (URJ_ERROR_OUT_OF_MEMORY, _("realloc(%s,%zd) fails"),
-                       "urj_buses.buses",
-                       (urj_buses.len + 1) * sizeof (urj_bus_t *));
+                       "buses->buses", (buses->len + 1) * sizeof (urj_bus_t *));
         return URJ_STATUS_FAIL;
     }
-    urj_buses.buses = b;
-    urj_buses.buses[urj_buses.len++] = abus;
-    if (urj_bus == NULL)
-        urj_bus = abus;
+    buses->buses = b;
+    buses->buses[buses->len++] = abus;
+    if (abus->chain->bus == NULL)
+        abus->chain->bus = abus;
 
     return URJ_STATUS_OK;
 }
@@ -87,55 +87,55 @@ urj_bus_buses_add (urj_bus_t *abus)
 int
 urj_bus_buses_delete (urj_bus_t *abus)
 {
+    urj_buses_t *buses = &abus->chain->buses;
     int i;
     urj_bus_t **b;
 
-    for (i = 0; i < urj_buses.len; i++)
-        if (abus == urj_buses.buses[i])
+    for (i = 0; i < buses->len; i++)
+        if (abus == buses->buses[i])
             break;
-    if (i >= urj_buses.len)
+    if (i >= buses->len)
     {
-        urj_error_set (URJ_ERROR_NOTFOUND, "abus not in global bus list");
+        urj_error_set (URJ_ERROR_NOTFOUND, "abus not in bus list of chain");
         return URJ_STATUS_FAIL;
     }
 
-    while (i + 1 < urj_buses.len)
+    while (i + 1 < buses->len)
     {
-        urj_buses.buses[i] = urj_buses.buses[i + 1];
+        buses->buses[i] = buses->buses[i + 1];
         i++;
     }
-    urj_buses.len--;
-    b = realloc (urj_buses.buses, urj_buses.len * sizeof (urj_bus_t *));
-    if (b == NULL && urj_buses.len > 0)
+    buses->len--;
+    b = realloc (buses->buses, buses->len * sizeof (urj_bus_t *));
+    if (b == NULL && buses->len > 0)
     {
         urj_error_set (URJ_ERROR_OUT_OF_MEMORY, _("realloc(%s,%zd) fails"),
-                       "urj_buses.buses", urj_buses.len * sizeof (urj_bus_t *));
+                       "buses->buses", buses->len * sizeof (urj_bus_t *));
         return URJ_STATUS_FAIL;
     }
-    urj_buses.buses = b;
+    buses->buses = b;
 
-    if (urj_bus == abus)
+    if (abus->chain->bus == abus)
     {
-        if (urj_buses.len > 0)
-            urj_bus = urj_buses.buses[0];
-        // @@@@ RFHH else: urj_bus is a dangling pointer?
+        if (buses->len > 0)
+            abus->chain->bus = buses->buses[0];
         else
-            urj_bus = NULL;
+            abus->chain->bus = NULL;
     }
 
     return URJ_STATUS_OK;
 }
 
 int
-urj_bus_buses_set (int n)
+urj_bus_buses_set (urj_chain_t *chain, int n)
 {
-    if (n >= urj_buses.len)
+    if (n < 0 || n >= chain->buses.len)
     {
         urj_error_set(URJ_ERROR_INVALID, _("invalid bus number"));
         return URJ_STATUS_FAIL;
     }
 
-    urj_bus = urj_buses.buses[n];
+    chain->bus = chain->buses.buses[n];
 
     return URJ_STATUS_OK;
 }
@@ -207,16 +207,163 @@ urj_bus_init_bus (urj_chain_t *chain, const urj_bus_driver_t *bus_driver,
         return NULL;
     }
 
-    for (i = 0; i < urj_buses.len; i++)
-        if (urj_buses.buses[i] == urj_bus)
+    for (i = 0; i < chain->buses.len; i++)
+        if (chain->buses.buses[i] == chain->bus)
             break;
-    if (i != urj_buses.len - 1)
+    if (i != chain->buses.len - 1)
         urj_log (URJ_LOG_LEVEL_NORMAL, _("Initialized bus %d, active bus %d\n"),
-                 urj_buses.len - 1, i);
+                 chain->buses.len - 1, i);
 
     return abus;
 }
 
+int
+urj_bus_trace_read_start (urj_bus_t *bus, uint32_t adr)
+{
+    urj_trace_event (URJ_TRACE_INSTANT, "bus", "read_start",
+                     "\"adr\":%lu", (long unsigned) adr);
+    return bus->driver->read_start (bus, adr);
+}
+
+uint32_t
+urj_bus_trace_read_next (urj_bus_t *bus, uint32_t adr)
+{
+    uint32_t data;
+
+    urj_trace_event (URJ_TRACE_BEGIN, "bus", "read_next",
+                     "\"next\":%lu", (long unsigned) adr);
+    data = bus->driver->read_next (bus, adr);
+    urj_trace_event (URJ_TRACE_END, "bus", "read_next",
+                     "\"data\":%lu", (long unsigned) data);
+    return data;
+}
+
+uint32_t
+urj_bus_trace_read_end (urj_bus_t *bus)
+{
+    uint32_t data;
+
+    urj_trace_event (URJ_TRACE_BEGIN, "bus", "read_end", NULL);
+    data = bus->driver->read_end (bus);
+    urj_trace_event (URJ_TRACE_END, "bus", "read_end",
+                     "\"data\":%lu", (long unsigned) data);
+    return data;
+}
+
+uint32_t
+urj_bus_trace_read (urj_bus_t *bus, uint32_t adr)
+{
+    uint32_t data;
+
+    urj_trace_event (URJ_TRACE_BEGIN, "bus", "read",
+                     "\"adr\":%lu", (long unsigned) adr);
+    data = bus->driver->read (bus, adr);
+    urj_trace_event (URJ_TRACE_END, "bus", "read",
+                     "\"data\":%lu", (long unsigned) data);
+    return data;
+}
+
+int
+urj_bus_trace_write_start (urj_bus_t *bus, uint32_t adr)
+{
+    urj_trace_event (URJ_TRACE_INSTANT, "bus", "write_start",
+                     "\"adr\":%lu", (long unsigned) adr);
+    return bus->driver->write_start (bus, adr);
+}
+
+void
+urj_bus_trace_write (urj_bus_t *bus, uint32_t adr, uint32_t data)
+{
+    urj_trace_event (URJ_TRACE_BEGIN, "bus", "write",
+                     "\"adr\":%lu,\"data\":%lu", (long unsigned) adr,
+                     (long unsigned) data);
+    bus->driver->write (bus, adr, data);
+    urj_trace_event (URJ_TRACE_END, "bus", "write", NULL);
+}
+
+int
+urj_bus_read_repeat (urj_bus_t *bus, uint32_t adr, uint32_t *data, int n)
+{
+    int r = URJ_STATUS_OK;
+    int i;
+
+    if (n <= 0)
+        return URJ_STATUS_OK;
+
+    urj_trace (URJ_TRACE_BEGIN, "bus", "read_repeat",
+               "\"adr\":%lu,\"n\":%d", (long unsigned) adr, n);
+    if (bus->driver->read_repeat != NULL)
+        r = bus->driver->read_repeat (bus, adr, data, n);
+    else
+        for (i = 0; i < n; i++)
+            data[i] = URJ_BUS_READ (bus, adr);
+    urj_trace (URJ_TRACE_END, "bus", "read_repeat", "\"data\":%lu",
+               (long unsigned) (r == URJ_STATUS_OK ? data[n - 1] : 0));
+
+    return r;
+}
+
+int
+urj_bus_read_block (urj_bus_t *bus, uint32_t adr, uint32_t *data, int n)
+{
+    int r;
+
+    if (n <= 0)
+        return URJ_STATUS_OK;
+
+    urj_trace (URJ_TRACE_BEGIN, "bus", "read_block",
+               "\"adr\":%lu,\"n\":%d", (long unsigned) adr, n);
+    if (bus->driver->read_block != NULL)
+        r = bus->driver->read_block (bus, adr, data, n);
+    else
+        r = urj_bus_generic_read_block (bus, adr, data, n);
+    urj_trace (URJ_TRACE_END, "bus", "read_block", "\"status\":%d", r);
+
+    return r;
+}
+
+int
+urj_bus_write_block (urj_bus_t *bus, uint32_t adr, const uint32_t *data,
+                     int n)
+{
+    int r;
+
+    if (n <= 0)
+        return URJ_STATUS_OK;
+
+    urj_trace (URJ_TRACE_BEGIN, "bus", "write_block",
+               "\"adr\":%lu,\"n\":%d", (long unsigned) adr, n);
+    if (bus->driver->write_block != NULL)
+        r = bus->driver->write_block (bus, adr, data, n);
+    else
+        r = urj_bus_generic_write_block (bus, adr, data, n);
+    urj_trace (URJ_TRACE_END, "bus", "write_block", "\"status\":%d", r);
+
+    return r;
+}
+
+int
+urj_bus_transfer (urj_bus_t *bus, const uint8_t *out, int out_len,
+                  uint8_t *in, int in_len)
+{
+    int r;
+
+    if (bus->driver->transfer == NULL)
+    {
+        urj_error_set (URJ_ERROR_UNSUPPORTED,
+                       _("bus driver '%s' has no serial transfers"),
+                       bus->driver->name);
+        return URJ_STATUS_FAIL;
+    }
+
+    urj_trace (URJ_TRACE_BEGIN, "bus", "transfer",
+               "\"out\":%d,\"in\":%d", out_len, in_len);
+    r = bus->driver->transfer (bus, out, out_len, in, in_len);
+    urj_trace (URJ_TRACE_END, "bus", "transfer", "\"status\":%d", r);
+
+    return r;
+}
+
 static const urj_param_descr_t bus_param[] =
 {
     { URJ_BUS_PARAM_KEY_MUX,        URJ_PARAM_TYPE_BOOL,    "MUX", },
@@ -247,6 +394,9 @@ static const urj_param_descr_t bus_param[] =
     { URJ_BUS_PARAM_KEY_DBGaDDR,    URJ_PARAM_TYPE_BOOL,    "DBGaDDR", },
     { URJ_BUS_PARAM_KEY_DBGdATA,    URJ_PARAM_TYPE_BOOL,    "DBGdATA", },
     { URJ_BUS_PARAM_KEY_HWAIT,      URJ_PARAM_TYPE_STRING,  "HWAIT", },
+    { URJ_BUS_PARAM_KEY_SCK,        URJ_PARAM_TYPE_STRING,  "SCK", },
+    { URJ_BUS_PARAM_KEY_MOSI,       URJ_PARAM_TYPE_STRING,  "MOSI", },
+    { URJ_BUS_PARAM_KEY_MISO,       URJ_PARAM_TYPE_STRING,  "MISO", },
 };
 
 const urj_param_list_t urj_bus_param_list =
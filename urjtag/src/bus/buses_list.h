@@ -83,6 +83,9 @@ _URJ_BUS(ixp465)
 #ifdef ENABLE_BUS_JOPCYC
 _URJ_BUS(jopcyc)
 #endif
+#ifdef ENABLE_BUS_JTAGSPI
+_URJ_BUS(jtagspi)
+#endif
 #ifdef ENABLE_BUS_LH7A400
 _URJ_BUS(lh7a400)
 #endif
@@ -137,6 +140,9 @@ _URJ_BUS(sharc_21369_ezkit)
 #ifdef ENABLE_BUS_SLSUP3
 _URJ_BUS(slsup3)
 #endif
+#ifdef ENABLE_BUS_SPI
+_URJ_BUS(spi)
+#endif
 #ifdef ENABLE_BUS_TX4925
 _URJ_BUS(tx4925)
 #endif
@@ -23,6 +23,12 @@
  * [1] MIPS Licensees, "MIPS EJTAG Debug Solution", 980818 Rev. 2.0.0
  * [2] MIPS Technologies, Inc. "EJTAG Specification", 2001-02-15, Rev. 2.60
  *
+ * Block transfers keep the processor in a copy loop in dmseg: the
+ * instruction fetches are answered through EJTAG_ALL without looking at
+ * them first, and the words of the loads from and stores to the fastdata
+ * area go through EJTAG_FASTDATA. A whole block is one queue of deferred
+ * scans, the captured PrAcc, address and SPrAcc bits are checked at the
+ * end.
  */
 
 #include <sysdep.h>
@@ -42,10 +48,32 @@
 #include "buses.h"
 #include "generic_bus.h"
 
+/* words per FASTDATA stream, and the longest stream in instructions */
+#define EJTAG_FD_WORDS  256
+#define EJTAG_FD_CODE   (3 * EJTAG_FD_WORDS + 16)
+
+/* what an instruction of a FASTDATA stream does in the fastdata area */
+#define EJTAG_FD_NONE   0
+#define EJTAG_FD_LOAD   1       /* lw $2,0($4): a word from the probe */
+#define EJTAG_FD_STORE  2       /* sw $2,0($4): a word to the probe */
+
+/* the largest lag between a fetch and its data access we can stream */
+#define EJTAG_FD_MAXLAG 3
+
 typedef struct
 {
     uint32_t impcode;           /* EJTAG Implementation Register */
     uint16_t adr_hi;            /* cached high bits of $3 */
+    int fastdata;               /* block transfers through FASTDATA */
+    int fastdata_probed;        /* the FASTDATA self-test has run */
+    /* instruction fetches between a load or store to the fastdata area
+       and its data access, by EJTAG_FD_LOAD/EJTAG_FD_STORE */
+    int lag[3];
+    /* the FASTDATA stream being built */
+    int len;
+    uint32_t code[EJTAG_FD_CODE];
+    uint32_t data[EJTAG_FD_CODE];       /* the words of the loads */
+    uint8_t kind[EJTAG_FD_CODE];
 } bus_params_t;
 
 #define BP              ((bus_params_t *) bus->params)
@@ -150,9 +178,17 @@ reg_value (urj_tap_register_t *reg)
     return retval;
 }
 
+/*
+ * Serve the processor accesses for @code until it fetches 0xff200200
+ * again. If @trace is not NULL, the address of each access, ORed with 1 for
+ * writes, goes to it; *@ntrace is its size on entry and the number of
+ * accesses on return.
+ */
 static uint32_t
-ejtag_run_pracc (urj_bus_t *bus, const uint32_t *code, unsigned int len)
+ejtag_run_pracc_trace (urj_bus_t *bus, const uint32_t *code,
+                       unsigned int len, uint32_t *trace, int *ntrace)
 {
+    int trace_size = trace != NULL ? *ntrace : 0;
     urj_data_register_t *ejaddr, *ejdata, *ejctrl;
     int i, pass;
     uint32_t addr, data, retval;
@@ -172,6 +208,8 @@ ejtag_run_pracc (urj_bus_t *bus, const uint32_t *code, unsigned int len)
 
     pass = 0;
     retval = 0;
+    if (trace != NULL)
+        *ntrace = 0;
 
     for (;;)
     {
@@ -209,6 +247,8 @@ ejtag_run_pracc (urj_bus_t *bus, const uint32_t *code, unsigned int len)
                            (long unsigned) addr);
             addr &= ~3;
         }
+        if (trace != NULL && *ntrace < trace_size)
+            trace[(*ntrace)++] = addr | ejctrl->out->data[PRnW];
 
         urj_part_set_instruction (bus->part, "EJTAG_DATA");
         urj_tap_chain_shift_instructions (bus->chain);
@@ -264,6 +304,260 @@ ejtag_run_pracc (urj_bus_t *bus, const uint32_t *code, unsigned int len)
     return retval;
 }
 
+static uint32_t
+ejtag_run_pracc (urj_bus_t *bus, const uint32_t *code, unsigned int len)
+{
+    return ejtag_run_pracc_trace (bus, code, len, NULL, NULL);
+}
+
+static void
+ejtag_fd_emit (urj_bus_t *bus, uint32_t insn, int kind, uint32_t data)
+{
+    BP->code[BP->len] = insn;
+    BP->kind[BP->len] = kind;
+    BP->data[BP->len] = data;
+    BP->len++;
+}
+
+/* Point $3 at the 64 KB around @adr, return the offset of @adr from it */
+static uint16_t
+ejtag_fd_adr (urj_bus_t *bus, uint32_t adr)
+{
+    uint16_t adr_hi, adr_lo;
+
+    /* 16-bit signed offset, phys -> kseg1 */
+    adr_lo = adr & 0xffff;
+    adr_hi = ((adr >> 16) & 0x1fff) + (adr_lo >> 15) + 0xa000;
+
+    if (BP->adr_hi != adr_hi)
+    {
+        BP->adr_hi = adr_hi;
+        ejtag_fd_emit (bus, 0x3c030000 | adr_hi,        // lui $3,adr_hi
+                       EJTAG_FD_NONE, 0);
+    }
+    return adr_lo;
+}
+
+static void
+ejtag_fd_put (urj_tap_register_t *reg, int pos, uint32_t v)
+{
+    int i;
+
+    for (i = 0; i < 32; i++)
+        reg->data[pos + i] = (v >> i) & 1;
+}
+
+static uint32_t
+ejtag_fd_get (urj_tap_register_t *reg, int pos)
+{
+    uint32_t v = 0;
+    int i;
+
+    for (i = 0; i < 32; i++)
+        if (reg->data[pos + i])
+            v |= UINT32_C (1) << i;
+    return v;
+}
+
+/*
+ * Run the stream in BP->code, followed by jr $31, and empty it. The stored
+ * words go to @result.
+ */
+static int
+ejtag_fd_run (urj_bus_t *bus, uint32_t *result)
+{
+    urj_data_register_t *ejctrl, *ejall, *ejfast;
+    /* the accesses in the order the processor makes them: the fetch of
+       instruction j is j << 1, its data access (j << 1) | 1 */
+    int order[2 * EJTAG_FD_CODE];
+    int n = 0, last = 0, fast = -1, r = URJ_STATUS_OK;
+    int i, j, k;
+    uint32_t ctrl, addr;
+
+    ejctrl = urj_part_find_data_register (bus->part, "EJCONTROL");
+    ejall = urj_part_find_data_register (bus->part, "EJALL");
+    ejfast = urj_part_find_data_register (bus->part, "EJFASTDATA");
+    if (!(ejctrl && ejall && ejfast))
+    {
+        BP->len = 0;
+        urj_error_set (URJ_ERROR_NOTFOUND,
+                       _("EJCONTROL, EJALL or EJFASTDATA register not found"));
+        return URJ_STATUS_FAIL;
+    }
+
+    /* the delay slot of jr $31 is the last fetch of the stream, all data
+       accesses have to come before the processor returns */
+    for (j = 0; j < BP->len; j++)
+        if (BP->kind[j] != EJTAG_FD_NONE && j + BP->lag[BP->kind[j]] > last)
+            last = j + BP->lag[BP->kind[j]];
+    while (BP->len + 1 < last)
+        ejtag_fd_emit (bus, 0x00000000, EJTAG_FD_NONE, 0);     // nop
+    ejtag_fd_emit (bus, 0x03e00008, EJTAG_FD_NONE, 0); // jr $31
+    ejtag_fd_emit (bus, 0x00000000, EJTAG_FD_NONE, 0); // nop
+
+    for (k = 0; k < BP->len; k++)
+    {
+        order[n++] = k << 1;
+        for (j = k < EJTAG_FD_MAXLAG ? 0 : k - EJTAG_FD_MAXLAG; j <= k; j++)
+            if (BP->kind[j] != EJTAG_FD_NONE && j + BP->lag[BP->kind[j]] == k)
+                order[n++] = (j << 1) | 1;
+    }
+
+    for (i = 0; i < n; i++)
+    {
+        j = order[i] >> 1;
+        if (fast != (order[i] & 1))
+        {
+            fast = order[i] & 1;
+            urj_part_set_instruction (bus->part, fast ? "EJTAG_FASTDATA"
+                                                      : "EJTAG_ALL");
+            urj_tap_chain_defer_shift_instructions (bus->chain);
+        }
+        if (fast)
+        {
+            /* SPrAcc = 0 completes the access */
+            urj_tap_register_fill (ejfast->in, 0);
+            if (BP->kind[j] == EJTAG_FD_LOAD)
+                ejtag_fd_put (ejfast->in, 1, BP->data[j]);
+        }
+        else
+        {
+            urj_tap_register_fill (ejall->in, 0);
+            for (k = 0; k < 32; k++)
+                ejall->in->data[k] = ejctrl->in->data[k];
+            ejall->in->data[PrAcc] = 0;
+            ejtag_fd_put (ejall->in, 32, BP->code[j]);
+        }
+        if (urj_tap_chain_defer_shift_data_registers (bus->chain, 1, 1,
+                                                      URJ_CHAIN_EXITMODE_IDLE)
+            != URJ_STATUS_OK)
+        {
+            n = i;
+            r = URJ_STATUS_FAIL;
+            break;
+        }
+    }
+
+    fast = -1;
+    for (i = 0; i < n; i++)
+    {
+        j = order[i] >> 1;
+        if (fast != (order[i] & 1))
+        {
+            fast = order[i] & 1;
+            urj_part_set_instruction (bus->part, fast ? "EJTAG_FASTDATA"
+                                                      : "EJTAG_ALL");
+        }
+        urj_tap_chain_shift_data_registers_output (bus->chain,
+                                                   URJ_CHAIN_EXITMODE_IDLE);
+        if (r != URJ_STATUS_OK)
+            continue;
+
+        if (fast)
+        {
+            if (!ejfast->out->data[0])
+            {
+                urj_error_set (URJ_ERROR_BUS,
+                               _("FASTDATA: no access for instruction %d"),
+                               j);
+                r = URJ_STATUS_FAIL;
+            }
+            else if (BP->kind[j] == EJTAG_FD_STORE)
+                *result++ = ejtag_fd_get (ejfast->out, 1);
+            continue;
+        }
+
+        ctrl = ejtag_fd_get (ejall->out, 0);
+        addr = ejtag_fd_get (ejall->out, 64);
+        if ((ctrl & (UINT32_C (1) << Rocc))
+            || !(ctrl & (UINT32_C (1) << PrAcc))
+            || (ctrl & (UINT32_C (1) << PRnW))
+            || addr != UINT32_C (0xff200200) + (j << 2))
+        {
+            urj_error_set (URJ_ERROR_BUS,
+                           _("FASTDATA: fetch %d out of step, ctrl=0x%08lx addr=0x%08lx"),
+                           j, (long unsigned) ctrl, (long unsigned) addr);
+            r = URJ_STATUS_FAIL;
+        }
+    }
+
+    BP->len = 0;
+    if (r != URJ_STATUS_OK)
+        bus->initialized = 0;
+    return r;
+}
+
+/*
+ * The number of fetches after @insn until it accesses the fastdata area
+ * with @access (the address, ORed with 1 for a write); -1 if it is too
+ * far behind.
+ */
+static int
+ejtag_fd_lag (urj_bus_t *bus, uint32_t insn, uint32_t access)
+{
+    uint32_t code[6] = {
+        insn,
+        0x00000000,             // nop
+        0x00000000,             // nop
+        0x00000000,             // nop
+        0x03e00008,             // jr $31
+        0x00000000              // nop
+    };
+    uint32_t trace[16];
+    int n = 16, i;
+
+    ejtag_run_pracc_trace (bus, code, 6, trace, &n);
+    for (i = 1; i < n; i++)
+        if (trace[i] == access)
+            return i - 1 <= EJTAG_FD_MAXLAG ? i - 1 : -1;
+    return -1;
+}
+
+/* Whether the part has the FASTDATA and ALL registers */
+static int
+ejtag_fd_available (urj_bus_t *bus)
+{
+    return urj_part_find_data_register (bus->part, "EJALL") != NULL
+        && urj_part_find_data_register (bus->part, "EJFASTDATA") != NULL
+        && urj_part_find_instruction (bus->part, "EJTAG_ALL") != NULL
+        && urj_part_find_instruction (bus->part, "EJTAG_FASTDATA") != NULL;
+}
+
+/* Measure the lags and run a short stream to see that FASTDATA works */
+static int
+ejtag_fd_probe (urj_bus_t *bus)
+{
+    uint32_t result[2];
+
+    BP->lag[EJTAG_FD_LOAD] = ejtag_fd_lag (bus, 0x8c820000,     // lw $2,0($4)
+                                           UINT32_C (0xff200000));
+    BP->lag[EJTAG_FD_STORE] = ejtag_fd_lag (bus, 0xac820000,    // sw $2,0($4)
+                                            UINT32_C (0xff200001));
+    if (BP->lag[EJTAG_FD_LOAD] < 0 || BP->lag[EJTAG_FD_STORE] < 0)
+    {
+        urj_error_set (URJ_ERROR_BUS, _("no fastdata access within %d fetches"),
+                       EJTAG_FD_MAXLAG);
+        return URJ_STATUS_FAIL;
+    }
+
+    ejtag_fd_emit (bus, 0x3c025a5a, EJTAG_FD_NONE, 0);  // lui $2,0x5a5a
+    ejtag_fd_emit (bus, 0x3442c3c3, EJTAG_FD_NONE, 0);  // ori $2,$2,0xc3c3
+    ejtag_fd_emit (bus, 0xac820000, EJTAG_FD_STORE, 0); // sw $2,0($4)
+    ejtag_fd_emit (bus, 0x8c820000, EJTAG_FD_LOAD,      // lw $2,0($4)
+                   UINT32_C (0x3c3ca5a5));
+    ejtag_fd_emit (bus, 0xac820000, EJTAG_FD_STORE, 0); // sw $2,0($4)
+    if (ejtag_fd_run (bus, result) != URJ_STATUS_OK)
+        return URJ_STATUS_FAIL;
+    if (result[0] != UINT32_C (0x5a5ac3c3) || result[1] != UINT32_C (0x3c3ca5a5))
+    {
+        urj_error_set (URJ_ERROR_BUS,
+                       _("FASTDATA self-test read 0x%08lx 0x%08lx"),
+                       (long unsigned) result[0], (long unsigned) result[1]);
+        return URJ_STATUS_FAIL;
+    }
+    return URJ_STATUS_OK;
+}
+
 static int
 ejtag_bus_init (urj_bus_t *bus)
 {
@@ -568,6 +862,24 @@ ejtag_bus_init (urj_bus_t *bus)
     ejtag_run_pracc (bus, code, 4);
     BP->adr_hi = 0;
     bus->initialized = 1;
+
+    if (!BP->fastdata_probed && ejtag_fd_available (bus))
+    {
+        BP->fastdata_probed = 1;
+        if (ejtag_fd_probe (bus) != URJ_STATUS_OK)
+        {
+            /* the processor may be anywhere now, start over */
+            urj_warning (_("%s, using PrAcc for every word\n"),
+                         urj_error_describe ());
+            urj_error_reset ();
+            return ejtag_bus_init (bus);
+        }
+        BP->fastdata = 1;
+        urj_log (URJ_LOG_LEVEL_NORMAL,
+                 "FASTDATA block transfers (load lag %d, store lag %d)\n",
+                 BP->lag[EJTAG_FD_LOAD], BP->lag[EJTAG_FD_STORE]);
+    }
+
     return URJ_STATUS_OK;
 }
 
@@ -759,6 +1071,110 @@ ejtag_bus_write (urj_bus_t *bus, uint32_t adr, uint32_t data)
              (long unsigned) adr, (long unsigned) data);
 }
 
+/**
+ * bus->driver->(*read_block)
+ *
+ */
+static int
+ejtag_bus_read_block (urj_bus_t *bus, uint32_t adr, uint32_t *data, int n)
+{
+    urj_bus_area_t area;
+    uint32_t step;
+    uint16_t adr_lo;
+    int i, m;
+
+    ejtag_bus_area (bus, adr, &area);
+    if (!BP->fastdata || area.width == 0)
+        return urj_bus_generic_read_block (bus, adr, data, n);
+    step = area.width / 8;
+
+    for (; n > 0; n -= m, data += m, adr += m * step)
+    {
+        m = n < EJTAG_FD_WORDS ? n : EJTAG_FD_WORDS;
+        for (i = 0; i < m; i++)
+        {
+            adr_lo = ejtag_fd_adr (bus, adr + i * step);
+            switch (adr >> 29)
+            {
+            case 0:
+                ejtag_fd_emit (bus, 0x90620000 | adr_lo,        // lbu $2,adr_lo($3)
+                               EJTAG_FD_NONE, 0);
+                break;
+            case 1:
+                ejtag_fd_emit (bus, 0x94620000 | (adr_lo & ~1), // lhu $2,adr_lo($3)
+                               EJTAG_FD_NONE, 0);
+                break;
+            default:
+                ejtag_fd_emit (bus, 0x8c620000 | (adr_lo & ~3), // lw $2,adr_lo($3)
+                               EJTAG_FD_NONE, 0);
+                break;
+            }
+            ejtag_fd_emit (bus, 0xac820000, EJTAG_FD_STORE, 0); // sw $2,0($4)
+        }
+
+        urj_log (URJ_LOG_LEVEL_COMM,
+                 "FASTDATA read: adr=0x%08lx words=%d\n",
+                 (long unsigned) adr, m);
+        if (ejtag_fd_run (bus, data) != URJ_STATUS_OK)
+            return URJ_STATUS_FAIL;
+    }
+
+    return URJ_STATUS_OK;
+}
+
+/**
+ * bus->driver->(*write_block)
+ *
+ */
+static int
+ejtag_bus_write_block (urj_bus_t *bus, uint32_t adr, const uint32_t *data,
+                       int n)
+{
+    urj_bus_area_t area;
+    uint32_t step, unused;
+    uint16_t adr_lo;
+    int i, m;
+
+    ejtag_bus_area (bus, adr, &area);
+    if (!BP->fastdata || area.width == 0)
+        return urj_bus_generic_write_block (bus, adr, data, n);
+    step = area.width / 8;
+
+    for (; n > 0; n -= m, data += m, adr += m * step)
+    {
+        m = n < EJTAG_FD_WORDS ? n : EJTAG_FD_WORDS;
+        for (i = 0; i < m; i++)
+        {
+            adr_lo = ejtag_fd_adr (bus, adr + i * step);
+            ejtag_fd_emit (bus, 0x8c820000, EJTAG_FD_LOAD,      // lw $2,0($4)
+                           data[i]);
+            switch (adr >> 29)
+            {
+            case 0:
+                ejtag_fd_emit (bus, 0xa0620000 | adr_lo,        // sb $2,adr_lo($3)
+                               EJTAG_FD_NONE, 0);
+                break;
+            case 1:
+                ejtag_fd_emit (bus, 0xa4620000 | (adr_lo & ~1), // sh $2,adr_lo($3)
+                               EJTAG_FD_NONE, 0);
+                break;
+            default:
+                ejtag_fd_emit (bus, 0xac620000 | (adr_lo & ~3), // sw $2,adr_lo($3)
+                               EJTAG_FD_NONE, 0);
+                break;
+            }
+        }
+
+        urj_log (URJ_LOG_LEVEL_COMM,
+                 "FASTDATA write: adr=0x%08lx words=%d\n",
+                 (long unsigned) adr, m);
+        if (ejtag_fd_run (bus, &unused) != URJ_STATUS_OK)
+            return URJ_STATUS_FAIL;
+    }
+
+    return URJ_STATUS_OK;
+}
+
 const urj_bus_driver_t urj_bus_ejtag_bus = {
     "ejtag",
     N_("EJTAG compatible bus driver via PrAcc"),
@@ -777,4 +1193,8 @@ const urj_bus_driver_t urj_bus_ejtag_bus = {
     urj_bus_generic_no_enable,
     urj_bus_generic_no_disable,
     URJ_BUS_TYPE_PARALLEL,
+    NULL,
+    NULL,
+    ejtag_bus_read_block,
+    ejtag_bus_write_block,
 };
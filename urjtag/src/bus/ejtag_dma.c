@@ -51,6 +51,14 @@
 typedef struct
 {
     uint32_t impcode;           /* EJTAG Implementation Register */
+    urj_data_register_t *ejctrl;
+    urj_data_register_t *ejaddr;
+    urj_data_register_t *ejdata;
+    uint32_t data_read;         /* value read ahead by read_start/next */
+    int wait;                   /* TCKs between a DMA start and its check */
+    int calibrated;             /* a DMA completed within the wait */
+    int scan_reg;               /* the register selected in the scan queue */
+    int derr;                   /* a DMA of the last transfer failed */
 } bus_params_t;
 
 #define BP              ((bus_params_t *) bus->params)
@@ -81,6 +89,10 @@ typedef struct
 #define DMA_WORD         8
 #define DMA_BYTE         0
 
+/* DMA transfers per batch of scans, and the longest wait for one */
+#define EJTAG_DMA_BATCH         256
+#define EJTAG_DMA_MAXWAIT       4096
+
 /**
  * bus->driver->(*new_bus)
  *
@@ -114,6 +126,21 @@ ejtag_dma_bus_printinfo (urj_log_level_t ll, urj_bus_t *bus)
              i);
 }
 
+/**
+ * helper function
+ *
+ */
+static void
+ejtag_dma_find_registers (urj_bus_t *bus)
+{
+    if (BP->ejctrl == NULL)
+        BP->ejctrl = urj_part_find_data_register (bus->part, "EJCONTROL");
+    if (BP->ejaddr == NULL)
+        BP->ejaddr = urj_part_find_data_register (bus->part, "EJADDRESS");
+    if (BP->ejdata == NULL)
+        BP->ejdata = urj_part_find_data_register (bus->part, "EJDATA");
+}
+
 /**
  * helper function
  *
@@ -150,28 +177,73 @@ siz_ (int sz)
     return 'E';
 }
 
+/* the registers of a DMA transfer, in the order of ejtag_dma_instructions */
+#define EJ_ADDRESS      0
+#define EJ_DATA         1
+#define EJ_CONTROL      2
+
+static const char *const ejtag_dma_instructions[] = {
+    "EJTAG_ADDRESS",
+    "EJTAG_DATA",
+    "EJTAG_CONTROL"
+};
+
+static urj_data_register_t *
+ejtag_dma_register (urj_bus_t *bus, int reg)
+{
+    switch (reg)
+    {
+    case EJ_ADDRESS:
+        return BP->ejaddr;
+    case EJ_DATA:
+        return BP->ejdata;
+    default:
+        return BP->ejctrl;
+    }
+}
+
 /**
- * low-level dma write
+ * helper function: queue a scan of @reg with @value, with its output if
+ * @capture
  *
  */
 static void
-ejtag_dma_write (urj_bus_t *bus, unsigned int addr, unsigned int data, int sz)
+ejtag_dma_defer (urj_bus_t *bus, int reg, uint32_t value, int capture)
 {
-    static urj_data_register_t *ejctrl = NULL;
-    static urj_data_register_t *ejaddr = NULL;
-    static urj_data_register_t *ejdata = NULL;
-    int i = 0;
-    int timeout = 5;
-
-    if (ejctrl == NULL)
-        ejctrl = urj_part_find_data_register (bus->part, "EJCONTROL");
-    if (ejaddr == NULL)
-        ejaddr = urj_part_find_data_register (bus->part, "EJADDRESS");
-    if (ejdata == NULL)
-        ejdata = urj_part_find_data_register (bus->part, "EJDATA");
+    urj_data_register_t *dr = ejtag_dma_register (bus, reg);
+    int i;
 
+    if (BP->scan_reg != reg)
+    {
+        urj_part_set_instruction (bus->part, ejtag_dma_instructions[reg]);
+        urj_tap_chain_defer_shift_instructions (bus->chain);
+        BP->scan_reg = reg;
+    }
+    for (i = 0; i < 32; i++)
+        dr->in->data[i] = (value >> i) & 1;
+    urj_tap_chain_defer_shift_data_registers (bus->chain, capture, 1,
+                                              URJ_CHAIN_EXITMODE_IDLE);
+}
+
+/**
+ * helper function: the output of the next queued scan, which is one of @reg
+ *
+ */
+static uint32_t
+ejtag_dma_collect (urj_bus_t *bus, int reg)
+{
+    urj_part_set_instruction (bus->part, ejtag_dma_instructions[reg]);
+    urj_tap_chain_shift_data_registers_output (bus->chain,
+                                               URJ_CHAIN_EXITMODE_IDLE);
+    return reg_value (ejtag_dma_register (bus, reg)->out);
+}
+
+/* Fill the other bytes with copy of the current */
+static uint32_t
+ejtag_dma_lanes (uint32_t data, int sz)
+{
     switch (sz)
-    {                           /* Fill the other bytes with copy of the current */
+    {
     case DMA_BYTE:
         data &= 0xff;
         data |= (data << 8) | (data << 16) | (data << 24);
@@ -183,184 +255,224 @@ ejtag_dma_write (urj_bus_t *bus, unsigned int addr, unsigned int data, int sz)
     default:
         break;
     }
+    return data;
+}
 
-    urj_part_set_instruction (bus->part, "EJTAG_ADDRESS");
-    urj_tap_chain_shift_instructions (bus->chain);
-    for (i = 0; i < 32; i++)
-        ejaddr->in->data[i] = (addr >> i) & 1;
-    urj_tap_chain_shift_data_registers (bus->chain, 0); /* Push the address to write */
-    urj_log (URJ_LOG_LEVEL_COMM, "Wrote to ejaddr->in      =%s %08lX\n",
-             urj_tap_register_get_string (ejaddr->in),
-             (long unsigned) reg_value (ejaddr->in));
-    urj_part_set_instruction (bus->part, "EJTAG_DATA");
-    urj_tap_chain_shift_instructions (bus->chain);
-    for (i = 0; i < 32; i++)
-        ejdata->in->data[i] = (data >> i) & 1;
-    urj_tap_chain_shift_data_registers (bus->chain, 0); /* Push the data to write */
-    urj_log (URJ_LOG_LEVEL_COMM, "Wrote to edata->in(%c)    =%s %08lX\n",
-             siz_ (sz), urj_tap_register_get_string (ejdata->in),
-             (long unsigned) reg_value (ejdata->in));
-    urj_part_set_instruction (bus->part, "EJTAG_CONTROL");
-    urj_tap_chain_shift_instructions (bus->chain);
-    urj_tap_register_fill (ejctrl->in, 0);
-    ejctrl->in->data[PrAcc] = 1;        // Processor access
-    ejctrl->in->data[ProbEn] = 1;
-    ejctrl->in->data[DmaAcc] = 1;       // DMA operation request */
-    ejctrl->in->data[DstRt] = 1;
+/* The byte or halfword at @addr out of the word read */
+static uint32_t
+ejtag_dma_lane (uint32_t ret, uint32_t addr, int sz)
+{
+    switch (sz)
+    {
+    case DMA_HALFWORD:
+        if (addr & 2)
+            ret = (ret >> 16) & 0xffff;
+        else
+            ret = ret & 0xffff;
+        break;
+    case DMA_BYTE:
+        if ((addr & 3) == 3)
+            ret = (ret >> 24) & 0xff;
+        else if ((addr & 3) == 2)
+            ret = (ret >> 16) & 0xff;
+        else if ((addr & 3) == 1)
+            ret = (ret >> 8) & 0xff;
+        else
+            ret = ret & 0xff;
+        break;
+    case DMA_WORD:
+    default:
+        break;
+    }
+    return ret;
+}
+
+/**
+ * One batch of @n DMA transfers of size @sz at @addr, @addr + @step, ...,
+ * writes of @wdata if it is not NULL, reads into @rdata otherwise. All
+ * scans go into one queue; the DstRt and Derr bits are checked when it is
+ * flushed. Returns the number of transfers that had completed when their
+ * DstRt was checked.
+ */
+static int
+ejtag_dma_batch (urj_bus_t *bus, uint32_t addr, uint32_t step,
+                 uint32_t *rdata, const uint32_t *wdata, int n, int sz)
+{
+    uint32_t start, ctrl, d = 0, a;
+    int write = wdata != NULL;
+    int i, done = n;
+
+    start = (1 << PrAcc) | (1 << ProbEn) | (1 << DmaAcc) | (1 << DstRt);
     if (sz)
-        ejctrl->in->data[sz] = 1;       // Size : can be WORD/HALFWORD or nothing for byte
-    urj_tap_chain_shift_data_registers (bus->chain, 0); /* Do the operation */
-    urj_log (URJ_LOG_LEVEL_ALL, "Wrote to ejctrl->in      =%s %08lX\n",
-             urj_tap_register_get_string (ejctrl->in),
-             (long unsigned) reg_value (ejctrl->in));
+        start |= 1 << sz;       // Size : can be WORD/HALFWORD or nothing for byte
+    if (!write)
+        start |= 1 << DmaRwn;   // This is a read
 
-    do
+    BP->scan_reg = -1;
+    for (i = 0, a = addr; i < n; i++, a += step)
     {
-        urj_part_set_instruction (bus->part, "EJTAG_CONTROL");
-        urj_tap_chain_shift_instructions (bus->chain);
-        urj_tap_register_fill (ejctrl->in, 0);
-        ejctrl->in->data[PrAcc] = 1;
-        ejctrl->in->data[ProbEn] = 1;
-        ejctrl->in->data[DmaAcc] = 1;
-        urj_tap_chain_shift_data_registers (bus->chain, 1);
-        timeout--;
-        if (!timeout)
-            break;
+        ejtag_dma_defer (bus, EJ_ADDRESS, a, 0);
+        if (write)
+            ejtag_dma_defer (bus, EJ_DATA, ejtag_dma_lanes (wdata[i], sz), 0);
+        ejtag_dma_defer (bus, EJ_CONTROL, start, 0);    /* Do the operation */
+        if (BP->wait)
+            urj_tap_chain_defer_clock (bus->chain, 0, 0, BP->wait);
+        /* DstRt tells us whether the processor has completed the op,
+           Derr whether it failed */
+        ejtag_dma_defer (bus, EJ_CONTROL,
+                         (1 << PrAcc) | (1 << ProbEn) | (1 << DmaAcc), 1);
+        if (!write)
+            ejtag_dma_defer (bus, EJ_DATA, 0, 1);
     }
-    while (ejctrl->out->data[DstRt] == 1);      // This flag tell us the processor has completed the op
+    /* Disable DMA, reset state to previous one */
+    ejtag_dma_defer (bus, EJ_CONTROL, (1 << PrAcc) | (1 << ProbEn), 0);
 
-    urj_part_set_instruction (bus->part, "EJTAG_CONTROL");
-    urj_tap_chain_shift_instructions (bus->chain);
-    urj_tap_register_fill (ejctrl->in, 0);
-    ejctrl->in->data[PrAcc] = 1;
-    ejctrl->in->data[ProbEn] = 1;
-    urj_tap_chain_shift_data_registers (bus->chain, 1); // Disable DMA, reset state to previous one.
-    if (ejctrl->out->data[Derr] == 1)
-    {                           // Check for DMA error, i.e. incorrect address
-        urj_error_set (URJ_ERROR_BUS_DMA,
-                       _("dma write (dma transaction failed)"));
+    for (i = 0, a = addr; i < n; i++, a += step)
+    {
+        ctrl = ejtag_dma_collect (bus, EJ_CONTROL);
+        if (!write)
+            d = ejtag_dma_collect (bus, EJ_DATA);
+        if (i >= done)
+            continue;
+
+        urj_log (URJ_LOG_LEVEL_COMM, "dma %s(%c) addr=0x%08lX data=%08lX ctrl=%08lX\n",
+                 write ? "write" : "read", siz_ (sz), (long unsigned) a,
+                 (long unsigned) (write ? wdata[i] : d), (long unsigned) ctrl);
+        if (ctrl & (1 << DstRt))
+        {
+            done = i;
+            continue;
+        }
+        if (ctrl & (1 << Derr))
+        {                       // Check for DMA error, i.e. incorrect address
+            urj_error_set (URJ_ERROR_BUS_DMA,
+                           write ? _("dma write (dma transaction failed)")
+                                 : _("dma read (dma transaction failed)"));
+            BP->derr = 1;
+        }
+        if (!write)
+            rdata[i] = ejtag_dma_lane (d, a, sz);
     }
-    return;
+
+    return done;
 }
 
 /**
- * low level dma read operation
+ * helper function: wait for the DMA that was still busy
  *
  */
-static unsigned int
-ejtag_dma_read (urj_bus_t *bus, unsigned int addr, int sz)
+static void
+ejtag_dma_settle (urj_bus_t *bus)
 {
-    static urj_data_register_t *ejctrl = NULL;
-    static urj_data_register_t *ejaddr = NULL;
-    static urj_data_register_t *ejdata = NULL;
-    int i = 0;
-    int timeout = 5;
-    unsigned int ret;
-
-    if (ejctrl == NULL)
-        ejctrl = urj_part_find_data_register (bus->part, "EJCONTROL");
-    if (ejaddr == NULL)
-        ejaddr = urj_part_find_data_register (bus->part, "EJADDRESS");
-    if (ejdata == NULL)
-        ejdata = urj_part_find_data_register (bus->part, "EJDATA");
-
-    urj_part_set_instruction (bus->part, "EJTAG_ADDRESS");
-    urj_tap_chain_shift_instructions (bus->chain);
-    for (i = 0; i < 32; i++)
-        ejaddr->in->data[i] = (addr >> i) & 1;
-    urj_tap_chain_shift_data_registers (bus->chain, 0); /* Push the address to read */
-    urj_log (URJ_LOG_LEVEL_COMM, "Wrote to ejaddr->in      =%s %08lX\n",
-             urj_tap_register_get_string (ejaddr->in),
-             (long unsigned) reg_value (ejaddr->in));
+    urj_data_register_t *ejctrl = BP->ejctrl;
+    int timeout = 100;
+
     urj_part_set_instruction (bus->part, "EJTAG_CONTROL");
     urj_tap_chain_shift_instructions (bus->chain);
     urj_tap_register_fill (ejctrl->in, 0);
-    ejctrl->in->data[PrAcc] = 1;        // Processor access
+    ejctrl->in->data[PrAcc] = 1;
     ejctrl->in->data[ProbEn] = 1;
-    ejctrl->in->data[DmaAcc] = 1;       // DMA operation request */
-    ejctrl->in->data[DstRt] = 1;
-    if (sz)
-        ejctrl->in->data[sz] = 1;       // Size : can be WORD/HALFWORD or nothing for byte
-    ejctrl->in->data[DmaRwn] = 1;       // This is a read
-    urj_tap_chain_shift_data_registers (bus->chain, 0); /* Do the operation */
-    urj_log (URJ_LOG_LEVEL_ALL, "Wrote to ejctrl->in      =%s %08lX\n",
-             urj_tap_register_get_string (ejctrl->in),
-             (long unsigned) reg_value (ejctrl->in));
-
     do
-    {
-        urj_part_set_instruction (bus->part, "EJTAG_CONTROL");
-        urj_tap_chain_shift_instructions (bus->chain);
-        urj_tap_register_fill (ejctrl->in, 0);
-        ejctrl->in->data[PrAcc] = 1;
-        ejctrl->in->data[ProbEn] = 1;
-        ejctrl->in->data[DmaAcc] = 1;
         urj_tap_chain_shift_data_registers (bus->chain, 1);
+    while (ejctrl->out->data[DstRt] == 1 && --timeout);
+}
 
-        urj_log (URJ_LOG_LEVEL_ALL, "Wrote to ejctrl->in   =%s %08lX\n",
-                 urj_tap_register_get_string (ejctrl->in),
-                 (long unsigned) reg_value (ejctrl->in));
-        urj_log (URJ_LOG_LEVEL_ALL, "Read from ejctrl->out =%s %08lX\n",
-                 urj_tap_register_get_string (ejctrl->out),
-                 (long unsigned) reg_value (ejctrl->out));
-        timeout--;
-        if (!timeout)
-            break;
-    }
-    while (ejctrl->out->data[DstRt] == 1);      // This flag tell us the processor has completed the op
+/**
+ * DMA transfers of @n words of size @sz from @addr on, @step bytes apart,
+ * in batches, like ejtag_dma_batch(). Until one transfer has completed
+ * within the wait, they go one per batch. When a DMA is still busy at its
+ * check, the wait before the checks doubles and the reads from there on
+ * are done again. A late write in a batch fails the transfer: the
+ * address and data of the busy DMA were already replaced by the next ones,
+ * so it is not known which of the writes from there on took place.
+ */
+static int
+ejtag_dma_transfer (urj_bus_t *bus, uint32_t addr, uint32_t step,
+                    uint32_t *rdata, const uint32_t *wdata, int n, int sz)
+{
+    int write = wdata != NULL;
+    int m, done;
 
-    urj_part_set_instruction (bus->part, "EJTAG_DATA");
-    urj_tap_chain_shift_instructions (bus->chain);
-    urj_tap_register_fill (ejdata->in, 0);
-    urj_tap_chain_shift_data_registers (bus->chain, 1);
-    ret = reg_value (ejdata->out);
-    urj_log (URJ_LOG_LEVEL_COMM, "Read from ejdata->out(%c) =%s %08lX\n",
-             siz_ (sz), urj_tap_register_get_string (ejdata->out),
-             (long unsigned) reg_value (ejdata->out));
-    urj_part_set_instruction (bus->part, "EJTAG_CONTROL");
-    urj_tap_chain_shift_instructions (bus->chain);
-    urj_tap_register_fill (ejctrl->in, 0);
-    ejctrl->in->data[PrAcc] = 1;
-    ejctrl->in->data[ProbEn] = 1;
-    urj_tap_chain_shift_data_registers (bus->chain, 1); // Disable DMA, reset state to previous one.
-
-    urj_log (URJ_LOG_LEVEL_ALL, "Wrote to ejctrl->in   =%s %08lX\n",
-             urj_tap_register_get_string (ejctrl->in),
-             (long unsigned) reg_value (ejctrl->in));
-    urj_log (URJ_LOG_LEVEL_ALL, "Read from ejctrl->out =%s %08lX\n",
-             urj_tap_register_get_string (ejctrl->out),
-             (long unsigned) reg_value(ejctrl->out));
-
-    if (ejctrl->out->data[Derr] == 1)
-    {                           // Check for DMA error, i.e. incorrect address
-        urj_error_set (URJ_ERROR_BUS_DMA,
-                       _("dma read (dma transaction failed)"));
+    ejtag_dma_find_registers (bus);
+    if (!(BP->ejctrl && BP->ejaddr && BP->ejdata))
+    {
+        urj_error_set (URJ_ERROR_NOTFOUND,
+                       _("EJADDRESS, EJDATA or EJCONTROL register not found"));
+        return URJ_STATUS_FAIL;
     }
 
-    switch (sz)
+    BP->derr = 0;
+    while (n > 0)
     {
-    case DMA_HALFWORD:
-        if (addr & 2)
-            ret = (ret >> 16) & 0xffff;
+        m = n < EJTAG_DMA_BATCH ? n : EJTAG_DMA_BATCH;
+        if (!BP->calibrated)
+            m = 1;
+        done = ejtag_dma_batch (bus, addr, step, rdata, wdata, m, sz);
+        if (done < m)
+        {
+            if (BP->wait >= EJTAG_DMA_MAXWAIT)
+            {
+                urj_error_set (URJ_ERROR_TIMEOUT,
+                               _("dma %s at 0x%08lx does not complete"),
+                               write ? "write" : "read",
+                               (long unsigned) (addr + done * step));
+                return URJ_STATUS_FAIL;
+            }
+            BP->wait = BP->wait ? 2 * BP->wait : 8;
+            BP->calibrated = 0;
+            urj_log (URJ_LOG_LEVEL_DETAIL,
+                     "DMA still busy, waiting %d clocks from now on\n",
+                     BP->wait);
+            ejtag_dma_settle (bus);
+            if (write && m > 1)
+            {
+                urj_error_set (URJ_ERROR_BUS_DMA,
+                               _("dma write at 0x%08lx was late, %d words "
+                                 "from there on are unknown"),
+                               (long unsigned) (addr + done * step),
+                               m - done);
+                return URJ_STATUS_FAIL;
+            }
+            /* a single write was left alone until it completed */
+            if (write)
+                done++;
+        }
         else
-            ret = ret & 0xffff;
-        break;
-    case DMA_BYTE:
-        if ((addr & 3) == 3)
-            ret = (ret >> 24) & 0xff;
-        else if ((addr & 3) == 2)
-            ret = (ret >> 16) & 0xff;
-        else if ((addr & 3) == 1)
-            ret = (ret >> 8) & 0xff;
+            BP->calibrated = 1;
+        addr += done * step;
+        if (write)
+            wdata += done;
         else
-            ret = ret & 0xff;
-        break;
-    case DMA_WORD:
-    default:
-        break;
+            rdata += done;
+        n -= done;
     }
 
-    return ret;
+    return BP->derr ? URJ_STATUS_FAIL : URJ_STATUS_OK;
+}
+
+/**
+ * low-level dma write
+ *
+ */
+static void
+ejtag_dma_write (urj_bus_t *bus, unsigned int addr, unsigned int data, int sz)
+{
+    uint32_t d = data;
+
+    ejtag_dma_transfer (bus, addr, 0, NULL, &d, 1, sz);
+}
+
+/**
+ * low level dma read operation
+ *
+ */
+static unsigned int
+ejtag_dma_read (urj_bus_t *bus, unsigned int addr, int sz)
+{
+    uint32_t d = 0;
+
+    ejtag_dma_transfer (bus, addr, 0, &d, NULL, 1, sz);
+    return d;
 }
 
 /**
@@ -596,14 +708,9 @@ ejtag_dma_bus_area (urj_bus_t *bus, uint32_t adr, urj_bus_area_t *area)
 static int
 get_sz (uint32_t adr)
 {
-    static urj_bus_area_t area;
-    static int initialized = 0;
+    urj_bus_area_t area;
 
-    if (!initialized)
-    {
-        ejtag_dma_bus_area (NULL, adr, &area);
-        initialized = 1;
-    }
+    ejtag_dma_bus_area (NULL, adr, &area);
     switch (area.width)
     {
     case 32:
@@ -641,7 +748,6 @@ ejtag_dma_bus_read (urj_bus_t *bus, uint32_t adr)
     return data;
 }
 
-static uint32_t _data_read;
 /**
  * bus->driver->(*read_start)
  *
@@ -649,9 +755,9 @@ static uint32_t _data_read;
 static int
 ejtag_dma_bus_read_start (urj_bus_t *bus, uint32_t adr)
 {
-    _data_read = ejtag_dma_read (bus, adr, get_sz (adr));
+    BP->data_read = ejtag_dma_read (bus, adr, get_sz (adr));
     urj_log (URJ_LOG_LEVEL_ALL, "%s:adr=0x%lx, got=0x%lx\n", __func__,
-             (long unsigned) adr, (long unsigned) _data_read);
+             (long unsigned) adr, (long unsigned) BP->data_read);
 
     return URJ_STATUS_OK;
 }
@@ -663,10 +769,10 @@ ejtag_dma_bus_read_start (urj_bus_t *bus, uint32_t adr)
 static uint32_t
 ejtag_dma_bus_read_next (urj_bus_t *bus, uint32_t adr)
 {
-    uint32_t tmp_value = _data_read;
-    _data_read = ejtag_dma_read (bus, adr, get_sz (adr));
+    uint32_t tmp_value = BP->data_read;
+    BP->data_read = ejtag_dma_read (bus, adr, get_sz (adr));
     urj_log (URJ_LOG_LEVEL_ALL, "%s:adr=0x%lx, got=0x%lx\n", __func__,
-             (long unsigned) adr, (long unsigned) _data_read);
+             (long unsigned) adr, (long unsigned) BP->data_read);
     return tmp_value;
 }
 
@@ -677,7 +783,37 @@ ejtag_dma_bus_read_next (urj_bus_t *bus, uint32_t adr)
 static uint32_t
 ejtag_dma_bus_read_end (urj_bus_t *bus)
 {
-    return _data_read;
+    return BP->data_read;
+}
+
+/**
+ * bus->driver->(*read_block)
+ *
+ */
+static int
+ejtag_dma_bus_read_block (urj_bus_t *bus, uint32_t adr, uint32_t *data,
+                          int n)
+{
+    urj_bus_area_t area;
+
+    ejtag_dma_bus_area (bus, adr, &area);
+    return ejtag_dma_transfer (bus, adr, area.width / 8, data, NULL, n,
+                               get_sz (adr));
+}
+
+/**
+ * bus->driver->(*write_block)
+ *
+ */
+static int
+ejtag_dma_bus_write_block (urj_bus_t *bus, uint32_t adr,
+                           const uint32_t *data, int n)
+{
+    urj_bus_area_t area;
+
+    ejtag_dma_bus_area (bus, adr, &area);
+    return ejtag_dma_transfer (bus, adr, area.width / 8, NULL, data, n,
+                               get_sz (adr));
 }
 
 const urj_bus_driver_t urj_bus_ejtag_dma_bus = {
@@ -698,4 +834,8 @@ const urj_bus_driver_t urj_bus_ejtag_dma_bus = {
     urj_bus_generic_no_enable,
     urj_bus_generic_no_disable,
     URJ_BUS_TYPE_PARALLEL,
+    NULL,
+    NULL,
+    ejtag_dma_bus_read_block,
+    ejtag_dma_bus_write_block,
 };
@@ -43,6 +43,11 @@
 #define FJMEM_REG_NAME  "FJMEM_REG"
 #define FJMEM_MAX_REG_LEN 2048
 
+/* words per read burst; a consecutive read starts with FJMEM_BURST_FIRST
+   and doubles the burst length from there */
+#define FJMEM_BURST_MAX   256
+#define FJMEM_BURST_FIRST 4
+
 struct block_param
 {
     struct block_param *next;
@@ -73,11 +78,22 @@ typedef struct
     uint32_t last_addr;
     urj_data_register_t *fjmem_reg;
     block_desc_t block_desc;
+    /* read bursts, if the core supports them */
+    int burst;
+    uint32_t burst_addr;        /* address of burst_buf[0] */
+    int burst_len;              /* valid words in burst_buf */
+    int burst_run;              /* length of the next burst */
+    uint32_t burst_buf[FJMEM_BURST_MAX];
 } bus_params_t;
 
 #define LAST_ADDR  ((bus_params_t *) bus->params)->last_addr
 #define FJMEM_REG  ((bus_params_t *) bus->params)->fjmem_reg
 #define BLOCK_DESC ((bus_params_t *) bus->params)->block_desc
+#define BURST      ((bus_params_t *) bus->params)->burst
+#define BURST_ADDR ((bus_params_t *) bus->params)->burst_addr
+#define BURST_LEN  ((bus_params_t *) bus->params)->burst_len
+#define BURST_RUN  ((bus_params_t *) bus->params)->burst_run
+#define BURST_BUF  ((bus_params_t *) bus->params)->burst_buf
 
 static int
 fjmem_detect_reg_len (urj_chain_t *chain, urj_part_t *part, const char *opcode,
@@ -149,7 +165,6 @@ fjmem_detect_reg_len (urj_chain_t *chain, urj_part_t *part, const char *opcode,
     urj_tap_capture_dr (chain);
     /* read current TDO and then shift once */
     urj_tap_shift_register (chain, dr->in, dr->out, URJ_CHAIN_EXITMODE_SHIFT);
-    urj_tap_register_get_string (dr->out);
     while ((tdo_bit[0] == 0) && (fjmem_reg_len < FJMEM_MAX_REG_LEN))
     {
         /* read current TDO and then shift once */
@@ -213,17 +228,17 @@ fjmem_detect_fields (urj_chain_t *chain, urj_part_t *part, urj_bus_t *bus)
              urj_tap_register_get_string (dr->out));
     /* scan block field */
     idx = bd->block_pos;
-    while (dr->out->data[idx] && (idx < dr->out->len))
+    while ((idx < dr->out->len) && dr->out->data[idx])
         idx++;
     bd->block_len = idx - bd->block_pos;
     /* scan address field */
     bd->addr_pos = idx;
-    while ((dr->out->data[idx] == 0) && (idx < dr->out->len))
+    while ((idx < dr->out->len) && (dr->out->data[idx] == 0))
         idx++;
     bd->addr_len = idx - bd->addr_pos;
     /* scan data field */
     bd->data_pos = idx;
-    while (dr->out->data[idx] && (idx < dr->out->len))
+    while ((idx < dr->out->len) && dr->out->data[idx])
         idx++;
     bd->data_len = idx - bd->data_pos;
 
@@ -286,6 +301,10 @@ fjmem_query_blocks (urj_chain_t *chain, urj_part_t *part, urj_bus_t *bus)
             block_param_t *bl;
             int nbytes;
 
+            /* cores with read bursts set the ack field in the reply */
+            if (dr->out->data[bd->instr_pos + 3])
+                BURST = 1;
+
             if ((bl = calloc (1, sizeof (block_param_t))) == NULL)
             {
                 urj_error_set (URJ_ERROR_OUT_OF_MEMORY, "calloc(%zd,%zd) fails",
@@ -344,6 +363,9 @@ fjmem_query_blocks (urj_chain_t *chain, urj_part_t *part, urj_bus_t *bus)
         }
     }
 
+    urj_log (URJ_LOG_LEVEL_DEBUG, "read bursts %ssupported\n",
+             BURST ? "" : "not ");
+
     return failed ? 0 : 1;
 }
 
@@ -587,6 +609,91 @@ setup_data (urj_bus_t *bus, uint32_t d, block_param_t *block)
     }
 }
 
+/*
+ * Read @n words from @adr on with one read burst: a shift with the burst
+ * instruction (011), the start address and the word count in the data
+ * field, and one long shift that brings the words out back to back while
+ * the core fetches the next ones. The zeros shifted in leave the core idle.
+ */
+static int
+fjmem_read_burst (urj_bus_t *bus, uint32_t adr, block_param_t *block, int n)
+{
+    urj_chain_t *chain = bus->chain;
+    block_desc_t *bd = &(BLOCK_DESC);
+    urj_data_register_t *dr = FJMEM_REG;
+    int width = block->data_width;
+    int len, i, idx;
+    const char *d;
+
+    /* stay inside the block, and the count must fit into the data field */
+    if ((uint32_t) n > ((block->end - adr) >> block->ashift) + 1)
+        n = ((block->end - adr) >> block->ashift) + 1;
+    if (width < 31 && n > (1 << width) - 1)
+        n = (1 << width) - 1;
+
+    urj_tap_register_fill (dr->in, 0);
+    setup_address (bus, adr, block);
+    setup_data (bus, n, block);
+    dr->in->data[bd->instr_pos + 0] = 1;
+    dr->in->data[bd->instr_pos + 1] = 1;
+    dr->in->data[bd->instr_pos + 2] = 0;
+    urj_tap_chain_shift_data_registers (chain, 0);
+
+    len = n * width > bd->reg_len ? n * width : bd->reg_len;
+    if (urj_part_data_register_realloc (dr, len) != URJ_STATUS_OK)
+        return URJ_STATUS_FAIL;
+    urj_tap_register_fill (dr->in, 0);
+    urj_tap_chain_shift_data_registers (chain, 1);
+
+    d = dr->out->data;
+    for (i = 0; i < n; i++)
+    {
+        uint32_t w = 0;
+
+        for (idx = 0; idx < width; idx++)
+            if (*d++)
+                w |= UINT32_C (1) << idx;
+        BURST_BUF[i] = w;
+    }
+    BURST_ADDR = adr;
+    BURST_LEN = n;
+
+    if (urj_part_data_register_realloc (dr, bd->reg_len) != URJ_STATUS_OK)
+        return URJ_STATUS_FAIL;
+
+    return URJ_STATUS_OK;
+}
+
+/* the word at @adr, from the last burst or a new one; with @ahead, the new
+   burst reads ahead and the next one will be twice as long */
+static uint32_t
+fjmem_burst_word (urj_bus_t *bus, uint32_t adr, int ahead)
+{
+    urj_bus_area_t area;
+    block_param_t *block;
+    uint32_t i;
+
+    block_bus_area (bus, adr, &area, &block);
+    if (!block)
+    {
+        urj_error_set (URJ_ERROR_OUT_OF_BOUNDS, _("Address out of range"));
+        return 0;
+    }
+
+    i = (adr - BURST_ADDR) >> block->ashift;
+    if (adr >= BURST_ADDR && i < (uint32_t) BURST_LEN)
+        return BURST_BUF[i];
+
+    BURST_LEN = 0;
+    if (fjmem_read_burst (bus, adr, block, ahead ? BURST_RUN : 1)
+        != URJ_STATUS_OK)
+        return 0;
+    if (ahead && BURST_RUN < FJMEM_BURST_MAX)
+        BURST_RUN *= 2;
+
+    return BURST_BUF[0];
+}
+
 /**
  * bus->driver->(*read_start)
  *
@@ -608,6 +715,15 @@ fjmem_bus_read_start (urj_bus_t *bus, uint32_t adr)
         return URJ_STATUS_FAIL;
     }
 
+    if (BURST)
+    {
+        /* fetch lazily, read_end() alone needs a single word */
+        LAST_ADDR = adr;
+        BURST_LEN = 0;
+        BURST_RUN = FJMEM_BURST_FIRST;
+        return URJ_STATUS_OK;
+    }
+
     setup_address (bus, adr, block);
 
     /* select read instruction */
@@ -635,6 +751,13 @@ fjmem_bus_read_next (urj_bus_t *bus, uint32_t adr)
     block_param_t *block;
     int idx;
 
+    if (BURST)
+    {
+        d = fjmem_burst_word (bus, LAST_ADDR, 1);
+        LAST_ADDR = adr;
+        return d;
+    }
+
     block_bus_area (bus, adr, &area, &block);
     if (!block)
     {
@@ -670,6 +793,9 @@ fjmem_bus_read_end (urj_bus_t *bus)
     block_param_t *block;
     int idx;
 
+    if (BURST)
+        return fjmem_burst_word (bus, LAST_ADDR, 0);
+
     block_bus_area (bus, LAST_ADDR, &area, &block);
     if (!block)
     {
@@ -713,6 +839,9 @@ fjmem_bus_write (urj_bus_t *bus, uint32_t adr, uint32_t data)
         return;
     }
 
+    /* the write may change the memory under the last burst */
+    BURST_LEN = 0;
+
     setup_address (bus, adr, block);
     setup_data (bus, data, block);
 
@@ -27,6 +27,7 @@
 #include <urjtag/error.h>
 #include <urjtag/part.h>
 #include <urjtag/chain.h>
+#include <urjtag/flash.h>
 
 #include "generic_bus.h"
 
@@ -82,6 +83,7 @@ urj_bus_generic_new (urj_chain_t *chain, const urj_bus_driver_t *driver,
 void
 urj_bus_generic_free (urj_bus_t *bus)
 {
+    urj_flash_cleanup (bus);
     free (bus->params);
     free (bus);
 }
@@ -157,3 +159,52 @@ urj_bus_generic_read (urj_bus_t *bus, uint32_t adr)
     URJ_BUS_READ_START (bus, adr);
     return URJ_BUS_READ_END (bus);
 }
+
+/* the distance between two bus words at @adr, in bytes */
+static uint32_t
+urj_bus_generic_step (urj_bus_t *bus, uint32_t adr)
+{
+    urj_bus_area_t area;
+
+    if (URJ_BUS_AREA (bus, adr, &area) != URJ_STATUS_OK || area.width < 8)
+        return 1;
+
+    return area.width / 8;
+}
+
+/**
+ * bus->driver->(*read_block)
+ *
+ */
+int
+urj_bus_generic_read_block (urj_bus_t *bus, uint32_t adr, uint32_t *data,
+                            int n)
+{
+    uint32_t step = urj_bus_generic_step (bus, adr);
+    int i;
+
+    if (URJ_BUS_READ_START (bus, adr) != URJ_STATUS_OK)
+        return URJ_STATUS_FAIL;
+    for (i = 0; i < n - 1; i++)
+        data[i] = URJ_BUS_READ_NEXT (bus, adr + (i + 1) * step);
+    data[n - 1] = URJ_BUS_READ_END (bus);
+
+    return URJ_STATUS_OK;
+}
+
+/**
+ * bus->driver->(*write_block)
+ *
+ */
+int
+urj_bus_generic_write_block (urj_bus_t *bus, uint32_t adr,
+                             const uint32_t *data, int n)
+{
+    uint32_t step = urj_bus_generic_step (bus, adr);
+    int i;
+
+    for (i = 0; i < n; i++)
+        URJ_BUS_WRITE (bus, adr + i * step, data[i]);
+
+    return URJ_STATUS_OK;
+}
@@ -42,5 +42,9 @@ int urj_bus_generic_no_disable (urj_bus_t *bus);
 void urj_bus_generic_prepare_extest (urj_bus_t *bus);
 int urj_bus_generic_write_start(urj_bus_t *bus, uint32_t adr);
 uint32_t urj_bus_generic_read (urj_bus_t *bus, uint32_t adr);
+int urj_bus_generic_read_block (urj_bus_t *bus, uint32_t adr, uint32_t *data,
+                                int n);
+int urj_bus_generic_write_block (urj_bus_t *bus, uint32_t adr,
+                                 const uint32_t *data, int n);
 
 #endif /* URJ_BUS_GENERIC_BUS_H */
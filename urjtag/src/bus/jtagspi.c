@@ -0,0 +1,381 @@
+/*
+ * $Id$
+ *
+ * Copyright (C) 2026 UrJTAG contributors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA
+ * 02111-1307, USA.
+ *
+ * SPI master through a JTAG-to-SPI bridge in an FPGA (see extra/jtagspi).
+ *
+ * The bridge sits in the data register of a USER instruction. After
+ * Capture-DR it waits for a 1 on TDI, takes the number of SPI clocks as
+ * 32 bit value LSB first, asserts the chip select and then clocks SCK with
+ * TCK: TDI goes to MOSI and MISO comes back on TDO one TCK later. When the
+ * count has run out, it releases the chip select again. A whole SPI
+ * transaction, e.g. a page program with its 256 data bytes, is thus one
+ * DR scan and one round trip to the cable.
+ *
+ * All other parts of the chain are put into BYPASS, so that only zeros
+ * pass the bridge before the start bit.
+ */
+
+#include <sysdep.h>
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <urjtag/log.h>
+#include <urjtag/part.h>
+#include <urjtag/bus.h>
+#include <urjtag/chain.h>
+#include <urjtag/tap.h>
+#include <urjtag/data_register.h>
+#include <urjtag/tap_register.h>
+#include <urjtag/part_instruction.h>
+
+#include "buses.h"
+#include "generic_bus.h"
+
+#define JTAGSPI_INST_NAME       "JTAGSPI_INST"
+#define JTAGSPI_REG_NAME        "JTAGSPI_REG"
+
+/* start bit and clock count in front of the SPI data */
+#define JTAGSPI_HEADER          33
+
+/* bytes per READ command of memory reads */
+#define JTAGSPI_READ_AHEAD      256
+
+#define SPI_CMD_READ            0x03
+
+typedef struct
+{
+    urj_data_register_t *dr;
+    /* memory read cache */
+    uint32_t last;              /* address passed to read_start/next */
+    uint32_t buf_adr;
+    int buf_len;
+    uint8_t buf[JTAGSPI_READ_AHEAD];
+} bus_params_t;
+
+#define JTAGSPI_REG     ((bus_params_t *) bus->params)->dr
+#define LAST            ((bus_params_t *) bus->params)->last
+#define BUF_ADR         ((bus_params_t *) bus->params)->buf_adr
+#define BUF_LEN         ((bus_params_t *) bus->params)->buf_len
+#define BUF             ((bus_params_t *) bus->params)->buf
+
+/* build JTAGSPI_REG and the instruction JTAGSPI_INST that selects it */
+static int
+jtagspi_add_instruction (urj_part_t *part, const char *opcode)
+{
+    urj_data_register_t *dr;
+    urj_part_instruction_t *i;
+
+    if (strlen (opcode) != part->instruction_length)
+    {
+        urj_error_set (URJ_ERROR_INVALID, _("invalid instruction length"));
+        return URJ_STATUS_FAIL;
+    }
+
+    dr = urj_part_find_data_register (part, JTAGSPI_REG_NAME);
+    if (dr == NULL)
+    {
+        dr = urj_part_data_register_alloc (JTAGSPI_REG_NAME, 1);
+        if (dr == NULL)
+            // retain error state
+            return URJ_STATUS_FAIL;
+        dr->next = part->data_registers;
+        part->data_registers = dr;
+    }
+
+    i = urj_part_find_instruction (part, JTAGSPI_INST_NAME);
+    if (i == NULL)
+    {
+        i = urj_part_instruction_alloc (JTAGSPI_INST_NAME,
+                                        part->instruction_length, opcode);
+        if (i == NULL)
+            // retain error state
+            return URJ_STATUS_FAIL;
+        i->next = part->instructions;
+        part->instructions = i;
+    }
+    else if (urj_tap_register_init (i->value, opcode) == NULL)
+        return URJ_STATUS_FAIL;
+    i->data_register = dr;
+
+    return URJ_STATUS_OK;
+}
+
+/**
+ * bus->driver->(*new_bus)
+ *
+ */
+static urj_bus_t *
+jtagspi_bus_new (urj_chain_t *chain, const urj_bus_driver_t *driver,
+                 const urj_param_t *params[])
+{
+    urj_bus_t *bus;
+    const char *opcode = NULL;
+    int idx;
+
+    bus = urj_bus_generic_new (chain, driver, sizeof (bus_params_t));
+    if (bus == NULL)
+        return NULL;
+
+    for (idx = 0; params[idx] != NULL; idx++)
+    {
+        switch (params[idx]->key)
+        {
+        case URJ_BUS_PARAM_KEY_OPCODE:
+            opcode = params[idx]->value.string;
+            break;
+        default:
+            urj_bus_generic_free (bus);
+            urj_error_set (URJ_ERROR_SYNTAX, "unrecognized bus parameter '%s'",
+                           urj_param_string (&urj_bus_param_list, params[idx]));
+            return NULL;
+        }
+    }
+
+    if (opcode == NULL)
+    {
+        urj_bus_generic_free (bus);
+        urj_error_set (URJ_ERROR_SYNTAX,
+                       _("Parameter for instruction opcode missing"));
+        return NULL;
+    }
+
+    if (jtagspi_add_instruction (bus->part, opcode) != URJ_STATUS_OK)
+    {
+        urj_bus_generic_free (bus);
+        return NULL;
+    }
+    JTAGSPI_REG = urj_part_find_data_register (bus->part, JTAGSPI_REG_NAME);
+
+    return bus;
+}
+
+/**
+ * bus->driver->(*printinfo)
+ *
+ */
+static void
+jtagspi_bus_printinfo (urj_log_level_t ll, urj_bus_t *bus)
+{
+    int i;
+
+    for (i = 0; i < bus->chain->parts->len; i++)
+        if (bus->part == bus->chain->parts->parts[i])
+            break;
+    urj_log (ll, _("JTAG-to-SPI bridge bus driver via USER register (JTAG part No. %d)\n"),
+             i);
+}
+
+/**
+ * bus->driver->(*prepare)
+ *
+ */
+static void
+jtagspi_bus_prepare (urj_bus_t *bus)
+{
+    urj_parts_t *ps = bus->chain->parts;
+    int i;
+
+    if (!bus->initialized)
+        URJ_BUS_INIT (bus);
+
+    /* the other parts must shift zeros into the bridge */
+    urj_part_parts_set_instruction (ps, "BYPASS");
+    for (i = 0; i < ps->len; i++)
+        if (ps->parts[i] != bus->part
+            && ps->parts[i]->active_instruction != NULL)
+            urj_tap_register_fill (ps->parts[i]->active_instruction
+                                   ->data_register->in, 0);
+
+    urj_part_set_instruction (bus->part, JTAGSPI_INST_NAME);
+    urj_tap_chain_shift_instructions (bus->chain);
+}
+
+/**
+ * bus->driver->(*area)
+ *
+ */
+static int
+jtagspi_bus_area (urj_bus_t *bus, uint32_t adr, urj_bus_area_t *area)
+{
+    area->description = NULL;
+    area->start = UINT32_C (0x00000000);
+    area->length = UINT64_C (0x01000000);       /* 3 byte addresses */
+    area->width = 8;
+
+    return URJ_STATUS_OK;
+}
+
+/**
+ * bus->driver->(*transfer)
+ *
+ */
+static int
+jtagspi_bus_transfer (urj_bus_t *bus, const uint8_t *out, int out_len,
+                      uint8_t *in, int in_len)
+{
+    urj_parts_t *ps = bus->chain->parts;
+    urj_data_register_t *dr = JTAGSPI_REG;
+    uint32_t count = 8 * (out_len + in_len);
+    int offset = 0;
+    int len, i, k;
+    char *d;
+
+    /* the SPI data may change the memory under the read cache */
+    BUF_LEN = 0;
+
+    if (count == 0)
+        return URJ_STATUS_OK;
+
+    /* bits of the other parts between TDI and TDO */
+    for (i = 0; i < ps->len; i++)
+    {
+        urj_part_instruction_t *inst = ps->parts[i]->active_instruction;
+
+        if (inst == NULL || inst->data_register == NULL)
+        {
+            urj_error_set (URJ_ERROR_NO_ACTIVE_INSTRUCTION,
+                           _("Part %d without active instruction"), i);
+            return URJ_STATUS_FAIL;
+        }
+        if (ps->parts[i] != bus->part)
+            offset += inst->data_register->in->len;
+    }
+
+    /* MISO bit k comes back at JTAGSPI_HEADER + k + 1 */
+    len = JTAGSPI_HEADER + count + offset + 1;
+    if (dr->in->len != len
+        && urj_part_data_register_realloc (dr, len) != URJ_STATUS_OK)
+        return URJ_STATUS_FAIL;
+
+    d = dr->in->data;
+    memset (d, 0, len);
+    d[0] = 1;
+    for (i = 0; i < 32; i++)
+        d[1 + i] = (count >> i) & 1;
+    for (k = 0; k < 8 * out_len; k++)
+        d[JTAGSPI_HEADER + k] = (out[k / 8] >> (7 - k % 8)) & 1;
+
+    if (urj_tap_chain_shift_data_registers (bus->chain, in_len > 0)
+        != URJ_STATUS_OK)
+        return URJ_STATUS_FAIL;
+
+    d = dr->out->data + JTAGSPI_HEADER + 8 * out_len + offset + 1;
+    for (i = 0; i < in_len; i++)
+    {
+        in[i] = 0;
+        for (k = 0; k < 8; k++)
+            in[i] = (in[i] << 1) | (*d++ & 1);
+    }
+
+    return URJ_STATUS_OK;
+}
+
+/* the byte at @adr, from the cache or a new READ command */
+static uint8_t
+jtagspi_read_byte (urj_bus_t *bus, uint32_t adr)
+{
+    uint8_t cmd[4];
+
+    if (adr - BUF_ADR < (uint32_t) BUF_LEN)
+        return BUF[adr - BUF_ADR];
+
+    cmd[0] = SPI_CMD_READ;
+    cmd[1] = adr >> 16;
+    cmd[2] = adr >> 8;
+    cmd[3] = adr;
+    if (jtagspi_bus_transfer (bus, cmd, sizeof cmd, BUF, JTAGSPI_READ_AHEAD)
+        != URJ_STATUS_OK)
+        return 0xFF;
+    BUF_ADR = adr;
+    BUF_LEN = JTAGSPI_READ_AHEAD;
+
+    return BUF[0];
+}
+
+/**
+ * bus->driver->(*read_start)
+ *
+ */
+static int
+jtagspi_bus_read_start (urj_bus_t *bus, uint32_t adr)
+{
+    LAST = adr;
+
+    return URJ_STATUS_OK;
+}
+
+/**
+ * bus->driver->(*read_next)
+ *
+ */
+static uint32_t
+jtagspi_bus_read_next (urj_bus_t *bus, uint32_t adr)
+{
+    uint32_t d = jtagspi_read_byte (bus, LAST);
+
+    LAST = adr;
+
+    return d;
+}
+
+/**
+ * bus->driver->(*read_end)
+ *
+ */
+static uint32_t
+jtagspi_bus_read_end (urj_bus_t *bus)
+{
+    return jtagspi_read_byte (bus, LAST);
+}
+
+/**
+ * bus->driver->(*write)
+ *
+ */
+static void
+jtagspi_bus_write (urj_bus_t *bus, uint32_t adr, uint32_t data)
+{
+    urj_warning (_("SPI bus: no memory writes, use the flash commands\n"));
+}
+
+const urj_bus_driver_t urj_bus_jtagspi_bus = {
+    "jtagspi",
+    N_("SPI bus driver via a JTAG-to-SPI bridge in an FPGA USER register,\n"
+       "           requires parameter: opcode=<USERx OPCODE>"),
+    jtagspi_bus_new,
+    urj_bus_generic_free,
+    jtagspi_bus_printinfo,
+    jtagspi_bus_prepare,
+    jtagspi_bus_area,
+    jtagspi_bus_read_start,
+    jtagspi_bus_read_next,
+    jtagspi_bus_read_end,
+    urj_bus_generic_read,
+    urj_bus_generic_write_start,
+    jtagspi_bus_write,
+    urj_bus_generic_no_init,
+    urj_bus_generic_no_enable,
+    urj_bus_generic_no_disable,
+    URJ_BUS_TYPE_SPI,
+    NULL,
+    jtagspi_bus_transfer,
+};
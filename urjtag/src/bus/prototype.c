@@ -155,7 +155,13 @@ prototype_bus_new (urj_chain_t *chain, const urj_bus_driver_t *driver,
             // @@@@ RFHH If it is mandatory for a signal to have an int inst
             // number, why does prototype_bus_signal_parse() accept values
             // without an int?
-            if (inst > 31 || inst < 0)
+            // Only address and data signals need one; CS, OE and WE may be
+            // plain names.
+            if ((inst > 31 || inst < 0)
+                && (cmd_params[i]->key == URJ_BUS_PARAM_KEY_ALSB
+                    || cmd_params[i]->key == URJ_BUS_PARAM_KEY_AMSB
+                    || cmd_params[i]->key == URJ_BUS_PARAM_KEY_DLSB
+                    || cmd_params[i]->key == URJ_BUS_PARAM_KEY_DMSB))
                 continue;
 
             sig = urj_part_find_signal (bus->part, value);
@@ -484,6 +490,54 @@ prototype_bus_read_end (urj_bus_t *bus)
     return d;
 }
 
+/**
+ * bus->driver->(*read_repeat)
+ *
+ */
+static int
+prototype_bus_read_repeat (urj_bus_t *bus, uint32_t adr, uint32_t *data,
+                           int n)
+{
+    urj_part_t *p = bus->part;
+    urj_chain_t *chain = bus->chain;
+    int i, j, k;
+
+    urj_part_set_signal (p, WE, 1, WEA ? 0 : 1);
+    setup_address (bus, adr);
+    set_data_in (bus);
+
+    /* each read is a scan with CS and OE active and a scan that captures
+       the data and ends the access, as status bits may change only from
+       one access to the next; all scans go to the cable together */
+    for (k = 0; k < n; k++)
+    {
+        urj_part_set_signal (p, CS, 1, CSA);
+        urj_part_set_signal (p, OE, 1, OEA);
+        if (urj_tap_chain_defer_shift_data_registers (chain, 0, 1,
+                                                      URJ_CHAIN_EXITMODE_IDLE)
+            != URJ_STATUS_OK)
+            return URJ_STATUS_FAIL;
+
+        urj_part_set_signal (p, CS, 1, CSA ? 0 : 1);
+        urj_part_set_signal (p, OE, 1, OEA ? 0 : 1);
+        if (urj_tap_chain_defer_shift_data_registers (chain, 1, 1,
+                                                      URJ_CHAIN_EXITMODE_IDLE)
+            != URJ_STATUS_OK)
+            return URJ_STATUS_FAIL;
+    }
+
+    for (k = 0; k < n; k++)
+    {
+        urj_tap_chain_shift_data_registers_output (chain,
+                                                   URJ_CHAIN_EXITMODE_IDLE);
+        data[k] = 0;
+        for (i = 0, j = DLSBI; i < DW; i++, j += DI)
+            data[k] |= (uint32_t) (urj_part_get_signal (p, D[j]) << i);
+    }
+
+    return URJ_STATUS_OK;
+}
+
 /**
  * bus->driver->(*write)
  *
@@ -530,4 +584,5 @@ const urj_bus_driver_t urj_bus_prototype_bus = {
     urj_bus_generic_no_enable,
     urj_bus_generic_no_disable,
     URJ_BUS_TYPE_PARALLEL,
+    prototype_bus_read_repeat,
 };
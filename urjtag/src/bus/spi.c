@@ -0,0 +1,461 @@
+/*
+ * $Id$
+ *
+ * Copyright (C) 2026 UrJTAG contributors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA
+ * 02111-1307, USA.
+ *
+ * SPI master (mode 0, MSB first) on four pins of a part, via BSR.
+ *
+ * Every SPI clock takes two scans: one with SCK low and the next MOSI bit,
+ * one with SCK high. The device shifts MISO out on the falling edge, so the
+ * scan with SCK high captures the bit. Only those scans of received bytes
+ * capture anything; all scans of a transaction are queued and go to the
+ * cable together.
+ *
+ * Memory reads (readmem, flash verify) use the READ command (0x03) with a
+ * 3 byte address that SPI NOR flashes and EEPROMs share, and continue the
+ * same READ as long as the addresses follow each other.
+ */
+
+#include <sysdep.h>
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <urjtag/part.h>
+#include <urjtag/bus.h>
+#include <urjtag/chain.h>
+#include <urjtag/bssignal.h>
+#include <urjtag/tap_state.h>
+
+#include "buses.h"
+#include "generic_bus.h"
+
+/* bytes received per cable flush while a memory read goes on */
+#define SPI_READ_AHEAD          64
+
+#define SPI_CMD_READ            0x03
+
+typedef struct
+{
+    urj_part_signal_t *sck;
+    urj_part_signal_t *mosi;
+    urj_part_signal_t *miso;
+    urj_part_signal_t *cs;
+    int csa;
+    /* memory read in progress */
+    int reading;
+    uint32_t next;              /* address of the next byte in buf */
+    uint8_t buf[SPI_READ_AHEAD];
+    int len, pos;
+} bus_params_t;
+
+#define SCK     ((bus_params_t *) bus->params)->sck
+#define MOSI    ((bus_params_t *) bus->params)->mosi
+#define MISO    ((bus_params_t *) bus->params)->miso
+#define CS      ((bus_params_t *) bus->params)->cs
+#define CSA     ((bus_params_t *) bus->params)->csa
+
+#define READING ((bus_params_t *) bus->params)->reading
+#define NEXT    ((bus_params_t *) bus->params)->next
+#define BUF     ((bus_params_t *) bus->params)->buf
+#define LEN     ((bus_params_t *) bus->params)->len
+#define POS     ((bus_params_t *) bus->params)->pos
+
+/**
+ * bus->driver->(*new_bus)
+ *
+ */
+static urj_bus_t *
+spi_bus_new (urj_chain_t *chain, const urj_bus_driver_t *driver,
+             const urj_param_t *cmd_params[])
+{
+    urj_bus_t *bus;
+    urj_part_signal_t *sig;
+    int i;
+    int failed = 0;
+
+    bus = urj_bus_generic_new (chain, driver, sizeof (bus_params_t));
+    if (bus == NULL)
+        return NULL;
+
+    for (i = 0; cmd_params[i] != NULL; i++)
+    {
+        if (cmd_params[i]->type != URJ_PARAM_TYPE_STRING)
+        {
+            urj_error_set (URJ_ERROR_SYNTAX,
+                           "parameter must be of type string");
+            failed = 1;
+            continue;
+        }
+
+        sig = urj_part_find_signal (bus->part, cmd_params[i]->value.string);
+        if (!sig)
+        {
+            urj_error_set (URJ_ERROR_NOTFOUND, _("signal '%s' not found"),
+                           cmd_params[i]->value.string);
+            failed = 1;
+            continue;
+        }
+
+        switch (cmd_params[i]->key)
+        {
+        case URJ_BUS_PARAM_KEY_SCK:
+            SCK = sig;
+            break;
+        case URJ_BUS_PARAM_KEY_MOSI:
+            MOSI = sig;
+            break;
+        case URJ_BUS_PARAM_KEY_MISO:
+            MISO = sig;
+            break;
+        case URJ_BUS_PARAM_KEY_CS:
+        case URJ_BUS_PARAM_KEY_NCS:
+            CS = sig;
+            CSA = (cmd_params[i]->key == URJ_BUS_PARAM_KEY_CS);
+            break;
+        default:
+            urj_error_set (URJ_ERROR_INVALID, _("parameter %s is unknown"),
+                           urj_param_string (&urj_bus_param_list,
+                                             cmd_params[i]));
+            failed = 1;
+            break;
+        }
+    }
+
+    if (!failed && (!SCK || !MOSI || !MISO || !CS))
+    {
+        urj_error_set (URJ_ERROR_INVALID,
+                       _("parameters sck=<signal> mosi=<signal> miso=<signal> and cs=<signal> or ncs=<signal> are required"));
+        failed = 1;
+    }
+
+    if (failed)
+    {
+        urj_bus_generic_free (bus);
+        return NULL;
+    }
+
+    return bus;
+}
+
+/**
+ * bus->driver->(*printinfo)
+ *
+ */
+static void
+spi_bus_printinfo (urj_log_level_t ll, urj_bus_t *bus)
+{
+    int i;
+
+    for (i = 0; i < bus->chain->parts->len; i++)
+        if (bus->part == bus->chain->parts->parts[i])
+            break;
+    urj_log (ll, _("SPI bus driver via BSR (JTAG part No. %d)\n"), i);
+}
+
+/**
+ * bus->driver->(*area)
+ *
+ */
+static int
+spi_bus_area (urj_bus_t *bus, uint32_t adr, urj_bus_area_t *area)
+{
+    area->description = NULL;
+    area->start = UINT32_C (0x00000000);
+    area->length = UINT64_C (0x01000000);       /* 3 byte addresses */
+    area->width = 8;
+
+    return URJ_STATUS_OK;
+}
+
+/**
+ * bus->driver->(*init)
+ *
+ */
+static int
+spi_bus_init (urj_bus_t *bus)
+{
+    urj_part_t *p = bus->part;
+
+    if (urj_tap_state (bus->chain) != URJ_TAP_STATE_RUN_TEST_IDLE)
+    {
+        /* silently skip initialization if TAP isn't in RUNTEST/IDLE state
+           this is required to avoid interfering with detect when initbus
+           is contained in the part description file
+           URJ_BUS_INIT() will be called latest by URJ_BUS_PREPARE() */
+        return URJ_STATUS_OK;
+    }
+
+    urj_part_set_signal_input (p, MISO);
+    urj_part_set_signal_low (p, SCK);
+    urj_part_set_signal_low (p, MOSI);
+    urj_part_set_signal (p, CS, 1, CSA ? 0 : 1);
+
+    /* the device must see CS going active for the first command */
+    if (urj_part_find_instruction (p, "SAMPLE/PRELOAD") != NULL)
+        urj_part_set_instruction (p, "SAMPLE/PRELOAD");
+    else
+        urj_part_set_instruction (p, "SAMPLE");
+    if (p->active_instruction != NULL)
+    {
+        urj_tap_chain_shift_instructions (bus->chain);
+        urj_tap_chain_shift_data_registers (bus->chain, 0);
+    }
+
+    bus->initialized = 1;
+
+    return URJ_STATUS_OK;
+}
+
+static int
+spi_scan (urj_bus_t *bus, int capture)
+{
+    return urj_tap_chain_defer_shift_data_registers (bus->chain, capture, 1,
+                                                     URJ_CHAIN_EXITMODE_IDLE);
+}
+
+static int
+spi_select (urj_bus_t *bus)
+{
+    urj_part_t *p = bus->part;
+
+    urj_part_set_signal_input (p, MISO);
+    urj_part_set_signal (p, SCK, 1, 0);
+    urj_part_set_signal (p, CS, 1, CSA);
+
+    return spi_scan (bus, 0);
+}
+
+static int
+spi_deselect (urj_bus_t *bus)
+{
+    urj_part_t *p = bus->part;
+
+    urj_part_set_signal (p, SCK, 1, 0);
+    urj_part_set_signal (p, CS, 1, CSA ? 0 : 1);
+
+    return spi_scan (bus, 0);
+}
+
+static int
+spi_send (urj_bus_t *bus, const uint8_t *out, int n)
+{
+    urj_part_t *p = bus->part;
+    int i, b;
+
+    for (i = 0; i < n; i++)
+        for (b = 7; b >= 0; b--)
+        {
+            urj_part_set_signal (p, MOSI, 1, (out[i] >> b) & 1);
+            urj_part_set_signal (p, SCK, 1, 0);
+            if (spi_scan (bus, 0) != URJ_STATUS_OK)
+                return URJ_STATUS_FAIL;
+            urj_part_set_signal (p, SCK, 1, 1);
+            if (spi_scan (bus, 0) != URJ_STATUS_OK)
+                return URJ_STATUS_FAIL;
+        }
+
+    return URJ_STATUS_OK;
+}
+
+/* queue the clocks for @n bytes; spi_collect() picks the bytes up */
+static int
+spi_receive (urj_bus_t *bus, int n)
+{
+    urj_part_t *p = bus->part;
+    int i;
+
+    urj_part_set_signal (p, MOSI, 1, 0);
+    for (i = 0; i < 8 * n; i++)
+    {
+        urj_part_set_signal (p, SCK, 1, 0);
+        if (spi_scan (bus, 0) != URJ_STATUS_OK)
+            return URJ_STATUS_FAIL;
+        urj_part_set_signal (p, SCK, 1, 1);
+        if (spi_scan (bus, 1) != URJ_STATUS_OK)
+            return URJ_STATUS_FAIL;
+    }
+
+    return URJ_STATUS_OK;
+}
+
+static void
+spi_collect (urj_bus_t *bus, uint8_t *in, int n)
+{
+    int i, b;
+
+    for (i = 0; i < n; i++)
+    {
+        in[i] = 0;
+        for (b = 0; b < 8; b++)
+        {
+            urj_tap_chain_shift_data_registers_output (bus->chain,
+                                                       URJ_CHAIN_EXITMODE_IDLE);
+            in[i] = (in[i] << 1) | urj_part_get_signal (bus->part, MISO);
+        }
+    }
+}
+
+static void
+spi_read_stop (urj_bus_t *bus)
+{
+    if (!READING)
+        return;
+
+    READING = 0;
+    spi_deselect (bus);
+    urj_tap_chain_flush (bus->chain);
+}
+
+static int
+spi_read_begin (urj_bus_t *bus, uint32_t adr)
+{
+    uint8_t cmd[4];
+
+    cmd[0] = SPI_CMD_READ;
+    cmd[1] = adr >> 16;
+    cmd[2] = adr >> 8;
+    cmd[3] = adr;
+
+    if (spi_select (bus) != URJ_STATUS_OK
+        || spi_send (bus, cmd, sizeof cmd) != URJ_STATUS_OK)
+        return URJ_STATUS_FAIL;
+
+    READING = 1;
+    NEXT = adr;
+    LEN = POS = 0;
+
+    return URJ_STATUS_OK;
+}
+
+/* the byte at NEXT */
+static uint8_t
+spi_read_byte (urj_bus_t *bus)
+{
+    if (POS == LEN)
+    {
+        if (spi_receive (bus, SPI_READ_AHEAD) != URJ_STATUS_OK)
+            return 0xFF;
+        spi_collect (bus, BUF, SPI_READ_AHEAD);
+        LEN = SPI_READ_AHEAD;
+        POS = 0;
+    }
+
+    NEXT++;
+    return BUF[POS++];
+}
+
+/**
+ * bus->driver->(*read_start)
+ *
+ */
+static int
+spi_bus_read_start (urj_bus_t *bus, uint32_t adr)
+{
+    spi_read_stop (bus);
+
+    return spi_read_begin (bus, adr);
+}
+
+/**
+ * bus->driver->(*read_next)
+ *
+ */
+static uint32_t
+spi_bus_read_next (urj_bus_t *bus, uint32_t adr)
+{
+    uint32_t d = spi_read_byte (bus);
+
+    if (adr != NEXT)
+    {
+        spi_read_stop (bus);
+        spi_read_begin (bus, adr);
+    }
+
+    return d;
+}
+
+/**
+ * bus->driver->(*read_end)
+ *
+ */
+static uint32_t
+spi_bus_read_end (urj_bus_t *bus)
+{
+    uint32_t d = spi_read_byte (bus);
+
+    spi_read_stop (bus);
+
+    return d;
+}
+
+/**
+ * bus->driver->(*write)
+ *
+ */
+static void
+spi_bus_write (urj_bus_t *bus, uint32_t adr, uint32_t data)
+{
+    urj_warning (_("SPI bus: no memory writes, use the flash commands\n"));
+}
+
+/**
+ * bus->driver->(*transfer)
+ *
+ */
+static int
+spi_bus_transfer (urj_bus_t *bus, const uint8_t *out, int out_len,
+                  uint8_t *in, int in_len)
+{
+    spi_read_stop (bus);
+
+    if (spi_select (bus) != URJ_STATUS_OK
+        || spi_send (bus, out, out_len) != URJ_STATUS_OK
+        || spi_receive (bus, in_len) != URJ_STATUS_OK
+        || spi_deselect (bus) != URJ_STATUS_OK)
+        return URJ_STATUS_FAIL;
+
+    spi_collect (bus, in, in_len);
+    urj_tap_chain_flush (bus->chain);
+
+    return URJ_STATUS_OK;
+}
+
+const urj_bus_driver_t urj_bus_spi_bus = {
+    "spi",
+    N_("SPI bus driver via BSR, requires parameters:\n"
+       "           sck=<SCK> mosi=<MOSI> miso=<MISO> ncs=<CS#>|cs=<CS>"),
+    spi_bus_new,
+    urj_bus_generic_free,
+    spi_bus_printinfo,
+    urj_bus_generic_prepare_extest,
+    spi_bus_area,
+    spi_bus_read_start,
+    spi_bus_read_next,
+    spi_bus_read_end,
+    urj_bus_generic_read,
+    urj_bus_generic_write_start,
+    spi_bus_write,
+    spi_bus_init,
+    urj_bus_generic_no_enable,
+    urj_bus_generic_no_disable,
+    URJ_BUS_TYPE_SPI,
+    NULL,
+    spi_bus_transfer,
+};
@@ -39,6 +39,8 @@ urj_bus_writemem (urj_bus_t *bus, FILE *f, uint32_t addr, uint32_t len)
     int bidx = 0;
 #define BSIZE 4096
     uint8_t b[BSIZE];
+    uint32_t w[BSIZE];
+    int wn = 0;
     urj_bus_area_t area;
     uint64_t end;
 
@@ -137,7 +139,16 @@ urj_bus_writemem (urj_bus_t *bus, FILE *f, uint32_t addr, uint32_t len)
             bc--;
         }
 
-        URJ_BUS_WRITE (bus, a, data);
+        /* the words of one block of the file go out with a single bus
+           block write */
+        w[wn++] = data;
+        if (bc == 0 || a + step >= end)
+        {
+            if (urj_bus_write_block (bus, a - (wn - 1) * step, w, wn)
+                != URJ_STATUS_OK)
+                return URJ_STATUS_FAIL;
+            wn = 0;
+        }
     }
 
     urj_log (URJ_LOG_LEVEL_NORMAL, _("\nDone.\n"));
@@ -37,6 +37,9 @@
 
 #include "cmd.h"
 
+/* Bytes read from or written to the file at a time by readmem and writemem */
+#define BFIN_MEM_BUF_SIZE 0x10000
+
 static int
 cmd_bfin_run (urj_chain_t *chain, char *params[])
 {
@@ -80,7 +83,12 @@ cmd_bfin_run (urj_chain_t *chain, char *params[])
 
     if (strcmp (params[1], "emulation") == 0)
     {
-        if (num_params != 3)
+        int all = 0;
+
+        if (num_params == 4 && strcmp (params[3], "all") == 0
+            && strcmp (params[2], "status") != 0)
+            all = 1;
+        else if (num_params != 3)
         {
             urj_error_set (URJ_ERROR_BFIN,
                            "'bfin emulation' requires 1 parameter, not %d",
@@ -90,29 +98,57 @@ cmd_bfin_run (urj_chain_t *chain, char *params[])
 
         if (strcmp (params[2], "enable") == 0)
         {
-            part_emulation_enable (chain, chain->active_part);
+            if (all)
+                chain_emulation_enable (chain);
+            else
+                part_emulation_enable (chain, chain->active_part);
         }
         else if (strcmp (params[2], "trigger") == 0)
         {
-            part_emulation_trigger (chain, chain->active_part);
+            if (all)
+                chain_emulation_trigger (chain);
+            else
+                part_emulation_trigger (chain, chain->active_part);
         }
         else if (strcmp (params[2], "enter") == 0)
         {
-            part_emulation_enable (chain, chain->active_part);
-            part_emulation_trigger (chain, chain->active_part);
+            if (all)
+            {
+                chain_emulation_enable (chain);
+                chain_emulation_trigger (chain);
+            }
+            else
+            {
+                part_emulation_enable (chain, chain->active_part);
+                part_emulation_trigger (chain, chain->active_part);
+            }
         }
         else if (strcmp (params[2], "return") == 0)
         {
-            part_emulation_return (chain, chain->active_part);
+            if (all)
+                chain_emulation_return (chain);
+            else
+                part_emulation_return (chain, chain->active_part);
         }
         else if (strcmp (params[2], "disable") == 0)
         {
-            part_emulation_disable (chain, chain->active_part);
+            if (all)
+                chain_emulation_disable (chain);
+            else
+                part_emulation_disable (chain, chain->active_part);
         }
         else if (strcmp (params[2], "exit") == 0)
         {
-            part_emulation_return (chain, chain->active_part);
-            part_emulation_disable (chain, chain->active_part);
+            if (all)
+            {
+                chain_emulation_return (chain);
+                chain_emulation_disable (chain);
+            }
+            else
+            {
+                part_emulation_return (chain, chain->active_part);
+                part_emulation_disable (chain, chain->active_part);
+            }
         }
         else if (strcmp (params[2], "status") == 0)
         {
@@ -169,24 +205,37 @@ cmd_bfin_run (urj_chain_t *chain, char *params[])
         }
         else if (strcmp (params[2], "singlestep") == 0)
         {
-            part_dbgstat_get (chain, chain->active_part);
+            int i, emuready;
+
+            if (all)
+            {
+                chain_dbgstat_get (chain);
+                emuready = 1;
+                for (i = 0; i < chain->parts->len; i++)
+                    if (part_is_bfin (chain, i)
+                        && !part_dbgstat_is_emuready (chain, i))
+                        emuready = 0;
+            }
+            else
+            {
+                part_dbgstat_get (chain, chain->active_part);
+                emuready = part_dbgstat_is_emuready (chain, chain->active_part);
+            }
 
-            if (!part_dbgstat_is_emuready (chain, chain->active_part))
+            if (!emuready)
             {
                 urj_error_set (URJ_ERROR_BFIN, "Run '%s' first",
-                               "bfin emulation enter");
+                               all ? "bfin emulation enter all"
+                               : "bfin emulation enter");
                 return URJ_STATUS_FAIL;
             }
 
             /* TODO  Allow an argument to specify how many single steps.  */
 
-            part_scan_select (chain, chain->active_part, DBGCTL_SCAN);
-            part_dbgctl_bit_set_esstep (chain, chain->active_part);
-            urj_tap_chain_shift_data_registers_mode (chain, 0, 1, URJ_CHAIN_EXITMODE_UPDATE);
-            part_emuir_set (chain, chain->active_part, INSN_RTE, URJ_CHAIN_EXITMODE_IDLE);
-            part_scan_select (chain, chain->active_part, DBGCTL_SCAN);
-            part_dbgctl_bit_clear_esstep (chain, chain->active_part);
-            urj_tap_chain_shift_data_registers_mode (chain, 0, 1, URJ_CHAIN_EXITMODE_UPDATE);
+            if (all)
+                chain_emulation_singlestep (chain);
+            else
+                part_emulation_singlestep (chain, chain->active_part);
         }
         else
         {
@@ -435,6 +484,74 @@ cmd_bfin_run (urj_chain_t *chain, char *params[])
 
         return execute_ret;
     }
+    else if (strcmp (params[1], "readmem") == 0
+             || strcmp (params[1], "writemem") == 0)
+    {
+        int write = params[1][0] == 'w';
+        long unsigned adr, len;
+        uint8_t *buf;
+        size_t cnt;
+        FILE *f;
+        int r = URJ_STATUS_OK;
+
+        if (num_params != 5)
+        {
+            urj_error_set (URJ_ERROR_BFIN,
+                           "'bfin %s' requires 3 parameters, not %d",
+                           params[1], num_params - 2);
+            return URJ_STATUS_FAIL;
+        }
+
+        if (urj_cmd_get_number (params[2], &adr) != URJ_STATUS_OK
+            || urj_cmd_get_number (params[3], &len) != URJ_STATUS_OK)
+            return URJ_STATUS_FAIL;
+
+        f = fopen (params[4], write ? FOPEN_R : FOPEN_W);
+        if (!f)
+        {
+            urj_error_IO_set (write ? _("Unable to open file `%s'")
+                              : _("Unable to create file `%s'"), params[4]);
+            return URJ_STATUS_FAIL;
+        }
+
+        buf = malloc (BFIN_MEM_BUF_SIZE);
+        if (buf == NULL)
+        {
+            fclose (f);
+            urj_error_set (URJ_ERROR_OUT_OF_MEMORY, "malloc(%d) fails",
+                           BFIN_MEM_BUF_SIZE);
+            return URJ_STATUS_FAIL;
+        }
+
+        while (len > 0 && r == URJ_STATUS_OK)
+        {
+            cnt = len < BFIN_MEM_BUF_SIZE ? len : BFIN_MEM_BUF_SIZE;
+            if (write)
+            {
+                cnt = fread (buf, 1, cnt, f);
+                if (cnt == 0)
+                    break;
+                r = part_mem_write (chain, chain->active_part, adr, buf, cnt);
+            }
+            else
+            {
+                r = part_mem_read (chain, chain->active_part, adr, buf, cnt);
+                if (r == URJ_STATUS_OK && fwrite (buf, 1, cnt, f) != cnt)
+                {
+                    urj_error_IO_set (_("Unable to write file `%s'"),
+                                      params[4]);
+                    r = URJ_STATUS_FAIL;
+                }
+            }
+            adr += cnt;
+            len -= cnt;
+        }
+
+        free (buf);
+        fclose (f);
+
+        return r;
+    }
     else if (strcmp (params[1], "reset") == 0)
     {
         int reset_what = 0;
@@ -499,15 +616,23 @@ cmd_bfin_help (void)
 {
     urj_log (URJ_LOG_LEVEL_NORMAL,
              _("Usage: %s INSTRUCTIONs\n"
+               "Usage: %s [all]\n"
                "Usage: %s\n"
-               "Usage: %s\n"
+               "Usage: %s ADDR LEN FILENAME\n"
                "Blackfin specific commands\n"
                "\n"
                "INSTRUCTIONs are a sequence of Blackfin encoded instructions,\n"
-               "double quoted assembly statements and [EMUDAT_IN]s\n"),
+               "double quoted assembly statements and [EMUDAT_IN]s\n"
+               "\n"
+               "'all' after an emulation subcommand other than status applies it to\n"
+               "all Blackfin parts in the chain together, e.g. both cores of a BF561.\n"
+               "\n"
+               "readmem and writemem copy LEN bytes of memory at ADDR to or from\n"
+               "FILENAME through the core, which has to be in emulation mode.\n"),
              "bfin execute",
              "bfin emulation enable|trigger|enter|return|disable|exit|singlestep|status",
-             "bfin reset [core|system]");
+             "bfin reset [core|system]",
+             "bfin readmem|writemem");
 }
 
 static void
@@ -519,6 +644,8 @@ cmd_bfin_complete (urj_chain_t *chain, char ***matches, size_t *match_cnt,
         "execute",
         "emulation",
         "reset",
+        "readmem",
+        "writemem",
     };
     static const char * const emu_cmds[] = {
         "enable",
@@ -550,6 +677,18 @@ cmd_bfin_complete (urj_chain_t *chain, char ***matches, size_t *match_cnt,
             urj_completion_mayben_add_matches (matches, match_cnt, text,
                                                text_len, emu_cmds);
         break;
+
+    case 3:
+        if (!strcmp (tokens[1], "emulation") && strcmp (tokens[2], "status"))
+            urj_completion_mayben_add_match (matches, match_cnt, text,
+                                             text_len, "all");
+        break;
+
+    case 4:
+        if (!strcmp (tokens[1], "readmem") || !strcmp (tokens[1], "writemem"))
+            urj_completion_mayben_add_file (matches, match_cnt, text,
+                                            text_len, false);
+        break;
     }
 }
 
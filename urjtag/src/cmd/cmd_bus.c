@@ -61,7 +61,7 @@ cmd_bus_run (urj_chain_t *chain, char *params[])
     if (urj_cmd_get_number (params[1], &n) != URJ_STATUS_OK)
         return URJ_STATUS_FAIL;
 
-    return urj_bus_buses_set (n);
+    return urj_bus_buses_set (chain, n);
 }
 
 static void
@@ -71,10 +71,10 @@ cmd_bus_complete (urj_chain_t *chain, char ***matches, size_t *match_cnt,
 {
     int i;
 
-    if (token_point != 1)
+    if (token_point != 1 || chain == NULL)
         return;
 
-    for (i = 0; i < urj_buses.len; ++i)
+    for (i = 0; i < chain->buses.len; ++i)
     {
         /* We assume you'll never have more than 15*10 buses */
         char num[16];
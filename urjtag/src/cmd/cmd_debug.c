@@ -55,6 +55,9 @@ cmd_debug_run (urj_chain_t *chain, char *params[])
             return URJ_STATUS_FAIL;
         }
         urj_log_state.level = new_level;
+        if (new_level < URJ_LOG_FLOOR)
+            urj_warning (_("messages below level '%s' are not compiled in\n"),
+                         urj_log_level_string (URJ_LOG_FLOOR));
 
         return URJ_STATUS_OK;
     }
@@ -29,6 +29,7 @@
 #include <urjtag/log.h>
 #include <urjtag/error.h>
 #include <urjtag/bus.h>
+#include <urjtag/chain.h>
 #include <urjtag/flash.h>
 #include <urjtag/cmd.h>
 
@@ -47,7 +48,7 @@ cmd_detectflash_run (urj_chain_t *chain, char *params[])
         return URJ_STATUS_FAIL;
     }
 
-    if (!urj_bus)
+    if (!chain->bus)
     {
         urj_error_set (URJ_ERROR_ILLEGAL_STATE, _("Bus missing"));
         return URJ_STATUS_FAIL;
@@ -56,7 +57,7 @@ cmd_detectflash_run (urj_chain_t *chain, char *params[])
     if (urj_cmd_get_number (params[1], &adr) != URJ_STATUS_OK)
         return URJ_STATUS_FAIL;
 
-    return urj_flash_detectflash (URJ_LOG_LEVEL_NORMAL, urj_bus, adr);
+    return urj_flash_detectflash (URJ_LOG_LEVEL_NORMAL, chain->bus, adr);
 }
 
 static void
@@ -30,6 +30,7 @@
 
 #include <urjtag/error.h>
 #include <urjtag/bus.h>
+#include <urjtag/chain.h>
 #include <urjtag/flash.h>
 
 #include <urjtag/cmd.h>
@@ -52,7 +53,7 @@ cmd_eraseflash_run (urj_chain_t *chain, char *params[])
 
     if (urj_cmd_test_cable (chain) != URJ_STATUS_OK)
         return URJ_STATUS_FAIL;
-    if (!urj_bus)
+    if (!chain->bus)
     {
         urj_error_set (URJ_ERROR_ILLEGAL_STATE, _("Bus driver missing"));
         return URJ_STATUS_FAIL;
@@ -62,7 +63,7 @@ cmd_eraseflash_run (urj_chain_t *chain, char *params[])
     if (urj_cmd_get_number (params[2], &number) != URJ_STATUS_OK)
         return URJ_STATUS_FAIL;
 
-    return urj_flasherase (urj_bus, adr, number);
+    return urj_flasherase (chain->bus, adr, number);
 }
 
 static void
@@ -31,6 +31,7 @@
 
 #include <urjtag/error.h>
 #include <urjtag/bus.h>
+#include <urjtag/chain.h>
 #include <urjtag/flash.h>
 
 #include <urjtag/cmd.h>
@@ -41,46 +42,60 @@ static int
 cmd_flashmem_run (urj_chain_t *chain, char *params[])
 {
     int msbin;
+    int diff;
     int noverify = 0;
     long unsigned adr = 0;
     FILE *f;
     int paramc = urj_cmd_params (params);
     int r;
 
-    if (paramc < 3)
+    /* "flashmem diff ADDR FILENAME" takes the arguments one further on */
+    diff = paramc > 1 && strcasecmp ("diff", params[1]) == 0;
+
+    if (paramc < 3 + diff)
     {
         urj_error_set (URJ_ERROR_SYNTAX,
                        "%s: #parameters should be >= %d, not %d",
-                       params[0], 3, urj_cmd_params (params));
+                       params[0], 3 + diff, urj_cmd_params (params));
         return URJ_STATUS_FAIL;
     }
 
-    if (!urj_bus)
+    if (!chain->bus)
     {
         urj_error_set (URJ_ERROR_ILLEGAL_STATE, _("Bus driver missing"));
         return URJ_STATUS_FAIL;
     }
 
-    msbin = strcasecmp ("msbin", params[1]) == 0;
-    if (!msbin && urj_cmd_get_number (params[1], &adr) != URJ_STATUS_OK)
+    msbin = strcasecmp ("msbin", params[1 + diff]) == 0;
+    if (msbin && diff)
+    {
+        urj_error_set (URJ_ERROR_SYNTAX,
+                       _("%s: diff is not supported for MS .bin files"),
+                       params[0]);
+        return URJ_STATUS_FAIL;
+    }
+    if (!msbin
+        && urj_cmd_get_number (params[1 + diff], &adr) != URJ_STATUS_OK)
         return URJ_STATUS_FAIL;
 
-    if (paramc > 3)
-        noverify = strcasecmp ("noverify", params[3]) == 0;
+    if (paramc > 3 + diff)
+        noverify = strcasecmp ("noverify", params[3 + diff]) == 0;
     else
         noverify = 0;
 
-    f = fopen (params[2], FOPEN_R);
+    f = fopen (params[2 + diff], FOPEN_R);
     if (!f)
     {
-        urj_error_IO_set (_("Unable to open file `%s'"), params[2]);
+        urj_error_IO_set (_("Unable to open file `%s'"), params[2 + diff]);
         return URJ_STATUS_FAIL;
     }
 
     if (msbin)
-        r = urj_flashmsbin (urj_bus, f, noverify);
+        r = urj_flashmsbin (chain->bus, f, noverify);
+    else if (diff)
+        r = urj_flashmem_diff (chain->bus, f, adr, noverify);
     else
-        r = urj_flashmem (urj_bus, f, adr, noverify);
+        r = urj_flashmem (chain->bus, f, adr, noverify);
 
     fclose (f);
 
@@ -93,17 +108,23 @@ cmd_flashmem_help (void)
     urj_log (URJ_LOG_LEVEL_NORMAL,
              _("Usage: %s ADDR FILENAME [noverify]\n"
                "Usage: %s FILENAME [noverify]\n"
+               "Usage: %s ADDR FILENAME [noverify]\n"
                "Program FILENAME content to flash memory.\n"
                "\n"
                "ADDR       target address for raw binary image\n"
                "FILENAME   name of the input file\n"
                "%-10s FILENAME is in MS .bin format (for WinCE)\n"
+               "%-10s read each block back first and skip the blocks that\n"
+               "           already hold the data, and the erase where they\n"
+               "           read back blank; only words that are not 0xFF\n"
+               "           are programmed\n"
                "%-10s if specified, verification is skipped\n"
                "\n"
                "ADDR could be in decimal or hexadecimal (prefixed with 0x) form.\n"
                "\n"
                "Supported Flash Memories:\n"),
-             "flashmem", "flashmem msbin", "msbin", "noverify");
+             "flashmem", "flashmem msbin", "flashmem diff", "msbin", "diff",
+             "noverify");
 
     urj_cmd_show_list (urj_flash_flash_drivers);
 }
@@ -113,9 +134,19 @@ cmd_flashmem_complete (urj_chain_t *chain, char ***matches, size_t *match_cnt,
                        char * const *tokens, const char *text, size_t text_len,
                        size_t token_point)
 {
+    /* after "diff", the address is the first argument */
+    if (token_point > 1 && strcasecmp (tokens[1], "diff") == 0)
+    {
+        if (token_point == 2)
+            return;
+        token_point--;
+    }
+
     switch (token_point)
     {
-    case 1: /* [addr|msbin] */
+    case 1: /* [addr|msbin|diff] */
+        urj_completion_mayben_add_match (matches, match_cnt, text, text_len, "msbin");
+        urj_completion_mayben_add_match (matches, match_cnt, text, text_len, "diff");
         break;
 
     case 2: /* filename */
@@ -0,0 +1,536 @@
+/*
+ * $Id$
+ *
+ * Copyright (C) 2026 UrJTAG contributors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA
+ * 02111-1307, USA.
+ *
+ */
+
+#include <sysdep.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <urjtag/error.h>
+#include <urjtag/log.h>
+#include <urjtag/chain.h>
+#include <urjtag/cable.h>
+#include <urjtag/part.h>
+#include <urjtag/tap.h>
+#include <urjtag/tap_register.h>
+#include <urjtag/flash.h>
+#ifdef ENABLE_SVF
+#include <urjtag/svf.h>
+#endif
+
+#include <urjtag/cmd.h>
+
+#include "cmd.h"
+
+/* A file read once and handed to all members of the gang */
+typedef struct
+{
+    const char *name;
+    char *buf;
+    size_t len;
+}
+gang_file_t;
+
+/* Arguments of a gang job, shared by all members */
+typedef struct
+{
+    char **params;
+    gang_file_t file;
+    long unsigned adr;
+    int msbin;
+    int diff;
+    int noverify;
+    int stop;
+    uint32_t ref_freq;
+}
+gang_args_t;
+
+static int
+gang_file_load (gang_file_t *file, const char *name)
+{
+    FILE *f;
+    long len;
+
+    file->name = name;
+    file->buf = NULL;
+    file->len = 0;
+
+#ifdef HAVE_FMEMOPEN
+    f = fopen (name, FOPEN_R);
+    if (f == NULL)
+    {
+        urj_error_IO_set (_("Unable to open file `%s'"), name);
+        return URJ_STATUS_FAIL;
+    }
+
+    if (fseek (f, 0, SEEK_END) != 0 || (len = ftell (f)) < 0
+        || fseek (f, 0, SEEK_SET) != 0)
+    {
+        urj_error_IO_set (_("Unable to read file `%s'"), name);
+        fclose (f);
+        return URJ_STATUS_FAIL;
+    }
+    if (len == 0)
+    {
+        urj_error_set (URJ_ERROR_INVALID, _("File `%s' is empty"), name);
+        fclose (f);
+        return URJ_STATUS_FAIL;
+    }
+
+    file->buf = malloc (len);
+    if (file->buf == NULL)
+    {
+        urj_error_set (URJ_ERROR_OUT_OF_MEMORY, "malloc(%ld) fails", len);
+        fclose (f);
+        return URJ_STATUS_FAIL;
+    }
+    if (fread (file->buf, 1, len, f) != (size_t) len)
+    {
+        urj_error_set (URJ_ERROR_FILEIO, _("Unable to read file `%s'"), name);
+        free (file->buf);
+        file->buf = NULL;
+        fclose (f);
+        return URJ_STATUS_FAIL;
+    }
+    file->len = len;
+    fclose (f);
+#endif
+
+    return URJ_STATUS_OK;
+}
+
+/* Each member reads the file through a stream of its own */
+static FILE *
+gang_file_open (const gang_file_t *file)
+{
+    FILE *f;
+
+#ifdef HAVE_FMEMOPEN
+    f = fmemopen (file->buf, file->len, FOPEN_R);
+#else
+    f = fopen (file->name, FOPEN_R);
+#endif
+    if (f == NULL)
+        urj_error_IO_set (_("Unable to open file `%s'"), file->name);
+
+    return f;
+}
+
+static int
+gang_report (urj_chain_t *chain, urj_chain_job_t *jobs)
+{
+    int i, failed = 0;
+
+    for (i = 0; i <= chain->gang_len; i++)
+    {
+        if (jobs[i].result == URJ_STATUS_OK)
+            urj_log (URJ_LOG_LEVEL_NORMAL, _("target %d (%s): ok\n"), i,
+                     jobs[i].chain->cable->driver->name);
+        else
+        {
+            urj_log (URJ_LOG_LEVEL_NORMAL, _("target %d (%s): failed: %s\n"),
+                     i, jobs[i].chain->cable->driver->name,
+                     jobs[i].error.msg);
+            failed++;
+        }
+    }
+
+    if (failed)
+    {
+        urj_error_set (URJ_ERROR_ILLEGAL_STATE,
+                       _("%d of %d targets failed"), failed,
+                       chain->gang_len + 1);
+        return URJ_STATUS_FAIL;
+    }
+
+    return URJ_STATUS_OK;
+}
+
+static int
+gang_run (urj_chain_t *chain, int (*run) (urj_chain_t *, void *),
+          gang_args_t *args)
+{
+    urj_chain_job_t *jobs;
+    int i, r, ran;
+
+    jobs = calloc (chain->gang_len + 1, sizeof *jobs);
+    if (jobs == NULL)
+    {
+        urj_error_set (URJ_ERROR_OUT_OF_MEMORY, "calloc(%d,%zd) fails",
+                       chain->gang_len + 1, sizeof *jobs);
+        return URJ_STATUS_FAIL;
+    }
+
+    for (i = 0; i <= chain->gang_len; i++)
+    {
+        jobs[i].run = run;
+        jobs[i].data = args;
+    }
+
+    ran = urj_tap_chain_gang_run (chain, jobs);
+    urj_error_reset ();
+    r = gang_report (chain, jobs);
+    if (ran != URJ_STATUS_OK && r == URJ_STATUS_OK)
+    {
+        urj_error_set (URJ_ERROR_ILLEGAL_STATE, _("gang jobs failed"));
+        r = URJ_STATUS_FAIL;
+    }
+
+    free (jobs);
+
+    return r;
+}
+
+static int
+gang_detect_job (urj_chain_t *chain, void *data)
+{
+    return urj_tap_detect (chain, 0);
+}
+
+static int
+gang_cmd_job (urj_chain_t *chain, void *data)
+{
+    const gang_args_t *args = data;
+    char **params;
+    int n, r;
+
+    /* commands may reorder their parameters, so each gets a copy */
+    n = urj_cmd_params (args->params);
+    params = malloc ((n + 1) * sizeof *params);
+    if (params == NULL)
+    {
+        urj_error_set (URJ_ERROR_OUT_OF_MEMORY, "malloc(%zd) fails",
+                       (n + 1) * sizeof *params);
+        return URJ_STATUS_FAIL;
+    }
+    memcpy (params, args->params, (n + 1) * sizeof *params);
+
+    r = urj_cmd_run (chain, params);
+
+    free (params);
+
+    return r;
+}
+
+static int
+gang_flashmem_job (urj_chain_t *chain, void *data)
+{
+    const gang_args_t *args = data;
+    FILE *f;
+    int r;
+
+    if (!chain->bus)
+    {
+        urj_error_set (URJ_ERROR_ILLEGAL_STATE, _("Bus driver missing"));
+        return URJ_STATUS_FAIL;
+    }
+
+    f = gang_file_open (&args->file);
+    if (f == NULL)
+        return URJ_STATUS_FAIL;
+
+    if (args->msbin)
+        r = urj_flashmsbin (chain->bus, f, args->noverify);
+    else if (args->diff)
+        r = urj_flashmem_diff (chain->bus, f, args->adr, args->noverify);
+    else
+        r = urj_flashmem (chain->bus, f, args->adr, args->noverify);
+
+    fclose (f);
+
+    return r;
+}
+
+#ifdef ENABLE_SVF
+static int
+gang_svf_job (urj_chain_t *chain, void *data)
+{
+    const gang_args_t *args = data;
+    FILE *f;
+    int r;
+
+    f = gang_file_open (&args->file);
+    if (f == NULL)
+        return URJ_STATUS_FAIL;
+
+    r = urj_svf_run (chain, f, args->stop, args->ref_freq);
+
+    fclose (f);
+
+    if (r == URJ_STATUS_OK && urj_svf_get_mismatches () > 0)
+    {
+        urj_error_set (URJ_ERROR_INVALID, _("%d TDO mismatches"),
+                       urj_svf_get_mismatches ());
+        return URJ_STATUS_FAIL;
+    }
+
+    return r;
+}
+#endif
+
+/* All members must hold the same parts as the first one */
+static int
+gang_compare (urj_chain_t *chain)
+{
+    int i, j;
+
+    if (chain->parts == NULL)
+    {
+        urj_error_set (URJ_ERROR_NO_PART, _("target %d: no parts"), 0);
+        return URJ_STATUS_FAIL;
+    }
+
+    for (i = 0; i < chain->gang_len; i++)
+    {
+        const urj_parts_t *parts = chain->gang[i]->parts;
+        int differs = parts == NULL || parts->len != chain->parts->len;
+
+        for (j = 0; !differs && j < parts->len; j++)
+            differs = urj_tap_register_compare (parts->parts[j]->id,
+                                                chain->parts->parts[j]->id);
+        if (differs)
+        {
+            urj_error_set (URJ_ERROR_INVALID,
+                           _("target %d: chain differs from target %d"),
+                           i + 1, 0);
+            return URJ_STATUS_FAIL;
+        }
+    }
+
+    return URJ_STATUS_OK;
+}
+
+static int
+cmd_gang_run (urj_chain_t *chain, char *params[])
+{
+    gang_args_t args;
+    int paramc = urj_cmd_params (params);
+    int i, r;
+
+    if (paramc < 2)
+    {
+        urj_error_set (URJ_ERROR_SYNTAX,
+                       "%s: #parameters should be >= %d, not %d",
+                       params[0], 2, paramc);
+        return URJ_STATUS_FAIL;
+    }
+
+    if (urj_cmd_test_cable (chain) != URJ_STATUS_OK)
+        return URJ_STATUS_FAIL;
+
+    memset (&args, 0, sizeof args);
+
+    if (strcasecmp (params[1], "add") == 0)
+    {
+        if (paramc < 3)
+        {
+            urj_error_set (URJ_ERROR_SYNTAX,
+                           "%s: #parameters should be >= %d, not %d",
+                           params[0], 3, paramc);
+            return URJ_STATUS_FAIL;
+        }
+        if (urj_tap_chain_gang_add (chain, params[2], &params[3]) == NULL)
+            return URJ_STATUS_FAIL;
+        urj_log (URJ_LOG_LEVEL_NORMAL, _("target %d (%s) added\n"),
+                 chain->gang_len, params[2]);
+        return URJ_STATUS_OK;
+    }
+
+    if (strcasecmp (params[1], "list") == 0)
+    {
+        for (i = 0; i <= chain->gang_len; i++)
+        {
+            urj_chain_t *c = i ? chain->gang[i - 1] : chain;
+
+            urj_log (URJ_LOG_LEVEL_NORMAL, _("target %d (%s): %d parts\n"),
+                     i, c->cable->driver->name,
+                     c->parts ? c->parts->len : 0);
+        }
+        return URJ_STATUS_OK;
+    }
+
+    if (strcasecmp (params[1], "free") == 0)
+    {
+        urj_tap_chain_gang_free (chain);
+        return URJ_STATUS_OK;
+    }
+
+    if (strcasecmp (params[1], "detect") == 0)
+    {
+        if (gang_run (chain, gang_detect_job, &args) != URJ_STATUS_OK)
+            return URJ_STATUS_FAIL;
+        return gang_compare (chain);
+    }
+
+    if (strcasecmp (params[1], "run") == 0)
+    {
+        if (paramc < 3)
+        {
+            urj_error_set (URJ_ERROR_SYNTAX,
+                           "%s: #parameters should be >= %d, not %d",
+                           params[0], 3, paramc);
+            return URJ_STATUS_FAIL;
+        }
+        args.params = &params[2];
+        return gang_run (chain, gang_cmd_job, &args);
+    }
+
+    if (strcasecmp (params[1], "flashmem") == 0)
+    {
+        int d;
+
+        args.diff = paramc > 2 && strcasecmp ("diff", params[2]) == 0;
+        d = args.diff;
+        if (paramc < 4 + d)
+        {
+            urj_error_set (URJ_ERROR_SYNTAX,
+                           "%s: #parameters should be >= %d, not %d",
+                           params[0], 4 + d, paramc);
+            return URJ_STATUS_FAIL;
+        }
+        args.msbin = !d && strcasecmp ("msbin", params[2]) == 0;
+        if (!args.msbin
+            && urj_cmd_get_number (params[2 + d], &args.adr) != URJ_STATUS_OK)
+            return URJ_STATUS_FAIL;
+        args.noverify = paramc > 4 + d
+            && strcasecmp ("noverify", params[4 + d]) == 0;
+
+        if (gang_file_load (&args.file, params[3 + d]) != URJ_STATUS_OK)
+            return URJ_STATUS_FAIL;
+        r = gang_run (chain, gang_flashmem_job, &args);
+        free (args.file.buf);
+        return r;
+    }
+
+#ifdef ENABLE_SVF
+    if (strcasecmp (params[1], "svf") == 0)
+    {
+        if (paramc < 3)
+        {
+            urj_error_set (URJ_ERROR_SYNTAX,
+                           "%s: #parameters should be >= %d, not %d",
+                           params[0], 3, paramc);
+            return URJ_STATUS_FAIL;
+        }
+        for (i = 3; i < paramc; i++)
+        {
+            if (strcasecmp (params[i], "stop") == 0)
+                args.stop = 1;
+            else if (strncasecmp (params[i], "ref_freq=", 9) == 0)
+                args.ref_freq = strtol (params[i] + 9, NULL, 10);
+            else
+            {
+                urj_error_set (URJ_ERROR_SYNTAX, "%s: unknown option '%s'",
+                               params[0], params[i]);
+                return URJ_STATUS_FAIL;
+            }
+        }
+
+        if (gang_file_load (&args.file, params[2]) != URJ_STATUS_OK)
+            return URJ_STATUS_FAIL;
+        r = gang_run (chain, gang_svf_job, &args);
+        free (args.file.buf);
+        return r;
+    }
+#endif
+
+    urj_error_set (URJ_ERROR_SYNTAX, "%s: unknown action '%s'",
+                   params[0], params[1]);
+    return URJ_STATUS_FAIL;
+}
+
+static void
+cmd_gang_help (void)
+{
+    urj_log (URJ_LOG_LEVEL_NORMAL,
+             _("Usage: %s add DRIVER [DRIVER_OPTS]\n"
+               "Usage: %s list|detect|free\n"
+               "Usage: %s run COMMAND [ARGS]\n"
+               "Usage: %s flashmem [diff] ADDR|msbin FILENAME [noverify]\n"
+               "Usage: %s svf FILE [stop] [ref_freq=<frequency>]\n"
+               "Program several identical targets at once.\n"
+               "\n"
+               "The current cable is target 0 of the gang; \"add\" connects a\n"
+               "further target on another cable, with the options of the \"cable\"\n"
+               "command. This may be another channel of the same adapter, e.g.\n"
+               "\"add ft2232 interface=1\" for the second MPSSE channel of an\n"
+               "FT2232H or FT4232H. \"detect\" detects the chain of every target and checks\n"
+               "that all chains hold the same parts. \"run\" runs COMMAND on every\n"
+               "target, e.g. \"run initbus ...\" or \"run stapl ...\".\n"
+               "\"flashmem\" and \"svf\" read FILE once and then program all\n"
+               "targets from it, like the commands of the same name.\n"
+               "\"flashmem diff\" leaves the blocks alone that already hold the data.\n"
+               "\n"
+               "All targets run at the same time, each on a thread of its own.\n"
+               "Each target is reported on its own; the command fails if any\n"
+               "target fails.\n"),
+             "gang", "gang", "gang", "gang", "gang");
+}
+
+static void
+cmd_gang_complete (urj_chain_t *chain, char ***matches, size_t *match_cnt,
+                   char * const *tokens, const char *text, size_t text_len,
+                   size_t token_point)
+{
+    static const char * const actions[] = {
+        "add",
+        "list",
+        "detect",
+        "free",
+        "run",
+        "flashmem",
+#ifdef ENABLE_SVF
+        "svf",
+#endif
+    };
+
+    switch (token_point)
+    {
+    case 1:
+        urj_completion_mayben_add_matches (matches, match_cnt, text,
+                                           text_len, actions);
+        break;
+
+    case 2:
+        if (strcasecmp (tokens[1], "svf") == 0)
+            urj_completion_mayben_add_file (matches, match_cnt, text,
+                                            text_len, false);
+        break;
+
+    case 3:
+    case 4:
+        if (strcasecmp (tokens[1], "flashmem") == 0
+            && (token_point == 3) == (strcasecmp (tokens[2], "diff") != 0))
+            urj_completion_mayben_add_file (matches, match_cnt, text,
+                                            text_len, false);
+        break;
+    }
+}
+
+const urj_cmd_t urj_cmd_gang = {
+    "gang",
+    N_("program several identical targets at once"),
+    cmd_gang_help,
+    cmd_gang_run,
+    cmd_gang_complete,
+};
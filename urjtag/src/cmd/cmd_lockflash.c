@@ -28,6 +28,7 @@
 
 #include <urjtag/error.h>
 #include <urjtag/bus.h>
+#include <urjtag/chain.h>
 #include <urjtag/flash.h>
 
 #include <urjtag/cmd.h>
@@ -51,7 +52,7 @@ cmd_lockflash_run (urj_chain_t *chain, char *params[])
 
     if (urj_cmd_test_cable (chain) != URJ_STATUS_OK)
         return URJ_STATUS_FAIL;
-    if (!urj_bus)
+    if (!chain->bus)
     {
         urj_error_set (URJ_ERROR_ILLEGAL_STATE, _("Bus driver missing"));
         return URJ_STATUS_FAIL;
@@ -64,7 +65,7 @@ cmd_lockflash_run (urj_chain_t *chain, char *params[])
     if (!strcmp(params[0], "unlockflash"))
         unlock = 1;
 
-    return urj_flashlock (urj_bus, adr, number, unlock);
+    return urj_flashlock (chain->bus, adr, number, unlock);
 }
 
 static void
@@ -29,6 +29,7 @@
 
 #include <urjtag/error.h>
 #include <urjtag/bus.h>
+#include <urjtag/chain.h>
 
 #include <urjtag/cmd.h>
 
@@ -52,12 +53,12 @@ cmd_peek_run (urj_chain_t *chain, char *params[])
         return URJ_STATUS_FAIL;
     }
 
-    if (!urj_bus)
+    if (!chain->bus)
     {
         urj_error_set (URJ_ERROR_ILLEGAL_STATE, _("Bus missing"));
         return URJ_STATUS_FAIL;
     }
-    if (!urj_bus->driver)
+    if (!chain->bus->driver)
     {
         urj_error_set (URJ_ERROR_ILLEGAL_STATE, _("Bus driver missing"));
         return URJ_STATUS_FAIL;
@@ -68,9 +69,9 @@ cmd_peek_run (urj_chain_t *chain, char *params[])
         if (urj_cmd_get_number (params[j], &adr) != URJ_STATUS_OK)
             return URJ_STATUS_FAIL;
 
-        URJ_BUS_PREPARE (urj_bus);
-        URJ_BUS_AREA (urj_bus, adr, &area);
-        val = URJ_BUS_READ (urj_bus, adr);
+        URJ_BUS_PREPARE (chain->bus);
+        URJ_BUS_AREA (chain->bus, adr, &area);
+        val = URJ_BUS_READ (chain->bus, adr);
 
         switch (area.width)
         {
@@ -134,26 +135,26 @@ cmd_poke_run (urj_chain_t *chain, char *params[])
         return URJ_STATUS_FAIL;
     }
 
-    if (!urj_bus)
+    if (!chain->bus)
     {
         urj_error_set (URJ_ERROR_ILLEGAL_STATE, _("Bus missing"));
         return URJ_STATUS_FAIL;
     }
-    if (!urj_bus->driver)
+    if (!chain->bus->driver)
     {
         urj_error_set (URJ_ERROR_ILLEGAL_STATE, _("Bus driver missing"));
         return URJ_STATUS_FAIL;
     }
 
-    URJ_BUS_PREPARE (urj_bus);
+    URJ_BUS_PREPARE (chain->bus);
 
     while (k < pars)
     {
         if (urj_cmd_get_number (params[k], &adr) != URJ_STATUS_OK
             || urj_cmd_get_number (params[k + 1], &val) != URJ_STATUS_OK)
             return URJ_STATUS_FAIL;
-        URJ_BUS_AREA (urj_bus, adr, &area);
-        URJ_BUS_WRITE (urj_bus, adr, val);
+        URJ_BUS_AREA (chain->bus, adr, &area);
+        URJ_BUS_WRITE (chain->bus, adr, val);
         k += 2;
     }
 
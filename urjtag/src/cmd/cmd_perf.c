@@ -0,0 +1,145 @@
+/*
+ * $Id$
+ *
+ * Copyright (C) 2026 UrJTAG contributors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA
+ * 02111-1307, USA.
+ *
+ */
+
+#include <sysdep.h>
+
+#include <string.h>
+
+#include <urjtag/error.h>
+#include <urjtag/log.h>
+#include <urjtag/chain.h>
+#include <urjtag/cable.h>
+
+#include <urjtag/cmd.h>
+
+#include "cmd.h"
+
+static double
+ratio (uint64_t a, uint64_t b)
+{
+    return b != 0 ? (double) a / b : 0.0;
+}
+
+static void
+cmd_perf_show (const urj_cable_perf_t *p)
+{
+    urj_log (URJ_LOG_LEVEL_NORMAL,
+             _("flushes:            %llu (%llu optional)\n"),
+             (unsigned long long) p->flushes,
+             (unsigned long long) p->optional_flushes);
+    urj_log (URJ_LOG_LEVEL_NORMAL,
+             _("queued items:       %llu (high-water mark %d)\n"),
+             (unsigned long long) p->queued, p->queue_high_water);
+    urj_log (URJ_LOG_LEVEL_NORMAL,
+             _("flushed items:      %llu in %llu driver calls (%.2f per call)\n"),
+             (unsigned long long) p->flushed_items,
+             (unsigned long long) p->flush_batches,
+             ratio (p->flushed_items, p->flush_batches));
+    urj_log (URJ_LOG_LEVEL_NORMAL,
+             _("cx commands:        %llu in %llu transfers (%.2f per transfer)\n"),
+             (unsigned long long) p->cx_cmds,
+             (unsigned long long) p->cx_xfers,
+             ratio (p->cx_cmds, p->cx_xfers));
+    urj_log (URJ_LOG_LEVEL_NORMAL,
+             _("USB writes:         %llu (%llu bytes)\n"),
+             (unsigned long long) p->usb_writes,
+             (unsigned long long) p->usb_write_bytes);
+    urj_log (URJ_LOG_LEVEL_NORMAL,
+             _("USB reads:          %llu (%llu bytes), %.3f s waiting\n"),
+             (unsigned long long) p->usb_reads,
+             (unsigned long long) p->usb_read_bytes, p->usb_read_time);
+}
+
+static int
+cmd_perf_run (urj_chain_t *chain, char *params[])
+{
+    int n = urj_cmd_params (params);
+
+    if (n > 2)
+    {
+        urj_error_set (URJ_ERROR_SYNTAX,
+                       "%s: #parameters should be <= %d, not %d",
+                       params[0], 2, n);
+        return URJ_STATUS_FAIL;
+    }
+
+    if (urj_cmd_test_cable (chain) != URJ_STATUS_OK)
+        return URJ_STATUS_FAIL;
+
+    if (n == 1 || strcasecmp (params[1], "show") == 0)
+    {
+        urj_cable_perf_t perf;
+
+        urj_tap_cable_get_perf (chain->cable, &perf);
+        cmd_perf_show (&perf);
+        return URJ_STATUS_OK;
+    }
+
+    if (strcasecmp (params[1], "reset") == 0)
+    {
+        urj_tap_cable_perf_reset (chain->cable);
+        return URJ_STATUS_OK;
+    }
+
+    urj_error_set (URJ_ERROR_SYNTAX, "%s: unknown action '%s'",
+                   params[0], params[1]);
+    return URJ_STATUS_FAIL;
+}
+
+static void
+cmd_perf_help (void)
+{
+    urj_log (URJ_LOG_LEVEL_NORMAL,
+             _("Usage: %s [show|reset]\n"
+               "Show or reset the performance counters of the cable.\n"
+               "\n"
+               "The counters tell how many flushes, queue items, USB transfers and\n"
+               "round trips the commands since the last reset needed, and how long\n"
+               "the host waited for USB reads. Many reads per byte of payload\n"
+               "indicate a round-trip bound workload.\n"),
+             "perf");
+}
+
+static void
+cmd_perf_complete (urj_chain_t *chain, char ***matches, size_t *match_cnt,
+                   char * const *tokens, const char *text, size_t text_len,
+                   size_t token_point)
+{
+    static const char * const actions[] = {
+        "show",
+        "reset",
+    };
+
+    if (token_point != 1)
+        return;
+
+    urj_completion_mayben_add_matches (matches, match_cnt, text, text_len,
+                                       actions);
+}
+
+const urj_cmd_t urj_cmd_perf = {
+    "perf",
+    N_("show or reset cable performance counters"),
+    cmd_perf_help,
+    cmd_perf_run,
+    cmd_perf_complete,
+};
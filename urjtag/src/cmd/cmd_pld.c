@@ -144,7 +144,10 @@ cmd_pld_help (void)
                "Usage: %s status\n"
                "Usage: %s readreg REG\n"
                "Usage: %s writereg REG VALUE\n"
-               "Configure FPGA from PLDFILE, query status, read and write registers.\n"),
+               "Configure FPGA from PLDFILE, query status, read and write registers.\n"
+               "\n"
+               "PLDFILE is a .bit file for Xilinx Spartan 3/6, Virtex 4 and Lattice\n"
+               "ECP5, an .rbf file for Altera/Intel FPGAs.\n"),
              "pld", "pld", "pld", "pld", "pld");
 }
 
@@ -205,22 +205,22 @@ cmd_print_run (urj_chain_t *chain, char *params[])
             urj_part_print (URJ_LOG_LEVEL_NORMAL,
                             chain->parts->parts[chain->active_part]);
         }
-        if (urj_bus != NULL)
+        if (chain->bus != NULL)
         {
             int i;
             uint64_t a;
             urj_bus_area_t area;
 
-            for (i = 0; i < urj_buses.len; i++)
-                if (urj_buses.buses[i] == urj_bus)
+            for (i = 0; i < chain->buses.len; i++)
+                if (chain->buses.buses[i] == chain->bus)
                     break;
             urj_log (URJ_LOG_LEVEL_NORMAL, _("\nActive bus:\n*%d: "), i);
-            URJ_BUS_PRINTINFO (URJ_LOG_LEVEL_NORMAL, urj_bus);
+            URJ_BUS_PRINTINFO (URJ_LOG_LEVEL_NORMAL, chain->bus);
 
             for (a = 0; a < UINT64_C (0x100000000);
                  a = area.start + area.length)
             {
-                r = URJ_BUS_AREA (urj_bus, a, &area);
+                r = URJ_BUS_AREA (chain->bus, a, &area);
                 if (r != URJ_STATUS_OK)
                 {
                     urj_log (URJ_LOG_LEVEL_NORMAL,
@@ -255,13 +255,13 @@ cmd_print_run (urj_chain_t *chain, char *params[])
         return URJ_STATUS_OK;
     }
 
-    for (i = 0; i < urj_buses.len; i++)
+    for (i = 0; i < chain->buses.len; i++)
     {
-        if (urj_buses.buses[i] == urj_bus)
+        if (chain->buses.buses[i] == chain->bus)
             urj_log (URJ_LOG_LEVEL_NORMAL, _("*%d: "), i);
         else
             urj_log (URJ_LOG_LEVEL_NORMAL, _("%d: "), i);
-        URJ_BUS_PRINTINFO (URJ_LOG_LEVEL_NORMAL, urj_buses.buses[i]);
+        URJ_BUS_PRINTINFO (URJ_LOG_LEVEL_NORMAL, chain->buses.buses[i]);
     }
 
     return URJ_STATUS_OK;
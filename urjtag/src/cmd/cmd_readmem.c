@@ -31,6 +31,7 @@
 
 #include <urjtag/error.h>
 #include <urjtag/bus.h>
+#include <urjtag/chain.h>
 
 #include <urjtag/cmd.h>
 
@@ -52,7 +53,7 @@ cmd_readmem_run (urj_chain_t *chain, char *params[])
         return URJ_STATUS_FAIL;
     }
 
-    if (!urj_bus)
+    if (!chain->bus)
     {
         urj_error_set (URJ_ERROR_ILLEGAL_STATE, _("Bus missing"));
         return URJ_STATUS_FAIL;
@@ -68,7 +69,7 @@ cmd_readmem_run (urj_chain_t *chain, char *params[])
         urj_error_IO_set (_("Unable to create file `%s'"), params[3]);
         return URJ_STATUS_FAIL;
     }
-    r = urj_bus_readmem (urj_bus, f, adr, len);
+    r = urj_bus_readmem (chain->bus, f, adr, len);
     fclose (f);
 
     return r;
@@ -0,0 +1,98 @@
+/*
+ * $Id$
+ *
+ * Copyright (C) 2026 UrJTAG contributors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA
+ * 02111-1307, USA.
+ *
+ */
+
+#include <sysdep.h>
+
+#include <string.h>
+
+#include <urjtag/error.h>
+#include <urjtag/log.h>
+#include <urjtag/trace.h>
+
+#include <urjtag/cmd.h>
+
+#include "cmd.h"
+
+static int
+cmd_trace_run (urj_chain_t *chain, char *params[])
+{
+    switch (urj_cmd_params (params))
+    {
+    case 1:
+        urj_log (URJ_LOG_LEVEL_NORMAL, _("Tracing is %s\n"),
+                 URJ_TRACE_ON () ? _("on") : _("off"));
+        return URJ_STATUS_OK;
+
+    case 2:
+        if (strcasecmp (params[1], "off") == 0)
+        {
+            urj_trace_stop ();
+            return URJ_STATUS_OK;
+        }
+        return urj_trace_start (params[1]);
+
+    default:
+        urj_error_set (URJ_ERROR_SYNTAX,
+                       "%s: #parameters should be <= %d, not %d",
+                       params[0], 2, urj_cmd_params (params));
+        return URJ_STATUS_FAIL;
+    }
+}
+
+static void
+cmd_trace_help (void)
+{
+    urj_log (URJ_LOG_LEVEL_NORMAL,
+             _("Usage: %s FILENAME\n"
+               "Usage: %s off\n"
+               "Record a trace of JTAG operations in FILENAME, or stop recording.\n"
+               "\n"
+               "The trace holds timestamped events for cable queue and flushes, USB\n"
+               "transfers, TAP state changes, bus accesses and flash erase, program\n"
+               "and verify. It is written in the Chrome trace-event JSON format, which\n"
+               "trace viewers like chrome://tracing or Perfetto open directly.\n"
+               "\n"
+               "Tracing can also be started with the environment variable URJ_TRACE\n"
+               "set to the name of the trace file.\n"),
+             "trace", "trace");
+}
+
+static void
+cmd_trace_complete (urj_chain_t *chain, char ***matches, size_t *match_cnt,
+                    char * const *tokens, const char *text, size_t text_len,
+                    size_t token_point)
+{
+    if (token_point != 1)
+        return;
+
+    urj_completion_mayben_add_match (matches, match_cnt, text, text_len,
+                                     "off");
+    urj_completion_mayben_add_file (matches, match_cnt, text, text_len, false);
+}
+
+const urj_cmd_t urj_cmd_trace = {
+    "trace",
+    N_("record a trace of JTAG operations"),
+    cmd_trace_help,
+    cmd_trace_run,
+    cmd_trace_complete,
+};
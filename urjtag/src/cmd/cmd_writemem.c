@@ -29,6 +29,7 @@
 
 #include <urjtag/error.h>
 #include <urjtag/bus.h>
+#include <urjtag/chain.h>
 
 #include <urjtag/cmd.h>
 
@@ -50,7 +51,7 @@ cmd_writemem_run (urj_chain_t *chain, char *params[])
         return URJ_STATUS_FAIL;
     }
 
-    if (!urj_bus)
+    if (!chain->bus)
     {
         urj_error_set (URJ_ERROR_ILLEGAL_STATE, _("Bus missing"));
         return URJ_STATUS_FAIL;
@@ -66,7 +67,7 @@ cmd_writemem_run (urj_chain_t *chain, char *params[])
         urj_error_IO_set (_("Unable to open file `%s'"), params[3]);
         return URJ_STATUS_FAIL;
     }
-    r = urj_bus_writemem (urj_bus, f, adr, len);
+    r = urj_bus_writemem (chain->bus, f, adr, len);
     fclose (f);
 
     return r;
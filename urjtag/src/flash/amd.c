@@ -170,37 +170,31 @@ amdstatus29 (urj_flash_cfi_array_t *cfi_array, uint32_t adr,
 
 
 #if 1
-/*
- * second implementation: see [1], page 30
- */
+/* urj_flash_poll() condition: DQ6 stopped toggling */
 static int
-amdstatus (urj_flash_cfi_array_t *cfi_array, uint32_t adr, int data)
+amd_toggle_done (const uint32_t *prev, uint32_t status, const void *arg)
 {
-    urj_bus_t *bus = cfi_array->bus;
-
-    int timeout;
     uint32_t togglemask = ((1 << 6) << 16) + (1 << 6);  /* DQ 6 */
-    /*  int dq5mask = ((1 << 5) << 16) + (1 << 5); DQ5 */
 
-    for (timeout = 0; timeout < 7000; timeout++)
-    {
-        uint32_t data1 = URJ_BUS_READ (bus, adr);
-        uint32_t data2 = URJ_BUS_READ (bus, adr);
+    urj_log (URJ_LOG_LEVEL_DEBUG, "amdstatus: %04lX/%04lX\n",
+             (long unsigned) (prev ? *prev : 0), (long unsigned) status);
 
-        urj_log (URJ_LOG_LEVEL_DEBUG,
-                 "amdstatus %d: %04lX/%04lX   %04lX/%04lX \n",
-                 timeout, (long unsigned) data1, (long unsigned) data2,
-                 (long unsigned) (data1 & togglemask),
-                 (long unsigned) (data2 & togglemask));
-        if ((data1 & togglemask) == (data2 & togglemask))
-            return URJ_STATUS_OK;
+    return prev != NULL && (*prev & togglemask) == (status & togglemask);
+}
 
-        /*    if ( (data1 & dq5mask) != 0 )   TODO */
-        /*      return URJ_STATUS_OK; */
-        urj_log (URJ_LOG_LEVEL_DEBUG, "amdstatus %d: %04lX/%04lX\n",
-                 timeout, (long unsigned)data1, (long unsigned)data2);
-        usleep (100);
-    }
+/*
+ * second implementation: see [1], page 30
+ */
+static int
+amdstatus (urj_flash_cfi_array_t *cfi_array, uint32_t adr, int data,
+           urj_flash_op_t op)
+{
+    uint32_t status;
+    /*  int dq5mask = ((1 << 5) << 16) + (1 << 5); DQ5 TODO */
+
+    if (urj_flash_poll (cfi_array, adr, op, amd_toggle_done, NULL, &status)
+        == URJ_STATUS_OK)
+        return URJ_STATUS_OK;
 
     urj_error_set (URJ_ERROR_FLASH, "hardware failure");
     return URJ_STATUS_FAIL;
@@ -216,7 +210,8 @@ amdstatus (urj_flash_cfi_array_t *cfi_array, uint32_t adr, int data)
  * second implementation: see [1], page 30
  */
 static int
-amdstatus (urj_flash_cfi_array_t *cfi_array, uint32_t adr, int data)
+amdstatus (urj_flash_cfi_array_t *cfi_array, uint32_t adr, int data,
+           urj_flash_op_t op)
 {
     urj_bus_t *bus = cfi_array->bus;
     int o = amd_flash_address_shift (cfi_array);
@@ -445,7 +440,8 @@ amd_flash_erase_block (urj_flash_cfi_array_t *cfi_array, uint32_t adr)
     URJ_BUS_WRITE (bus, cfi_array->address + (0x02aa << o), 0x00550055);
     URJ_BUS_WRITE (bus, adr, 0x00300030);
 
-    if (amdstatus (cfi_array, adr, 0xffff) == URJ_STATUS_OK)
+    if (amdstatus (cfi_array, adr, 0xffff, URJ_FLASH_OP_ERASE)
+        == URJ_STATUS_OK)
     {
         urj_log (URJ_LOG_LEVEL_NORMAL, "flash_erase_block 0x%08lX DONE\n",
                  (long unsigned) adr);
@@ -493,41 +489,48 @@ amd_flash_program_single (urj_flash_cfi_array_t *cfi_array, uint32_t adr,
     URJ_BUS_WRITE (bus, cfi_array->address + (0x0555 << o), 0x00A000A0);
 
     URJ_BUS_WRITE (bus, adr, data);
-    status = amdstatus (cfi_array, adr, data);
+    status = amdstatus (cfi_array, adr, data, URJ_FLASH_OP_WRITE);
     /*      amd_flash_read_array(ps); */
 
     return status;
 }
 
+/* urj_flash_poll() condition: DQ7 of every chip shows the data written, or
+   DQ5 a timeout in a chip that is not done yet */
+static int
+amd_dq7_done (const uint32_t *prev, uint32_t status, const void *arg)
+{
+    uint32_t bit7 = *(const uint32_t *) arg;
+    const uint32_t dq7mask = ((1 << 7) << 16) + (1 << 7);
+    uint32_t busy = (status ^ bit7) & dq7mask;
+
+    urj_log (URJ_LOG_LEVEL_DEBUG,
+             "amd_program_buffer_status: %04lX (%04lX) = %04lX\n",
+             (long unsigned) status, (long unsigned) (status & dq7mask),
+             (long unsigned) bit7);
+    if (busy == 0)
+        return 1;
+    if ((status & (busy >> 2)) != 0)    /* DQ5 of a busy chip */
+        return -1;
+    return 0;
+}
+
 static int
 amd_program_buffer_status (urj_flash_cfi_array_t *cfi_array, uint32_t adr,
                            uint32_t data)
 {
-    /* NOTE: Status polling according to [3], Figure 1.
-       The current method for status polling is not compatible with 32 bit (2x16) configurations
-       since it only checks the DQ7 bit of the lower chip. */
+    /* NOTE: Status polling according to [3], Figure 1, on the DQ7 bits of
+       both chips of a 32 bit (2x16) configuration. */
     urj_bus_t *bus = cfi_array->bus;
-    int timeout;
-    const uint32_t dq7mask = (1 << 7);
-    const uint32_t dq5mask = (1 << 5);
+    const uint32_t dq7mask = ((1 << 7) << 16) + (1 << 7);
     uint32_t bit7 = data & dq7mask;
     uint32_t data1;
 
-    for (timeout = 0; timeout < 7000; timeout++)
-    {
-        data1 = URJ_BUS_READ (bus, adr);
-        urj_log (URJ_LOG_LEVEL_DEBUG,
-                 "amd_program_buffer_status %d: %04lX (%04lX) = %04lX\n",
-                 timeout, (long unsigned) data1,
-                 (long unsigned) (data1 & dq7mask), (long unsigned) bit7);
-        if ((data1 & dq7mask) == bit7)
-            return URJ_STATUS_OK;
-
-        if ((data1 & dq5mask) == dq5mask)
-            break;
-        usleep (100);
-    }
+    if (urj_flash_poll (cfi_array, adr, URJ_FLASH_OP_BUFFER_WRITE,
+                        amd_dq7_done, &bit7, &data1) == URJ_STATUS_OK)
+        return URJ_STATUS_OK;
 
+    /* DQ7 may change at the same time as DQ5, so look once more */
     data1 = URJ_BUS_READ (bus, adr);
     if ((data1 & dq7mask) == bit7)
         return URJ_STATUS_OK;
@@ -546,6 +549,9 @@ amd_flash_program_buffer (urj_flash_cfi_array_t *cfi_array, uint32_t adr,
     int o = amd_flash_address_shift (cfi_array);
     int wb_bytes = cfi_chip->cfi.device_geometry.max_bytes_write;
     int chip_width = cfi_chip->width;
+    /* bytes on the bus that fill the write buffers of all chips */
+    int window = wb_bytes * (cfi_array->bus_width / chip_width);
+    uint32_t erased = URJ_FLASH_ERASED_WORD (cfi_array->bus_width);
     int offset = 0;
 
     urj_log (URJ_LOG_LEVEL_DEBUG,
@@ -554,41 +560,53 @@ amd_flash_program_buffer (urj_flash_cfi_array_t *cfi_array, uint32_t adr,
 
     while (count > 0)
     {
-        int wcount, idx;
-        uint32_t sa = adr;
+        int wcount, first, last, idx;
 
         /* determine length of next multi-byte write */
-        wcount = wb_bytes - (adr % wb_bytes);
-        wcount /= chip_width;
+        wcount = (window - (adr % window)) / cfi_array->bus_width;
         if (wcount > count)
             wcount = count;
 
-        URJ_BUS_WRITE (bus, cfi_array->address + (0x0555 << o), 0x00aa00aa);
-        URJ_BUS_WRITE (bus, cfi_array->address + (0x02aa << o), 0x00550055);
-        URJ_BUS_WRITE (bus, adr, 0x00250025);
-        URJ_BUS_WRITE (bus, sa, wcount - 1);
-
-        /* write payload to write buffer */
-        for (idx = 0; idx < wcount; idx++)
-        {
-            URJ_BUS_WRITE (bus, adr, buffer[offset + idx]);
-            adr += cfi_array->bus_width;
-        }
-        offset += wcount;
-
-        /* program buffer to flash */
-        URJ_BUS_WRITE (bus, sa, 0x00290029);
+        /* erased words at either end of the write need no bus cycles */
+        for (first = 0; first < wcount && buffer[offset + first] == erased;
+             first++)
+            ;
+        for (last = wcount; last > first && buffer[offset + last - 1] == erased;
+             last--)
+            ;
 
-        status = amd_program_buffer_status (cfi_array,
-                                            adr - cfi_array->bus_width,
-                                            buffer[offset - 1]);
-        /*      amd_flash_read_array(ps); */
-        if (status != URJ_STATUS_OK)
+        if (first < last)
         {
-            urj_error_set (URJ_ERROR_FLASH_PROGRAM, "status fails after write");
-            return URJ_STATUS_FAIL;
+            uint32_t n = last - first - 1;
+            uint32_t sa = adr + first * cfi_array->bus_width;
+            uint32_t la = adr + (last - 1) * cfi_array->bus_width;
+
+            URJ_BUS_WRITE (bus, cfi_array->address + (0x0555 << o), 0x00aa00aa);
+            URJ_BUS_WRITE (bus, cfi_array->address + (0x02aa << o), 0x00550055);
+            URJ_BUS_WRITE (bus, sa, 0x00250025);
+            URJ_BUS_WRITE (bus, sa, (n << 16) | n);
+
+            /* write payload to write buffer */
+            for (idx = first; idx < last; idx++)
+                URJ_BUS_WRITE (bus, adr + idx * cfi_array->bus_width,
+                               buffer[offset + idx]);
+
+            /* program buffer to flash */
+            URJ_BUS_WRITE (bus, sa, 0x00290029);
+
+            status = amd_program_buffer_status (cfi_array, la,
+                                                buffer[offset + last - 1]);
+            /*      amd_flash_read_array(ps); */
+            if (status != URJ_STATUS_OK)
+            {
+                urj_error_set (URJ_ERROR_FLASH_PROGRAM,
+                               "status fails after write");
+                return URJ_STATUS_FAIL;
+            }
         }
 
+        adr += wcount * cfi_array->bus_width;
+        offset += wcount;
         count -= wcount;
     }
 
@@ -621,35 +639,17 @@ amd_flash_program (urj_flash_cfi_array_t *cfi_array, uint32_t adr,
     }
 
     /* unroll buffer to single writes */
+    uint32_t erased = URJ_FLASH_ERASED_WORD (cfi_array->bus_width);
     int idx;
     for (idx = 0; idx < count; idx++)
     {
-        int status = amd_flash_program_single (cfi_array, adr, buffer[idx]);
-        if (status != URJ_STATUS_OK)
-            return status;
-        adr += cfi_array->bus_width;
-    }
-
-    return URJ_STATUS_OK;
-}
-
-static int
-amd_flash_program32 (urj_flash_cfi_array_t *cfi_array, uint32_t adr,
-                     uint32_t *buffer, int count)
-{
-    /* Single byte programming is forced for 32 bit (2x16) flash configuration.
-       a) lack of testing capbilities for 2x16 multi-byte write operation
-       b) amd_flash_program_buffer() is not 2x16 compatible at the moment
-       due to insufficiency of amd_program_buffer_status()
-       Closing these issues will obsolete amd_flash_program32(). */
-    int idx;
-
-    /* unroll buffer to single writes */
-    for (idx = 0; idx < count; idx++)
-    {
-        int status = amd_flash_program_single (cfi_array, adr, buffer[idx]);
-        if (status != URJ_STATUS_OK)
-            return status;
+        if (buffer[idx] != erased)
+        {
+            int status = amd_flash_program_single (cfi_array, adr,
+                                                   buffer[idx]);
+            if (status != URJ_STATUS_OK)
+                return status;
+        }
         adr += cfi_array->bus_width;
     }
 
@@ -665,7 +665,7 @@ const urj_flash_driver_t urj_flash_amd_32_flash_driver = {
     amd_flash_erase_block,
     amd_flash_lock_block,
     amd_flash_unlock_block,
-    amd_flash_program32,
+    amd_flash_program,
     amd_flash_read_array,
 };
 
@@ -44,23 +44,24 @@
 #include "amd.h"
 #include "cfi.h"
 #include "intel.h"
-
-urj_flash_cfi_array_t *urj_flash_cfi_array = NULL;
+#include "spi_nor.h"
 
 static const urj_flash_detect_func_t urj_flash_detect_funcs[] = {
     &urj_flash_cfi_detect,
     &urj_flash_jedec_detect,
     &urj_flash_amd_detect,
+    &urj_flash_spi_nor_detect,
 #ifdef JEDEC_EXP
     &urj_flash_jedec_exp_detect,
 #endif
 };
 
 void
-urj_flash_cleanup (void)
+urj_flash_cleanup (urj_bus_t *bus)
 {
-    urj_flash_cfi_array_free (urj_flash_cfi_array);
-    urj_flash_cfi_array = NULL;
+    urj_flash_cfi_array_free (bus->cfi_array);
+    bus->cfi_array = NULL;
+    bus->flash_driver = NULL;
 }
 
 int
@@ -78,19 +79,19 @@ urj_flash_detectflash (urj_log_level_t ll, urj_bus_t *bus, uint32_t adr)
 
     urj_error_reset ();
 
-    urj_flash_cleanup();
+    urj_flash_cleanup (bus);
 
     URJ_BUS_PREPARE (bus);
 
     for (i = 0; i < ARRAY_SIZE (urj_flash_detect_funcs); ++i)
     {
-        ret = urj_flash_detect_funcs[i] (bus, adr, &urj_flash_cfi_array);
+        ret = urj_flash_detect_funcs[i] (bus, adr, &bus->cfi_array);
         if (ret == URJ_STATUS_OK)
             break;
-        urj_flash_cleanup ();
+        urj_flash_cleanup (bus);
     }
 
-    if (urj_flash_cfi_array == NULL)
+    if (bus->cfi_array == NULL)
     {
         /* Preserve error from lower layers if they set one */
         if (urj_error_get () == URJ_ERROR_OK)
@@ -98,7 +99,7 @@ urj_flash_detectflash (urj_log_level_t ll, urj_bus_t *bus, uint32_t adr)
         return URJ_STATUS_FAIL;
     }
 
-    cfi = &urj_flash_cfi_array->cfi_chips[0]->cfi;
+    cfi = &bus->cfi_array->cfi_chips[0]->cfi;
 
     /* detect CFI capable devices */
     /* TODO: Low chip only */
@@ -45,11 +45,13 @@
 #include <urjtag/bus.h>
 #include <urjtag/jtag.h>
 #include <urjtag/flash.h>
+#include <urjtag/trace.h>
 
 #include "flash.h"
 #include "cfi.h"
 #include "intel.h"
 #include "amd.h"
+#include "spi_nor.h"
 
 const urj_flash_driver_t * const urj_flash_flash_drivers[] = {
     &urj_flash_amd_32_flash_driver,
@@ -59,32 +61,31 @@ const urj_flash_driver_t * const urj_flash_flash_drivers[] = {
     &urj_flash_intel_16_flash_driver,
     &urj_flash_intel_8_flash_driver,
     &urj_flash_amd_29xx040_flash_driver,        //20/09/2006
+    &urj_flash_spi_nor_flash_driver,
     NULL
 };
 
-static const urj_flash_driver_t *flash_driver = NULL;
-
 static int
-set_flash_driver (void)
+set_flash_driver (urj_bus_t *bus)
 {
     int i;
     urj_flash_cfi_query_structure_t *cfi;
 
-    flash_driver = NULL;
-    if (urj_flash_cfi_array == NULL)
+    bus->flash_driver = NULL;
+    if (bus->cfi_array == NULL)
     {
-        urj_error_set (URJ_ERROR_NOTFOUND, "global cfi_array not set");
+        urj_error_set (URJ_ERROR_NOTFOUND, "no flash detected on bus");
         return URJ_STATUS_FAIL;
     }
 
-    cfi = &urj_flash_cfi_array->cfi_chips[0]->cfi;
+    cfi = &bus->cfi_array->cfi_chips[0]->cfi;
 
     for (i = 0; urj_flash_flash_drivers[i] != NULL; i++)
-        if (urj_flash_flash_drivers[i]->autodetect (urj_flash_cfi_array))
+        if (urj_flash_flash_drivers[i]->autodetect (bus->cfi_array))
         {
-            flash_driver = urj_flash_flash_drivers[i];
-            flash_driver->print_info (URJ_LOG_LEVEL_NORMAL,
-                                      urj_flash_cfi_array);
+            bus->flash_driver = urj_flash_flash_drivers[i];
+            bus->flash_driver->print_info (URJ_LOG_LEVEL_NORMAL,
+                                           bus->cfi_array);
             return URJ_STATUS_OK;
         }
 
@@ -113,14 +114,14 @@ urj_flashmsbin (urj_bus_t *bus, FILE *f, int noverify)
     uint32_t adr;
     urj_flash_cfi_query_structure_t *cfi;
 
-    set_flash_driver ();
-    if (!urj_flash_cfi_array || !flash_driver)
+    set_flash_driver (bus);
+    if (!bus->cfi_array || !bus->flash_driver)
     {
         urj_error_set (URJ_ERROR_NOTFOUND, _("no flash driver found"));
         return URJ_STATUS_FAIL;
     }
 
-    cfi = &urj_flash_cfi_array->cfi_chips[0]->cfi;
+    cfi = &bus->cfi_array->cfi_chips[0]->cfi;
 
     /* test sync bytes */
     {
@@ -152,10 +153,14 @@ urj_flashmsbin (urj_bus_t *bus, FILE *f, int noverify)
 
             adr = first * block_size * 2;
             // @@@@ RFHH what about returning on error?
-            (void) flash_driver->unlock_block (urj_flash_cfi_array, adr);
+            urj_trace (URJ_TRACE_BEGIN, "flash", "erase",
+                       "\"block\":%d,\"adr\":%lu", first,
+                       (long unsigned) adr);
+            (void) bus->flash_driver->unlock_block (bus->cfi_array, adr);
             urj_log (URJ_LOG_LEVEL_NORMAL, _("block %d unlocked\n"), first);
             // @@@@ RFHH what about returning on error?
-            r = flash_driver->erase_block (urj_flash_cfi_array, adr);
+            r = bus->flash_driver->erase_block (bus->cfi_array, adr);
+            urj_trace (URJ_TRACE_END, "flash", "erase", "\"status\":%d", r);
             urj_log (URJ_LOG_LEVEL_NORMAL, _("erasing block %d: %d\n"),
                      first, r);
         }
@@ -193,7 +198,7 @@ urj_flashmsbin (urj_bus_t *bus, FILE *f, int noverify)
                      (long unsigned) a);
             urj_log (URJ_LOG_LEVEL_NORMAL, "\r");
             fread_ret (&data, sizeof data, 1, f);
-            if (flash_driver->program (urj_flash_cfi_array, a, &data, 1)
+            if (bus->flash_driver->program (bus->cfi_array, a, &data, 1)
                 != URJ_STATUS_OK)
                 // retain error state
                 return URJ_STATUS_FAIL;
@@ -203,7 +208,7 @@ urj_flashmsbin (urj_bus_t *bus, FILE *f, int noverify)
     }
     urj_log (URJ_LOG_LEVEL_NORMAL, "\n");
 
-    flash_driver->readarray (urj_flash_cfi_array);
+    bus->flash_driver->readarray (bus->cfi_array);
 
     if (noverify)
     {
@@ -294,185 +299,368 @@ find_block (urj_flash_cfi_query_structure_t *cfi, int adr, int bus_width,
     return -1;
 }
 
-int
-urj_flashmem (urj_bus_t *bus, FILE *f, uint32_t addr, int noverify)
+/*
+ * Size in bytes of the largest erase block of the array, i.e. the most
+ * urj_flashmem() has to hold in memory at once
+ */
+static int
+max_block_size (urj_flash_cfi_query_structure_t *cfi, int bus_width,
+                int chip_width)
 {
-    uint32_t adr;
-    urj_flash_cfi_query_structure_t *cfi;
-    int *erased;
     int i;
-    int neb;
+    int max = 0;
+
+    for (i = 0; i < cfi->device_geometry.number_of_erase_regions; i++)
+    {
+        const int region_block_size = (bus_width / chip_width)
+            * cfi->device_geometry.erase_block_regions[i].erase_block_size;
+
+        if (region_block_size > max)
+            max = region_block_size;
+    }
+    return max;
+}
+
+/*
+ * Erase plan: the number of erase blocks that @len bytes at offset @adr of
+ * the array touch, or -1 if they do not fit into the array
+ */
+static int
+plan_blocks (urj_flash_cfi_query_structure_t *cfi, int adr, long len,
+             int bus_width, int chip_width)
+{
+    int blocks = 0;
+    int btr;
+
+    while (len > 0)
+    {
+        if (find_block (cfi, adr, bus_width, chip_width, &btr) < 0)
+            return -1;
+        blocks++;
+        adr += btr;
+        len -= btr;
+    }
+    return blocks;
+}
+
+/* Bytes left in @f from the current position, or -1 if it cannot seek */
+static long
+file_remaining (FILE *f)
+{
+    long pos, end;
+
+    pos = ftell (f);
+    if (pos < 0 || fseek (f, 0, SEEK_END) != 0)
+        return -1;
+    end = ftell (f);
+    if (fseek (f, pos, SEEK_SET) != 0 || end < pos)
+        return -1;
+    return end - pos;
+}
+
+/* Compare @count words at @adr with the data just programmed there */
+static int
+verify_block (urj_bus_t *bus, uint32_t adr, const uint32_t *words, int count)
+{
+    int width = bus->flash_driver->bus_width;
+    int i;
+
+    urj_trace (URJ_TRACE_BEGIN, "flash", "verify",
+               "\"adr\":%lu,\"bytes\":%d", (long unsigned) adr, count * width);
+
+    /* start consecutive read */
+    URJ_BUS_READ_START (bus, adr);
+
+    for (i = 0; i < count; i++)
+    {
+        uint32_t next_adr = adr + width;
+        uint32_t readed = URJ_BUS_READ_NEXT (bus, next_adr);
+
+        if (words[i] != readed)
+        {
+            /* end consecutive read */
+            (void) URJ_BUS_READ_END (bus);
+            urj_trace (URJ_TRACE_END, "flash", "verify",
+                       "\"status\":%d", URJ_STATUS_FAIL);
+
+            urj_error_set (URJ_ERROR_FLASH_PROGRAM,
+                           _("addr: 0x%08lX\n verify error:\nread: 0x%08lX\nexpected: 0x%08lX\n"),
+                             (long unsigned) adr, (long unsigned) readed,
+                             (long unsigned) words[i]);
+            return URJ_STATUS_FAIL;
+        }
+        adr = next_adr;
+    }
+
+    /* end consecutive read
+       this wastes one read access but saves us from determining the for-loop
+       finish condition twice within the loop */
+    (void) URJ_BUS_READ_END (bus);
+    urj_trace (URJ_TRACE_END, "flash", "verify", "\"status\":%d",
+               URJ_STATUS_OK);
+
+    return URJ_STATUS_OK;
+}
+
+/*
+ * The image goes to flash one erase block at a time: read the block from
+ * the file, erase it, program it as a whole and verify it while its data
+ * are still in memory. The file is read only once, and no verify pass over
+ * the whole flash follows.
+ *
+ * The drivers skip the words in the erased state when they program.
+ *
+ * With @diff, each block is read back first and left alone if it already
+ * holds the data. If the words to be written read back blank, the block is
+ * not erased either. Without @diff nothing is read back: on buses through
+ * the boundary scan register, reading a block costs more than erasing it.
+ */
+static int
+flashmem_blocks (urj_bus_t *bus, FILE *f, uint32_t addr, int noverify,
+                 int diff)
+{
+    const urj_flash_driver_t *drv;
+    urj_flash_cfi_query_structure_t *cfi;
+    uint32_t adr;
+    uint8_t *b;
+    uint32_t *words;
+    uint32_t *old = NULL;
+    long len;
     int bus_width;
     int chip_width;
-#define BSIZE (1 << 12)
-    uint32_t write_buffer[BSIZE];
-    int write_buffer_count;
-    uint32_t write_buffer_adr;
+    int width;
+    int block_size;
+    uint32_t erased;
+    int blocks = 0;
+    int blank = 0;
+    int unchanged = 0;
+    int total = 0;
+    int programmed = 0;
+    int status = URJ_STATUS_OK;
 
-    set_flash_driver ();
-    if (!urj_flash_cfi_array || !flash_driver)
+    set_flash_driver (bus);
+    if (!bus->cfi_array || !bus->flash_driver)
     {
         urj_error_set (URJ_ERROR_NOTFOUND, _("no flash driver found"));
         return URJ_STATUS_FAIL;
     }
-    cfi = &urj_flash_cfi_array->cfi_chips[0]->cfi;
+    drv = bus->flash_driver;
+    cfi = &bus->cfi_array->cfi_chips[0]->cfi;
 
-    bus_width = urj_flash_cfi_array->bus_width;
-    chip_width = urj_flash_cfi_array->cfi_chips[0]->width;
+    bus_width = bus->cfi_array->bus_width;
+    chip_width = bus->cfi_array->cfi_chips[0]->width;
+    width = drv->bus_width;
+    erased = URJ_FLASH_ERASED_WORD (width);
 
-    for (i = 0, neb = 0; i < cfi->device_geometry.number_of_erase_regions;
-         i++)
-        neb +=
-            cfi->device_geometry.erase_block_regions[i].number_of_erase_blocks;
+    len = file_remaining (f);
+    if (len >= 0)
+    {
+        int planned = plan_blocks (cfi, addr - bus->cfi_array->address, len,
+                                   bus_width, chip_width);
+
+        if (planned < 0)
+        {
+            urj_error_set (URJ_ERROR_OUT_OF_BOUNDS,
+                           _("%ld bytes at 0x%08lX do not fit into the flash"),
+                           len, (long unsigned) addr);
+            return URJ_STATUS_FAIL;
+        }
+        urj_log (URJ_LOG_LEVEL_NORMAL, _("%ld bytes in %d block%s\n"),
+                 len, planned, planned == 1 ? "" : "s");
+    }
 
-    erased = malloc (neb * sizeof *erased);
-    if (!erased)
+    block_size = max_block_size (cfi, bus_width, chip_width);
+    b = malloc (block_size + width);
+    words = malloc ((block_size / width + 1) * sizeof *words);
+    if (diff)
+        old = malloc ((block_size / width + 1) * sizeof *old);
+    if (b == NULL || words == NULL || (diff && old == NULL))
     {
+        free (b);
+        free (words);
+        free (old);
         urj_error_set (URJ_ERROR_OUT_OF_MEMORY, _("malloc(%zd) failed"),
-                       neb * sizeof *erased);
+                       (size_t) block_size);
         return URJ_STATUS_FAIL;
     }
-    for (i = 0; i < neb; i++)
-        erased[i] = 0;
 
     urj_log (URJ_LOG_LEVEL_NORMAL, _("program:\n"));
     adr = addr;
-    while (!feof (f))
+    for (;;)
     {
-        uint32_t data;
-        uint8_t b[BSIZE];
-        int bc = 0, bn = 0, btr = BSIZE;
-        int block_no = find_block (cfi, adr - urj_flash_cfi_array->address,
+        int bc, bn, btr = block_size, count, i, r;
+        int blank_data = 0;     /* whether the words read back are blank */
+        int block_no = find_block (cfi, adr - bus->cfi_array->address,
                                    bus_width, chip_width, &btr);
 
-        write_buffer_count = 0;
-        write_buffer_adr = adr;
-
-        if (btr > BSIZE)
-            btr = BSIZE;
-        // @@@@ RFHH check error state?
+        if (btr > block_size)
+            btr = block_size;
         bn = fread (b, 1, btr, f);
-
-        if (bn > 0 && !erased[block_no])
+        if (bn <= 0)
         {
-            int r;
-
-            // @@@@ RFHH what about returning on error?
-            (void) flash_driver->unlock_block (urj_flash_cfi_array, adr);
-            urj_log (URJ_LOG_LEVEL_NORMAL, _("\nblock %d unlocked\n"),
-                     block_no);
-            // @@@@ RFHH what about returning on error?
-            r = flash_driver->erase_block (urj_flash_cfi_array, adr);
-            urj_log (URJ_LOG_LEVEL_NORMAL, _("erasing block %d: %d\n"),
-                     block_no, r);
-            erased[block_no] = 1;
+            if (ferror (f))
+            {
+                urj_error_IO_set (_("Error reading file"));
+                status = URJ_STATUS_FAIL;
+            }
+            break;
+        }
+        if (block_no < 0)
+        {
+            urj_error_set (URJ_ERROR_OUT_OF_BOUNDS,
+                           _("addr 0x%08lX is beyond the flash"),
+                           (long unsigned) adr);
+            status = URJ_STATUS_FAIL;
+            break;
         }
 
-        for (bc = 0; bc < bn; bc += flash_driver->bus_width)
+        /* a trailing partial word is padded with the erased state */
+        while (bn % width)
+            b[bn++] = 0xFF;
+
+        urj_log (URJ_LOG_LEVEL_NORMAL, _("addr: 0x%08lX"),
+                 (long unsigned) adr);
+        urj_log (URJ_LOG_LEVEL_NORMAL, "\r");
+
+        for (bc = 0, count = 0; bc < bn; bc += width)
         {
+            uint32_t data = 0;
             int j;
-            if ((adr & (BSIZE - 1)) == 0)
-            {
-                urj_log (URJ_LOG_LEVEL_NORMAL, _("addr: 0x%08lX"),
-                         (long unsigned) adr);
-                urj_log (URJ_LOG_LEVEL_NORMAL, "\r");
-            }
 
-            data = 0;
-            for (j = 0; j < flash_driver->bus_width; j++)
+            for (j = 0; j < width; j++)
                 if (urj_get_file_endian () == URJ_ENDIAN_BIG)
                     data = (data << 8) | b[bc + j];
                 else
                     data |= b[bc + j] << (j * 8);
 
-            /* store data in write buffer, will be programmed to flash later */
-            write_buffer[write_buffer_count++] = data;
-
-            adr += flash_driver->bus_width;
+            words[count++] = data;
         }
 
-        if (write_buffer_count > 0)
-            if (flash_driver->program (urj_flash_cfi_array, write_buffer_adr,
-                                       write_buffer, write_buffer_count))
+        blocks++;
+        total += count;
+        if (diff)
+        {
+            urj_trace (URJ_TRACE_BEGIN, "flash", "compare",
+                       "\"block\":%d,\"adr\":%lu", block_no,
+                       (long unsigned) adr);
+            drv->readarray (bus->cfi_array);
+            r = urj_bus_read_block (bus, adr, old, count) == URJ_STATUS_OK;
+            if (!r)
             {
-                // retain error state
-                return URJ_STATUS_FAIL;
+                /* the block cannot be compared, so it is erased and
+                   written */
+                urj_log (URJ_LOG_LEVEL_DETAIL,
+                         _("block %d not compared: %s\n"), block_no,
+                         urj_error_describe ());
+                urj_error_reset ();
             }
+            else
+            {
+                r = memcmp (old, words, count * sizeof *words) == 0;
+                for (i = 0; i < count && old[i] == erased; i++)
+                    ;
+                blank_data = i == count;
+            }
+            urj_trace (URJ_TRACE_END, "flash", "compare", "\"same\":%d", r);
+            if (r)
+            {
+                urj_log (URJ_LOG_LEVEL_DETAIL, _("block %d unchanged\n"),
+                         block_no);
+                unchanged++;
+                adr += count * width;
+                continue;
+            }
+        }
 
-    }
-    free (erased);
-
-    urj_log (URJ_LOG_LEVEL_NORMAL, _("addr: 0x%08lX\n"),
-             (long unsigned) adr - flash_driver->bus_width);
-
-    flash_driver->readarray (urj_flash_cfi_array);
-
-    if (noverify)
-    {
-        urj_log (URJ_LOG_LEVEL_NORMAL, _("verify skipped\n"));
-        return URJ_STATUS_OK;
-    }
-
-    fseek (f, 0, SEEK_SET);
-    urj_log (URJ_LOG_LEVEL_NORMAL, _("verify:\n"));
-    adr = addr;
-    while (!feof (f))
-    {
-        uint32_t data, readed;
-        uint8_t b[BSIZE];
-        int bc = 0, bn = 0, btr = BSIZE;
-
-        // @@@@ RFHH check error state?
-        bn = fread (b, 1, btr, f);
-
-        /* start consecutive read */
-        URJ_BUS_READ_START (bus, adr);
+        /* parts without block locking may fail this; the erase or the
+           program tells. Blank blocks may power up locked too. */
+        (void) drv->unlock_block (bus->cfi_array, adr);
+        urj_log (URJ_LOG_LEVEL_NORMAL, _("\nblock %d unlocked\n"), block_no);
 
-        for (bc = 0; bc < bn; bc += flash_driver->bus_width)
+        if (blank_data)
         {
-            int j;
-            uint32_t next_adr = adr + flash_driver->bus_width;
-
-            if ((adr & 0xFF) == 0)
+            urj_log (URJ_LOG_LEVEL_DETAIL, _("block %d is blank\n"),
+                     block_no);
+            blank++;
+        }
+        else
+        {
+            urj_trace (URJ_TRACE_BEGIN, "flash", "erase",
+                       "\"block\":%d,\"adr\":%lu", block_no,
+                       (long unsigned) adr);
+            r = drv->erase_block (bus->cfi_array, adr);
+            urj_trace (URJ_TRACE_END, "flash", "erase", "\"status\":%d", r);
+            urj_log (URJ_LOG_LEVEL_NORMAL, _("erasing block %d: %d\n"),
+                     block_no, r);
+            if (r != URJ_STATUS_OK)
             {
-                urj_log (URJ_LOG_LEVEL_NORMAL, _("addr: 0x%08lX"),
-                         (long unsigned) adr);
-                urj_log (URJ_LOG_LEVEL_NORMAL, "\r");
+                // retain error state
+                status = URJ_STATUS_FAIL;
+                break;
             }
+        }
 
-            data = 0;
-            for (j = 0; j < flash_driver->bus_width; j++)
-                if (urj_get_file_endian () == URJ_ENDIAN_BIG)
-                    data = (data << 8) | b[bc + j];
-                else
-                    data |= b[bc + j] << (j * 8);
+        urj_trace (URJ_TRACE_BEGIN, "flash", "program",
+                   "\"block\":%d,\"adr\":%lu,\"words\":%d", block_no,
+                   (long unsigned) adr, count);
+        r = drv->program (bus->cfi_array, adr, words, count);
+        for (i = 0; i < count; i++)
+            programmed += words[i] != erased;
+        urj_trace (URJ_TRACE_END, "flash", "program", "\"status\":%d", r);
+        if (r != URJ_STATUS_OK)
+        {
+            // retain error state
+            status = URJ_STATUS_FAIL;
+            break;
+        }
 
-            readed = URJ_BUS_READ_NEXT (bus, next_adr);
-            if (data != readed)
+        if (!noverify)
+        {
+            drv->readarray (bus->cfi_array);
+            if (verify_block (bus, adr, words, count) != URJ_STATUS_OK)
             {
-                /* end consecutive read */
-                (void) URJ_BUS_READ_END (bus);
-
-                urj_error_set (URJ_ERROR_FLASH_PROGRAM,
-                               _("addr: 0x%08lX\n verify error:\nread: 0x%08lX\nexpected: 0x%08lX\n"),
-                                 (long unsigned) adr, (long unsigned) readed,
-                                 (long unsigned) data);
-                return URJ_STATUS_FAIL;
+                status = URJ_STATUS_FAIL;
+                break;
             }
-            adr = next_adr;
         }
 
-        /* end consecutive read
-           this wastes one read access but saves us from determining the for-loop
-           finish condition twice within the loop */
-        (void) URJ_BUS_READ_END (bus);
+        adr += count * width;
     }
-    urj_log (URJ_LOG_LEVEL_NORMAL, _("addr: 0x%08lX\nDone.\n"),
-             (long unsigned) adr - flash_driver->bus_width);
+    free (b);
+    free (words);
+    free (old);
+
+    drv->readarray (bus->cfi_array);
+
+    if (status != URJ_STATUS_OK)
+        return status;
+
+    urj_log (URJ_LOG_LEVEL_NORMAL, _("addr: 0x%08lX\n"),
+             (long unsigned) adr - width);
+    urj_log (URJ_LOG_LEVEL_NORMAL,
+             _("%d of %d block%s unchanged, %d blank, %d of %d words programmed\n"),
+             unchanged, blocks, blocks == 1 ? "" : "s", blank, programmed,
+             total);
+    if (noverify)
+        urj_log (URJ_LOG_LEVEL_NORMAL, _("verify skipped\n"));
+    else
+        urj_log (URJ_LOG_LEVEL_NORMAL, _("Done.\n"));
 
     return URJ_STATUS_OK;
 }
 
+int
+urj_flashmem (urj_bus_t *bus, FILE *f, uint32_t addr, int noverify)
+{
+    return flashmem_blocks (bus, f, addr, noverify, 0);
+}
+
+int
+urj_flashmem_diff (urj_bus_t *bus, FILE *f, uint32_t addr, int noverify)
+{
+    return flashmem_blocks (bus, f, addr, noverify, 1);
+}
+
 int
 urj_flasherase (urj_bus_t *bus, uint32_t addr, uint32_t number)
 {
@@ -482,16 +670,16 @@ urj_flasherase (urj_bus_t *bus, uint32_t addr, uint32_t number)
     int bus_width;
     int chip_width;
 
-    set_flash_driver ();
-    if (!urj_flash_cfi_array || !flash_driver)
+    set_flash_driver (bus);
+    if (!bus->cfi_array || !bus->flash_driver)
     {
         urj_error_set (URJ_ERROR_NOTFOUND, _("no flash driver found"));
         return URJ_STATUS_FAIL;
     }
-    cfi = &urj_flash_cfi_array->cfi_chips[0]->cfi;
+    cfi = &bus->cfi_array->cfi_chips[0]->cfi;
 
-    bus_width = urj_flash_cfi_array->bus_width;
-    chip_width = urj_flash_cfi_array->cfi_chips[0]->width;
+    bus_width = bus->cfi_array->bus_width;
+    chip_width = bus->cfi_array->cfi_chips[0]->width;
 
     urj_log (URJ_LOG_LEVEL_NORMAL,
              _("\nErasing %d Flash block%s from address 0x%lx\n"), number,
@@ -501,7 +689,7 @@ urj_flasherase (urj_bus_t *bus, uint32_t addr, uint32_t number)
     {
         int r;
         int btr = 0;
-        int block_no = find_block (cfi, addr - urj_flash_cfi_array->address,
+        int block_no = find_block (cfi, addr - bus->cfi_array->address,
                                    bus_width, chip_width, &btr);
 
         if (block_no < 0)
@@ -514,9 +702,13 @@ urj_flasherase (urj_bus_t *bus, uint32_t addr, uint32_t number)
         urj_log (URJ_LOG_LEVEL_NORMAL,
                  _("(%d%% Completed) FLASH Block %d : Unlocking ... "),
                 i * 100 / number, block_no);
-        flash_driver->unlock_block (urj_flash_cfi_array, addr);
+        urj_trace (URJ_TRACE_BEGIN, "flash", "erase",
+                   "\"block\":%d,\"adr\":%lu", block_no,
+                   (long unsigned) addr);
+        bus->flash_driver->unlock_block (bus->cfi_array, addr);
         urj_log (URJ_LOG_LEVEL_NORMAL, _("Erasing ... "));
-        r = flash_driver->erase_block (urj_flash_cfi_array, addr);
+        r = bus->flash_driver->erase_block (bus->cfi_array, addr);
+        urj_trace (URJ_TRACE_END, "flash", "erase", "\"status\":%d", r);
         if (r == URJ_STATUS_OK)
         {
             if (i == number)
@@ -563,16 +755,16 @@ urj_flashlock (urj_bus_t *bus, uint32_t addr, uint32_t number, int unlock)
     int bus_width;
     int chip_width;
 
-    set_flash_driver ();
-    if (!urj_flash_cfi_array || !flash_driver)
+    set_flash_driver (bus);
+    if (!bus->cfi_array || !bus->flash_driver)
     {
         urj_error_set (URJ_ERROR_NOTFOUND, _("no flash driver found"));
         return URJ_STATUS_FAIL;
     }
-    cfi = &urj_flash_cfi_array->cfi_chips[0]->cfi;
+    cfi = &bus->cfi_array->cfi_chips[0]->cfi;
 
-    bus_width = urj_flash_cfi_array->bus_width;
-    chip_width = urj_flash_cfi_array->cfi_chips[0]->width;
+    bus_width = bus->cfi_array->bus_width;
+    chip_width = bus->cfi_array->cfi_chips[0]->width;
 
     urj_log (URJ_LOG_LEVEL_NORMAL,
              _("\n%s %d Flash block%s from address 0x%lx\n"),
@@ -584,7 +776,7 @@ urj_flashlock (urj_bus_t *bus, uint32_t addr, uint32_t number, int unlock)
     {
         int r;
         int btr = 0;
-        int block_no = find_block (cfi, addr - urj_flash_cfi_array->address,
+        int block_no = find_block (cfi, addr - bus->cfi_array->address,
                                    bus_width, chip_width, &btr);
 
         if (block_no < 0)
@@ -602,9 +794,9 @@ urj_flashlock (urj_bus_t *bus, uint32_t addr, uint32_t number, int unlock)
                  unlock == 1 ? "unlocking" : "locking");
 
         if (unlock)
-                r = flash_driver->unlock_block (urj_flash_cfi_array, addr);
+                r = bus->flash_driver->unlock_block (bus->cfi_array, addr);
         else
-                r = flash_driver->lock_block (urj_flash_cfi_array, addr);
+                r = bus->flash_driver->lock_block (bus->cfi_array, addr);
 
         if (r == URJ_STATUS_OK)
         {
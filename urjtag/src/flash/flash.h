@@ -52,6 +52,40 @@ struct URJ_FLASH_CFI_ARRAY
     urj_flash_cfi_chip_t **cfi_chips;
 };
 
-extern urj_flash_cfi_array_t *urj_flash_cfi_array;
+/* The erased state of a word of @bus_width bytes; programming it is a no-op */
+#define URJ_FLASH_ERASED_WORD(bus_width) \
+    (0xFFFFFFFF >> (32 - 8 * (bus_width)))
+
+/* What a status poll waits for; selects the CFI timing used */
+typedef enum URJ_FLASH_OP
+{
+    URJ_FLASH_OP_WRITE,         /* single word program */
+    URJ_FLASH_OP_BUFFER_WRITE,  /* write buffer program */
+    URJ_FLASH_OP_ERASE,         /* block erase */
+    URJ_FLASH_OP_OTHER,         /* e.g. lock bits, no CFI timing */
+}
+urj_flash_op_t;
+
+/*
+ * Condition for urj_flash_poll(): 1 when @status shows that the operation
+ * is done, -1 when it shows a failure, 0 while it is busy. @prev is the
+ * status read just before, or NULL for the first one.
+ */
+typedef int (*urj_flash_poll_done_t) (const uint32_t *prev, uint32_t status,
+                                      const void *arg);
+
+/*
+ * Poll the status at @adr until @done says the @op is over. The poll first
+ * sleeps for the CFI typical time of @op, then the reads go out in batches
+ * per cable flush until the CFI maximum time.
+ * On an SPI bus, the status register is read instead of @adr.
+ * @status gets the last status read.
+ *
+ * @return URJ_STATUS_OK when done; URJ_STATUS_FAIL on failure or timeout,
+ *      without setting an error unless the bus failed
+ */
+int urj_flash_poll (urj_flash_cfi_array_t *cfi_array, uint32_t adr,
+                    urj_flash_op_t op, urj_flash_poll_done_t done,
+                    const void *arg, uint32_t *status);
 
 #endif /* URJ_FLASH_H */
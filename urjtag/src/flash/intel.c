@@ -237,10 +237,36 @@ intel_flash_print_info32 (urj_log_level_t ll, urj_flash_cfi_array_t *cfi_array)
     _intel_flash_print_info (ll, cfi_array, o);
 }
 
+/* urj_flash_poll() condition: SR7 set in every chip of the array */
+static int
+intel_ready (const uint32_t *prev, uint32_t status, const void *arg)
+{
+    uint32_t ready = *(const uint32_t *) arg;
+
+    return (status & ready) == ready;
+}
+
+/* wait for the end of @op, @ready is SR7 of every chip of the array */
+static int
+intel_wait_ready (urj_flash_cfi_array_t *cfi_array, urj_flash_op_t op,
+                  uint32_t ready, uint32_t *sr)
+{
+    if (urj_flash_poll (cfi_array, cfi_array->address, op, intel_ready,
+                        &ready, sr) != URJ_STATUS_OK)
+    {
+        urj_error_set (URJ_ERROR_FLASH, _("flash not ready, sr = 0x%08lX"),
+                       (long unsigned) *sr);
+        return URJ_STATUS_FAIL;
+    }
+
+    return URJ_STATUS_OK;
+}
+
 static int
 intel_flash_erase_block (urj_flash_cfi_array_t *cfi_array, uint32_t adr)
 {
     uint16_t sr;
+    uint32_t status;
     urj_bus_t *bus = cfi_array->bus;
 
     URJ_BUS_WRITE (bus, cfi_array->address,
@@ -248,7 +274,10 @@ intel_flash_erase_block (urj_flash_cfi_array_t *cfi_array, uint32_t adr)
     URJ_BUS_WRITE (bus, adr, CFI_INTEL_CMD_BLOCK_ERASE);
     URJ_BUS_WRITE (bus, adr, CFI_INTEL_CMD_CONFIRM);
 
-    while (!((sr = URJ_BUS_READ (bus, cfi_array->address) & 0xFE) & CFI_INTEL_SR_READY));     /* TODO: add timeout */
+    if (intel_wait_ready (cfi_array, URJ_FLASH_OP_ERASE, CFI_INTEL_SR_READY,
+                          &status) != URJ_STATUS_OK)
+        return URJ_STATUS_FAIL;
+    sr = status & 0xFE;
 
     switch (sr & ~CFI_INTEL_SR_READY)
     {
@@ -275,6 +304,7 @@ static int
 intel_flash_unlock_block (urj_flash_cfi_array_t *cfi_array, uint32_t adr)
 {
     uint16_t sr;
+    uint32_t status;
     urj_bus_t *bus = cfi_array->bus;
 
     URJ_BUS_WRITE (bus, cfi_array->address,
@@ -282,7 +312,10 @@ intel_flash_unlock_block (urj_flash_cfi_array_t *cfi_array, uint32_t adr)
     URJ_BUS_WRITE (bus, adr, CFI_INTEL_CMD_LOCK_SETUP);
     URJ_BUS_WRITE (bus, adr, CFI_INTEL_CMD_UNLOCK_BLOCK);
 
-    while (!((sr = URJ_BUS_READ (bus, cfi_array->address) & 0xFE) & CFI_INTEL_SR_READY));     /* TODO: add timeout */
+    if (intel_wait_ready (cfi_array, URJ_FLASH_OP_OTHER, CFI_INTEL_SR_READY,
+                          &status) != URJ_STATUS_OK)
+        return URJ_STATUS_FAIL;
+    sr = status & 0xFE;
 
     if (sr != CFI_INTEL_SR_READY)
     {
@@ -298,6 +331,7 @@ static int
 intel_flash_lock_block (urj_flash_cfi_array_t *cfi_array, uint32_t adr)
 {
     uint16_t sr;
+    uint32_t status;
     urj_bus_t *bus = cfi_array->bus;
 
     URJ_BUS_WRITE (bus, cfi_array->address,
@@ -305,7 +339,10 @@ intel_flash_lock_block (urj_flash_cfi_array_t *cfi_array, uint32_t adr)
     URJ_BUS_WRITE (bus, adr, CFI_INTEL_CMD_LOCK_SETUP);
     URJ_BUS_WRITE (bus, adr, CFI_INTEL_CMD_LOCK_BLOCK);
 
-    while (!((sr = URJ_BUS_READ (bus, cfi_array->address) & 0xFE) & CFI_INTEL_SR_READY));     /* TODO: add timeout */
+    if (intel_wait_ready (cfi_array, URJ_FLASH_OP_OTHER, CFI_INTEL_SR_READY,
+                          &status) != URJ_STATUS_OK)
+        return URJ_STATUS_FAIL;
+    sr = status & 0xFE;
 
     if (sr != CFI_INTEL_SR_READY)
     {
@@ -332,6 +369,7 @@ intel_flash_program_single (urj_flash_cfi_array_t *cfi_array,
                             uint32_t adr, uint32_t data)
 {
     uint16_t sr;
+    uint32_t status;
     urj_bus_t *bus = cfi_array->bus;
 
     URJ_BUS_WRITE (bus, cfi_array->address,
@@ -339,7 +377,10 @@ intel_flash_program_single (urj_flash_cfi_array_t *cfi_array,
     URJ_BUS_WRITE (bus, adr, CFI_INTEL_CMD_PROGRAM1);
     URJ_BUS_WRITE (bus, adr, data);
 
-    while (!((sr = URJ_BUS_READ (bus, cfi_array->address) & 0xFE) & CFI_INTEL_SR_READY));     /* TODO: add timeout */
+    if (intel_wait_ready (cfi_array, URJ_FLASH_OP_WRITE, CFI_INTEL_SR_READY,
+                          &status) != URJ_STATUS_OK)
+        return URJ_STATUS_FAIL;
+    sr = status & 0xFE;
 
     if (sr != CFI_INTEL_SR_READY)
     {
@@ -351,57 +392,106 @@ intel_flash_program_single (urj_flash_cfi_array_t *cfi_array,
     return URJ_STATUS_OK;
 }
 
+/* @cmd for every chip of the array, each on its own byte lanes */
+static uint32_t
+intel_cmd (urj_flash_cfi_array_t *cfi_array, uint32_t cmd)
+{
+    uint32_t r = 0;
+    int i;
+
+    for (i = 0; i < cfi_array->bus_width; i++)
+        if (cfi_array->cfi_chips[i] != NULL)
+            r |= cmd << (8 * i);
+
+    return r;
+}
+
 static int
 intel_flash_program_buffer (urj_flash_cfi_array_t *cfi_array,
                             uint32_t adr, uint32_t *buffer, int count)
 {
-    /* NOTE: Write-to-buffer programming operation according to [5], Figure 9 */
-    uint16_t sr;
+    /* NOTE: Write-to-buffer programming operation according to [5], Figure 9.
+       All chips of the array get the same commands on their own byte lanes,
+       so the chips of a 2 x 16 bit array fill and program their buffers
+       together. */
+    uint32_t sr;
     urj_bus_t *bus = cfi_array->bus;
     urj_flash_cfi_chip_t *cfi_chip = cfi_array->cfi_chips[0];
     int wb_bytes = cfi_chip->cfi.device_geometry.max_bytes_write;
     int chip_width = cfi_chip->width;
+    int bus_width = cfi_array->bus_width;
+    /* bytes on the bus that fill the write buffers of all chips */
+    int window = wb_bytes * (bus_width / chip_width);
+    uint32_t ready = intel_cmd (cfi_array, CFI_INTEL_SR_READY);
+    uint32_t erased = URJ_FLASH_ERASED_WORD (bus_width);
     int offset = 0;
+    int written = 0;
 
     while (count > 0)
     {
-        int wcount, idx;
-        uint32_t block_adr = adr;
+        int wcount, first, last, idx;
 
         /* determine length of next multi-byte write */
-        wcount = wb_bytes - (adr % wb_bytes);
-        wcount /= chip_width;
+        wcount = (window - (adr % window)) / bus_width;
         if (wcount > count)
             wcount = count;
 
-        /* issue command WRITE_TO_BUFFER */
-        URJ_BUS_WRITE (bus, cfi_array->address,
-                       CFI_INTEL_CMD_CLEAR_STATUS_REGISTER);
-        /* poll XSR7 == 1 */
-        do {
-            URJ_BUS_WRITE (bus, adr, CFI_INTEL_CMD_WRITE_TO_BUFFER);
-        } while (!((sr = URJ_BUS_READ (bus, cfi_array->address) & 0xFE) & CFI_INTEL_SR_READY)); /* TODO: add timeout */
-
-        /* write count value (number of upcoming writes - 1) */
-        URJ_BUS_WRITE (bus, adr, wcount - 1);
+        /* erased words at either end of the write need no bus cycles */
+        for (first = 0; first < wcount && buffer[offset + first] == erased;
+             first++)
+            ;
+        for (last = wcount; last > first && buffer[offset + last - 1] == erased;
+             last--)
+            ;
 
-        /* write payload to buffer */
-        for (idx = 0; idx < wcount; idx++)
+        if (first < last)
         {
-            URJ_BUS_WRITE (bus, adr, buffer[offset + idx]);
-            adr += cfi_array->bus_width;
+            uint32_t block_adr = adr + first * bus_width;
+
+            /* issue command WRITE_TO_BUFFER */
+            URJ_BUS_WRITE (bus, cfi_array->address,
+                           intel_cmd (cfi_array,
+                                      CFI_INTEL_CMD_CLEAR_STATUS_REGISTER));
+            URJ_BUS_WRITE (bus, block_adr,
+                           intel_cmd (cfi_array,
+                                      CFI_INTEL_CMD_WRITE_TO_BUFFER));
+            /* XSR7 == 1: mostly at once, else the buffer is free when the
+               last one is programmed */
+            if ((URJ_BUS_READ (bus, cfi_array->address) & ready) != ready
+                && intel_wait_ready (cfi_array, URJ_FLASH_OP_BUFFER_WRITE,
+                                     ready, &sr) != URJ_STATUS_OK)
+                return URJ_STATUS_FAIL;
+
+            /* write count value (number of upcoming writes - 1) */
+            URJ_BUS_WRITE (bus, block_adr, intel_cmd (cfi_array,
+                                                      last - first - 1));
+
+            /* write payload to buffer */
+            for (idx = first; idx < last; idx++)
+                URJ_BUS_WRITE (bus, adr + idx * bus_width,
+                               buffer[offset + idx]);
+
+            /* issue command WRITE_CONFIRM */
+            URJ_BUS_WRITE (bus, block_adr,
+                           intel_cmd (cfi_array, CFI_INTEL_CMD_WRITE_CONFIRM));
+            written = 1;
         }
-        offset += wcount;
-
-        /* issue command WRITE_CONFIRM */
-        URJ_BUS_WRITE (bus, block_adr, CFI_INTEL_CMD_WRITE_CONFIRM);
 
+        adr += wcount * bus_width;
+        offset += wcount;
         count -= wcount;
     }
 
+    /* nothing but erased words, so no status either */
+    if (!written)
+        return URJ_STATUS_OK;
+
     /* poll SR7 == 1 */
-    while (!((sr = URJ_BUS_READ (bus, cfi_array->address) & 0xFE) & CFI_INTEL_SR_READY));     /* TODO: add timeout */
-    if (sr != CFI_INTEL_SR_READY)
+    if (intel_wait_ready (cfi_array, URJ_FLASH_OP_BUFFER_WRITE, ready, &sr)
+        != URJ_STATUS_OK)
+        return URJ_STATUS_FAIL;
+    sr &= intel_cmd (cfi_array, 0xFE);
+    if (sr != ready)
     {
         urj_error_set (URJ_ERROR_FLASH_PROGRAM,
                        _("unknown error while programming"));
@@ -429,14 +519,18 @@ intel_flash_program (urj_flash_cfi_array_t *cfi_array,
     else
     {
         /* unroll buffer to single writes */
+        uint32_t erased = URJ_FLASH_ERASED_WORD (cfi_array->bus_width);
         int idx;
 
         for (idx = 0; idx < count; idx++)
         {
-            int status = intel_flash_program_single (cfi_array, adr,
-                                                     buffer[idx]);
-            if (status != URJ_STATUS_OK)
-                return status;
+            if (buffer[idx] != erased)
+            {
+                int status = intel_flash_program_single (cfi_array, adr,
+                                                         buffer[idx]);
+                if (status != URJ_STATUS_OK)
+                    return status;
+            }
             adr += cfi_array->bus_width;
         }
     }
@@ -459,7 +553,11 @@ intel_flash_erase_block32 (urj_flash_cfi_array_t *cfi_array, uint32_t adr)
     URJ_BUS_WRITE (bus, adr,
                    (CFI_INTEL_CMD_CONFIRM << 16) | CFI_INTEL_CMD_CONFIRM);
 
-    while (((sr = URJ_BUS_READ (bus, cfi_array->address) & 0x00FE00FE) & ((CFI_INTEL_SR_READY << 16) | CFI_INTEL_SR_READY)) != ((CFI_INTEL_SR_READY << 16) | CFI_INTEL_SR_READY));    /* TODO: add timeout */
+    if (intel_wait_ready (cfi_array, URJ_FLASH_OP_ERASE,
+                          (CFI_INTEL_SR_READY << 16) | CFI_INTEL_SR_READY,
+                          &sr) != URJ_STATUS_OK)
+        return URJ_STATUS_FAIL;
+    sr &= 0x00FE00FE;
 
     if (sr != ((CFI_INTEL_SR_READY << 16) | CFI_INTEL_SR_READY))
     {
@@ -488,7 +586,11 @@ intel_flash_unlock_block32 (urj_flash_cfi_array_t *cfi_array,
                    (CFI_INTEL_CMD_UNLOCK_BLOCK << 16) |
                    CFI_INTEL_CMD_UNLOCK_BLOCK);
 
-    while (((sr = URJ_BUS_READ (bus, cfi_array->address) & 0x00FE00FE) & ((CFI_INTEL_SR_READY << 16) | CFI_INTEL_SR_READY)) != ((CFI_INTEL_SR_READY << 16) | CFI_INTEL_SR_READY));    /* TODO: add timeout */
+    if (intel_wait_ready (cfi_array, URJ_FLASH_OP_OTHER,
+                          (CFI_INTEL_SR_READY << 16) | CFI_INTEL_SR_READY,
+                          &sr) != URJ_STATUS_OK)
+        return URJ_STATUS_FAIL;
+    sr &= 0x00FE00FE;
 
     if (sr != ((CFI_INTEL_SR_READY << 16) | CFI_INTEL_SR_READY))
     {
@@ -523,7 +625,11 @@ intel_flash_program32_single (urj_flash_cfi_array_t *cfi_array,
                    (CFI_INTEL_CMD_PROGRAM1 << 16) | CFI_INTEL_CMD_PROGRAM1);
     URJ_BUS_WRITE (bus, adr, data);
 
-    while (((sr = URJ_BUS_READ (bus, cfi_array->address) & 0x00FE00FE) & ((CFI_INTEL_SR_READY << 16) | CFI_INTEL_SR_READY)) != ((CFI_INTEL_SR_READY << 16) | CFI_INTEL_SR_READY));    /* TODO: add timeout */
+    if (intel_wait_ready (cfi_array, URJ_FLASH_OP_WRITE,
+                          (CFI_INTEL_SR_READY << 16) | CFI_INTEL_SR_READY,
+                          &sr) != URJ_STATUS_OK)
+        return URJ_STATUS_FAIL;
+    sr &= 0x00FE00FE;
 
     if (sr != ((CFI_INTEL_SR_READY << 16) | CFI_INTEL_SR_READY))
     {
@@ -539,18 +645,29 @@ static int
 intel_flash_program32 (urj_flash_cfi_array_t *cfi_array,
                        uint32_t adr, uint32_t *buffer, int count)
 {
-    /* Single byte programming is forced for 32 bit (2x16) flash configuration.
-       a) lack of testing capbilities for 2x16 multi-byte write operation
-       b) no implementation of intel_flash_program32_buffer() available
-       Closing these issues will enable multi-byte for 2x16 as well. */
+    urj_flash_cfi_query_structure_t *cfi = &(cfi_array->cfi_chips[0]->cfi);
+    int max_bytes_write = cfi->device_geometry.max_bytes_write;
+    uint32_t erased = URJ_FLASH_ERASED_WORD (cfi_array->bus_width);
     int idx;
 
+#ifndef FLASH_MULTI_BYTE
+    max_bytes_write = 1;
+#endif
+
+    /* multi-byte writes supported? */
+    if (max_bytes_write > 1)
+        return intel_flash_program_buffer (cfi_array, adr, buffer, count);
+
     /* unroll buffer to single writes */
     for (idx = 0; idx < count; idx++)
     {
-        int status = intel_flash_program32_single (cfi_array, adr, buffer[idx]);
-        if (status != URJ_STATUS_OK)
-            return status;
+        if (buffer[idx] != erased)
+        {
+            int status = intel_flash_program32_single (cfi_array, adr,
+                                                       buffer[idx]);
+            if (status != URJ_STATUS_OK)
+                return status;
+        }
         adr += cfi_array->bus_width;
     }
 
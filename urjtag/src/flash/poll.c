@@ -0,0 +1,151 @@
+/*
+ * $Id$
+ *
+ * Copyright (C) 2026 UrJTAG contributors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA
+ * 02111-1307, USA.
+ *
+ * Status polling for the flash drivers. Every status read over JTAG is a
+ * round trip to the cable, so the reads are queued in batches and the
+ * typical operation times from the CFI query decide when to look again.
+ * An SPI NOR flash sends its status register for as long as the clock runs
+ * after RDSR, so one transaction gives a batch there.
+ */
+
+#include <sysdep.h>
+
+#include <stdint.h>
+#include <unistd.h>
+
+#include <urjtag/bus.h>
+#include <urjtag/fclock.h>
+#include <urjtag/flash.h>
+#include <urjtag/log.h>
+
+#include "flash.h"
+#include "cfi.h"
+#include "spi_nor.h"
+
+/* status reads per cable flush */
+#define POLL_BATCH              8
+/* pause between batches once the typical time is over */
+#define POLL_INTERVAL_US        100
+/* no operation times out sooner, whatever the CFI maximum says */
+#define POLL_MIN_TIMEOUT_US     1000000L
+
+static void
+poll_timing (urj_flash_cfi_array_t *cfi_array, urj_flash_op_t op,
+             long *typ_us, long *max_us)
+{
+    const urj_flash_cfi_query_structure_t *cfi =
+        &cfi_array->cfi_chips[0]->cfi;
+
+    switch (op)
+    {
+    case URJ_FLASH_OP_WRITE:
+        *typ_us = cfi->system_interface_info.typ_single_write_timeout;
+        *max_us = cfi->system_interface_info.max_single_write_timeout;
+        break;
+    case URJ_FLASH_OP_BUFFER_WRITE:
+        *typ_us = cfi->system_interface_info.typ_buffer_write_timeout;
+        *max_us = cfi->system_interface_info.max_buffer_write_timeout;
+        break;
+    case URJ_FLASH_OP_ERASE:
+        *typ_us = cfi->system_interface_info.typ_block_erase_timeout * 1000L;
+        *max_us = cfi->system_interface_info.max_block_erase_timeout * 1000L;
+        break;
+    default:
+        *typ_us = 0;
+        *max_us = 0;
+        break;
+    }
+
+    if (*max_us < POLL_MIN_TIMEOUT_US)
+        *max_us = POLL_MIN_TIMEOUT_US;
+}
+
+static int
+poll_read (urj_flash_cfi_array_t *cfi_array, uint32_t adr, uint32_t *words)
+{
+    urj_bus_t *bus = cfi_array->bus;
+    uint8_t cmd = SPI_NOR_CMD_RDSR;
+    uint8_t sr[POLL_BATCH];
+    int i;
+
+    if (URJ_BUS_TYPE (bus) != URJ_BUS_TYPE_SPI)
+        return urj_bus_read_repeat (bus, adr, words, POLL_BATCH);
+
+    if (urj_bus_transfer (bus, &cmd, 1, sr, POLL_BATCH) != URJ_STATUS_OK)
+        return URJ_STATUS_FAIL;
+    for (i = 0; i < POLL_BATCH; i++)
+        words[i] = sr[i];
+
+    return URJ_STATUS_OK;
+}
+
+int
+urj_flash_poll (urj_flash_cfi_array_t *cfi_array, uint32_t adr,
+                urj_flash_op_t op, urj_flash_poll_done_t done,
+                const void *arg, uint32_t *status)
+{
+    uint32_t words[POLL_BATCH];
+    uint32_t last;
+    const uint32_t *prev = NULL;
+    long double start = urj_lib_frealtime ();
+    long typ_us, max_us, elapsed_us;
+    int batch, i, r;
+
+    poll_timing (cfi_array, op, &typ_us, &max_us);
+
+    /* the operation is hardly ever over sooner */
+    if (typ_us > 0)
+        usleep (typ_us);
+
+    for (batch = 0;; batch++)
+    {
+        if (poll_read (cfi_array, adr, words) != URJ_STATUS_OK)
+            return URJ_STATUS_FAIL;
+
+        for (i = 0; i < POLL_BATCH; i++)
+        {
+            *status = words[i];
+            r = done (prev, words[i], arg);
+            if (r != 0)
+            {
+                urj_log (URJ_LOG_LEVEL_DEBUG,
+                         "flash poll 0x%08lX: %s after %d reads: 0x%08lX\n",
+                         (long unsigned) adr, r > 0 ? "done" : "failed",
+                         batch * POLL_BATCH + i + 1, (long unsigned) *status);
+                return r > 0 ? URJ_STATUS_OK : URJ_STATUS_FAIL;
+            }
+            prev = &words[i];
+        }
+        /* the last read of this batch comes before the next one */
+        last = words[POLL_BATCH - 1];
+        prev = &last;
+
+        elapsed_us = (urj_lib_frealtime () - start) * 1e6;
+        if (elapsed_us >= max_us)
+        {
+            urj_log (URJ_LOG_LEVEL_DEBUG,
+                     "flash poll 0x%08lX: timeout after %ld us: 0x%08lX\n",
+                     (long unsigned) adr, elapsed_us, (long unsigned) *status);
+            return URJ_STATUS_FAIL;
+        }
+
+        usleep (POLL_INTERVAL_US);
+    }
+}
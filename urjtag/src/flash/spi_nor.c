@@ -0,0 +1,502 @@
+/*
+ * $Id$
+ *
+ * Copyright (C) 2026 UrJTAG contributors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA
+ * 02111-1307, USA.
+ *
+ * SPI NOR flash on a bus of type URJ_BUS_TYPE_SPI.
+ *
+ * The geometry and the timing come from the SFDP basic flash parameter
+ * table [1] when the flash has one, else from the JEDEC ID. The result is
+ * filled into a CFI query structure, so that flashmem, flasherase and
+ * detectflash work as they do for parallel flashes. The smallest erase
+ * type is the erase block; only the first 16 MiB (3 byte addresses) are
+ * used.
+ *
+ * Documentation:
+ * [1] JEDEC Solid State Technology Association, "Serial Flash Discoverable
+ *     Parameters (SFDP)", JESD216B, 2015
+ *
+ */
+
+#include <sysdep.h>
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <urjtag/log.h>
+#include <urjtag/error.h>
+#include <urjtag/flash.h>
+#include <urjtag/bus.h>
+
+#include "flash.h"
+#include "cfi.h"
+#include "spi_nor.h"
+
+/* 3 byte addresses */
+#define SPI_NOR_MAX_SIZE        0x01000000
+/* basic flash parameter table dwords read, JESD216B has 16 */
+#define SFDP_BFPT_DWORDS        16
+
+/* kept in pri_vendor_tbl */
+typedef struct
+{
+    uint8_t id[3];              /* JEDEC ID: manufacturer, type, capacity */
+    int sfdp;                   /* geometry from SFDP */
+    uint8_t erase_opcode;
+}
+spi_nor_t;
+
+static int
+spi_nor_cmd_adr (urj_bus_t *bus, uint8_t cmd, uint32_t adr,
+                 const uint8_t *out, int out_len, uint8_t *in, int in_len)
+{
+    uint8_t buf[4 + 256 + 1];
+
+    if (out_len > (int) sizeof buf - 4)
+    {
+        urj_error_set (URJ_ERROR_INVALID, "SPI transfer of %d bytes",
+                       out_len);
+        return URJ_STATUS_FAIL;
+    }
+
+    buf[0] = cmd;
+    buf[1] = adr >> 16;
+    buf[2] = adr >> 8;
+    buf[3] = adr;
+    if (out_len > 0)
+        memcpy (buf + 4, out, out_len);
+
+    return urj_bus_transfer (bus, buf, 4 + out_len, in, in_len);
+}
+
+static int
+spi_nor_read_sfdp (urj_bus_t *bus, uint32_t adr, uint8_t *in, int len)
+{
+    /* one dummy byte after the address */
+    static const uint8_t dummy = 0;
+
+    return spi_nor_cmd_adr (bus, SPI_NOR_CMD_RDSFDP, adr, &dummy, 1, in, len);
+}
+
+static uint32_t
+sfdp_dword (const uint8_t *p)
+{
+    return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t) p[3] << 24);
+}
+
+/* typical time of SFDP erase type @t (0..3) in ms */
+static uint32_t
+sfdp_erase_time (uint32_t dw10, int t)
+{
+    static const uint32_t unit_ms[4] = { 1, 16, 128, 1000 };
+    uint32_t count = (dw10 >> (4 + 7 * t)) & 0x1F;
+    uint32_t units = (dw10 >> (9 + 7 * t)) & 0x03;
+
+    return (count + 1) * unit_ms[units];
+}
+
+/*
+ * Fill @cfi and @nor from the SFDP basic flash parameter table, see
+ * section 6.4 in [1].
+ *
+ * @return URJ_STATUS_OK when the flash has SFDP, URJ_STATUS_FAIL otherwise
+ */
+static int
+spi_nor_sfdp (urj_bus_t *bus, urj_flash_cfi_query_structure_t *cfi,
+              spi_nor_t *nor, uint32_t *erase_size)
+{
+    uint8_t hdr[8], ph[8], tbl[SFDP_BFPT_DWORDS * 4];
+    uint32_t dw[SFDP_BFPT_DWORDS];
+    uint32_t ptp, size;
+    int len, i, t, erase_type = -1;
+
+    if (spi_nor_read_sfdp (bus, 0, hdr, sizeof hdr) != URJ_STATUS_OK
+        || memcmp (hdr, "SFDP", 4) != 0)
+        return URJ_STATUS_FAIL;
+
+    /* the first parameter header is the basic flash parameter table */
+    if (spi_nor_read_sfdp (bus, 8, ph, sizeof ph) != URJ_STATUS_OK
+        || ph[0] != 0x00 || ph[7] != 0xFF || ph[3] < 9)
+        return URJ_STATUS_FAIL;
+
+    len = ph[3] < SFDP_BFPT_DWORDS ? ph[3] : SFDP_BFPT_DWORDS;
+    ptp = ph[4] | (ph[5] << 8) | (ph[6] << 16);
+    if (spi_nor_read_sfdp (bus, ptp, tbl, len * 4) != URJ_STATUS_OK)
+        return URJ_STATUS_FAIL;
+    for (i = 0; i < len; i++)
+        dw[i] = sfdp_dword (tbl + 4 * i);
+
+    /* DW2: density in bits */
+    if (dw[1] & 0x80000000)
+        size = (dw[1] & 0x7FFFFFFF) >= 27 ? SPI_NOR_MAX_SIZE
+            : (UINT32_C (1) << (dw[1] & 0x7FFFFFFF)) / 8;
+    else
+        size = (dw[1] + 1) / 8;
+    cfi->device_geometry.device_size =
+        size > SPI_NOR_MAX_SIZE ? SPI_NOR_MAX_SIZE : size;
+
+    /* DW8, DW9: erase types, take the smallest */
+    *erase_size = 0;
+    for (t = 0; t < 4; t++)
+    {
+        uint32_t d = dw[7 + t / 2] >> (16 * (t % 2));
+        uint32_t n = d & 0xFF;
+
+        if (n == 0 || n >= 32)
+            continue;
+        if (*erase_size == 0 || (UINT32_C (1) << n) < *erase_size)
+        {
+            *erase_size = UINT32_C (1) << n;
+            nor->erase_opcode = (d >> 8) & 0xFF;
+            erase_type = t;
+        }
+    }
+    /* DW1: 4 KiB erase */
+    if (*erase_size == 0 && (dw[0] & 0x03) == 0x01)
+    {
+        *erase_size = 4096;
+        nor->erase_opcode = (dw[0] >> 8) & 0xFF;
+    }
+    if (*erase_size == 0)
+        return URJ_STATUS_FAIL;
+
+    /* DW10: erase times; DW11: page size and program time */
+    if (len >= 11)
+    {
+        uint32_t mult;
+
+        if (erase_type >= 0)
+        {
+            mult = 2 * ((dw[9] & 0x0F) + 1);
+            cfi->system_interface_info.typ_block_erase_timeout =
+                sfdp_erase_time (dw[9], erase_type);
+            cfi->system_interface_info.max_block_erase_timeout =
+                mult * cfi->system_interface_info.typ_block_erase_timeout;
+        }
+
+        mult = 2 * ((dw[10] & 0x0F) + 1);
+        cfi->device_geometry.max_bytes_write = 1 << ((dw[10] >> 4) & 0x0F);
+        cfi->system_interface_info.typ_buffer_write_timeout =
+            (((dw[10] >> 8) & 0x1F) + 1) * ((dw[10] & 0x2000) ? 64 : 8);
+        cfi->system_interface_info.max_buffer_write_timeout =
+            mult * cfi->system_interface_info.typ_buffer_write_timeout;
+    }
+
+    nor->sfdp = 1;
+
+    return URJ_STATUS_OK;
+}
+
+int
+urj_flash_spi_nor_detect (urj_bus_t *bus, uint32_t adr,
+                          urj_flash_cfi_array_t **cfi_array)
+{
+    urj_flash_cfi_query_structure_t *cfi;
+    spi_nor_t *nor;
+    uint8_t cmd = SPI_NOR_CMD_RDID;
+    uint32_t erase_size;
+
+    if (URJ_BUS_TYPE (bus) != URJ_BUS_TYPE_SPI)
+        return URJ_STATUS_FAIL;
+
+    *cfi_array = calloc (1, sizeof (urj_flash_cfi_array_t));
+    if (!*cfi_array)
+    {
+        urj_error_set (URJ_ERROR_OUT_OF_MEMORY, "calloc(%zd,%zd) fails",
+                       (size_t) 1, sizeof (urj_flash_cfi_array_t));
+        return URJ_STATUS_FAIL;
+    }
+
+    (*cfi_array)->bus = bus;
+    (*cfi_array)->address = 0;
+    (*cfi_array)->bus_width = 1;
+    (*cfi_array)->cfi_chips = calloc (1, sizeof (urj_flash_cfi_chip_t *));
+    if (!(*cfi_array)->cfi_chips)
+    {
+        urj_error_set (URJ_ERROR_OUT_OF_MEMORY, "calloc(%zd,%zd) fails",
+                       (size_t) 1, sizeof (urj_flash_cfi_chip_t *));
+        return URJ_STATUS_FAIL;
+    }
+
+    (*cfi_array)->cfi_chips[0] = calloc (1, sizeof (urj_flash_cfi_chip_t));
+    if (!(*cfi_array)->cfi_chips[0])
+    {
+        urj_error_set (URJ_ERROR_OUT_OF_MEMORY, "calloc(%zd,%zd) fails",
+                       (size_t) 1, sizeof (urj_flash_cfi_chip_t));
+        return URJ_STATUS_FAIL;
+    }
+    (*cfi_array)->cfi_chips[0]->width = 1;
+    cfi = &(*cfi_array)->cfi_chips[0]->cfi;
+
+    nor = calloc (1, sizeof (spi_nor_t));
+    if (!nor)
+    {
+        urj_error_set (URJ_ERROR_OUT_OF_MEMORY, "calloc(%zd,%zd) fails",
+                       (size_t) 1, sizeof (spi_nor_t));
+        return URJ_STATUS_FAIL;
+    }
+    cfi->identification_string.pri_id_code = CFI_VENDOR_NULL;
+    cfi->identification_string.pri_vendor_tbl = nor;
+    cfi->identification_string.alt_id_code = CFI_VENDOR_NULL;
+
+    if (urj_bus_transfer (bus, &cmd, 1, nor->id, sizeof nor->id)
+        != URJ_STATUS_OK)
+        return URJ_STATUS_FAIL;
+    if (nor->id[0] == 0x00 || nor->id[0] == 0xFF)
+    {
+        urj_error_set (URJ_ERROR_FLASH_DETECT, _("no SPI NOR flash found"));
+        return URJ_STATUS_FAIL;
+    }
+
+    cfi->device_geometry.device_interface = CFI_INTERFACE_X8;
+    cfi->device_geometry.max_bytes_write = 256;
+
+    if (spi_nor_sfdp (bus, cfi, nor, &erase_size) != URJ_STATUS_OK)
+    {
+        /* no SFDP: the capacity byte of the JEDEC ID is log2 of the size,
+           and about every SPI NOR flash has the 4 KiB sector erase */
+        if (nor->id[2] < 16 || nor->id[2] > 24)
+        {
+            urj_error_set (URJ_ERROR_FLASH_DETECT,
+                           _("SPI NOR flash 0x%02X%02X%02X: unknown size"),
+                           nor->id[0], nor->id[1], nor->id[2]);
+            return URJ_STATUS_FAIL;
+        }
+        nor->sfdp = 0;
+        nor->erase_opcode = SPI_NOR_CMD_SE;
+        erase_size = 4096;
+        cfi->device_geometry.device_size = UINT32_C (1) << nor->id[2];
+    }
+
+    cfi->device_geometry.number_of_erase_regions = 1;
+    cfi->device_geometry.erase_block_regions =
+        malloc (sizeof (urj_flash_cfi_erase_block_region_t));
+    if (!cfi->device_geometry.erase_block_regions)
+    {
+        urj_error_set (URJ_ERROR_OUT_OF_MEMORY, "malloc(%zd) fails",
+                       sizeof (urj_flash_cfi_erase_block_region_t));
+        return URJ_STATUS_FAIL;
+    }
+    cfi->device_geometry.erase_block_regions[0].erase_block_size =
+        erase_size;
+    cfi->device_geometry.erase_block_regions[0].number_of_erase_blocks =
+        cfi->device_geometry.device_size / erase_size;
+
+    return URJ_STATUS_OK;
+}
+
+static spi_nor_t *
+spi_nor (urj_flash_cfi_array_t *cfi_array)
+{
+    return cfi_array->cfi_chips[0]->cfi.identification_string.pri_vendor_tbl;
+}
+
+/* urj_flash_poll() condition on the status register */
+static int
+spi_nor_ready (const uint32_t *prev, uint32_t status, const void *arg)
+{
+    return (status & SPI_NOR_SR_WIP) == 0;
+}
+
+static int
+spi_nor_write_enable (urj_bus_t *bus)
+{
+    uint8_t cmd = SPI_NOR_CMD_WREN;
+
+    return urj_bus_transfer (bus, &cmd, 1, NULL, 0);
+}
+
+static int
+spi_nor_autodetect (urj_flash_cfi_array_t *cfi_array)
+{
+    return URJ_BUS_TYPE (cfi_array->bus) == URJ_BUS_TYPE_SPI;
+}
+
+static void
+spi_nor_print_info (urj_log_level_t ll, urj_flash_cfi_array_t *cfi_array)
+{
+    urj_flash_cfi_query_structure_t *cfi = &cfi_array->cfi_chips[0]->cfi;
+    spi_nor_t *nor = spi_nor (cfi_array);
+
+    urj_log (ll, _("Chip: SPI NOR Flash\n"));
+    urj_log (ll, _("\tManufacturer: 0x%02X\n"), nor->id[0]);
+    urj_log (ll, _("\tChip: 0x%02X%02X\n"), nor->id[1], nor->id[2]);
+    urj_log (ll, _("\tGeometry: %s\n"), nor->sfdp ? "SFDP" : "JEDEC ID");
+    urj_log (ll, _("\tPage: %d B, Erase: %d KiB (0x%02X)\n"),
+             (int) cfi->device_geometry.max_bytes_write,
+             (int) cfi->device_geometry.erase_block_regions[0].
+             erase_block_size / 1024, nor->erase_opcode);
+}
+
+static int
+spi_nor_erase_block (urj_flash_cfi_array_t *cfi_array, uint32_t adr)
+{
+    urj_bus_t *bus = cfi_array->bus;
+    uint32_t status;
+
+    urj_log (URJ_LOG_LEVEL_NORMAL, "flash_erase_block 0x%08lX\n",
+             (long unsigned) adr);
+
+    if (spi_nor_write_enable (bus) != URJ_STATUS_OK
+        || spi_nor_cmd_adr (bus, spi_nor (cfi_array)->erase_opcode, adr,
+                            NULL, 0, NULL, 0) != URJ_STATUS_OK)
+        return URJ_STATUS_FAIL;
+
+    if (urj_flash_poll (cfi_array, adr, URJ_FLASH_OP_ERASE, spi_nor_ready,
+                        NULL, &status) != URJ_STATUS_OK)
+    {
+        urj_log (URJ_LOG_LEVEL_NORMAL, "flash_erase_block 0x%08lX FAILED\n",
+                 (long unsigned) adr);
+        urj_error_set (URJ_ERROR_FLASH_ERASE, "erase timeout, status 0x%02lX",
+                       (long unsigned) status);
+        return URJ_STATUS_FAIL;
+    }
+
+    urj_log (URJ_LOG_LEVEL_NORMAL, "flash_erase_block 0x%08lX DONE\n",
+             (long unsigned) adr);
+    return URJ_STATUS_OK;
+}
+
+static int
+spi_nor_lock_block (urj_flash_cfi_array_t *cfi_array, uint32_t adr)
+{
+    urj_log (URJ_LOG_LEVEL_NORMAL, "flash_lock_block 0x%08lX IGNORE\n",
+             (long unsigned) adr);
+    return URJ_STATUS_OK;
+}
+
+/* the block protect bits cover the whole chip, clear them when set */
+static int
+spi_nor_unlock_block (urj_flash_cfi_array_t *cfi_array, uint32_t adr)
+{
+    urj_bus_t *bus = cfi_array->bus;
+    uint8_t cmd[2], sr;
+    uint32_t status;
+
+    cmd[0] = SPI_NOR_CMD_RDSR;
+    if (urj_bus_transfer (bus, cmd, 1, &sr, 1) != URJ_STATUS_OK)
+        return URJ_STATUS_FAIL;
+    if ((sr & SPI_NOR_SR_BP) == 0)
+        return URJ_STATUS_OK;
+
+    cmd[0] = SPI_NOR_CMD_WRSR;
+    cmd[1] = sr & ~SPI_NOR_SR_BP;
+    if (spi_nor_write_enable (bus) != URJ_STATUS_OK
+        || urj_bus_transfer (bus, cmd, 2, NULL, 0) != URJ_STATUS_OK)
+        return URJ_STATUS_FAIL;
+
+    if (urj_flash_poll (cfi_array, adr, URJ_FLASH_OP_OTHER, spi_nor_ready,
+                        NULL, &status) != URJ_STATUS_OK)
+    {
+        urj_error_set (URJ_ERROR_FLASH_UNLOCK,
+                       "write status timeout, status 0x%02lX",
+                       (long unsigned) status);
+        return URJ_STATUS_FAIL;
+    }
+
+    return URJ_STATUS_OK;
+}
+
+static int
+spi_nor_program_page (urj_flash_cfi_array_t *cfi_array, uint32_t adr,
+                      const uint32_t *buffer, int count)
+{
+    urj_bus_t *bus = cfi_array->bus;
+    uint8_t data[256];
+    uint32_t status;
+    int i;
+
+    urj_log (URJ_LOG_LEVEL_DEBUG, "\nflash_program_page 0x%08lX, %d B\n",
+             (long unsigned) adr, count);
+
+    for (i = 0; i < count; i++)
+        data[i] = buffer[i];
+
+    if (spi_nor_write_enable (bus) != URJ_STATUS_OK
+        || spi_nor_cmd_adr (bus, SPI_NOR_CMD_PP, adr, data, count, NULL, 0)
+        != URJ_STATUS_OK)
+        return URJ_STATUS_FAIL;
+
+    if (urj_flash_poll (cfi_array, adr, URJ_FLASH_OP_BUFFER_WRITE,
+                        spi_nor_ready, NULL, &status) != URJ_STATUS_OK)
+    {
+        urj_error_set (URJ_ERROR_FLASH_PROGRAM,
+                       "page program timeout, status 0x%02lX",
+                       (long unsigned) status);
+        return URJ_STATUS_FAIL;
+    }
+
+    return URJ_STATUS_OK;
+}
+
+static int
+spi_nor_program (urj_flash_cfi_array_t *cfi_array, uint32_t adr,
+                 uint32_t *buffer, int count)
+{
+    urj_flash_cfi_query_structure_t *cfi = &cfi_array->cfi_chips[0]->cfi;
+    uint32_t page = cfi->device_geometry.max_bytes_write;
+    int n, first, last;
+
+    /* the page buffer of spi_nor_program_page() */
+    if (page > 256)
+        page = 256;
+
+    while (count > 0)
+    {
+        /* up to the end of the page; PP wraps around inside a page */
+        n = page - adr % page;
+        if (n > count)
+            n = count;
+
+        /* leave out the 0xFF at both ends, they are erased already */
+        for (first = 0; first < n && buffer[first] == 0xFF; first++)
+            ;
+        for (last = n; last > first && buffer[last - 1] == 0xFF; last--)
+            ;
+        if (first < last
+            && spi_nor_program_page (cfi_array, adr + first, buffer + first,
+                                     last - first) != URJ_STATUS_OK)
+            return URJ_STATUS_FAIL;
+
+        adr += n;
+        buffer += n;
+        count -= n;
+    }
+
+    return URJ_STATUS_OK;
+}
+
+static void
+spi_nor_read_array (urj_flash_cfi_array_t *cfi_array)
+{
+    /* SPI NOR flashes are always in read array mode */
+}
+
+const urj_flash_driver_t urj_flash_spi_nor_flash_driver = {
+    N_("SPI NOR"),
+    N_("supported: SPI NOR flashes with 3 byte addresses, SFDP"),
+    1,                          /* buswidth */
+    spi_nor_autodetect,
+    spi_nor_print_info,
+    spi_nor_erase_block,
+    spi_nor_lock_block,
+    spi_nor_unlock_block,
+    spi_nor_program,
+    spi_nor_read_array,
+};
@@ -0,0 +1,55 @@
+/*
+ * $Id$
+ *
+ * Copyright (C) 2026 UrJTAG contributors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA
+ * 02111-1307, USA.
+ *
+ * Documentation:
+ * [1] JEDEC Solid State Technology Association, "Serial Flash Discoverable
+ *     Parameters (SFDP)", JESD216B, 2015
+ *
+ */
+
+#ifndef URJ_FLASH_SPI_NOR_H
+#define URJ_FLASH_SPI_NOR_H
+
+#include <urjtag/types.h>
+#include <urjtag/flash.h>
+
+/* commands common to SPI NOR flashes with 3 byte addresses */
+#define SPI_NOR_CMD_WRSR        0x01
+#define SPI_NOR_CMD_PP          0x02
+#define SPI_NOR_CMD_READ        0x03
+#define SPI_NOR_CMD_WRDI        0x04
+#define SPI_NOR_CMD_RDSR        0x05
+#define SPI_NOR_CMD_WREN        0x06
+#define SPI_NOR_CMD_SE          0x20    /* 4 KiB sector erase */
+#define SPI_NOR_CMD_RDSFDP      0x5A
+#define SPI_NOR_CMD_RDID        0x9F
+#define SPI_NOR_CMD_BE          0xD8    /* 64 KiB block erase */
+
+/* status register */
+#define SPI_NOR_SR_WIP          0x01    /* write in progress */
+#define SPI_NOR_SR_WEL          0x02    /* write enable latch */
+#define SPI_NOR_SR_BP           0x1C    /* block protect BP0..BP2 */
+
+int urj_flash_spi_nor_detect (urj_bus_t *bus, uint32_t adr,
+                              urj_flash_cfi_array_t **cfi_array);
+
+extern const urj_flash_driver_t urj_flash_spi_nor_flash_driver;
+
+#endif /* ndef URJ_FLASH_SPI_NOR_H */
@@ -24,6 +24,7 @@
 #include <sysdep.h>
 
 #include <stdarg.h>
+#include <stdlib.h>
 #include <errno.h>
 #include <string.h>
 #include <stdbool.h>
@@ -32,7 +33,7 @@
 #include <urjtag/error.h>
 #include <urjtag/jtag.h>
 
-urj_error_state_t urj_error_state;
+URJ_THREAD_LOCAL urj_error_state_t urj_error_state;
 
 static int stderr_vprintf (const char *fmt, va_list ap);
 static int stdout_vprintf (const char *fmt, va_list ap);
@@ -103,6 +104,27 @@ urj_do_log (urj_log_level_t level, const char *file, size_t line,
     return r;
 }
 
+void
+urj_do_log_bits (urj_log_level_t level, const char *file, size_t line,
+                 const char *func, const char *prefix, int len,
+                 const char *vec)
+{
+    char *s;
+    int i;
+
+    s = malloc (len + 1);
+    if (s == NULL)
+        return;
+
+    for (i = 0; i < len; i++)
+        s[i] = vec[i] ? '1' : '0';
+    s[len] = '\0';
+
+    urj_do_log (level, file, line, func, "%s%s\n", prefix, s);
+
+    free (s);
+}
+
 urj_error_t
 urj_error_get (void)
 {
@@ -211,7 +233,7 @@ urj_error_string (urj_error_t err)
 const char *
 urj_error_describe (void)
 {
-    static char msg[URJ_ERROR_MSG_LEN + 1024 + 256 + 20];
+    static URJ_THREAD_LOCAL char msg[URJ_ERROR_MSG_LEN + 1024 + 256 + 20];
 
     if (urj_error_state.errnum == URJ_ERROR_IO)
     {
@@ -285,7 +285,7 @@ const char *
 urj_param_string(const urj_param_list_t *params, const urj_param_t *p)
 {
 #define PARAM_BUF_SIZE  256
-    static char buf[PARAM_BUF_SIZE];
+    static URJ_THREAD_LOCAL char buf[PARAM_BUF_SIZE];
     size_t size;
 
     snprintf(buf, sizeof buf, "%s=", urj_param_key_string(params, p->key));
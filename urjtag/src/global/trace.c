@@ -0,0 +1,134 @@
+/*
+ * $Id$
+ *
+ * Copyright (C) 2026 UrJTAG contributors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA
+ * 02111-1307, USA.
+ *
+ * The trace file is a JSON array of trace events, see "Trace Event Format"
+ * of the Chromium project. Timestamps are microseconds since the start of
+ * the trace. All events belong to one process; each thread that records
+ * events gets a thread id of its own.
+ */
+
+#include <sysdep.h>
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <urjtag/error.h>
+#include <urjtag/fclock.h>
+#include <urjtag/trace.h>
+
+FILE *urj_trace_file = NULL;
+
+static long double trace_start_time;
+static int trace_events;
+static int trace_threads;
+static URJ_THREAD_LOCAL int trace_tid;
+
+void
+urj_trace_event (char ph, const char *cat, const char *name,
+                 const char *args, ...)
+{
+    long double ts = (urj_lib_frealtime () - trace_start_time) * 1e6;
+    va_list ap;
+
+    if (urj_trace_file == NULL)
+        return;
+
+#ifdef HAVE_FLOCKFILE
+    flockfile (urj_trace_file);
+#endif
+    if (trace_tid == 0)
+        trace_tid = ++trace_threads;
+    fprintf (urj_trace_file,
+             "%s{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"%c\",\"ts\":%.3Lf,"
+             "\"pid\":1,\"tid\":%d",
+             trace_events++ ? ",\n" : "", name, cat, ph, ts, trace_tid);
+    if (ph == URJ_TRACE_INSTANT)
+        fputs (",\"s\":\"t\"", urj_trace_file);
+    if (args != NULL)
+    {
+        fputs (",\"args\":{", urj_trace_file);
+        va_start (ap, args);
+        vfprintf (urj_trace_file, args, ap);
+        va_end (ap);
+        fputc ('}', urj_trace_file);
+    }
+    fputc ('}', urj_trace_file);
+#ifdef HAVE_FLOCKFILE
+    funlockfile (urj_trace_file);
+#endif
+}
+
+void
+urj_trace_stop (void)
+{
+    if (urj_trace_file == NULL)
+        return;
+
+    fputs ("\n]\n", urj_trace_file);
+    fclose (urj_trace_file);
+    urj_trace_file = NULL;
+}
+
+int
+urj_trace_start (const char *filename)
+{
+    static int registered;
+    FILE *f;
+
+    urj_trace_stop ();
+
+    f = fopen (filename, FOPEN_W);
+    if (f == NULL)
+    {
+        urj_error_IO_set (_("Unable to create trace file '%s'"), filename);
+        return URJ_STATUS_FAIL;
+    }
+
+    if (!registered)
+    {
+        atexit (urj_trace_stop);
+        registered = 1;
+    }
+
+    fputs ("[\n", f);
+    trace_start_time = urj_lib_frealtime ();
+    trace_events = 0;
+    urj_trace_file = f;
+
+    return URJ_STATUS_OK;
+}
+
+int
+urj_trace_from_env (void)
+{
+    static int checked;
+    const char *filename;
+
+    if (checked)
+        return URJ_STATUS_OK;
+    checked = 1;
+
+    filename = getenv ("URJ_TRACE");
+    if (filename == NULL || *filename == '\0')
+        return URJ_STATUS_OK;
+
+    return urj_trace_start (filename);
+}
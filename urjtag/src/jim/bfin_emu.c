@@ -0,0 +1,547 @@
+/*
+ * $Id$
+ *
+ * Copyright (C) 2026 UrJTAG contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * A Blackfin core with its emulation TAP and RAM at address 0. Instructions
+ * (5 bit IR, as in data/analog/bfin/bfin):
+ *
+ *   00010      IDCODE          (IDR, the IDCODE of a BF537)
+ *   01100      DBGSTAT_SCAN    (DBGSTAT)
+ *   00100      DBGCTL_SCAN     (DBGCTL)
+ *   01000      EMUIR_SCAN      (EMUIR or EMUIR64, after DBGCTL EMUIRSZ)
+ *   10100      EMUDAT_SCAN     (EMUDAT or EMUDAT40, after DBGCTL EMUDATSZ)
+ *   11110      EMUPC_SCAN      (EMUPC)
+ *   all others BYPASS
+ *
+ * Except IDCODE, the data registers shift out MSB first. DBGCTL with EMPWR,
+ * EMEEN and WAKEUP enters emulation mode. In emulation mode, every entry
+ * into Run-Test/Idle runs EMUIR (both instructions with EMUIRLPSZ_2), which
+ * takes a given number of TCK cycles plus some more for each memory access;
+ * DBGSTAT shows EMUREADY when it is done. Entries while it runs are lost.
+ * Known instructions are the register moves, the loads and stores of
+ * src/bfin/insn-gen.c, "JUMP (Preg)" and RTE; all others do nothing. RTE
+ * with DBGCTL ESSTEP steps over one 16 bit instruction at EMUPC and stays
+ * in emulation mode.
+ * EMUDOF is cleared when EMUDAT is captured, EMUDIF is set when EMUDAT is
+ * updated with EMUDIF set, or always for the 32 bit EMUDAT.
+ */
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <urjtag/types.h>
+#include <urjtag/log.h>
+#include <urjtag/error.h>
+#include <urjtag/jim.h>
+
+#define BFIN_DR_BYPASS          0
+#define BFIN_DR_IDR             1
+#define BFIN_DR_DBGSTAT         2
+#define BFIN_DR_DBGCTL          3
+#define BFIN_DR_EMUIR           4
+#define BFIN_DR_EMUIR64         5
+#define BFIN_DR_EMUDAT          6
+#define BFIN_DR_EMUDAT40        7
+#define BFIN_DR_EMUPC           8
+
+#define BFIN_IR_IDCODE          0x02
+#define BFIN_IR_DBGSTAT         0x0c
+#define BFIN_IR_DBGCTL          0x04
+#define BFIN_IR_EMUIR           0x08
+#define BFIN_IR_EMUDAT          0x14
+#define BFIN_IR_EMUPC           0x1e
+
+/* BF537 */
+#define BFIN_IDCODE             0x027c80cb
+
+#define BFIN_DBGCTL_WAKEUP      0x0800
+#define BFIN_DBGCTL_ESSTEP      0x0200
+#define BFIN_DBGCTL_EMUDATSZ    0x0180
+#define BFIN_DBGCTL_EMUDATSZ_40 0x0080
+#define BFIN_DBGCTL_EMUIRLPSZ_2 0x0040
+#define BFIN_DBGCTL_EMUIRSZ     0x0030
+#define BFIN_DBGCTL_EMUIRSZ_32  0x0020
+#define BFIN_DBGCTL_EMEEN       0x0004
+#define BFIN_DBGCTL_EMPWR       0x0001
+
+#define BFIN_DBGSTAT_EMUCAUSE   0x03c0
+#define BFIN_DBGSTAT_EMUCAUSE_SHIFT 6
+#define BFIN_DBGSTAT_EMUACK     0x0020
+#define BFIN_DBGSTAT_EMUREADY   0x0010
+#define BFIN_DBGSTAT_EMUDIOVF   0x0008
+#define BFIN_DBGSTAT_EMUDOOVF   0x0004
+#define BFIN_DBGSTAT_EMUDIF     0x0002
+#define BFIN_DBGSTAT_EMUDOF     0x0001
+
+/* register groups and numbers as in enum core_regnum */
+#define BFIN_GROUP_R            0
+#define BFIN_GROUP_P            1
+#define BFIN_GROUP_EMUDAT       7
+#define BFIN_NUM_EMUDAT         7
+
+#define BFIN_INSN_RTE           0x0014
+
+#define BFIN_EMUCAUSE_EMUIN     0x1
+#define BFIN_EMUCAUSE_SSTEP     0x8
+
+typedef struct
+{
+    uint8_t *ram;
+    uint32_t ram_size;
+    int core;                   /* TCKs to run EMUIR */
+    int mem;                    /* more TCKs for each memory access */
+    uint16_t dbgctl;
+    int emu;                    /* in emulation mode */
+    int cause;                  /* EMUCAUSE */
+    int busy;                   /* TCKs until EMUIR has run */
+    uint64_t emuir[2];          /* [0] runs first */
+    uint32_t emudat_in;
+    uint32_t emudat_out;
+    int dif, dof, diovf, doovf;
+    uint32_t regs[8][8];        /* by group and number */
+    uint32_t emupc;
+}
+bfin_state_t;
+
+/* The value of a register that shifts MSB first */
+static uint64_t
+urj_jim_bfin_get (const uint32_t *reg, int len)
+{
+    uint64_t v = 0;
+    int i;
+
+    for (i = 0; i < len; i++)
+        v = (v << 1) | ((reg[i / 32] >> (i % 32)) & 1);
+
+    return v;
+}
+
+static void
+urj_jim_bfin_put (uint32_t *reg, int len, uint64_t v)
+{
+    int i;
+
+    for (i = 0; i < len; i++)
+    {
+        if ((v >> (len - 1 - i)) & 1)
+            reg[i / 32] |= UINT32_C (1) << (i % 32);
+        else
+            reg[i / 32] &= ~(UINT32_C (1) << (i % 32));
+    }
+}
+
+static uint32_t
+urj_jim_bfin_reg (bfin_state_t *bs, int group, int num)
+{
+    if (group == BFIN_GROUP_EMUDAT && num == BFIN_NUM_EMUDAT)
+    {
+        bs->dif = 0;
+        return bs->emudat_in;
+    }
+    return bs->regs[group][num];
+}
+
+static void
+urj_jim_bfin_set_reg (bfin_state_t *bs, int group, int num, uint32_t v)
+{
+    if (group == BFIN_GROUP_EMUDAT && num == BFIN_NUM_EMUDAT)
+    {
+        if (bs->dof)
+            bs->doovf = 1;
+        bs->emudat_out = v;
+        bs->dof = 1;
+        return;
+    }
+    bs->regs[group][num] = v;
+}
+
+static uint32_t
+urj_jim_bfin_load (bfin_state_t *bs, uint32_t adr, int size)
+{
+    uint32_t v = 0;
+    int i;
+
+    if (adr >= bs->ram_size || bs->ram_size - adr < (uint32_t) size)
+        return 0;
+    for (i = 0; i < size; i++)
+        v |= (uint32_t) bs->ram[adr + i] << (8 * i);
+
+    return v;
+}
+
+static void
+urj_jim_bfin_store (bfin_state_t *bs, uint32_t adr, int size, uint32_t v)
+{
+    int i;
+
+    if (adr >= bs->ram_size || bs->ram_size - adr < (uint32_t) size)
+        return;
+    for (i = 0; i < size; i++)
+        bs->ram[adr + i] = (v >> (8 * i)) & 0xff;
+}
+
+/* A load or store of @size bytes of R@reg at @adr */
+static void
+urj_jim_bfin_access (bfin_state_t *bs, int store, int reg, uint32_t adr,
+                     int size)
+{
+    if (store)
+        urj_jim_bfin_store (bs, adr, size, bs->regs[BFIN_GROUP_R][reg]);
+    else
+        bs->regs[BFIN_GROUP_R][reg] = urj_jim_bfin_load (bs, adr, size);
+}
+
+static int
+urj_jim_bfin_is_memory (uint64_t insn)
+{
+    if (insn > 0xffff)
+        return (insn & 0xfc000000) == 0xe4000000;
+    return (insn & 0xf000) == 0x9000;
+}
+
+static void
+urj_jim_bfin_exec (bfin_state_t *bs, uint64_t insn)
+{
+    int size, sz;
+    uint32_t *preg;
+
+    if (insn > 0xffff)
+    {
+        /* [Preg + offset] */
+        if ((insn & 0xfc000000) != 0xe4000000)
+            return;
+        sz = (insn >> 22) & 3;
+        if (sz == 3)
+            return;
+        size = 4 >> sz;
+        preg = &bs->regs[BFIN_GROUP_P][(insn >> 19) & 7];
+        urj_jim_bfin_access (bs, (insn >> 25) & 1, (insn >> 16) & 7,
+                             *preg + (uint32_t) ((int16_t) (insn & 0xffff)
+                                                 * size), size);
+        return;
+    }
+
+    if (insn == BFIN_INSN_RTE)
+    {
+        if (bs->dbgctl & BFIN_DBGCTL_ESSTEP)
+        {
+            /* the user program runs one 16 bit instruction */
+            bs->emupc += 2;
+            bs->cause = BFIN_EMUCAUSE_SSTEP;
+        }
+        else
+            bs->emu = 0;
+    }
+    else if ((insn & 0xf000) == 0x3000)
+        urj_jim_bfin_set_reg (bs, (insn >> 9) & 7, (insn >> 3) & 7,
+                              urj_jim_bfin_reg (bs, (insn >> 6) & 7,
+                                                insn & 7));
+    else if ((insn & 0xf000) == 0x9000)
+    {
+        /* [Preg++], [Preg--] and [Preg] */
+        sz = (insn >> 10) & 3;
+        if (sz == 3)
+            return;
+        size = 4 >> sz;
+        preg = &bs->regs[BFIN_GROUP_P][(insn >> 3) & 7];
+        urj_jim_bfin_access (bs, (insn >> 9) & 1, insn & 7, *preg, size);
+        switch ((insn >> 7) & 3)
+        {
+        case 0:
+            *preg += size;
+            break;
+        case 1:
+            *preg -= size;
+            break;
+        default:
+            break;
+        }
+    }
+    else if ((insn & 0xfff8) == 0x0050)
+        bs->emupc = bs->regs[BFIN_GROUP_P][insn & 7];
+}
+
+/* EMUIR has run */
+static void
+urj_jim_bfin_run (bfin_state_t *bs)
+{
+    bs->busy = 0;
+    urj_jim_bfin_exec (bs, bs->emuir[0]);
+    if (bs->dbgctl & BFIN_DBGCTL_EMUIRLPSZ_2)
+        urj_jim_bfin_exec (bs, bs->emuir[1]);
+}
+
+/* Run-Test/Idle is entered */
+static void
+urj_jim_bfin_start (urj_jim_device_t *dev, bfin_state_t *bs)
+{
+    int n = 1 + ((bs->dbgctl & BFIN_DBGCTL_EMUIRLPSZ_2) != 0);
+    int i;
+
+    if (!bs->emu || bs->busy)
+        return;
+
+    bs->busy = bs->core;
+    for (i = 0; i < n; i++)
+        if (urj_jim_bfin_is_memory (bs->emuir[i]))
+            bs->busy += bs->mem;
+    if (bs->busy == 0)
+        urj_jim_bfin_run (bs);
+    /* count the clocks in Shift-DR too */
+    dev->clocked = bs->busy != 0;
+}
+
+static void
+urj_jim_bfin_select_dr (urj_jim_device_t *dev)
+{
+    bfin_state_t *bs = dev->state;
+
+    switch (dev->sreg[0].reg[0])
+    {
+    case BFIN_IR_IDCODE:
+        dev->current_dr = BFIN_DR_IDR;
+        break;
+    case BFIN_IR_DBGSTAT:
+        dev->current_dr = BFIN_DR_DBGSTAT;
+        break;
+    case BFIN_IR_DBGCTL:
+        dev->current_dr = BFIN_DR_DBGCTL;
+        break;
+    case BFIN_IR_EMUIR:
+        if ((bs->dbgctl & BFIN_DBGCTL_EMUIRSZ) == BFIN_DBGCTL_EMUIRSZ_32)
+            dev->current_dr = BFIN_DR_EMUIR;
+        else
+            dev->current_dr = BFIN_DR_EMUIR64;
+        break;
+    case BFIN_IR_EMUDAT:
+        if ((bs->dbgctl & BFIN_DBGCTL_EMUDATSZ) == BFIN_DBGCTL_EMUDATSZ_40)
+            dev->current_dr = BFIN_DR_EMUDAT40;
+        else
+            dev->current_dr = BFIN_DR_EMUDAT;
+        break;
+    case BFIN_IR_EMUPC:
+        dev->current_dr = BFIN_DR_EMUPC;
+        break;
+    default:
+        dev->current_dr = BFIN_DR_BYPASS;
+        break;
+    }
+}
+
+static void
+urj_jim_bfin_capture (urj_jim_device_t *dev, bfin_state_t *bs)
+{
+    uint32_t *reg = dev->sreg[dev->current_dr].reg;
+    int len = dev->sreg[dev->current_dr].len;
+    uint32_t stat = 0;
+
+    switch (dev->current_dr)
+    {
+    case BFIN_DR_IDR:
+        reg[0] = BFIN_IDCODE;
+        break;
+    case BFIN_DR_DBGSTAT:
+        if (bs->emu)
+            stat |= BFIN_DBGSTAT_EMUACK
+                | (bs->cause << BFIN_DBGSTAT_EMUCAUSE_SHIFT);
+        if (bs->emu && !bs->busy)
+            stat |= BFIN_DBGSTAT_EMUREADY;
+        if (bs->diovf)
+            stat |= BFIN_DBGSTAT_EMUDIOVF;
+        if (bs->doovf)
+            stat |= BFIN_DBGSTAT_EMUDOOVF;
+        if (bs->dif)
+            stat |= BFIN_DBGSTAT_EMUDIF;
+        if (bs->dof)
+            stat |= BFIN_DBGSTAT_EMUDOF;
+        urj_jim_bfin_put (reg, len, stat);
+        break;
+    case BFIN_DR_DBGCTL:
+        urj_jim_bfin_put (reg, len, bs->dbgctl);
+        break;
+    case BFIN_DR_EMUDAT:
+        urj_jim_bfin_put (reg, len, bs->emudat_out);
+        bs->dof = 0;
+        break;
+    case BFIN_DR_EMUDAT40:
+        /* data, EMUDOF, EMUDIF */
+        urj_jim_bfin_put (reg, len, ((uint64_t) bs->emudat_out << 8)
+                          | (bs->dof << 7) | (bs->dif << 6));
+        bs->dof = 0;
+        break;
+    case BFIN_DR_EMUPC:
+        urj_jim_bfin_put (reg, len, bs->emupc);
+        break;
+    default:
+        break;
+    }
+}
+
+static void
+urj_jim_bfin_update (urj_jim_device_t *dev, bfin_state_t *bs)
+{
+    uint32_t *reg = dev->sreg[dev->current_dr].reg;
+    int len = dev->sreg[dev->current_dr].len;
+    uint64_t v = urj_jim_bfin_get (reg, len);
+    uint64_t insn;
+
+    switch (dev->current_dr)
+    {
+    case BFIN_DR_DBGSTAT:
+        if (v & BFIN_DBGSTAT_EMUDIOVF)
+            bs->diovf = 0;
+        if (v & BFIN_DBGSTAT_EMUDOOVF)
+            bs->doovf = 0;
+        break;
+    case BFIN_DR_DBGCTL:
+        bs->dbgctl = v;
+        if ((v & BFIN_DBGCTL_EMPWR) && (v & BFIN_DBGCTL_EMEEN)
+            && (v & BFIN_DBGCTL_WAKEUP) && !bs->emu)
+        {
+            bs->emu = 1;
+            bs->cause = BFIN_EMUCAUSE_EMUIN;
+        }
+        break;
+    case BFIN_DR_EMUIR:
+    case BFIN_DR_EMUIR64:
+        /* 16 and 32 bit instructions are aligned to the MSB */
+        v <<= 64 - len;
+        if ((v >> 60) < 0xc)
+            insn = v >> 48;
+        else
+            insn = v >> 32;
+        if (bs->dbgctl & BFIN_DBGCTL_EMUIRLPSZ_2)
+            bs->emuir[1] = bs->emuir[0];
+        bs->emuir[0] = insn;
+        break;
+    case BFIN_DR_EMUDAT:
+    case BFIN_DR_EMUDAT40:
+        if (dev->current_dr == BFIN_DR_EMUDAT40 && !((v >> 6) & 1))
+            break;
+        if (bs->dif)
+            bs->diovf = 1;
+        bs->emudat_in = v >> (len - 32);
+        bs->dif = 1;
+        break;
+    default:
+        break;
+    }
+}
+
+static void
+urj_jim_bfin_tck_rise (urj_jim_device_t *dev, int tms, int tdi,
+                       uint8_t *shmem, size_t shmem_size)
+{
+    bfin_state_t *bs = dev->state;
+
+    if (bs->busy && --bs->busy == 0)
+    {
+        urj_jim_bfin_run (bs);
+        dev->clocked = 0;
+    }
+
+    switch (dev->tap_state)
+    {
+    case URJ_JIM_RESET:
+        dev->sreg[0].reg[0] = BFIN_IR_IDCODE;
+        urj_jim_bfin_select_dr (dev);
+        break;
+
+    case URJ_JIM_CAPTURE_IR:
+        dev->sreg[0].reg[0] = 1;
+        break;
+
+    case URJ_JIM_UPDATE_IR:
+        urj_jim_bfin_select_dr (dev);
+        if (!tms)
+            urj_jim_bfin_start (dev, bs);
+        break;
+
+    case URJ_JIM_CAPTURE_DR:
+        urj_jim_bfin_capture (dev, bs);
+        break;
+
+    case URJ_JIM_UPDATE_DR:
+        urj_jim_bfin_update (dev, bs);
+        if (!tms)
+            urj_jim_bfin_start (dev, bs);
+        break;
+
+    default:
+        break;
+    }
+}
+
+static void
+urj_jim_bfin_free (urj_jim_device_t *dev)
+{
+    bfin_state_t *bs = dev->state;
+
+    if (bs != NULL)
+    {
+        free (bs->ram);
+        free (bs);
+    }
+}
+
+urj_jim_device_t *
+urj_jim_bfin (int kbytes, int core, int mem)
+{
+    urj_jim_device_t *dev;
+    bfin_state_t *bs;
+    const int reg_size[9] = { 5, 32, 16, 16, 32, 64, 32, 40, 32 };
+
+    bs = calloc (1, sizeof (bfin_state_t));
+    if (bs == NULL)
+    {
+        urj_error_set (URJ_ERROR_OUT_OF_MEMORY, "calloc(%zd,%zd) fails",
+                       (size_t) 1, sizeof (bfin_state_t));
+        return NULL;
+    }
+    bs->ram_size = (uint32_t) kbytes * 1024;
+    bs->ram = calloc (bs->ram_size, 1);
+    if (bs->ram == NULL)
+    {
+        free (bs);
+        urj_error_set (URJ_ERROR_OUT_OF_MEMORY, "calloc(%zd,%zd) fails",
+                       (size_t) kbytes * 1024, (size_t) 1);
+        return NULL;
+    }
+    bs->core = core;
+    bs->mem = mem;
+
+    dev = urj_jim_alloc_device (9, reg_size);
+    if (dev == NULL)
+    {
+        free (bs->ram);
+        free (bs);
+        // retain error state
+        return NULL;
+    }
+
+    dev->state = bs;
+    dev->tck_rise = urj_jim_bfin_tck_rise;
+    dev->dev_free = urj_jim_bfin_free;
+
+    return dev;
+}
@@ -0,0 +1,317 @@
+/*
+ * $Id$
+ *
+ * Copyright (C) 2026 UrJTAG contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * This code simulates a x16 CFI NOR flash with the Intel/Sharp command set
+ * (like the 28FxxxJ3 StrataFlash family) and uniform 128 KByte blocks. The
+ * size is set by the creator of the device (size field, in words). Program
+ * and erase operations complete immediately, so that the model can be used
+ * for benchmarking the host side. Block locking is accepted but not enforced.
+ */
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <urjtag/types.h>
+#include <urjtag/log.h>
+#include <urjtag/error.h>
+#include <urjtag/jim.h>
+
+#define CFI_BLOCK_WORDS         0x10000         /* 128 KByte */
+#define CFI_BUFFER_WORDS        16              /* 32 byte write buffer */
+
+#define CFI_SR_READY            0x80
+#define CFI_SR_ERASE_ERROR      0x20
+#define CFI_SR_PROG_ERROR       0x10
+
+typedef enum
+{
+    READ_ARRAY,
+    READ_STATUS,
+    READ_ID,
+    READ_QUERY,
+    PROG_SETUP,
+    ERASE_SETUP,
+    LOCK_SETUP,
+    BUFFER_COUNT,
+    BUFFER_DATA,
+    BUFFER_CONFIRM
+}
+cfi_flash_op_state_t;
+
+typedef struct
+{
+    uint16_t *array;
+    uint8_t query[0x40];
+    cfi_flash_op_state_t opstate;
+    uint8_t status;
+    uint32_t control_buffer;
+    int buffer_count;
+}
+cfi_flash_state_t;
+
+static void
+urj_jim_cfi_flash_query (cfi_flash_state_t *fs, int size_log2)
+{
+    static const uint8_t head[] = {
+        'Q', 'R', 'Y',
+        0x01, 0x00,             /* Intel/Sharp Extended Command Set */
+        0x31, 0x00,             /* primary extended table */
+        0x00, 0x00, 0x00, 0x00, /* no alternate command set */
+        0x27, 0x36, 0x00, 0x00, /* Vcc 2.7 .. 3.6 V, no Vpp */
+        0x07, 0x07, 0x0A, 0x00, /* typical timeouts */
+        0x04, 0x04, 0x04, 0x00, /* maximum timeouts */
+    };
+    uint32_t blocks = (1u << size_log2) / (CFI_BLOCK_WORDS * 2);
+    uint8_t *q = fs->query;
+
+    memset (q, 0, sizeof fs->query);
+    memcpy (&q[0x10], head, sizeof head);
+    q[0x27] = size_log2;
+    q[0x28] = 0x01;             /* x16 */
+    q[0x2A] = 0x05;             /* 32 byte write buffer */
+    q[0x2C] = 0x01;             /* one erase block region */
+    q[0x2D] = (blocks - 1) & 0xFF;
+    q[0x2E] = (blocks - 1) >> 8;
+    q[0x2F] = ((CFI_BLOCK_WORDS * 2) >> 8) & 0xFF;
+    q[0x30] = (CFI_BLOCK_WORDS * 2) >> 16;
+    q[0x31] = 'P';
+    q[0x32] = 'R';
+    q[0x33] = 'I';
+    q[0x34] = '1';
+    q[0x35] = '1';
+}
+
+static int
+urj_jim_cfi_flash_init (urj_jim_bus_device_t *d)
+{
+    cfi_flash_state_t *fs;
+    size_t bytes = (size_t) d->size * 2;
+    int size_log2;
+
+    for (size_log2 = 0; ((size_t) 1 << size_log2) < bytes; size_log2++)
+        ;
+    if (((size_t) 1 << size_log2) != bytes || d->size < CFI_BLOCK_WORDS)
+    {
+        urj_error_set (URJ_ERROR_INVALID,
+                       "CFI flash size %zd is not a power of two >= 128k",
+                       bytes);
+        return URJ_STATUS_FAIL;
+    }
+
+    fs = malloc (sizeof (cfi_flash_state_t));
+    if (fs == NULL)
+    {
+        urj_error_set (URJ_ERROR_OUT_OF_MEMORY, "malloc(%zd) fails",
+                       sizeof (cfi_flash_state_t));
+        return URJ_STATUS_FAIL;
+    }
+    fs->array = malloc (bytes);
+    if (fs->array == NULL)
+    {
+        free (fs);
+        urj_error_set (URJ_ERROR_OUT_OF_MEMORY, "malloc(%zd) fails", bytes);
+        return URJ_STATUS_FAIL;
+    }
+
+    memset (fs->array, 0xFF, bytes);
+    urj_jim_cfi_flash_query (fs, size_log2);
+    fs->opstate = READ_ARRAY;
+    fs->status = CFI_SR_READY;
+    fs->control_buffer = 0;
+    fs->buffer_count = 0;
+    d->state = fs;
+
+    urj_log (URJ_LOG_LEVEL_NORMAL,
+             "Simulating %zd bytes of CFI NOR flash.\n", bytes);
+
+    return URJ_STATUS_OK;
+}
+
+static void
+urj_jim_cfi_flash_free (urj_jim_bus_device_t *d)
+{
+    cfi_flash_state_t *fs = d->state;
+
+    if (fs != NULL)
+    {
+        free (fs->array);
+        free (fs);
+    }
+}
+
+static uint32_t
+urj_jim_cfi_flash_capture (urj_jim_bus_device_t *d,
+                           uint32_t address, uint32_t control,
+                           uint8_t *shmem, size_t shmem_size)
+{
+    cfi_flash_state_t *fs = d->state;
+    uint32_t data = 0;
+
+    if ((control & 7) != 5)     /* OE and CS: READ */
+        return 0;
+
+    switch (fs->opstate)
+    {
+    case READ_ARRAY:
+        data = fs->array[address];
+        break;
+
+    case READ_ID:
+        if (address % CFI_BLOCK_WORDS == 0)
+            data = 0x0089;
+        else if (address % CFI_BLOCK_WORDS == 1)
+            data = 0x0018;
+        break;
+
+    case READ_QUERY:
+        if (address < sizeof fs->query)
+            data = fs->query[address];
+        break;
+
+    default:
+        data = fs->status;
+        break;
+    }
+
+    urj_log (URJ_LOG_LEVEL_COMM, "cfi: read %04X from %08X\n",
+             data, address);
+
+    return data;
+}
+
+static void
+urj_jim_cfi_flash_command (cfi_flash_state_t *fs, uint32_t address,
+                           uint16_t data)
+{
+    uint8_t dl = data & 0xFF;
+
+    switch (fs->opstate)
+    {
+    case PROG_SETUP:
+        fs->array[address] &= data;
+        fs->opstate = READ_STATUS;
+        return;
+
+    case ERASE_SETUP:
+        if (dl == 0xD0)
+        {
+            address -= address % CFI_BLOCK_WORDS;
+            memset (&fs->array[address], 0xFF, CFI_BLOCK_WORDS * 2);
+        }
+        else
+            fs->status |= CFI_SR_ERASE_ERROR | CFI_SR_PROG_ERROR;
+        fs->opstate = READ_STATUS;
+        return;
+
+    case LOCK_SETUP:
+        fs->opstate = READ_STATUS;
+        return;
+
+    case BUFFER_COUNT:
+        fs->buffer_count = dl + 1;
+        if (fs->buffer_count > CFI_BUFFER_WORDS)
+        {
+            fs->status |= CFI_SR_PROG_ERROR;
+            fs->opstate = READ_STATUS;
+        }
+        else
+            fs->opstate = BUFFER_DATA;
+        return;
+
+    case BUFFER_DATA:
+        fs->array[address] &= data;
+        if (--fs->buffer_count == 0)
+            fs->opstate = BUFFER_CONFIRM;
+        return;
+
+    case BUFFER_CONFIRM:
+        if (dl != 0xD0)
+            fs->status |= CFI_SR_PROG_ERROR | CFI_SR_ERASE_ERROR;
+        fs->opstate = READ_STATUS;
+        return;
+
+    default:
+        break;
+    }
+
+    switch (dl)
+    {
+    case 0x10:
+    case 0x40:
+        fs->opstate = PROG_SETUP;
+        break;
+    case 0x20:
+        fs->opstate = ERASE_SETUP;
+        break;
+    case 0x50:
+        fs->status = CFI_SR_READY;
+        break;
+    case 0x60:
+        fs->opstate = LOCK_SETUP;
+        break;
+    case 0x70:
+        fs->opstate = READ_STATUS;
+        break;
+    case 0x90:
+        fs->opstate = READ_ID;
+        break;
+    case 0x98:
+        fs->opstate = READ_QUERY;
+        break;
+    case 0xE8:
+        fs->opstate = BUFFER_COUNT;
+        break;
+    default:
+        fs->opstate = READ_ARRAY;
+        break;
+    }
+}
+
+static void
+urj_jim_cfi_flash_update (urj_jim_bus_device_t *d,
+                          uint32_t address, uint32_t data,
+                          uint32_t control, uint8_t *shmem,
+                          size_t shmem_size)
+{
+    cfi_flash_state_t *fs = d->state;
+
+    if (((control & 7) == 6) && ((fs->control_buffer & 2) != 2))  /* WE rise, CS active: WRITE */
+    {
+        urj_log (URJ_LOG_LEVEL_COMM, "cfi: write %04X to %08X\n",
+                 data & 0xFFFF, address);
+        urj_jim_cfi_flash_command (fs, address, data & 0xFFFF);
+    }
+
+    fs->control_buffer = control;
+}
+
+urj_jim_bus_device_t urj_jim_cfi_flash = {
+    2,                          /* width [bytes] */
+    0,                          /* size [words], set by the user */
+    NULL,                       /* state */
+    urj_jim_cfi_flash_init,     /* init() */
+    urj_jim_cfi_flash_capture,  /* access() */
+    urj_jim_cfi_flash_update,   /* access() */
+    urj_jim_cfi_flash_free      /* free() */
+};
@@ -0,0 +1,354 @@
+/*
+ * $Id$
+ *
+ * Copyright (C) 2026 UrJTAG contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * An FPGA TAP configured with the fjmem core of extra/fjmem and one block of
+ * 16 bit wide RAM. Instructions (6 bit IR, as on Spartan 3):
+ *
+ *   001001     IDCODE   (IDR)
+ *   000010     USER1    (the fjmem shift register)
+ *   all others BYPASS
+ *
+ * The shift register follows fjmem_core.vhd: instruction (3 bits), ack,
+ * block (1 bit), address and data (16 bits), LSB first. Capture-DR and
+ * Update-DR act like the core does, the memory answers immediately. With
+ * bursts enabled, the query reply has the ack bit set and instruction 011
+ * streams the words on TDO after Capture-DR.
+ */
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <urjtag/types.h>
+#include <urjtag/log.h>
+#include <urjtag/error.h>
+#include <urjtag/jim.h>
+
+#define FJMEM_DR_BYPASS         0
+#define FJMEM_DR_IDR            1
+#define FJMEM_DR_USER1          2
+
+#define FJMEM_IR_IDCODE         0x09
+#define FJMEM_IR_USER1          0x02
+
+#define FJMEM_IDCODE            0x0a5b1c3d
+
+#define FJMEM_INSTR_IDLE        0
+#define FJMEM_INSTR_READ        1
+#define FJMEM_INSTR_WRITE       2
+#define FJMEM_INSTR_BURST       3
+#define FJMEM_INSTR_QUERY       6
+#define FJMEM_INSTR_DETECT      7
+
+#define FJMEM_ACK_POS           3
+#define FJMEM_BLOCK_POS         4
+#define FJMEM_ADDR_POS          5
+#define FJMEM_DATA_WIDTH        16
+
+typedef struct
+{
+    uint16_t *ram;
+    int addr_width;
+    int has_burst;
+    /* registers of the core, latched at Update-DR */
+    int instr;
+    uint32_t addr;
+    uint32_t dout;
+    uint32_t din;
+    /* burst streaming */
+    uint32_t burst_word;
+    int burst_bit;
+    uint32_t burst_cnt;
+    uint32_t burst_addr;
+}
+fjmem_state_t;
+
+static int
+urj_jim_fjmem_data_pos (fjmem_state_t *fs)
+{
+    return FJMEM_ADDR_POS + fs->addr_width;
+}
+
+static uint32_t
+urj_jim_fjmem_get (urj_jim_shift_reg_t *sr, int pos, int len)
+{
+    uint32_t v = 0;
+    int i;
+
+    for (i = 0; i < len; i++)
+        if (sr->reg[(pos + i) / 32] & ((uint32_t) 1 << ((pos + i) % 32)))
+            v |= (uint32_t) 1 << i;
+
+    return v;
+}
+
+static void
+urj_jim_fjmem_put (urj_jim_shift_reg_t *sr, int pos, int len, uint32_t v)
+{
+    int i;
+
+    for (i = 0; i < len; i++)
+    {
+        uint32_t m = (uint32_t) 1 << ((pos + i) % 32);
+
+        if (v & ((uint32_t) 1 << i))
+            sr->reg[(pos + i) / 32] |= m;
+        else
+            sr->reg[(pos + i) / 32] &= ~m;
+    }
+}
+
+static uint32_t
+urj_jim_fjmem_read (fjmem_state_t *fs, uint32_t addr)
+{
+    return fs->ram[addr & ((1 << fs->addr_width) - 1)];
+}
+
+static void
+urj_jim_fjmem_select_dr (urj_jim_device_t *dev)
+{
+    uint32_t ir = dev->sreg[0].reg[0];
+
+    if (ir == FJMEM_IR_IDCODE)
+        dev->current_dr = FJMEM_DR_IDR;
+    else if (ir == FJMEM_IR_USER1)
+        dev->current_dr = FJMEM_DR_USER1;
+    else
+        dev->current_dr = FJMEM_DR_BYPASS;
+}
+
+/* Capture-DR of USER1: the shift register still holds the last scan */
+static void
+urj_jim_fjmem_capture (fjmem_state_t *fs, urj_jim_shift_reg_t *sr)
+{
+    int data_pos = urj_jim_fjmem_data_pos (fs);
+    int block = urj_jim_fjmem_get (sr, FJMEM_BLOCK_POS, 1);
+
+    switch (fs->instr)
+    {
+    case FJMEM_INSTR_READ:
+        memset (sr->reg, 0, ((sr->len + 31) / 32) * sizeof (uint32_t));
+        urj_jim_fjmem_put (sr, 0, 3, fs->instr);
+        urj_jim_fjmem_put (sr, FJMEM_ACK_POS, 1, 1);
+        urj_jim_fjmem_put (sr, data_pos, FJMEM_DATA_WIDTH, fs->din);
+        break;
+
+    case FJMEM_INSTR_WRITE:
+        urj_jim_fjmem_put (sr, 0, 3, fs->instr);
+        break;
+
+    case FJMEM_INSTR_DETECT:
+        memset (sr->reg, 0, ((sr->len + 31) / 32) * sizeof (uint32_t));
+        urj_jim_fjmem_put (sr, 0, 3, fs->instr);
+        urj_jim_fjmem_put (sr, FJMEM_BLOCK_POS, 1, 1);
+        urj_jim_fjmem_put (sr, data_pos, FJMEM_DATA_WIDTH, 0xFFFF);
+        break;
+
+    case FJMEM_INSTR_QUERY:
+        memset (sr->reg, 0, ((sr->len + 31) / 32) * sizeof (uint32_t));
+        if (block == 0)
+        {
+            urj_jim_fjmem_put (sr, FJMEM_ADDR_POS, fs->addr_width,
+                               (1 << fs->addr_width) - 1);
+            urj_jim_fjmem_put (sr, data_pos, FJMEM_DATA_WIDTH, 0xFFFF);
+        }
+        urj_jim_fjmem_put (sr, 0, 3, fs->instr);
+        urj_jim_fjmem_put (sr, FJMEM_ACK_POS, 1, fs->has_burst);
+        break;
+
+    case FJMEM_INSTR_BURST:
+        memset (sr->reg, 0, ((sr->len + 31) / 32) * sizeof (uint32_t));
+        /* first word, the core requests the next one right away */
+        fs->burst_addr = fs->addr;
+        fs->burst_word = urj_jim_fjmem_read (fs, fs->burst_addr);
+        fs->burst_bit = 0;
+        fs->burst_cnt = fs->dout > 1 ? fs->dout - 1 : 0;
+        break;
+
+    default:
+        memset (sr->reg, 0, ((sr->len + 31) / 32) * sizeof (uint32_t));
+        break;
+    }
+}
+
+/* Update-DR of USER1: latch the fields and access the memory */
+static void
+urj_jim_fjmem_update (urj_jim_device_t *dev, fjmem_state_t *fs,
+                      urj_jim_shift_reg_t *sr)
+{
+    fs->instr = urj_jim_fjmem_get (sr, 0, 3);
+    if (!fs->has_burst && fs->instr == FJMEM_INSTR_BURST)
+        fs->instr = FJMEM_INSTR_IDLE;
+    fs->addr = urj_jim_fjmem_get (sr, FJMEM_ADDR_POS, fs->addr_width);
+    fs->dout = urj_jim_fjmem_get (sr, urj_jim_fjmem_data_pos (fs),
+                                  FJMEM_DATA_WIDTH);
+
+    if (urj_jim_fjmem_get (sr, FJMEM_BLOCK_POS, 1) == 0)
+    {
+        if (fs->instr == FJMEM_INSTR_READ)
+            fs->din = urj_jim_fjmem_read (fs, fs->addr);
+        else if (fs->instr == FJMEM_INSTR_WRITE)
+            fs->ram[fs->addr] = fs->dout;
+    }
+
+    /* TDO follows the burst engine instead of the shift register */
+    dev->clocked = fs->instr == FJMEM_INSTR_BURST;
+}
+
+/* one TCK rising edge in Shift-DR with the burst instruction */
+static void
+urj_jim_fjmem_burst_shift (fjmem_state_t *fs)
+{
+    if (fs->burst_bit < FJMEM_DATA_WIDTH - 1)
+    {
+        fs->burst_bit++;
+        return;
+    }
+
+    fs->burst_bit = 0;
+    if (fs->burst_cnt == 0)
+    {
+        fs->burst_word = 0;
+        return;
+    }
+    fs->burst_cnt--;
+    fs->burst_addr++;
+    fs->burst_word = urj_jim_fjmem_read (fs, fs->burst_addr);
+}
+
+static void
+urj_jim_fjmem_tck_rise (urj_jim_device_t *dev, int tms, int tdi,
+                        uint8_t *shmem, size_t shmem_size)
+{
+    fjmem_state_t *fs = dev->state;
+    urj_jim_shift_reg_t *ir = &dev->sreg[0];
+    urj_jim_shift_reg_t *sr = &dev->sreg[FJMEM_DR_USER1];
+
+    switch (dev->tap_state)
+    {
+    case URJ_JIM_RESET:
+        ir->reg[0] = FJMEM_IR_IDCODE;
+        urj_jim_fjmem_select_dr (dev);
+        fs->instr = FJMEM_INSTR_IDLE;
+        dev->clocked = 0;
+        break;
+
+    case URJ_JIM_CAPTURE_IR:
+        ir->reg[0] = 1;
+        break;
+
+    case URJ_JIM_UPDATE_IR:
+        urj_jim_fjmem_select_dr (dev);
+        break;
+
+    case URJ_JIM_CAPTURE_DR:
+        if (dev->current_dr == FJMEM_DR_IDR)
+            dev->sreg[FJMEM_DR_IDR].reg[0] = FJMEM_IDCODE;
+        else if (dev->current_dr == FJMEM_DR_USER1)
+            urj_jim_fjmem_capture (fs, sr);
+        break;
+
+    case URJ_JIM_SHIFT_DR:
+        if (dev->current_dr == FJMEM_DR_USER1
+            && fs->instr == FJMEM_INSTR_BURST)
+            urj_jim_fjmem_burst_shift (fs);
+        break;
+
+    case URJ_JIM_UPDATE_DR:
+        if (dev->current_dr == FJMEM_DR_USER1)
+            urj_jim_fjmem_update (dev, fs, sr);
+        break;
+
+    default:
+        break;
+    }
+}
+
+static void
+urj_jim_fjmem_tck_fall (urj_jim_device_t *dev, uint8_t *shmem,
+                        size_t shmem_size)
+{
+    fjmem_state_t *fs = dev->state;
+
+    if (dev->current_dr == FJMEM_DR_USER1
+        && dev->tap_state == URJ_JIM_SHIFT_DR
+        && fs->instr == FJMEM_INSTR_BURST)
+        dev->tdo = (fs->burst_word >> fs->burst_bit) & 1;
+}
+
+static void
+urj_jim_fjmem_free (urj_jim_device_t *dev)
+{
+    fjmem_state_t *fs = dev->state;
+
+    if (fs != NULL)
+    {
+        free (fs->ram);
+        free (fs);
+    }
+}
+
+urj_jim_device_t *
+urj_jim_fjmem_core (int kbytes, int burst)
+{
+    urj_jim_device_t *dev;
+    fjmem_state_t *fs;
+    int reg_size[3] = { 6, 32, 0 };
+    int words = kbytes * 512;
+
+    fs = calloc (1, sizeof (fjmem_state_t));
+    if (fs == NULL)
+    {
+        urj_error_set (URJ_ERROR_OUT_OF_MEMORY, "calloc(%zd,%zd) fails",
+                       (size_t) 1, sizeof (fjmem_state_t));
+        return NULL;
+    }
+    fs->ram = calloc (words, sizeof (uint16_t));
+    if (fs->ram == NULL)
+    {
+        free (fs);
+        urj_error_set (URJ_ERROR_OUT_OF_MEMORY, "calloc(%zd,%zd) fails",
+                       (size_t) words, sizeof (uint16_t));
+        return NULL;
+    }
+    while ((1 << fs->addr_width) < words)
+        fs->addr_width++;
+    fs->has_burst = burst;
+
+    reg_size[FJMEM_DR_USER1] = urj_jim_fjmem_data_pos (fs) + FJMEM_DATA_WIDTH;
+    dev = urj_jim_alloc_device (3, reg_size);
+    if (dev == NULL)
+    {
+        free (fs->ram);
+        free (fs);
+        // retain error state
+        return NULL;
+    }
+
+    dev->state = fs;
+    dev->tck_rise = urj_jim_fjmem_tck_rise;
+    dev->tck_fall = urj_jim_fjmem_tck_fall;
+    dev->dev_free = urj_jim_fjmem_free;
+
+    return dev;
+}
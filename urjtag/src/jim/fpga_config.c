@@ -0,0 +1,439 @@
+/*
+ * $Id$
+ *
+ * Copyright (C) 2026 UrJTAG contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * FPGAs that take their configuration through JTAG, as the pld drivers of
+ * src/pld/altera.c and src/pld/lattice.c load them. The configuration
+ * memory of <size> bytes is a shift register: it holds the last bits
+ * shifted in, so that bits coming through BYPASS registers in front of the
+ * configuration data don't matter. Once configured, USERCODE reads the
+ * CRC-32 of the configuration memory, bytes in file order.
+ *
+ * cyclone (10 bit IR, IDCODE of an EP2C8):
+ *
+ *   0000000110 IDCODE          (IDR)
+ *   0000000111 USERCODE        (USERCODE, all ones when unconfigured)
+ *   0000000001 PULSE_NCONFIG   (BYPASS), unconfigures at Update-IR
+ *   0000000010 PROGRAM         (configuration memory, bytes LSB first)
+ *   0000000011 STARTUP         (BYPASS), enters user mode after
+ *                              CYCLONE_INIT_CLOCKS in Run-Test/Idle when
+ *                              the memory has been filled since PROGRAM
+ *   all others BYPASS
+ *
+ * ecp5 (8 bit IR, IDCODE of an LFE5U-45F):
+ *
+ *   11100000   IDCODE          (IDR)
+ *   11000000   USERCODE        (USERCODE, zero when unconfigured)
+ *   11000110   ISC_ENABLE      (8 bit), enters ISC mode at Update-IR
+ *   00001110   ISC_ERASE       (8 bit), in ISC mode unconfigures at
+ *                              Update-DR
+ *   01000110   LSC_INIT_ADDRESS (8 bit), in ISC mode starts at Update-DR
+ *   01111010   LSC_BITSTREAM_BURST (configuration memory, bytes MSB first,
+ *                              only in ISC mode)
+ *   00100110   ISC_DISABLE     (BYPASS), leaves ISC mode at Update-IR: the
+ *                              device is configured if the memory has been
+ *                              filled since LSC_INIT_ADDRESS and starts
+ *                              with 0xff bytes and the preamble 0xbdb3,
+ *                              otherwise the FAIL bit is set, and
+ *                              BSE_ERROR is 4 if a full memory lacks the
+ *                              preamble
+ *   00111100   LSC_READ_STATUS (32 bit: DONE 8, ISC_ENABLE 9, FAIL 13,
+ *                              STD_PREAMBLE 21, BSE_ERROR 25-23)
+ *   01111001   LSC_REFRESH     (BYPASS), unconfigures at Update-IR
+ *   all others BYPASS
+ */
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <urjtag/types.h>
+#include <urjtag/log.h>
+#include <urjtag/error.h>
+#include <urjtag/jim.h>
+
+#define FPGA_DR_BYPASS          0
+#define FPGA_DR_IDR             1
+#define FPGA_DR_USERCODE        2
+#define FPGA_DR_CONFIG          3
+#define FPGA_DR_STATUS          4
+#define FPGA_DR_8BIT            5
+
+#define CYCLONE_IR_PULSE_NCONFIG 0x001
+#define CYCLONE_IR_PROGRAM      0x002
+#define CYCLONE_IR_STARTUP      0x003
+#define CYCLONE_IR_IDCODE       0x006
+#define CYCLONE_IR_USERCODE     0x007
+
+#define CYCLONE_IDCODE          0x020b20dd
+#define CYCLONE_INIT_CLOCKS     299
+
+#define ECP5_IR_ISC_ERASE       0x0e
+#define ECP5_IR_ISC_DISABLE     0x26
+#define ECP5_IR_LSC_READ_STATUS 0x3c
+#define ECP5_IR_LSC_INIT_ADDRESS 0x46
+#define ECP5_IR_LSC_REFRESH     0x79
+#define ECP5_IR_LSC_BITSTREAM_BURST 0x7a
+#define ECP5_IR_USERCODE        0xc0
+#define ECP5_IR_ISC_ENABLE      0xc6
+#define ECP5_IR_IDCODE          0xe0
+
+#define ECP5_IDCODE             0x41112043
+
+#define ECP5_STATUS_DONE        (1 << 8)
+#define ECP5_STATUS_ISC_ENABLE  (1 << 9)
+#define ECP5_STATUS_FAIL        (1 << 13)
+#define ECP5_STATUS_STD_PREAMBLE (1 << 21)
+#define ECP5_STATUS_BSE_ERROR(e) ((e) << 23)
+#define ECP5_BSE_PREAMBLE       4
+
+typedef enum
+{
+    FPGA_CYCLONE,
+    FPGA_ECP5,
+}
+fpga_family_t;
+
+typedef struct
+{
+    fpga_family_t family;
+    /** configuration memory, one bit per byte */
+    uint8_t *mem;
+    size_t size;
+    size_t pos;
+    size_t count;
+    int configured;
+    int isc;
+    int fail;
+    int preamble;               /* the last bitstream had the preamble */
+    int bse_error;              /* BSE_ERROR code of the last bitstream */
+    int init_clocks;
+    uint32_t usercode;
+}
+fpga_state_t;
+
+/* CRC-32 of the configuration memory, bytes in file order */
+static int
+urj_jim_fpga_check (fpga_state_t *fs, uint32_t *crc)
+{
+    size_t i, n;
+    int b, k, ffs = 1, preamble = 0;
+    uint8_t byte, last = 0;
+
+    *crc = 0xffffffff;
+    for (i = 0; i < fs->size; i++)
+    {
+        byte = 0;
+        for (b = 0; b < 8; b++)
+        {
+            n = (fs->pos + 8 * i + b) % (8 * fs->size);
+            if (fs->family == FPGA_CYCLONE)
+                byte |= fs->mem[n] << b;
+            else
+                byte |= fs->mem[n] << (7 - b);
+        }
+
+        /* 0xff bytes, then 0xbd 0xb3 */
+        if (ffs && byte != 0xff)
+        {
+            ffs = 0;
+            preamble = last == 0xff && byte == 0xbd;
+        }
+        else if (preamble == 1)
+            preamble = (byte == 0xb3) ? 2 : 0;
+        last = byte;
+
+        *crc ^= byte;
+        for (k = 0; k < 8; k++)
+            *crc = (*crc >> 1) ^ ((*crc & 1) ? 0xedb88320 : 0);
+    }
+    *crc = ~*crc;
+
+    return preamble == 2;
+}
+
+static void
+urj_jim_fpga_select_dr (urj_jim_device_t *dev)
+{
+    fpga_state_t *fs = dev->state;
+    uint32_t ir = dev->sreg[0].reg[0];
+
+    dev->current_dr = FPGA_DR_BYPASS;
+    if (fs->family == FPGA_CYCLONE)
+    {
+        if (ir == CYCLONE_IR_IDCODE)
+            dev->current_dr = FPGA_DR_IDR;
+        else if (ir == CYCLONE_IR_USERCODE)
+            dev->current_dr = FPGA_DR_USERCODE;
+        else if (ir == CYCLONE_IR_PROGRAM)
+            dev->current_dr = FPGA_DR_CONFIG;
+        return;
+    }
+
+    switch (ir)
+    {
+    case ECP5_IR_IDCODE:
+        dev->current_dr = FPGA_DR_IDR;
+        break;
+    case ECP5_IR_USERCODE:
+        dev->current_dr = FPGA_DR_USERCODE;
+        break;
+    case ECP5_IR_LSC_BITSTREAM_BURST:
+        dev->current_dr = FPGA_DR_CONFIG;
+        break;
+    case ECP5_IR_LSC_READ_STATUS:
+        dev->current_dr = FPGA_DR_STATUS;
+        break;
+    case ECP5_IR_ISC_ENABLE:
+    case ECP5_IR_ISC_ERASE:
+    case ECP5_IR_LSC_INIT_ADDRESS:
+        dev->current_dr = FPGA_DR_8BIT;
+        break;
+    default:
+        break;
+    }
+}
+
+static void
+urj_jim_fpga_unconfigure (fpga_state_t *fs)
+{
+    fs->configured = 0;
+    fs->fail = 0;
+    fs->preamble = 0;
+    fs->bse_error = 0;
+    fs->pos = 0;
+    fs->count = 0;
+}
+
+/* an instruction takes effect */
+static void
+urj_jim_fpga_update_ir (urj_jim_device_t *dev)
+{
+    fpga_state_t *fs = dev->state;
+    uint32_t ir = dev->sreg[0].reg[0];
+    uint32_t crc;
+
+    if (fs->family == FPGA_CYCLONE)
+    {
+        if (ir == CYCLONE_IR_PROGRAM || ir == CYCLONE_IR_PULSE_NCONFIG)
+            urj_jim_fpga_unconfigure (fs);
+        fs->init_clocks = 0;
+        return;
+    }
+
+    switch (ir)
+    {
+    case ECP5_IR_ISC_ENABLE:
+        fs->isc = 1;
+        break;
+    case ECP5_IR_ISC_DISABLE:
+        if (!fs->isc)
+            break;
+        fs->isc = 0;
+        if (fs->count < 8 * fs->size)
+            fs->fail = 1;
+        else if (urj_jim_fpga_check (fs, &crc))
+        {
+            fs->configured = 1;
+            fs->preamble = 1;
+            fs->usercode = crc;
+        }
+        else
+        {
+            fs->fail = 1;
+            fs->bse_error = ECP5_BSE_PREAMBLE;
+        }
+        break;
+    case ECP5_IR_LSC_REFRESH:
+        fs->isc = 0;
+        urj_jim_fpga_unconfigure (fs);
+        break;
+    default:
+        break;
+    }
+}
+
+static void
+urj_jim_fpga_update_dr (urj_jim_device_t *dev)
+{
+    fpga_state_t *fs = dev->state;
+    uint32_t ir = dev->sreg[0].reg[0];
+
+    if (fs->family != FPGA_ECP5 || !fs->isc)
+        return;
+
+    if (ir == ECP5_IR_ISC_ERASE)
+        urj_jim_fpga_unconfigure (fs);
+    else if (ir == ECP5_IR_LSC_INIT_ADDRESS)
+    {
+        fs->pos = 0;
+        fs->count = 0;
+    }
+}
+
+static void
+urj_jim_fpga_tck_rise (urj_jim_device_t *dev, int tms, int tdi,
+                       uint8_t *shmem, size_t shmem_size)
+{
+    fpga_state_t *fs = dev->state;
+    urj_jim_shift_reg_t *ir = &dev->sreg[0];
+    uint32_t crc, status;
+
+    switch (dev->tap_state)
+    {
+    case URJ_JIM_RESET:
+        ir->reg[0] = fs->family == FPGA_CYCLONE ? CYCLONE_IR_IDCODE
+                                                : ECP5_IR_IDCODE;
+        urj_jim_fpga_select_dr (dev);
+        break;
+
+    case URJ_JIM_IDLE:
+        if (fs->family == FPGA_CYCLONE && ir->reg[0] == CYCLONE_IR_STARTUP
+            && ++fs->init_clocks == CYCLONE_INIT_CLOCKS
+            && fs->count >= 8 * fs->size && !fs->configured)
+        {
+            urj_jim_fpga_check (fs, &crc);
+            fs->configured = 1;
+            fs->usercode = crc;
+        }
+        break;
+
+    case URJ_JIM_CAPTURE_IR:
+        ir->reg[0] = 1;
+        break;
+
+    case URJ_JIM_UPDATE_IR:
+        urj_jim_fpga_select_dr (dev);
+        urj_jim_fpga_update_ir (dev);
+        break;
+
+    case URJ_JIM_CAPTURE_DR:
+        if (dev->current_dr == FPGA_DR_IDR)
+            dev->sreg[FPGA_DR_IDR].reg[0] = fs->family == FPGA_CYCLONE
+                                            ? CYCLONE_IDCODE : ECP5_IDCODE;
+        else if (dev->current_dr == FPGA_DR_USERCODE)
+        {
+            if (fs->configured)
+                dev->sreg[FPGA_DR_USERCODE].reg[0] = fs->usercode;
+            else
+                dev->sreg[FPGA_DR_USERCODE].reg[0] =
+                    fs->family == FPGA_CYCLONE ? 0xffffffff : 0;
+        }
+        else if (dev->current_dr == FPGA_DR_STATUS)
+        {
+            status = 0;
+            if (fs->configured)
+                status |= ECP5_STATUS_DONE;
+            if (fs->isc)
+                status |= ECP5_STATUS_ISC_ENABLE;
+            if (fs->fail)
+                status |= ECP5_STATUS_FAIL;
+            if (fs->preamble)
+                status |= ECP5_STATUS_STD_PREAMBLE;
+            status |= ECP5_STATUS_BSE_ERROR (fs->bse_error);
+            dev->sreg[FPGA_DR_STATUS].reg[0] = status;
+        }
+        break;
+
+    case URJ_JIM_SHIFT_DR:
+        if (dev->current_dr != FPGA_DR_CONFIG
+            || (fs->family == FPGA_ECP5 && !fs->isc))
+            break;
+        fs->mem[fs->pos] = tdi;
+        fs->pos = (fs->pos + 1) % (8 * fs->size);
+        fs->count++;
+        break;
+
+    case URJ_JIM_UPDATE_DR:
+        urj_jim_fpga_update_dr (dev);
+        break;
+
+    default:
+        break;
+    }
+}
+
+static void
+urj_jim_fpga_free (urj_jim_device_t *dev)
+{
+    fpga_state_t *fs = dev->state;
+
+    if (fs != NULL)
+    {
+        free (fs->mem);
+        free (fs);
+    }
+}
+
+static urj_jim_device_t *
+urj_jim_fpga_config (fpga_family_t family, int ir_len, int kbytes)
+{
+    urj_jim_device_t *dev;
+    fpga_state_t *fs;
+    const int reg_size[6] = { ir_len, 32, 32, 1, 32, 8 };
+
+    fs = calloc (1, sizeof (fpga_state_t));
+    if (fs == NULL)
+    {
+        urj_error_set (URJ_ERROR_OUT_OF_MEMORY, "calloc(%zd,%zd) fails",
+                       (size_t) 1, sizeof (fpga_state_t));
+        return NULL;
+    }
+    fs->family = family;
+    fs->size = (size_t) kbytes << 10;
+    fs->mem = calloc (8, fs->size);
+    if (fs->mem == NULL)
+    {
+        urj_error_set (URJ_ERROR_OUT_OF_MEMORY, "calloc(%zd,%zd) fails",
+                       (size_t) 8, fs->size);
+        free (fs);
+        return NULL;
+    }
+
+    dev = urj_jim_alloc_device (6, reg_size);
+    if (dev == NULL)
+    {
+        free (fs->mem);
+        free (fs);
+        // retain error state
+        return NULL;
+    }
+
+    dev->state = fs;
+    dev->tck_rise = urj_jim_fpga_tck_rise;
+    dev->dev_free = urj_jim_fpga_free;
+    dev->clocked = 1;
+
+    return dev;
+}
+
+urj_jim_device_t *
+urj_jim_cyclone (int kbytes)
+{
+    return urj_jim_fpga_config (FPGA_CYCLONE, 10, kbytes);
+}
+
+urj_jim_device_t *
+urj_jim_ecp5 (int kbytes)
+{
+    return urj_jim_fpga_config (FPGA_ECP5, 8, kbytes);
+}
@@ -0,0 +1,184 @@
+/*
+ * $Id$
+ *
+ * Copyright (C) 2026 UrJTAG contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * A generic TAP with configurable IR length, IDCODE and BSR length, to fill
+ * simulated chains with further devices. Instructions:
+ *
+ *   all zeros  EXTEST   (BSR)
+ *   ...0001    IDCODE   (IDR, only if the device has an IDCODE)
+ *   ...0010    SAMPLE   (BSR)
+ *   all ones   BYPASS, as well as all other opcodes
+ *
+ * The BSR cells are not connected to anything; Capture-DR loads the values
+ * latched by the last Update-DR, like pins looped back to their inputs.
+ */
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <urjtag/types.h>
+#include <urjtag/log.h>
+#include <urjtag/error.h>
+#include <urjtag/jim.h>
+
+#define GENERIC_DR_BYPASS       0
+#define GENERIC_DR_IDR          1
+#define GENERIC_DR_BSR          2
+
+typedef struct
+{
+    int has_idcode;
+    uint32_t idcode;
+    uint32_t *bsr_latch;
+}
+generic_state_t;
+
+static void
+urj_jim_generic_select_dr (urj_jim_device_t *dev)
+{
+    generic_state_t *gs = dev->state;
+    uint32_t ir = dev->sreg[0].reg[0];
+    int has_bsr = dev->num_sregs > GENERIC_DR_BSR;
+
+    if (ir == 0 && has_bsr)
+        dev->current_dr = GENERIC_DR_BSR;
+    else if (ir == 1 && gs->has_idcode)
+        dev->current_dr = GENERIC_DR_IDR;
+    else if (ir == 2 && has_bsr)
+        dev->current_dr = GENERIC_DR_BSR;
+    else
+        dev->current_dr = GENERIC_DR_BYPASS;
+}
+
+static void
+urj_jim_generic_tck_rise (urj_jim_device_t *dev, int tms, int tdi,
+                          uint8_t *shmem, size_t shmem_size)
+{
+    generic_state_t *gs = dev->state;
+    urj_jim_shift_reg_t *ir = &dev->sreg[0];
+
+    switch (dev->tap_state)
+    {
+    case URJ_JIM_RESET:
+        if (gs->has_idcode)
+            ir->reg[0] = 1;
+        else
+            ir->reg[0] = (ir->len < 32) ? (1u << ir->len) - 1 : 0xFFFFFFFF;
+        urj_jim_generic_select_dr (dev);
+        break;
+
+    case URJ_JIM_CAPTURE_IR:
+        ir->reg[0] = 1;         /* ...01 as required by IEEE 1149.1 */
+        break;
+
+    case URJ_JIM_CAPTURE_DR:
+        if (dev->current_dr == GENERIC_DR_IDR)
+            dev->sreg[GENERIC_DR_IDR].reg[0] = gs->idcode;
+        else if (dev->current_dr == GENERIC_DR_BSR)
+            memcpy (dev->sreg[GENERIC_DR_BSR].reg, gs->bsr_latch,
+                    (dev->sreg[GENERIC_DR_BSR].len + 31) / 32
+                    * sizeof (uint32_t));
+        break;
+
+    case URJ_JIM_UPDATE_IR:
+        urj_jim_generic_select_dr (dev);
+        break;
+
+    case URJ_JIM_UPDATE_DR:
+        if (dev->current_dr == GENERIC_DR_BSR)
+            memcpy (gs->bsr_latch, dev->sreg[GENERIC_DR_BSR].reg,
+                    (dev->sreg[GENERIC_DR_BSR].len + 31) / 32
+                    * sizeof (uint32_t));
+        break;
+
+    default:
+        break;
+    }
+}
+
+static void
+urj_jim_generic_free (urj_jim_device_t *dev)
+{
+    generic_state_t *gs = dev->state;
+
+    if (gs != NULL)
+    {
+        free (gs->bsr_latch);
+        free (gs);
+    }
+}
+
+urj_jim_device_t *
+urj_jim_generic_device (int ir_len, int bsr_len, int has_idcode,
+                        uint32_t idcode)
+{
+    urj_jim_device_t *dev;
+    generic_state_t *gs;
+    const int reg_size[3] = { ir_len, 32, bsr_len };
+
+    if (ir_len < 1 || ir_len > 32 || bsr_len < 0
+        || (has_idcode && (ir_len < 2 || (idcode & 1) == 0)))
+    {
+        urj_error_set (URJ_ERROR_INVALID,
+                       "generic device: ir=%d bsr=%d idcode=0x%08lX",
+                       ir_len, bsr_len, (unsigned long) idcode);
+        return NULL;
+    }
+
+    gs = calloc (1, sizeof (generic_state_t));
+    if (gs == NULL)
+    {
+        urj_error_set (URJ_ERROR_OUT_OF_MEMORY, "calloc(%zd,%zd) fails",
+                       (size_t) 1, sizeof (generic_state_t));
+        return NULL;
+    }
+    gs->has_idcode = has_idcode;
+    gs->idcode = idcode;
+    if (bsr_len > 0)
+    {
+        gs->bsr_latch = calloc ((bsr_len + 31) / 32, sizeof (uint32_t));
+        if (gs->bsr_latch == NULL)
+        {
+            free (gs);
+            urj_error_set (URJ_ERROR_OUT_OF_MEMORY, "calloc(%zd,%zd) fails",
+                           (size_t) (bsr_len + 31) / 32, sizeof (uint32_t));
+            return NULL;
+        }
+    }
+
+    dev = urj_jim_alloc_device (bsr_len > 0 ? 3 : 2, reg_size);
+    if (dev == NULL)
+    {
+        free (gs->bsr_latch);
+        free (gs);
+        // retain error state
+        return NULL;
+    }
+
+    dev->state = gs;
+    dev->tck_rise = urj_jim_generic_tck_rise;
+    dev->dev_free = urj_jim_generic_free;
+
+    return dev;
+}
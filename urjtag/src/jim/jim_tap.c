@@ -22,10 +22,13 @@
  * THE SOFTWARE.
  */
 
+#include <sysdep.h>
+
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <stdint.h>
+#include <ctype.h>
 
 #include <urjtag/log.h>
 #include <urjtag/error.h>
@@ -222,6 +225,193 @@ urj_jim_tck_fall (urj_jim_state_t *s)
     }
 }
 
+/* Bits pos..pos+31 of the bit string w; w must have a spare word at its end */
+static inline uint32_t
+urj_jim_get_bits (const uint32_t *w, size_t pos)
+{
+    size_t i = pos / 32;
+    unsigned int sh = pos % 32;
+    uint32_t v = w[i] >> sh;
+
+    if (sh != 0)
+        v |= w[i + 1] << (32 - sh);
+
+    return v;
+}
+
+static void
+urj_jim_copy_bits (uint32_t *dst, size_t dst_pos,
+                   const uint32_t *src, size_t src_pos, size_t n)
+{
+    while (n > 0)
+    {
+        unsigned int k = (n < 32) ? n : 32;
+        uint32_t m = (k == 32) ? 0xFFFFFFFF : ((uint32_t) 1 << k) - 1;
+        uint32_t v = urj_jim_get_bits (src, src_pos) & m;
+        size_t i = dst_pos / 32;
+        unsigned int sh = dst_pos % 32;
+
+        dst[i] = (dst[i] & ~(m << sh)) | (v << sh);
+        if (sh + k > 32)
+            dst[i + 1] = (dst[i + 1] & ~(m >> (32 - sh))) | (v >> (32 - sh));
+
+        dst_pos += k;
+        src_pos += k;
+        n -= k;
+    }
+}
+
+/* The shift register that is between TDI and TDO of dev; NULL for BYPASS */
+static urj_jim_shift_reg_t *
+urj_jim_current_sreg (urj_jim_device_t *dev)
+{
+    if (dev->tap_state & 8)
+        return &dev->sreg[0];
+    if (dev->current_dr == 0)
+        return NULL;
+    return &dev->sreg[dev->current_dr];
+}
+
+/*
+ * Push n bits through dev and all devices in front of it.  On entry,
+ * *stream holds the bits on TDI of the first device; on return it holds
+ * the bits seen on TDO of dev before each of the n clocks.
+ *
+ * With the register contents R in front of the input bits S, register and
+ * TDO after clock t are C[t + 1 .. t + len] and C[t + 1] of C = R S, so
+ * the whole run takes three bit string copies.  BYPASS behaves like a
+ * register of one bit.
+ */
+static void
+urj_jim_shift_device (urj_jim_device_t *dev, size_t n,
+                      uint32_t **stream, uint32_t **concat)
+{
+    urj_jim_shift_reg_t *sr;
+    uint32_t bypass[2] = { 0, 0 };
+    uint32_t *reg, *c;
+    size_t len;
+
+    if (dev->prev != NULL)
+        urj_jim_shift_device (dev->prev, n, stream, concat);
+
+    sr = urj_jim_current_sreg (dev);
+    if (sr != NULL)
+    {
+        reg = sr->reg;
+        len = sr->len;
+    }
+    else
+    {
+        reg = bypass;
+        len = 1;
+    }
+
+    c = *concat;
+    urj_jim_copy_bits (c, 0, reg, 0, len);
+    urj_jim_copy_bits (c, len, *stream, 0, n);
+    urj_jim_copy_bits (reg, 0, c, n, len);
+
+    /* TDO before the first clock is the bit latched at the last falling edge */
+    c[0] = (c[0] & ~1) | (dev->tdo & 1);
+    dev->tdo = dev->tdo_buffer = urj_jim_get_bits (c, n) & 1;
+
+    *concat = *stream;
+    *stream = c;
+}
+
+/* Shift n bits with TMS = 0 through the chain, all devices in Shift-xR */
+static int
+urj_jim_shift_bulk (urj_jim_state_t *s, size_t n, const char *tdi, char *tdo)
+{
+    urj_jim_device_t *dev;
+    uint32_t *stream, *concat;
+    size_t max_len = 1;
+    size_t words, i;
+
+    for (dev = s->last_device_in_chain; dev; dev = dev->prev)
+    {
+        urj_jim_shift_reg_t *sr = urj_jim_current_sreg (dev);
+
+        if (sr != NULL && (size_t) sr->len > max_len)
+            max_len = sr->len;
+    }
+
+    words = (n + max_len + 31) / 32 + 1;
+    if (s->shift_buf_words < 2 * words)
+    {
+        uint32_t *buf = realloc (s->shift_buf, 2 * words * sizeof (uint32_t));
+
+        if (buf == NULL)
+            return URJ_STATUS_FAIL;
+        s->shift_buf = buf;
+        s->shift_buf_words = 2 * words;
+    }
+
+    stream = s->shift_buf;
+    concat = s->shift_buf + words;
+    memset (stream, 0, words * sizeof (uint32_t));
+    memset (concat, 0, words * sizeof (uint32_t));
+
+    for (i = 0; i < n; i++)
+        if (tdi[i])
+            stream[i / 32] |= (uint32_t) 1 << (i % 32);
+
+    urj_jim_shift_device (s->last_device_in_chain, n, &stream, &concat);
+
+    if (tdo != NULL)
+        for (i = 0; i < n; i++)
+            tdo[i] = (stream[i / 32] >> (i % 32)) & 1;
+
+    return URJ_STATUS_OK;
+}
+
+static int
+urj_jim_all_shifting (urj_jim_state_t *s)
+{
+    urj_jim_device_t *dev;
+
+    if (s->last_device_in_chain == NULL)
+        return 0;
+
+    for (dev = s->last_device_in_chain; dev; dev = dev->prev)
+        if ((dev->tap_state != URJ_JIM_SHIFT_DR
+             && dev->tap_state != URJ_JIM_SHIFT_IR)
+            || (dev->clocked && dev->tap_state == URJ_JIM_SHIFT_DR))
+            return 0;
+
+    return 1;
+}
+
+void
+urj_jim_shift (urj_jim_state_t *s, int n, const char *tms, const char *tdi,
+               char *tdo)
+{
+    int i = 0;
+
+    while (i < n)
+    {
+        int run = 0;
+
+        if (urj_jim_all_shifting (s))
+            while (i + run < n && (tms == NULL || tms[i + run] == 0))
+                run++;
+
+        if (run > 1 && urj_jim_shift_bulk (s, run, &tdi[i],
+                                           tdo ? &tdo[i] : NULL)
+                       == URJ_STATUS_OK)
+        {
+            i += run;
+            continue;
+        }
+
+        if (tdo != NULL)
+            tdo[i] = urj_jim_get_tdo (s);
+        urj_jim_tck_rise (s, tms ? tms[i] != 0 : 0, tdi[i] != 0);
+        urj_jim_tck_fall (s);
+        i++;
+    }
+}
+
 urj_jim_device_t *
 urj_jim_alloc_device (int num_sregs, const int reg_size[])
 {
@@ -271,12 +461,277 @@ urj_jim_alloc_device (int num_sregs, const int reg_size[])
     dev->dev_free = NULL;
     dev->tap_state = URJ_JIM_RESET;
     dev->tdo = dev->tdo_buffer = 1;
+    dev->clocked = 0;
 
     return dev;
 }
 
+/* Parse one "key=value" option of a chain description line */
+static int
+urj_jim_chain_option (const char *tok, const char *key, unsigned long *value)
+{
+    size_t n = strlen (key);
+    char *end;
+
+    if (strncmp (tok, key, n) != 0 || tok[n] != '=')
+        return 0;
+    *value = strtoul (tok + n + 1, &end, 0);
+    return *end == '\0' && end != tok + n + 1;
+}
+
+/* Create the device described by one line of a chain description */
+static urj_jim_device_t *
+urj_jim_chain_device (char *line, const char *filename, int lineno)
+{
+    char *tok, *type;
+    unsigned long v;
+    unsigned long flash = 0, chips = 1, spi = 0, ir = 0, bsr = 0, idcode = 0;
+    unsigned long fjmem = 0, burst = 1, ram = 0, lag = 1, fastdata = 1;
+    unsigned long dma = 0, core = 8, mem = 0, size = 0;
+    int has_idcode = 0, has_dma = 0;
+
+    type = strtok (line, " \t\r\n");
+
+    while ((tok = strtok (NULL, " \t\r\n")) != NULL)
+    {
+        if (urj_jim_chain_option (tok, "flash", &v))
+            flash = v;
+        else if (urj_jim_chain_option (tok, "chips", &v))
+            chips = v;
+        else if (urj_jim_chain_option (tok, "spi", &v))
+            spi = v;
+        else if (urj_jim_chain_option (tok, "fjmem", &v))
+            fjmem = v;
+        else if (urj_jim_chain_option (tok, "burst", &v))
+            burst = v;
+        else if (urj_jim_chain_option (tok, "ram", &v))
+            ram = v;
+        else if (urj_jim_chain_option (tok, "lag", &v))
+            lag = v;
+        else if (urj_jim_chain_option (tok, "fastdata", &v))
+            fastdata = v;
+        else if (urj_jim_chain_option (tok, "dma", &v))
+        {
+            dma = v;
+            has_dma = 1;
+        }
+        else if (urj_jim_chain_option (tok, "core", &v))
+            core = v;
+        else if (urj_jim_chain_option (tok, "mem", &v))
+            mem = v;
+        else if (urj_jim_chain_option (tok, "size", &v))
+            size = v;
+        else if (urj_jim_chain_option (tok, "ir", &v))
+            ir = v;
+        else if (urj_jim_chain_option (tok, "bsr", &v))
+            bsr = v;
+        else if (urj_jim_chain_option (tok, "idcode", &v))
+        {
+            idcode = v;
+            has_idcode = 1;
+        }
+        else
+        {
+            urj_error_set (URJ_ERROR_SYNTAX, "%s:%d: bad option '%s'",
+                           filename, lineno, tok);
+            return NULL;
+        }
+    }
+
+    if (strcmp (type, "some_cpu") == 0 && spi != 0)
+    {
+        if (flash != 0)
+        {
+            urj_error_set (URJ_ERROR_SYNTAX,
+                           "%s:%d: flash and spi exclude each other",
+                           filename, lineno);
+            return NULL;
+        }
+        if (spi > 16 || (spi & (spi - 1)) != 0)
+        {
+            urj_error_set (URJ_ERROR_SYNTAX,
+                           "%s:%d: spi size must be a power of two <= 16",
+                           filename, lineno);
+            return NULL;
+        }
+        return urj_jim_some_cpu_spi (spi);
+    }
+
+    if (strcmp (type, "some_cpu") == 0)
+    {
+        if (flash == 0)
+            return urj_jim_some_cpu ();
+        if (flash > 1024 || (flash & (flash - 1)) != 0)
+        {
+            urj_error_set (URJ_ERROR_SYNTAX,
+                           "%s:%d: flash size must be a power of two <= 1024",
+                           filename, lineno);
+            return NULL;
+        }
+        if (chips != 1 && chips != 2)
+        {
+            urj_error_set (URJ_ERROR_SYNTAX, "%s:%d: chips must be 1 or 2",
+                           filename, lineno);
+            return NULL;
+        }
+        return urj_jim_some_cpu_cfi (flash, chips);
+    }
+
+    if (strcmp (type, "generic") == 0)
+        return urj_jim_generic_device (ir, bsr, has_idcode, idcode);
+
+    if (strcmp (type, "fpga") == 0 && fjmem != 0)
+    {
+        if (spi != 0)
+        {
+            urj_error_set (URJ_ERROR_SYNTAX,
+                           "%s:%d: fjmem and spi exclude each other",
+                           filename, lineno);
+            return NULL;
+        }
+        if (fjmem > 1024 || (fjmem & (fjmem - 1)) != 0)
+        {
+            urj_error_set (URJ_ERROR_SYNTAX,
+                           "%s:%d: fjmem size must be a power of two <= 1024",
+                           filename, lineno);
+            return NULL;
+        }
+        return urj_jim_fjmem_core (fjmem, burst != 0);
+    }
+
+    if (strcmp (type, "fpga") == 0)
+    {
+        if (spi == 0 || spi > 16 || (spi & (spi - 1)) != 0)
+        {
+            urj_error_set (URJ_ERROR_SYNTAX,
+                           "%s:%d: spi size must be a power of two <= 16",
+                           filename, lineno);
+            return NULL;
+        }
+        return urj_jim_spi_bridge (spi);
+    }
+
+    if (strcmp (type, "mips") == 0)
+    {
+        if (ram == 0 || ram > 16384 || (ram & (ram - 1)) != 0)
+        {
+            urj_error_set (URJ_ERROR_SYNTAX,
+                           "%s:%d: ram size must be a power of two <= 16384",
+                           filename, lineno);
+            return NULL;
+        }
+        if (lag > 3)
+        {
+            urj_error_set (URJ_ERROR_SYNTAX, "%s:%d: lag must be 0 to 3",
+                           filename, lineno);
+            return NULL;
+        }
+        if (dma > 100000)
+        {
+            urj_error_set (URJ_ERROR_SYNTAX, "%s:%d: dma must be <= 100000",
+                           filename, lineno);
+            return NULL;
+        }
+        return urj_jim_mips_ejtag (ram, lag, fastdata != 0,
+                                   has_dma ? (int) dma : -1);
+    }
+
+    if (strcmp (type, "bfin") == 0)
+    {
+        if (ram == 0 || ram > 16384 || (ram & (ram - 1)) != 0)
+        {
+            urj_error_set (URJ_ERROR_SYNTAX,
+                           "%s:%d: ram size must be a power of two <= 16384",
+                           filename, lineno);
+            return NULL;
+        }
+        if (core > 1000 || mem > 1000)
+        {
+            urj_error_set (URJ_ERROR_SYNTAX,
+                           "%s:%d: core and mem must be <= 1000",
+                           filename, lineno);
+            return NULL;
+        }
+        return urj_jim_bfin (ram, core, mem);
+    }
+
+    if (strcmp (type, "cyclone") == 0 || strcmp (type, "ecp5") == 0)
+    {
+        if (size == 0 || size > 1024)
+        {
+            urj_error_set (URJ_ERROR_SYNTAX,
+                           "%s:%d: size must be 1 to 1024",
+                           filename, lineno);
+            return NULL;
+        }
+        if (strcmp (type, "cyclone") == 0)
+            return urj_jim_cyclone (size);
+        return urj_jim_ecp5 (size);
+    }
+
+    urj_error_set (URJ_ERROR_SYNTAX, "%s:%d: unknown device '%s'",
+                   filename, lineno, type);
+    return NULL;
+}
+
+/* Build the chain from a description file, see README.jim */
+static int
+urj_jim_chain_load (urj_jim_state_t *s, const char *filename)
+{
+    FILE *f;
+    char line[256];
+    int lineno = 0;
+    urj_jim_device_t *first_in_chain = NULL;
+
+    f = fopen (filename, FOPEN_R);
+    if (f == NULL)
+    {
+        urj_error_IO_set ("Cannot open JIM chain description '%s'", filename);
+        return URJ_STATUS_FAIL;
+    }
+
+    while (fgets (line, sizeof line, f) != NULL)
+    {
+        urj_jim_device_t *dev;
+        char *p;
+
+        lineno++;
+        if ((p = strchr (line, '#')) != NULL)
+            *p = '\0';
+        for (p = line; isspace ((unsigned char) *p); p++)
+            ;
+        if (*p == '\0')
+            continue;
+
+        dev = urj_jim_chain_device (p, filename, lineno);
+        if (dev == NULL)
+        {
+            fclose (f);
+            // retain error state
+            return URJ_STATUS_FAIL;
+        }
+
+        /* The first line is the device next to TDO (part 0) */
+        dev->prev = NULL;
+        if (first_in_chain == NULL)
+            s->last_device_in_chain = dev;
+        else
+            first_in_chain->prev = dev;
+        first_in_chain = dev;
+    }
+    fclose (f);
+
+    if (s->last_device_in_chain == NULL)
+    {
+        urj_error_set (URJ_ERROR_INVALID, "%s: no devices", filename);
+        return URJ_STATUS_FAIL;
+    }
+
+    return URJ_STATUS_OK;
+}
+
 urj_jim_state_t *
-urj_jim_init (void)
+urj_jim_init_chain (const char *chain_file)
 {
     urj_jim_state_t *s;
 
@@ -307,6 +762,21 @@ urj_jim_init (void)
     }
 
     s->trst = 0;
+    s->shift_buf = NULL;
+    s->shift_buf_words = 0;
+    s->last_device_in_chain = NULL;
+
+    if (chain_file != NULL)
+    {
+        if (urj_jim_chain_load (s, chain_file) != URJ_STATUS_OK)
+        {
+            urj_jim_free (s);
+            // retain error state
+            return NULL;
+        }
+        return s;
+    }
+
     s->last_device_in_chain = urj_jim_some_cpu ();
 
     if (s->last_device_in_chain != NULL)
@@ -323,6 +793,12 @@ urj_jim_init (void)
     return s;
 }
 
+urj_jim_state_t *
+urj_jim_init (void)
+{
+    return urj_jim_init_chain (NULL);
+}
+
 void
 urj_jim_free (urj_jim_state_t *s)
 {
@@ -347,6 +823,7 @@ urj_jim_free (urj_jim_state_t *s)
     }
 
     s->last_device_in_chain = NULL;
+    free (s->shift_buf);
     free (s->shmem);
     free (s);
 }
@@ -0,0 +1,676 @@
+/*
+ * $Id$
+ *
+ * Copyright (C) 2026 UrJTAG contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * A MIPS32 processor with an EJTAG 2.6 TAP and RAM at physical address 0.
+ * Instructions (5 bit IR, as in data/admtek/adm5120):
+ *
+ *   00001      IDCODE          (IDR)
+ *   00011      EJTAG_IMPCODE   (IMPCODE)
+ *   01000      EJTAG_ADDRESS   (ADDRESS)
+ *   01001      EJTAG_DATA      (DATA)
+ *   01010      EJTAG_CONTROL   (CONTROL)
+ *   01011      EJTAG_ALL       (CONTROL, DATA and ADDRESS in one register)
+ *   01110      EJTAG_FASTDATA  (SPrAcc and DATA, unless left out)
+ *   all others BYPASS
+ *
+ * JtagBrk with ProbEn and ProbTrap set enters debug mode at 0xff200200, and
+ * from then on the processor only runs code from dmseg: every fetch, load
+ * and store in 0xff200000..0xff2fffff waits for the probe, which completes
+ * it by writing PrAcc = 0 (or SPrAcc = 0 through FASTDATA for the first 16
+ * bytes). Between those, the processor runs instantly. It fetches lag
+ * instructions ahead of the one it executes, and stops fetching after the
+ * delay slot of a jump until the jump is done. Known instructions are lui,
+ * ori, addiu, or, addu, sll (nop), jr and the unsigned loads and stores of
+ * bytes, halfwords and words; all others do nothing. kseg0 and kseg1 map
+ * to the RAM, little endian.
+ *
+ * With DMA, DmaAcc and DStrt start a transfer at the Address register that
+ * takes a given number of TCK cycles. DMA addresses below 0x20000000 are
+ * physical, kseg0 and kseg1 are mapped as above, 0xff300000 is the Debug
+ * Control Register and kseg2 ends in Derr.
+ */
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <urjtag/types.h>
+#include <urjtag/log.h>
+#include <urjtag/error.h>
+#include <urjtag/jim.h>
+
+#define MIPS_DR_BYPASS          0
+#define MIPS_DR_IDR             1
+#define MIPS_DR_IMPCODE         2
+#define MIPS_DR_ADDRESS         3
+#define MIPS_DR_DATA            4
+#define MIPS_DR_CONTROL         5
+#define MIPS_DR_ALL             6
+#define MIPS_DR_FASTDATA        7
+
+#define MIPS_IR_IDCODE          0x01
+#define MIPS_IR_IMPCODE         0x03
+#define MIPS_IR_ADDRESS         0x08
+#define MIPS_IR_DATA            0x09
+#define MIPS_IR_CONTROL         0x0a
+#define MIPS_IR_ALL             0x0b
+#define MIPS_IR_FASTDATA        0x0e
+
+#define MIPS_IDCODE             0x3a5c7e1f
+/* EJTAG 2.6 */
+#define MIPS_IMPCODE            (2 << 29)
+#define MIPS_NODMA              (1 << 14)
+
+/* EJTAG Control Register bits */
+#define MIPS_ROCC               (UINT32_C (1) << 31)
+#define MIPS_PSZ_POS            29
+#define MIPS_PERRST             (UINT32_C (1) << 20)
+#define MIPS_PRNW               (UINT32_C (1) << 19)
+#define MIPS_PRACC              (UINT32_C (1) << 18)
+#define MIPS_DMAACC             (UINT32_C (1) << 17)
+#define MIPS_PRRST              (UINT32_C (1) << 16)
+#define MIPS_PROBEN             (UINT32_C (1) << 15)
+#define MIPS_PROBTRAP           (UINT32_C (1) << 14)
+#define MIPS_JTAGBRK            (UINT32_C (1) << 12)
+#define MIPS_DSTRT              (UINT32_C (1) << 11)
+#define MIPS_DERR               (UINT32_C (1) << 10)
+#define MIPS_DRWN               (UINT32_C (1) << 9)
+#define MIPS_DSZ_POS            7
+#define MIPS_BRKST              (UINT32_C (1) << 3)
+
+#define MIPS_DCR                UINT32_C (0xff300000)
+#define MIPS_DCR_MP             (UINT32_C (1) << 2)
+
+#define MIPS_DMSEG              UINT32_C (0xff200000)
+#define MIPS_DMSEG_SIZE         UINT32_C (0x00100000)
+#define MIPS_FASTDATA_SIZE      16
+#define MIPS_DEBUG_VECTOR       UINT32_C (0xff200200)
+#define MIPS_ROM_DEBUG_VECTOR   UINT32_C (0xbfc00480)
+
+#define MIPS_MAX_LAG            3
+
+/* processor accesses that wait for the probe */
+#define MIPS_ACC_NONE           0
+#define MIPS_ACC_FETCH          1
+#define MIPS_ACC_LOAD           2
+#define MIPS_ACC_STORE          3
+
+typedef struct
+{
+    uint8_t *ram;
+    uint32_t ram_size;
+    int lag;
+    int has_fastdata;
+    /* EJTAG */
+    uint32_t data;              /* the Data register */
+    uint32_t addr;              /* the Address register */
+    int rocc;
+    int proben;
+    int probtrap;
+    int access;                 /* MIPS_ACC_*, the access PrAcc stands for */
+    int size;                   /* of the access, in bytes */
+    int load_rt;                /* the register a pending load goes to */
+    /* DMA */
+    int dma_clocks;             /* TCKs per transfer, -1 without DMA */
+    int dma_busy;               /* TCKs until the transfer is done */
+    int dma_acc;
+    int dma_read;
+    int dma_size;
+    uint32_t dma_addr;          /* written to the Address register */
+    int derr;
+    uint32_t dcr;               /* Debug Control Register */
+    /* the processor */
+    int debug;
+    int stuck;                  /* it left dmseg, only a reset helps */
+    uint32_t gpr[32];
+    uint32_t fetch_pc;
+    uint32_t queue[MIPS_MAX_LAG + 1];   /* fetched, not yet executed */
+    int qlen;
+    int delay_slot;             /* the next fetch is a delay slot */
+    int fetch_stop;             /* the delay slot is fetched */
+    int jump;                   /* a jump is executed, its delay slot next */
+    uint32_t jump_target;
+}
+mips_state_t;
+
+static void
+urj_jim_mips_set (mips_state_t *ms, int r, uint32_t v)
+{
+    if (r != 0)
+        ms->gpr[r] = v;
+}
+
+static void
+urj_jim_mips_reset (mips_state_t *ms)
+{
+    memset (ms->gpr, 0, sizeof ms->gpr);
+    ms->debug = 0;
+    ms->stuck = 0;
+    ms->access = MIPS_ACC_NONE;
+    ms->qlen = 0;
+    ms->delay_slot = 0;
+    ms->fetch_stop = 0;
+    ms->jump = 0;
+    ms->rocc = 1;
+}
+
+static uint32_t
+urj_jim_mips_control_value (mips_state_t *ms)
+{
+    uint32_t ctrl = 0;
+
+    if (ms->rocc)
+        ctrl |= MIPS_ROCC;
+    if (ms->access != MIPS_ACC_NONE)
+    {
+        ctrl |= MIPS_PRACC;
+        ctrl |= (uint32_t) (ms->size == 4 ? 2 : ms->size - 1) << MIPS_PSZ_POS;
+        if (ms->access == MIPS_ACC_STORE)
+            ctrl |= MIPS_PRNW;
+    }
+    if (ms->proben)
+        ctrl |= MIPS_PROBEN;
+    if (ms->probtrap)
+        ctrl |= MIPS_PROBTRAP;
+    if (ms->debug)
+        ctrl |= MIPS_BRKST;
+    if (ms->dma_acc)
+        ctrl |= MIPS_DMAACC;
+    if (ms->dma_busy)
+        ctrl |= MIPS_DSTRT;
+    if (ms->derr)
+        ctrl |= MIPS_DERR;
+
+    return ctrl;
+}
+
+/* The DMA transfer is done; like the core, it takes the address and the
+   data from the registers now, not when it was started */
+static void
+urj_jim_mips_dma (mips_state_t *ms)
+{
+    uint32_t adr = ms->dma_addr, phys, v = 0;
+    int i, lane;
+
+    ms->dma_busy = 0;
+
+    if (adr == MIPS_DCR)
+    {
+        if (ms->dma_read)
+            ms->data = ms->dcr;
+        else
+            ms->dcr = ms->data;
+        return;
+    }
+    if ((adr >> 29) == 6)
+    {
+        /* kseg2, mapped */
+        ms->derr = 1;
+        return;
+    }
+    if (adr >= UINT32_C (0x20000000) && (adr >> 30) != 2)
+    {
+        if (ms->dma_read)
+            ms->data = 0;
+        return;
+    }
+
+    phys = adr & UINT32_C (0x1fffffff) & ~(uint32_t) 3;
+    if (phys >= ms->ram_size)
+    {
+        if (ms->dma_read)
+            ms->data = 0;
+        return;
+    }
+    if (ms->dma_read)
+    {
+        for (i = 0; i < 4; i++)
+            v |= (uint32_t) ms->ram[phys + i] << (8 * i);
+        ms->data = v;
+        return;
+    }
+    /* the bytes in their lanes of the Data register */
+    lane = adr & (4 - ms->dma_size);
+    for (i = lane; i < lane + ms->dma_size; i++)
+        ms->ram[phys + i] = (ms->data >> (8 * i)) & 0xff;
+}
+
+static int
+urj_jim_mips_in_dmseg (uint32_t adr)
+{
+    return adr - MIPS_DMSEG < MIPS_DMSEG_SIZE;
+}
+
+/* A load or store of @size bytes at the virtual address @adr */
+static void
+urj_jim_mips_mem (mips_state_t *ms, int store, int size, int rt,
+                  uint32_t adr)
+{
+    uint32_t phys, v = 0;
+    int i;
+
+    adr &= ~(uint32_t) (size - 1);
+
+    if (urj_jim_mips_in_dmseg (adr))
+    {
+        ms->access = store ? MIPS_ACC_STORE : MIPS_ACC_LOAD;
+        ms->addr = adr;
+        ms->size = size;
+        ms->load_rt = rt;
+        if (store)
+            ms->data = size == 4 ? ms->gpr[rt]
+                : ms->gpr[rt] & ((UINT32_C (1) << (8 * size)) - 1);
+        return;
+    }
+
+    /* kseg0 and kseg1 */
+    if ((adr >> 30) != 2)
+        return;
+    phys = adr & UINT32_C (0x1fffffff);
+    if (phys >= ms->ram_size)
+        return;
+
+    if (store)
+    {
+        for (i = 0; i < size; i++)
+            ms->ram[phys + i] = (ms->gpr[rt] >> (8 * i)) & 0xff;
+        return;
+    }
+    for (i = 0; i < size; i++)
+        v |= (uint32_t) ms->ram[phys + i] << (8 * i);
+    urj_jim_mips_set (ms, rt, v);
+}
+
+/* Execute the oldest fetched instruction */
+static void
+urj_jim_mips_exec (mips_state_t *ms)
+{
+    uint32_t insn = ms->queue[0];
+    int rs = (insn >> 21) & 31;
+    int rt = (insn >> 16) & 31;
+    int rd = (insn >> 11) & 31;
+    uint32_t imm = insn & 0xffff;
+    uint32_t simm = (uint32_t) (int32_t) (int16_t) imm;
+    uint32_t adr = ms->gpr[rs] + simm;
+    int in_delay_slot = ms->jump;
+
+    ms->qlen--;
+    memmove (ms->queue, ms->queue + 1, ms->qlen * sizeof ms->queue[0]);
+
+    switch (insn >> 26)
+    {
+    case 0x00:
+        switch (insn & 0x3f)
+        {
+        case 0x00:              /* sll */
+            urj_jim_mips_set (ms, rd, ms->gpr[rt] << ((insn >> 6) & 31));
+            break;
+        case 0x08:              /* jr */
+            ms->jump = 1;
+            ms->jump_target = ms->gpr[rs];
+            break;
+        case 0x21:              /* addu */
+            urj_jim_mips_set (ms, rd, ms->gpr[rs] + ms->gpr[rt]);
+            break;
+        case 0x25:              /* or */
+            urj_jim_mips_set (ms, rd, ms->gpr[rs] | ms->gpr[rt]);
+            break;
+        default:
+            break;
+        }
+        break;
+    case 0x09:                  /* addiu */
+        urj_jim_mips_set (ms, rt, ms->gpr[rs] + simm);
+        break;
+    case 0x0d:                  /* ori */
+        urj_jim_mips_set (ms, rt, ms->gpr[rs] | imm);
+        break;
+    case 0x0f:                  /* lui */
+        urj_jim_mips_set (ms, rt, imm << 16);
+        break;
+    case 0x23:                  /* lw */
+        urj_jim_mips_mem (ms, 0, 4, rt, adr);
+        break;
+    case 0x24:                  /* lbu */
+        urj_jim_mips_mem (ms, 0, 1, rt, adr);
+        break;
+    case 0x25:                  /* lhu */
+        urj_jim_mips_mem (ms, 0, 2, rt, adr);
+        break;
+    case 0x28:                  /* sb */
+        urj_jim_mips_mem (ms, 1, 1, rt, adr);
+        break;
+    case 0x29:                  /* sh */
+        urj_jim_mips_mem (ms, 1, 2, rt, adr);
+        break;
+    case 0x2b:                  /* sw */
+        urj_jim_mips_mem (ms, 1, 4, rt, adr);
+        break;
+    default:
+        break;
+    }
+
+    if (in_delay_slot)
+    {
+        ms->jump = 0;
+        ms->fetch_pc = ms->jump_target;
+        ms->fetch_stop = 0;
+    }
+}
+
+/* Run until the next access that waits for the probe */
+static void
+urj_jim_mips_run (mips_state_t *ms)
+{
+    while (ms->debug && !ms->stuck && ms->access == MIPS_ACC_NONE)
+    {
+        if (ms->qlen > ms->lag || (ms->fetch_stop && ms->qlen > 0))
+            urj_jim_mips_exec (ms);
+        else if (!ms->fetch_stop && urj_jim_mips_in_dmseg (ms->fetch_pc))
+        {
+            ms->access = MIPS_ACC_FETCH;
+            ms->addr = ms->fetch_pc;
+            ms->size = 4;
+        }
+        else
+            ms->stuck = 1;
+    }
+}
+
+/* The probe completes the pending access */
+static void
+urj_jim_mips_complete (mips_state_t *ms)
+{
+    uint32_t v = ms->data;
+
+    switch (ms->access)
+    {
+    case MIPS_ACC_FETCH:
+        ms->queue[ms->qlen++] = v;
+        ms->fetch_pc += 4;
+        if (ms->delay_slot)
+        {
+            ms->delay_slot = 0;
+            ms->fetch_stop = 1;
+        }
+        else if ((v & 0xfc00003f) == 0x00000008)        /* jr */
+            ms->delay_slot = 1;
+        break;
+    case MIPS_ACC_LOAD:
+        if (ms->size < 4)
+            v &= (UINT32_C (1) << (8 * ms->size)) - 1;
+        urj_jim_mips_set (ms, ms->load_rt, v);
+        break;
+    default:
+        break;
+    }
+
+    ms->access = MIPS_ACC_NONE;
+    urj_jim_mips_run (ms);
+}
+
+static void
+urj_jim_mips_control (mips_state_t *ms, uint32_t v)
+{
+    if (!(v & MIPS_ROCC))
+        ms->rocc = 0;
+    ms->proben = (v & MIPS_PROBEN) != 0;
+    ms->probtrap = (v & MIPS_PROBTRAP) != 0;
+
+    if (v & (MIPS_PRRST | MIPS_PERRST))
+    {
+        urj_jim_mips_reset (ms);
+        return;
+    }
+
+    ms->dma_acc = (v & MIPS_DMAACC) != 0;
+    if (ms->dma_clocks >= 0 && ms->dma_acc && (v & MIPS_DSTRT)
+        && !ms->dma_busy)
+    {
+        ms->derr = 0;
+        ms->dma_read = (v & MIPS_DRWN) != 0;
+        ms->dma_size = 1 << ((v >> MIPS_DSZ_POS) & 3);
+        if (ms->dma_size > 4)
+            ms->dma_size = 4;
+        ms->dma_busy = ms->dma_clocks;
+        if (ms->dma_clocks == 0)
+            urj_jim_mips_dma (ms);
+    }
+
+    if ((v & MIPS_JTAGBRK) && !ms->debug)
+    {
+        ms->debug = 1;
+        ms->fetch_pc = ms->proben && ms->probtrap ? MIPS_DEBUG_VECTOR
+            : MIPS_ROM_DEBUG_VECTOR;
+        urj_jim_mips_run (ms);
+        return;
+    }
+
+    if (!(v & MIPS_PRACC) && ms->access != MIPS_ACC_NONE)
+        urj_jim_mips_complete (ms);
+}
+
+static void
+urj_jim_mips_select_dr (urj_jim_device_t *dev)
+{
+    mips_state_t *ms = dev->state;
+
+    switch (dev->sreg[0].reg[0])
+    {
+    case MIPS_IR_IDCODE:
+        dev->current_dr = MIPS_DR_IDR;
+        break;
+    case MIPS_IR_IMPCODE:
+        dev->current_dr = MIPS_DR_IMPCODE;
+        break;
+    case MIPS_IR_ADDRESS:
+        dev->current_dr = MIPS_DR_ADDRESS;
+        break;
+    case MIPS_IR_DATA:
+        dev->current_dr = MIPS_DR_DATA;
+        break;
+    case MIPS_IR_CONTROL:
+        dev->current_dr = MIPS_DR_CONTROL;
+        break;
+    case MIPS_IR_ALL:
+        dev->current_dr = MIPS_DR_ALL;
+        break;
+    case MIPS_IR_FASTDATA:
+        dev->current_dr = ms->has_fastdata ? MIPS_DR_FASTDATA
+            : MIPS_DR_BYPASS;
+        break;
+    default:
+        dev->current_dr = MIPS_DR_BYPASS;
+        break;
+    }
+}
+
+static void
+urj_jim_mips_capture (urj_jim_device_t *dev, mips_state_t *ms)
+{
+    uint32_t *reg = dev->sreg[dev->current_dr].reg;
+
+    switch (dev->current_dr)
+    {
+    case MIPS_DR_IDR:
+        reg[0] = MIPS_IDCODE;
+        break;
+    case MIPS_DR_IMPCODE:
+        reg[0] = MIPS_IMPCODE;
+        if (ms->dma_clocks < 0)
+            reg[0] |= MIPS_NODMA;
+        break;
+    case MIPS_DR_ADDRESS:
+        reg[0] = ms->addr;
+        break;
+    case MIPS_DR_DATA:
+        reg[0] = ms->data;
+        break;
+    case MIPS_DR_CONTROL:
+        reg[0] = urj_jim_mips_control_value (ms);
+        break;
+    case MIPS_DR_ALL:
+        reg[0] = urj_jim_mips_control_value (ms);
+        reg[1] = ms->data;
+        reg[2] = ms->addr;
+        break;
+    case MIPS_DR_FASTDATA:
+        reg[0] = (ms->data << 1) | (ms->access != MIPS_ACC_NONE);
+        reg[1] = ms->data >> 31;
+        break;
+    default:
+        break;
+    }
+}
+
+static void
+urj_jim_mips_update (urj_jim_device_t *dev, mips_state_t *ms)
+{
+    uint32_t *reg = dev->sreg[dev->current_dr].reg;
+
+    switch (dev->current_dr)
+    {
+    case MIPS_DR_ADDRESS:
+        ms->dma_addr = reg[0];
+        break;
+    case MIPS_DR_DATA:
+        ms->data = reg[0];
+        break;
+    case MIPS_DR_CONTROL:
+        urj_jim_mips_control (ms, reg[0]);
+        break;
+    case MIPS_DR_ALL:
+        ms->data = reg[1];
+        urj_jim_mips_control (ms, reg[0]);
+        break;
+    case MIPS_DR_FASTDATA:
+        ms->data = (reg[0] >> 1) | (reg[1] << 31);
+        if (!(reg[0] & 1)
+            && (ms->access == MIPS_ACC_LOAD || ms->access == MIPS_ACC_STORE)
+            && ms->addr - MIPS_DMSEG < MIPS_FASTDATA_SIZE)
+            urj_jim_mips_complete (ms);
+        break;
+    default:
+        break;
+    }
+
+    /* count the clocks of a DMA transfer in Shift-DR too */
+    dev->clocked = ms->dma_busy != 0;
+}
+
+static void
+urj_jim_mips_tck_rise (urj_jim_device_t *dev, int tms, int tdi,
+                       uint8_t *shmem, size_t shmem_size)
+{
+    mips_state_t *ms = dev->state;
+
+    if (ms->dma_busy && --ms->dma_busy == 0)
+    {
+        urj_jim_mips_dma (ms);
+        dev->clocked = 0;
+    }
+
+    switch (dev->tap_state)
+    {
+    case URJ_JIM_RESET:
+        dev->sreg[0].reg[0] = MIPS_IR_IDCODE;
+        urj_jim_mips_select_dr (dev);
+        break;
+
+    case URJ_JIM_CAPTURE_IR:
+        dev->sreg[0].reg[0] = 1;
+        break;
+
+    case URJ_JIM_UPDATE_IR:
+        urj_jim_mips_select_dr (dev);
+        break;
+
+    case URJ_JIM_CAPTURE_DR:
+        urj_jim_mips_capture (dev, ms);
+        break;
+
+    case URJ_JIM_UPDATE_DR:
+        urj_jim_mips_update (dev, ms);
+        break;
+
+    default:
+        break;
+    }
+}
+
+static void
+urj_jim_mips_free (urj_jim_device_t *dev)
+{
+    mips_state_t *ms = dev->state;
+
+    if (ms != NULL)
+    {
+        free (ms->ram);
+        free (ms);
+    }
+}
+
+urj_jim_device_t *
+urj_jim_mips_ejtag (int kbytes, int lag, int fastdata, int dma)
+{
+    urj_jim_device_t *dev;
+    mips_state_t *ms;
+    const int reg_size[8] = { 5, 32, 32, 32, 32, 32, 96, 33 };
+
+    ms = calloc (1, sizeof (mips_state_t));
+    if (ms == NULL)
+    {
+        urj_error_set (URJ_ERROR_OUT_OF_MEMORY, "calloc(%zd,%zd) fails",
+                       (size_t) 1, sizeof (mips_state_t));
+        return NULL;
+    }
+    ms->ram_size = (uint32_t) kbytes * 1024;
+    ms->ram = calloc (ms->ram_size, 1);
+    if (ms->ram == NULL)
+    {
+        free (ms);
+        urj_error_set (URJ_ERROR_OUT_OF_MEMORY, "calloc(%zd,%zd) fails",
+                       (size_t) kbytes * 1024, (size_t) 1);
+        return NULL;
+    }
+    ms->lag = lag;
+    ms->has_fastdata = fastdata;
+    ms->dma_clocks = dma;
+    ms->dcr = MIPS_DCR_MP;
+    urj_jim_mips_reset (ms);
+
+    dev = urj_jim_alloc_device (8, reg_size);
+    if (dev == NULL)
+    {
+        free (ms->ram);
+        free (ms);
+        // retain error state
+        return NULL;
+    }
+
+    dev->state = ms;
+    dev->tck_rise = urj_jim_mips_tck_rise;
+    dev->dev_free = urj_jim_mips_free;
+
+    return dev;
+}
@@ -33,6 +33,8 @@
 #include <urjtag/bitmask.h>
 
 extern urj_jim_bus_device_t urj_jim_intel_28f800b3b;
+extern urj_jim_bus_device_t urj_jim_cfi_flash;
+extern urj_jim_bus_device_t urj_jim_spi_flash;
 
 static urj_jim_attached_part_t some_cpu_attached[] = {
     /* 1. Address offset: base offset [bytes]
@@ -78,7 +80,8 @@ urj_jim_some_cpu_tck_rise (urj_jim_device_t *dev, int tms, int tdi,
 
             urj_log (URJ_LOG_LEVEL_DETAIL, "URJ_JIM_CAPTURE_DR/EXTEST\n");
 
-            for (i = 0; some_cpu_attached[i].part; i++)
+            for (i = 0; ((urj_jim_attached_part_t *) (dev->state))[i].part;
+                 i++)
             {
                 urj_jim_attached_part_t *tp =
                     &(((urj_jim_attached_part_t *) (dev->state))[i]);
@@ -150,7 +153,8 @@ urj_jim_some_cpu_tck_fall (urj_jim_device_t *dev, uint8_t *shmem,
 
             urj_log (URJ_LOG_LEVEL_DETAIL, "URJ_JIM_UPDATE_DR/EXTEST\n");
 
-            for (i = 0; some_cpu_attached[i].part; i++)
+            for (i = 0; ((urj_jim_attached_part_t *) (dev->state))[i].part;
+                 i++)
             {
                 urj_jim_attached_part_t *tp =
                     &(((urj_jim_attached_part_t *) (dev->state))[i]);
@@ -185,7 +189,7 @@ urj_jim_some_cpu_free (urj_jim_device_t *dev)
     if (!dev->state)
         return;
 
-    for (i = 0; some_cpu_attached[i].part; i++)
+    for (i = 0; ((urj_jim_attached_part_t *) (dev->state))[i].part; i++)
     {
         urj_jim_bus_device_t *b =
             ((urj_jim_attached_part_t *) (dev->state))[i].part;
@@ -196,12 +200,18 @@ urj_jim_some_cpu_free (urj_jim_device_t *dev)
     free (dev->state);
 }
 
-urj_jim_device_t *
-urj_jim_some_cpu (void)
+static urj_jim_device_t *
+urj_jim_some_cpu_attach (const urj_jim_attached_part_t *attached)
 {
     urj_jim_device_t *dev;
     const int reg_size[3] =
         { 2 /* IR */ , 32 /* IDR */ , BSR_LEN /* BSR */  };
+    size_t attached_size;
+    int n;
+
+    for (n = 0; attached[n].part; n++)
+        ;
+    attached_size = (n + 1) * sizeof (urj_jim_attached_part_t);
 
     dev = urj_jim_alloc_device (3, reg_size);
 
@@ -210,12 +220,12 @@ urj_jim_some_cpu (void)
         /* Allocate memory for copies of the original structure for dynamic
          * modifications (e.g. if bus width changes because of some signal) */
 
-        dev->state = malloc (sizeof (some_cpu_attached));
+        dev->state = malloc (attached_size);
         if (!dev->state)
         {
             free (dev);
             urj_error_set (URJ_ERROR_OUT_OF_MEMORY, "malloc(%zd) fails",
-                           sizeof (some_cpu_attached));
+                           attached_size);
             dev = NULL;
         }
         else
@@ -224,10 +234,9 @@ urj_jim_some_cpu (void)
             dev->tck_rise = urj_jim_some_cpu_tck_rise;
             dev->tck_fall = urj_jim_some_cpu_tck_fall;
             dev->dev_free = urj_jim_some_cpu_free;
-            memcpy (dev->state, some_cpu_attached,
-                    sizeof (some_cpu_attached));
+            memcpy (dev->state, attached, attached_size);
 
-            for (i = 0; some_cpu_attached[i].part; i++)
+            for (i = 0; attached[i].part; i++)
             {
                 urj_jim_bus_device_t **b =
                     &(((urj_jim_attached_part_t *) (dev->state))[i].part);
@@ -238,7 +247,7 @@ urj_jim_some_cpu (void)
                                    sizeof (urj_jim_bus_device_t));
                     break;
                 }
-                memcpy (*b, some_cpu_attached[i].part,
+                memcpy (*b, attached[i].part,
                         sizeof (urj_jim_bus_device_t));
                 if ((*b)->init (*b) != URJ_STATUS_OK)
                 {
@@ -249,7 +258,7 @@ urj_jim_some_cpu (void)
                 }
             }
 
-            if (some_cpu_attached[i].part)      /* loop broken; failed to malloc all parts */
+            if (attached[i].part)      /* loop broken; failed to malloc all parts */
             {
                 for (i--; i >= 0; i--)
                     free (((urj_jim_attached_part_t *) (dev->state))[i].part);
@@ -261,3 +270,48 @@ urj_jim_some_cpu (void)
     }
     return dev;
 }
+
+urj_jim_device_t *
+urj_jim_some_cpu (void)
+{
+    return urj_jim_some_cpu_attach (some_cpu_attached);
+}
+
+urj_jim_device_t *
+urj_jim_some_cpu_cfi (int mbytes, int chips)
+{
+    urj_jim_bus_device_t flash = urj_jim_cfi_flash;
+    urj_jim_attached_part_t attached[] = {
+        {0x00000000, 1, 0, &flash},
+        {0xFFFFFFFF, 0, 0, NULL},
+        {0xFFFFFFFF, 0, 0, NULL}
+    };
+
+    flash.size = mbytes << 19;  /* words of 2 bytes */
+
+    if (chips == 2)
+    {
+        /* 2 x 16 bit: one chip on D(15)..D(0), the other on D(31)..D(16) */
+        attached[0].adr_shift = 2;
+        attached[1] = attached[0];
+        attached[1].data_shift = 16;
+    }
+
+    return urj_jim_some_cpu_attach (attached);
+}
+
+urj_jim_device_t *
+urj_jim_some_cpu_spi (int mbytes)
+{
+    urj_jim_bus_device_t flash = urj_jim_spi_flash;
+    /* the SPI flash ignores the address bus: with the address shifted by
+       31, every access falls into the decoded range */
+    urj_jim_attached_part_t attached[] = {
+        {0x00000000, 31, 0, &flash},
+        {0xFFFFFFFF, 0, 0, NULL}
+    };
+
+    flash.size = mbytes << 20;
+
+    return urj_jim_some_cpu_attach (attached);
+}
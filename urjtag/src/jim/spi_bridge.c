@@ -0,0 +1,255 @@
+/*
+ * $Id$
+ *
+ * Copyright (C) 2026 UrJTAG contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * An FPGA TAP configured with the JTAG-to-SPI bridge of extra/jtagspi, with
+ * the SPI NOR flash of spi_flash.c behind it. Instructions (6 bit IR, as on
+ * Spartan 3):
+ *
+ *   001001     IDCODE   (IDR)
+ *   000010     USER1    (the bridge, 1 bit)
+ *   all others BYPASS
+ *
+ * The bridge follows jtagspi_core.vhd: after Capture-DR it waits for a 1,
+ * takes a 32 bit clock count LSB first, then clocks the flash with TCK while
+ * it has nCS low. MISO is sampled on the rising edge and shows up on TDO
+ * after the falling edge. Leaving Shift-DR ends the transaction.
+ */
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <urjtag/types.h>
+#include <urjtag/log.h>
+#include <urjtag/error.h>
+#include <urjtag/jim.h>
+
+#define BRIDGE_DR_BYPASS        0
+#define BRIDGE_DR_IDR           1
+#define BRIDGE_DR_USER1         2
+
+#define BRIDGE_IR_IDCODE        0x09
+#define BRIDGE_IR_USER1         0x02
+
+#define BRIDGE_IDCODE           0x0a5b1c3d
+
+/* spi_flash.c pins: nCS is control bit 2, SCK data bit 1, MOSI data bit 2 */
+#define BRIDGE_NCS              (1 << 2)
+#define BRIDGE_SCK              (1 << 1)
+#define BRIDGE_MOSI             (1 << 2)
+
+extern urj_jim_bus_device_t urj_jim_spi_flash;
+
+typedef enum
+{
+    BRIDGE_WAIT_START,
+    BRIDGE_COUNT,
+    BRIDGE_DATA,
+    BRIDGE_DONE,
+}
+bridge_phase_t;
+
+typedef struct
+{
+    urj_jim_bus_device_t flash;
+    bridge_phase_t phase;
+    int bits;
+    uint32_t count;
+    int miso;
+}
+bridge_state_t;
+
+static void
+urj_jim_spi_bridge_select_dr (urj_jim_device_t *dev)
+{
+    uint32_t ir = dev->sreg[0].reg[0];
+
+    if (ir == BRIDGE_IR_IDCODE)
+        dev->current_dr = BRIDGE_DR_IDR;
+    else if (ir == BRIDGE_IR_USER1)
+        dev->current_dr = BRIDGE_DR_USER1;
+    else
+        dev->current_dr = BRIDGE_DR_BYPASS;
+}
+
+static void
+urj_jim_spi_bridge_pins (bridge_state_t *bs, int ncs, int sck, int mosi,
+                         uint8_t *shmem, size_t shmem_size)
+{
+    bs->flash.update (&bs->flash, 0,
+                      (sck ? BRIDGE_SCK : 0) | (mosi ? BRIDGE_MOSI : 0),
+                      ncs ? BRIDGE_NCS : 0, shmem, shmem_size);
+}
+
+/* one TCK rising edge in Shift-DR with USER1 */
+static void
+urj_jim_spi_bridge_shift (bridge_state_t *bs, int tdi,
+                          uint8_t *shmem, size_t shmem_size)
+{
+    switch (bs->phase)
+    {
+    case BRIDGE_WAIT_START:
+        if (tdi)
+        {
+            bs->phase = BRIDGE_COUNT;
+            bs->bits = 0;
+            bs->count = 0;
+        }
+        break;
+
+    case BRIDGE_COUNT:
+        bs->count |= (uint32_t) tdi << bs->bits;
+        if (++bs->bits == 32)
+        {
+            bs->phase = bs->count ? BRIDGE_DATA : BRIDGE_DONE;
+            if (bs->count)
+                urj_jim_spi_bridge_pins (bs, 0, 0, 0, shmem, shmem_size);
+        }
+        break;
+
+    case BRIDGE_DATA:
+        /* SCK is TCK: rising edge now, falling edge half a clock later */
+        urj_jim_spi_bridge_pins (bs, 0, 1, tdi, shmem, shmem_size);
+        bs->miso = bs->flash.capture (&bs->flash, 0, 0, shmem, shmem_size);
+        urj_jim_spi_bridge_pins (bs, 0, 0, tdi, shmem, shmem_size);
+        if (--bs->count == 0)
+        {
+            urj_jim_spi_bridge_pins (bs, 1, 0, 0, shmem, shmem_size);
+            bs->phase = BRIDGE_DONE;
+        }
+        break;
+
+    default:
+        break;
+    }
+}
+
+static void
+urj_jim_spi_bridge_tck_rise (urj_jim_device_t *dev, int tms, int tdi,
+                             uint8_t *shmem, size_t shmem_size)
+{
+    bridge_state_t *bs = dev->state;
+    urj_jim_shift_reg_t *ir = &dev->sreg[0];
+
+    switch (dev->tap_state)
+    {
+    case URJ_JIM_RESET:
+        ir->reg[0] = BRIDGE_IR_IDCODE;
+        urj_jim_spi_bridge_select_dr (dev);
+        break;
+
+    case URJ_JIM_CAPTURE_IR:
+        ir->reg[0] = 1;
+        break;
+
+    case URJ_JIM_UPDATE_IR:
+        urj_jim_spi_bridge_select_dr (dev);
+        break;
+
+    case URJ_JIM_CAPTURE_DR:
+        if (dev->current_dr == BRIDGE_DR_IDR)
+            dev->sreg[BRIDGE_DR_IDR].reg[0] = BRIDGE_IDCODE;
+        bs->phase = BRIDGE_WAIT_START;
+        bs->miso = 0;
+        break;
+
+    case URJ_JIM_SHIFT_DR:
+        if (dev->current_dr != BRIDGE_DR_USER1)
+            break;
+        urj_jim_spi_bridge_shift (bs, tdi, shmem, shmem_size);
+        if (tms && bs->phase == BRIDGE_DATA)
+        {
+            /* Exit1-DR: nCS goes high with the SHIFT signal */
+            urj_jim_spi_bridge_pins (bs, 1, 0, 0, shmem, shmem_size);
+            bs->phase = BRIDGE_DONE;
+        }
+        break;
+
+    default:
+        break;
+    }
+}
+
+static void
+urj_jim_spi_bridge_tck_fall (urj_jim_device_t *dev, uint8_t *shmem,
+                             size_t shmem_size)
+{
+    bridge_state_t *bs = dev->state;
+
+    if (dev->current_dr == BRIDGE_DR_USER1
+        && dev->tap_state == URJ_JIM_SHIFT_DR)
+        dev->tdo = bs->miso;
+}
+
+static void
+urj_jim_spi_bridge_free (urj_jim_device_t *dev)
+{
+    bridge_state_t *bs = dev->state;
+
+    if (bs != NULL)
+    {
+        bs->flash.free (&bs->flash);
+        free (bs);
+    }
+}
+
+urj_jim_device_t *
+urj_jim_spi_bridge (int mbytes)
+{
+    urj_jim_device_t *dev;
+    bridge_state_t *bs;
+    const int reg_size[3] = { 6, 32, 1 };
+
+    bs = calloc (1, sizeof (bridge_state_t));
+    if (bs == NULL)
+    {
+        urj_error_set (URJ_ERROR_OUT_OF_MEMORY, "calloc(%zd,%zd) fails",
+                       (size_t) 1, sizeof (bridge_state_t));
+        return NULL;
+    }
+    bs->flash = urj_jim_spi_flash;
+    bs->flash.size = mbytes << 20;
+    if (bs->flash.init (&bs->flash) != URJ_STATUS_OK)
+    {
+        free (bs);
+        // retain error state
+        return NULL;
+    }
+
+    dev = urj_jim_alloc_device (3, reg_size);
+    if (dev == NULL)
+    {
+        bs->flash.free (&bs->flash);
+        free (bs);
+        // retain error state
+        return NULL;
+    }
+
+    dev->state = bs;
+    dev->tck_rise = urj_jim_spi_bridge_tck_rise;
+    dev->tck_fall = urj_jim_spi_bridge_tck_fall;
+    dev->dev_free = urj_jim_spi_bridge_free;
+    dev->clocked = 1;
+
+    return dev;
+}
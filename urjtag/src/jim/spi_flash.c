@@ -0,0 +1,334 @@
+/*
+ * $Id$
+ *
+ * Copyright (C) 2026 UrJTAG contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * This code simulates an SPI NOR flash (mode 0, 3 byte addresses) with
+ * SFDP, 256 byte pages, 4 KByte sector erase (0x20) and 64 KByte block erase
+ * (0xD8). It is attached to the some_cpu pins CS (nCS), D(1) (SCK), D(2)
+ * (MOSI) and D(0) (MISO), and ignores the address bus. Page program and
+ * erase complete when nCS goes high, so that the model can be used for
+ * benchmarking the host side.
+ */
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <urjtag/types.h>
+#include <urjtag/log.h>
+#include <urjtag/error.h>
+#include <urjtag/jim.h>
+
+#define SPI_PAGE_BYTES          256
+
+#define SPI_SR_WIP              0x01
+#define SPI_SR_WEL              0x02
+#define SPI_SR_BP               0x1C
+
+/* some_cpu pins */
+#define SPI_NCS(control)        (((control) >> 2) & 1)
+#define SPI_SCK(data)           (((data) >> 1) & 1)
+#define SPI_MOSI(data)          (((data) >> 2) & 1)
+
+typedef struct
+{
+    uint8_t *array;
+    uint32_t bytes;
+    uint8_t sfdp[0x50];
+    uint8_t status;
+    /* pins */
+    int selected;
+    int sck;
+    int miso;
+    /* current transaction */
+    int bits;                   /* SCK rising edges since nCS went low */
+    uint8_t in;
+    uint8_t out;
+    uint8_t cmd;
+    uint32_t adr;
+}
+spi_flash_state_t;
+
+static void
+put_dword (uint8_t *p, uint32_t v)
+{
+    p[0] = v;
+    p[1] = v >> 8;
+    p[2] = v >> 16;
+    p[3] = v >> 24;
+}
+
+/* SFDP header, one parameter header and the basic flash parameter table */
+static void
+urj_jim_spi_flash_sfdp (spi_flash_state_t *fs)
+{
+    static const uint8_t head[] = {
+        'S', 'F', 'D', 'P', 0x06, 0x01, 0x00, 0xFF,
+        0x00, 0x06, 0x01, 16, 0x10, 0x00, 0x00, 0xFF,
+    };
+    uint8_t *t = &fs->sfdp[0x10];
+
+    memset (fs->sfdp, 0xFF, sizeof fs->sfdp);
+    memcpy (fs->sfdp, head, sizeof head);
+    memset (t, 0x00, 16 * 4);
+    put_dword (t + 0, 0xFFF120E5);      /* 4 KByte erase with 0x20 */
+    put_dword (t + 4, fs->bytes * 8 - 1);       /* density in bits - 1 */
+    put_dword (t + 28, 0xD810200C);     /* 4 KByte 0x20, 64 KByte 0xD8 */
+    /* erase typical 48 ms (4K) and 160 ms (64K), maximum 8 x typical */
+    put_dword (t + 36, 0x3 | (2 << 4) | (1 << 9) | (9 << 11) | (1 << 16));
+    /* 256 byte page, program typical 448 us, maximum 6 x typical */
+    put_dword (t + 40, 0x2 | (8 << 4) | (6 << 8) | (1 << 13));
+}
+
+static int
+urj_jim_spi_flash_init (urj_jim_bus_device_t *d)
+{
+    spi_flash_state_t *fs;
+    uint32_t bytes = d->size;
+
+    if (bytes < 0x10000 || (bytes & (bytes - 1)) != 0
+        || bytes > 0x1000000)
+    {
+        urj_error_set (URJ_ERROR_INVALID,
+                       "SPI flash size %lu is not a power of two in 64k..16M",
+                       (unsigned long) bytes);
+        return URJ_STATUS_FAIL;
+    }
+
+    fs = calloc (1, sizeof (spi_flash_state_t));
+    if (fs == NULL)
+    {
+        urj_error_set (URJ_ERROR_OUT_OF_MEMORY, "calloc(%zd,%zd) fails",
+                       (size_t) 1, sizeof (spi_flash_state_t));
+        return URJ_STATUS_FAIL;
+    }
+    fs->array = malloc (bytes);
+    if (fs->array == NULL)
+    {
+        free (fs);
+        urj_error_set (URJ_ERROR_OUT_OF_MEMORY, "malloc(%zd) fails",
+                       (size_t) bytes);
+        return URJ_STATUS_FAIL;
+    }
+
+    memset (fs->array, 0xFF, bytes);
+    fs->bytes = bytes;
+    urj_jim_spi_flash_sfdp (fs);
+    d->state = fs;
+
+    urj_log (URJ_LOG_LEVEL_NORMAL,
+             "Simulating %lu bytes of SPI NOR flash.\n",
+             (unsigned long) bytes);
+
+    return URJ_STATUS_OK;
+}
+
+static void
+urj_jim_spi_flash_free (urj_jim_bus_device_t *d)
+{
+    spi_flash_state_t *fs = d->state;
+
+    if (fs != NULL)
+    {
+        free (fs->array);
+        free (fs);
+    }
+}
+
+static uint32_t
+urj_jim_spi_flash_capture (urj_jim_bus_device_t *d,
+                           uint32_t address, uint32_t control,
+                           uint8_t *shmem, size_t shmem_size)
+{
+    spi_flash_state_t *fs = d->state;
+
+    return fs->selected ? fs->miso : 0;
+}
+
+/* the byte sent while byte @n of the transaction comes in */
+static uint8_t
+urj_jim_spi_flash_output (spi_flash_state_t *fs, int n)
+{
+    switch (fs->cmd)
+    {
+    case 0x9F:                 /* RDID */
+        if (n <= 3)
+        {
+            uint8_t id[3] = { 0xEF, 0x40, 0 };
+
+            while ((1u << id[2]) < fs->bytes)
+                id[2]++;
+            return id[n - 1];
+        }
+        break;
+    case 0x05:                 /* RDSR */
+        return fs->status;
+    case 0x03:                 /* READ */
+        if (n >= 4)
+            return fs->array[(fs->adr + n - 4) % fs->bytes];
+        break;
+    case 0x5A:                 /* RDSFDP, one dummy byte */
+        if (n >= 5)
+            return fs->sfdp[(fs->adr + n - 5) % sizeof fs->sfdp];
+        break;
+    default:
+        break;
+    }
+
+    return 0xFF;
+}
+
+/* byte @n of the transaction came in */
+static void
+urj_jim_spi_flash_input (spi_flash_state_t *fs, int n, uint8_t b)
+{
+    if (n == 0)
+    {
+        fs->cmd = b;
+        fs->adr = 0;
+        urj_log (URJ_LOG_LEVEL_COMM, "spi: command %02X\n", b);
+        return;
+    }
+
+    switch (fs->cmd)
+    {
+    case 0x01:                 /* WRSR */
+        if (n == 1 && (fs->status & SPI_SR_WEL))
+            fs->status = (fs->status & (SPI_SR_WIP | SPI_SR_WEL))
+                | (b & ~(SPI_SR_WIP | SPI_SR_WEL));
+        break;
+    case 0x02:                 /* PP */
+        if (n >= 4 && (fs->status & SPI_SR_WEL)
+            && (fs->status & SPI_SR_BP) == 0)
+        {
+            /* the address wraps around inside the page */
+            uint32_t a = (fs->adr & ~(SPI_PAGE_BYTES - 1))
+                | ((fs->adr + n - 4) & (SPI_PAGE_BYTES - 1));
+
+            fs->array[a % fs->bytes] &= b;
+            break;
+        }
+        /* fall through */
+    case 0x03:
+    case 0x5A:
+    case 0x20:
+    case 0xD8:
+        if (n <= 3)
+            fs->adr = (fs->adr << 8) | b;
+        break;
+    default:
+        break;
+    }
+}
+
+/* nCS went high */
+static void
+urj_jim_spi_flash_end (spi_flash_state_t *fs)
+{
+    int n = fs->bits / 8;
+    uint32_t size = 0;
+
+    if (n == 0)
+        return;
+
+    switch (fs->cmd)
+    {
+    case 0x06:                 /* WREN */
+        fs->status |= SPI_SR_WEL;
+        return;
+    case 0x20:                 /* SE */
+        size = 0x1000;
+        break;
+    case 0xD8:                 /* BE */
+        size = 0x10000;
+        break;
+    case 0x01:                 /* WRSR */
+    case 0x02:                 /* PP */
+    case 0x04:                 /* WRDI */
+        break;
+    default:
+        return;
+    }
+
+    if (size != 0 && n == 4 && (fs->status & SPI_SR_WEL)
+        && (fs->status & SPI_SR_BP) == 0)
+    {
+        uint32_t a = (fs->adr % fs->bytes) & ~(size - 1);
+
+        urj_log (URJ_LOG_LEVEL_COMM, "spi: erase %lu bytes at %06lX\n",
+                 (unsigned long) size, (unsigned long) a);
+        memset (&fs->array[a], 0xFF, size);
+    }
+    fs->status &= ~SPI_SR_WEL;
+}
+
+static void
+urj_jim_spi_flash_update (urj_jim_bus_device_t *d,
+                          uint32_t address, uint32_t data,
+                          uint32_t control, uint8_t *shmem,
+                          size_t shmem_size)
+{
+    spi_flash_state_t *fs = d->state;
+    int sck = SPI_SCK (data);
+
+    if (!fs->selected && !SPI_NCS (control))
+    {
+        fs->selected = 1;
+        fs->bits = 0;
+        fs->cmd = 0;
+    }
+    else if (fs->selected && SPI_NCS (control))
+    {
+        fs->selected = 0;
+        urj_jim_spi_flash_end (fs);
+    }
+
+    if (fs->selected && sck != fs->sck)
+    {
+        if (sck)
+        {
+            /* rising edge: sample MOSI */
+            fs->in = (fs->in << 1) | SPI_MOSI (data);
+            if (++fs->bits % 8 == 0)
+                urj_jim_spi_flash_input (fs, fs->bits / 8 - 1, fs->in);
+        }
+        else
+        {
+            /* falling edge: next bit on MISO */
+            if (fs->bits % 8 == 0)
+                fs->out = urj_jim_spi_flash_output (fs, fs->bits / 8);
+            fs->miso = (fs->out >> (7 - fs->bits % 8)) & 1;
+        }
+    }
+
+    fs->sck = sck;
+}
+
+urj_jim_bus_device_t urj_jim_spi_flash = {
+    1,                          /* width [bytes] */
+    0,                          /* size [bytes], set by the user */
+    NULL,                       /* state */
+    urj_jim_spi_flash_init,     /* init() */
+    urj_jim_spi_flash_capture,  /* access() */
+    urj_jim_spi_flash_update,   /* access() */
+    urj_jim_spi_flash_free      /* free() */
+};
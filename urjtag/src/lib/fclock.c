@@ -80,7 +80,12 @@ urj_lib_frealtime (void)
     long double result;
 
     struct timespec t;
+#ifdef CLOCK_MONOTONIC
+    /* deadlines must not move with the wall clock */
+    if (clock_gettime (CLOCK_MONOTONIC, &t) == -1)
+#else
     if (clock_gettime (CLOCK_REALTIME, &t) == -1)
+#endif
     {
         perror ("urj_lib_frealtime (clock_gettime)");
         exit (EXIT_FAILURE);
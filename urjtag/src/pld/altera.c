@@ -0,0 +1,182 @@
+/*
+ * $Id$
+ *
+ * Driver for Altera/Intel FPGAs
+ *
+ * Copyright (C) 2026 UrJTAG contributors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA
+ * 02111-1307, USA.
+ *
+ * The FPGAs (Cyclone, Stratix, Arria, MAX 10) take a raw binary file
+ * (.rbf) through the PROGRAM instruction, every byte LSB first, as in the
+ * SVF files of Quartus. A .sof is converted with
+ * "quartus_cpf -c design.sof design.rbf".
+ */
+
+#include <sysdep.h>
+
+#include <string.h>
+
+#include <urjtag/tap.h>
+#include <urjtag/part.h>
+#include <urjtag/chain.h>
+#include <urjtag/tap_register.h>
+#include <urjtag/data_register.h>
+#include <urjtag/part_instruction.h>
+#include <urjtag/pld.h>
+#include "altera.h"
+#include "stream.h"
+
+static int
+altera_define_instructions (urj_part_t *part)
+{
+    if (urj_pld_instruction_define (part, "PULSE_NCONFIG",
+                                    ALTERA_PULSE_NCONFIG, "BYPASS", 1)
+            != URJ_STATUS_OK
+        || urj_pld_instruction_define (part, "PROGRAM", ALTERA_PROGRAM,
+                                       "BYPASS", 1) != URJ_STATUS_OK
+        || urj_pld_instruction_define (part, "STARTUP", ALTERA_STARTUP,
+                                       "BYPASS", 1) != URJ_STATUS_OK
+        || urj_pld_instruction_define (part, "USERCODE", ALTERA_USERCODE,
+                                       "USERCODE", 32) != URJ_STATUS_OK)
+        return URJ_STATUS_FAIL;
+
+    return URJ_STATUS_OK;
+}
+
+static int
+altera_print_status (urj_pld_t *pld)
+{
+    urj_part_t *part = pld->part;
+    uint32_t idcode, usercode;
+
+    if (altera_define_instructions (part) != URJ_STATUS_OK)
+        return URJ_STATUS_FAIL;
+
+    urj_tap_reset_bypass (pld->chain);
+
+    if (urj_pld_set_ir_and_shift (pld, "USERCODE") != URJ_STATUS_OK)
+        return URJ_STATUS_FAIL;
+    urj_tap_chain_shift_data_registers (pld->chain, 1);
+    usercode = urj_tap_register_get_value (
+                        part->active_instruction->data_register->out);
+
+    idcode = urj_tap_register_get_value (part->id);
+
+    urj_log (URJ_LOG_LEVEL_NORMAL, _("Device ID 0x%08x\n"), idcode);
+    urj_log (URJ_LOG_LEVEL_NORMAL, _("Usercode  0x%08x\n"), usercode);
+
+    return URJ_STATUS_OK;
+}
+
+static int
+altera_configure (urj_pld_t *pld, FILE *rbf_file)
+{
+    uint8_t head[URJ_PLD_STREAM_CHUNK];
+    urj_pld_stream_t s;
+    size_t n;
+
+    n = fread (head, 1, sizeof head, rbf_file);
+    if (n == 0)
+    {
+        urj_error_set (URJ_ERROR_PLD, _("Invalid bitfile"));
+        return URJ_STATUS_FAIL;
+    }
+    if (n >= 3 && (memcmp (head, "SOF", 3) == 0
+                   || memcmp (head, "POF", 3) == 0))
+    {
+        urj_error_set (URJ_ERROR_PLD,
+                       _("SRAM Object Files are not supported, convert with "
+                         "'quartus_cpf -c FILE.sof FILE.rbf'"));
+        return URJ_STATUS_FAIL;
+    }
+
+    if (altera_define_instructions (pld->part) != URJ_STATUS_OK)
+        return URJ_STATUS_FAIL;
+
+    /* set all devices in bypass mode */
+    urj_tap_reset_bypass (pld->chain);
+
+    if (urj_pld_set_ir_and_shift (pld, "PROGRAM") != URJ_STATUS_OK)
+        return URJ_STATUS_FAIL;
+    urj_pld_run_test (pld, ALTERA_PROGRAM_CLOCKS, 0);
+
+    if (urj_pld_stream_open (&s, pld, 0) != URJ_STATUS_OK)
+        return URJ_STATUS_FAIL;
+    urj_pld_stream_write (&s, head, n);
+    if (urj_pld_stream_file (&s, rbf_file) != URJ_STATUS_OK)
+    {
+        urj_pld_stream_close (&s);
+        return URJ_STATUS_FAIL;
+    }
+    if (urj_pld_stream_close (&s) != URJ_STATUS_OK)
+        return URJ_STATUS_FAIL;
+
+    urj_log (URJ_LOG_LEVEL_NORMAL, _("Bitstream length: %ld\n"), s.bytes);
+
+    if (urj_pld_set_ir_and_shift (pld, "STARTUP") != URJ_STATUS_OK)
+        return URJ_STATUS_FAIL;
+    urj_pld_run_test (pld, ALTERA_STARTUP_CLOCKS, 0);
+
+    if (urj_pld_set_ir_and_shift (pld, "BYPASS") != URJ_STATUS_OK)
+        return URJ_STATUS_FAIL;
+    urj_pld_run_test (pld, ALTERA_BYPASS_CLOCKS, 0);
+
+    urj_tap_chain_flush (pld->chain);
+
+    return URJ_STATUS_OK;
+}
+
+static int
+altera_reconfigure (urj_pld_t *pld)
+{
+    if (altera_define_instructions (pld->part) != URJ_STATUS_OK)
+        return URJ_STATUS_FAIL;
+
+    urj_tap_reset_bypass (pld->chain);
+
+    if (urj_pld_set_ir_and_shift (pld, "PULSE_NCONFIG") != URJ_STATUS_OK)
+        return URJ_STATUS_FAIL;
+
+    urj_tap_reset (pld->chain);
+    urj_tap_chain_flush (pld->chain);
+
+    return URJ_STATUS_OK;
+}
+
+static int
+altera_detect (urj_pld_t *pld)
+{
+    urj_part_t *part = pld->part;
+    uint32_t idcode;
+
+    idcode = urj_tap_register_get_value (part->id);
+
+    if ((idcode & 0xfff) != ALTERA_MANUFACTURER
+        || part->instruction_length != ALTERA_IR_LEN
+        || ALTERA_MAXII (idcode) || ALTERA_MAX7000 (idcode))
+        return URJ_STATUS_FAIL;
+
+    return URJ_STATUS_OK;
+}
+
+const urj_pld_driver_t urj_pld_altera_driver = {
+    .name = N_("Altera/Intel FPGA"),
+    .detect = altera_detect,
+    .print_status = altera_print_status,
+    .configure = altera_configure,
+    .reconfigure = altera_reconfigure,
+};
@@ -0,0 +1,49 @@
+/*
+ * $Id$
+ *
+ * Copyright (C) 2026 UrJTAG contributors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA
+ * 02111-1307, USA.
+ *
+ */
+
+#ifndef URJ_PLD_ALTERA_H
+#define URJ_PLD_ALTERA_H
+
+#include <urjtag/pld.h>
+
+/* bits 11-0 of the IDCODE: manufacturer 0x06e and the mandatory 1 */
+#define ALTERA_MANUFACTURER     0x0dd
+
+#define ALTERA_IR_LEN           10
+
+/* bits 27-12 of the IDCODE, for the CPLDs which configure through ISC */
+#define ALTERA_MAXII(id)        ((((id) >> 12) & 0xfff0) == 0x20a0)
+#define ALTERA_MAX7000(id)      ((((id) >> 12) & 0xf000) == 0x7000)
+
+#define ALTERA_PULSE_NCONFIG    "0000000001"
+#define ALTERA_PROGRAM          "0000000010"
+#define ALTERA_STARTUP          "0000000011"
+#define ALTERA_USERCODE         "0000000111"
+
+/* Run-Test/Idle clocks of the Quartus SVF files */
+#define ALTERA_PROGRAM_CLOCKS   12000
+#define ALTERA_STARTUP_CLOCKS   4096
+#define ALTERA_BYPASS_CLOCKS    350
+
+extern const urj_pld_driver_t urj_pld_altera_driver;
+
+#endif /* URJ_PLD_ALTERA_H */
@@ -0,0 +1,306 @@
+/*
+ * $Id$
+ *
+ * Driver for Lattice ECP5 FPGAs
+ *
+ * Copyright (C) 2026 UrJTAG contributors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA
+ * 02111-1307, USA.
+ *
+ * The SRAM is erased in ISC mode and the .bit file of Diamond or ecppack
+ * goes through LSC_BITSTREAM_BURST as one DR scan, every byte MSB first
+ * [1]. The comment header of the file, "\xff\x00" and NUL terminated
+ * strings up to the first 0xff, is not sent.
+ */
+
+#include <sysdep.h>
+
+#include <string.h>
+
+#include <urjtag/tap.h>
+#include <urjtag/part.h>
+#include <urjtag/chain.h>
+#include <urjtag/bitmask.h>
+#include <urjtag/tap_register.h>
+#include <urjtag/data_register.h>
+#include <urjtag/part_instruction.h>
+#include <urjtag/pld.h>
+#include "lattice.h"
+#include "stream.h"
+
+static int
+ecp5_define_instructions (urj_part_t *part)
+{
+    if (urj_pld_instruction_define (part, "ISC_ENABLE", ECP5_ISC_ENABLE,
+                                    "ISC_CONFIG", 8) != URJ_STATUS_OK
+        || urj_pld_instruction_define (part, "ISC_DISABLE", ECP5_ISC_DISABLE,
+                                       "ISC_DEFAULT", 1) != URJ_STATUS_OK
+        || urj_pld_instruction_define (part, "ISC_ERASE", ECP5_ISC_ERASE,
+                                       "ISC_SECTOR", 8) != URJ_STATUS_OK
+        || urj_pld_instruction_define (part, "LSC_READ_STATUS",
+                                       ECP5_LSC_READ_STATUS,
+                                       "LSC_STATUS", 32) != URJ_STATUS_OK
+        || urj_pld_instruction_define (part, "LSC_INIT_ADDRESS",
+                                       ECP5_LSC_INIT_ADDRESS,
+                                       "ISC_CONFIG", 8) != URJ_STATUS_OK
+        || urj_pld_instruction_define (part, "LSC_BITSTREAM_BURST",
+                                       ECP5_LSC_BITSTREAM_BURST,
+                                       "ISC_DEFAULT", 1) != URJ_STATUS_OK
+        || urj_pld_instruction_define (part, "LSC_REFRESH", ECP5_LSC_REFRESH,
+                                       "ISC_DEFAULT", 1) != URJ_STATUS_OK
+        || urj_pld_instruction_define (part, "USERCODE", ECP5_USERCODE,
+                                       "USERCODE", 32) != URJ_STATUS_OK)
+        return URJ_STATUS_FAIL;
+
+    return URJ_STATUS_OK;
+}
+
+/* load instruction iname, shift value through its data register if
+   value >= 0, and wait */
+static int
+ecp5_command (urj_pld_t *pld, const char *iname, int value, long usecs)
+{
+    urj_tap_register_t *r;
+
+    if (urj_pld_set_ir_and_shift (pld, iname) != URJ_STATUS_OK)
+        return URJ_STATUS_FAIL;
+
+    if (value >= 0)
+    {
+        r = pld->part->active_instruction->data_register->in;
+        urj_tap_register_set_value (r, value);
+        urj_tap_chain_shift_data_registers (pld->chain, 0);
+    }
+
+    urj_pld_run_test (pld, 2, usecs);
+
+    return URJ_STATUS_OK;
+}
+
+static int
+ecp5_read_status (urj_pld_t *pld, uint32_t *status)
+{
+    urj_data_register_t *r;
+
+    if (urj_pld_set_ir_and_shift (pld, "LSC_READ_STATUS") != URJ_STATUS_OK)
+        return URJ_STATUS_FAIL;
+
+    r = pld->part->active_instruction->data_register;
+    urj_tap_register_set_value (r->in, 0);
+    urj_tap_chain_shift_data_registers (pld->chain, 1);
+    *status = urj_tap_register_get_value (r->out);
+
+    return URJ_STATUS_OK;
+}
+
+/* the BSE_ERROR codes of the status register */
+static const char *
+ecp5_bse_error (uint32_t status)
+{
+    static const char *const names[] = {
+        N_("no bitstream error"),
+        N_("ID error"),
+        N_("invalid command"),
+        N_("CRC error"),
+        N_("preamble error"),
+        N_("configuration aborted"),
+        N_("data overflow"),
+        N_("bitstream ended early"),
+    };
+
+    return _(names[ECP5_STATUS_BSE_ERROR (status)]);
+}
+
+static int
+ecp5_print_status (urj_pld_t *pld)
+{
+    uint32_t status;
+
+    if (ecp5_define_instructions (pld->part) != URJ_STATUS_OK)
+        return URJ_STATUS_FAIL;
+
+    urj_tap_reset_bypass (pld->chain);
+
+    if (ecp5_read_status (pld, &status) != URJ_STATUS_OK)
+        return URJ_STATUS_FAIL;
+
+    urj_log (URJ_LOG_LEVEL_NORMAL, _("Status register (0x%08x)\n"), status);
+    urj_log (URJ_LOG_LEVEL_NORMAL, _("\tINVALID_CMD  %d\n"),
+        (status & ECP5_STATUS_INVALID_CMD) ? 1 : 0);
+    urj_log (URJ_LOG_LEVEL_NORMAL, _("\tID_ERROR     %d\n"),
+        (status & ECP5_STATUS_ID_ERROR) ? 1 : 0);
+    urj_log (URJ_LOG_LEVEL_NORMAL, _("\tEXEC_ERROR   %d\n"),
+        (status & ECP5_STATUS_EXEC_ERROR) ? 1 : 0);
+    urj_log (URJ_LOG_LEVEL_NORMAL, _("\tBSE_ERROR    %d (%s)\n"),
+        ECP5_STATUS_BSE_ERROR (status), ecp5_bse_error (status));
+    urj_log (URJ_LOG_LEVEL_NORMAL, _("\tSTD_PREAMBLE %d\n"),
+        (status & ECP5_STATUS_STD_PREAMBLE) ? 1 : 0);
+    urj_log (URJ_LOG_LEVEL_NORMAL, _("\tFAIL         %d\n"),
+        (status & ECP5_STATUS_FAIL) ? 1 : 0);
+    urj_log (URJ_LOG_LEVEL_NORMAL, _("\tBUSY         %d\n"),
+        (status & ECP5_STATUS_BUSY) ? 1 : 0);
+    urj_log (URJ_LOG_LEVEL_NORMAL, _("\tREAD_ENABLE  %d\n"),
+        (status & ECP5_STATUS_READ_ENABLE) ? 1 : 0);
+    urj_log (URJ_LOG_LEVEL_NORMAL, _("\tWRITE_ENABLE %d\n"),
+        (status & ECP5_STATUS_WRITE_ENABLE) ? 1 : 0);
+    urj_log (URJ_LOG_LEVEL_NORMAL, _("\tISC_ENABLE   %d\n"),
+        (status & ECP5_STATUS_ISC_ENABLE) ? 1 : 0);
+    urj_log (URJ_LOG_LEVEL_NORMAL, _("\tDONE         %d\n"),
+        (status & ECP5_STATUS_DONE) ? 1 : 0);
+
+    return URJ_STATUS_OK;
+}
+
+/* offset of the configuration data in the first n bytes of a .bit file,
+   -1 if there is no preamble */
+static int
+ecp5_bit_header (const uint8_t *head, size_t n)
+{
+    size_t i = 0, start, j;
+
+    if (n >= 2 && head[0] == 0xff && head[1] == 0x00)
+    {
+        urj_log (URJ_LOG_LEVEL_NORMAL, _("Bitstream information:\n"));
+        for (i = start = 2; i < n && head[i] != 0xff; i++)
+        {
+            if (head[i] != '\0')
+                continue;
+            if (i > start)
+                urj_log (URJ_LOG_LEVEL_NORMAL, "\t%s\n",
+                         (const char *) head + start);
+            start = i + 1;
+        }
+    }
+
+    for (j = i; j < n && head[j] == 0xff; j++)
+        ;
+    if (j == i || j + 1 >= n || head[j] != ECP5_PREAMBLE_0
+        || head[j + 1] != ECP5_PREAMBLE_1)
+        return -1;
+
+    return i;
+}
+
+static int
+ecp5_configure (urj_pld_t *pld, FILE *bit_file)
+{
+    uint8_t head[URJ_PLD_STREAM_CHUNK];
+    urj_pld_stream_t s;
+    uint32_t status;
+    size_t n;
+    int offset;
+
+    n = fread (head, 1, sizeof head, bit_file);
+    offset = ecp5_bit_header (head, n);
+    if (offset < 0)
+    {
+        urj_error_set (URJ_ERROR_PLD, _("Invalid bitfile"));
+        return URJ_STATUS_FAIL;
+    }
+
+    if (ecp5_define_instructions (pld->part) != URJ_STATUS_OK)
+        return URJ_STATUS_FAIL;
+
+    /* set all devices in bypass mode */
+    urj_tap_reset_bypass (pld->chain);
+
+    if (ecp5_command (pld, "ISC_ENABLE", 0x00, ECP5_CONFIG_DELAY)
+            != URJ_STATUS_OK
+        || ecp5_command (pld, "ISC_ERASE", 0x01, ECP5_CONFIG_DELAY)
+            != URJ_STATUS_OK
+        || ecp5_command (pld, "LSC_INIT_ADDRESS", 0x01, ECP5_CONFIG_DELAY)
+            != URJ_STATUS_OK
+        || ecp5_command (pld, "LSC_BITSTREAM_BURST", -1, ECP5_CONFIG_DELAY)
+            != URJ_STATUS_OK)
+        return URJ_STATUS_FAIL;
+
+    if (urj_pld_stream_open (&s, pld, 1) != URJ_STATUS_OK)
+        return URJ_STATUS_FAIL;
+    urj_pld_stream_write (&s, head + offset, n - offset);
+    if (urj_pld_stream_file (&s, bit_file) != URJ_STATUS_OK)
+    {
+        urj_pld_stream_close (&s);
+        return URJ_STATUS_FAIL;
+    }
+    if (urj_pld_stream_close (&s) != URJ_STATUS_OK)
+        return URJ_STATUS_FAIL;
+
+    urj_log (URJ_LOG_LEVEL_NORMAL, _("Bitstream length: %ld\n"), s.bytes);
+
+    if (ecp5_command (pld, "ISC_DISABLE", -1, ECP5_DISABLE_DELAY)
+            != URJ_STATUS_OK
+        || ecp5_command (pld, "BYPASS", -1, ECP5_CONFIG_DELAY)
+            != URJ_STATUS_OK)
+        return URJ_STATUS_FAIL;
+
+    if (ecp5_read_status (pld, &status) != URJ_STATUS_OK)
+        return URJ_STATUS_FAIL;
+
+    urj_tap_reset_bypass (pld->chain);
+    urj_tap_chain_flush (pld->chain);
+
+    if (!(status & ECP5_STATUS_DONE) || (status & ECP5_STATUS_FAIL))
+    {
+        urj_error_set (URJ_ERROR_PLD,
+                       _("Configuration failed, status register 0x%08x (%s)"),
+                       status, ecp5_bse_error (status));
+        return URJ_STATUS_FAIL;
+    }
+
+    return URJ_STATUS_OK;
+}
+
+static int
+ecp5_reconfigure (urj_pld_t *pld)
+{
+    if (ecp5_define_instructions (pld->part) != URJ_STATUS_OK)
+        return URJ_STATUS_FAIL;
+
+    urj_tap_reset_bypass (pld->chain);
+
+    if (ecp5_command (pld, "LSC_REFRESH", -1, ECP5_CONFIG_DELAY)
+            != URJ_STATUS_OK)
+        return URJ_STATUS_FAIL;
+
+    urj_tap_reset (pld->chain);
+    urj_tap_chain_flush (pld->chain);
+
+    return URJ_STATUS_OK;
+}
+
+static int
+ecp5_detect (urj_pld_t *pld)
+{
+    urj_part_t *part = pld->part;
+    uint32_t idcode;
+
+    idcode = urj_tap_register_get_value (part->id);
+
+    if ((idcode & 0xfff) != LATTICE_MANUFACTURER
+        || part->instruction_length != ECP5_IR_LEN
+        || !ECP5_FAMILY (idcode))
+        return URJ_STATUS_FAIL;
+
+    return URJ_STATUS_OK;
+}
+
+const urj_pld_driver_t urj_pld_ecp5_driver = {
+    .name = N_("Lattice ECP5 Family"),
+    .detect = ecp5_detect,
+    .print_status = ecp5_print_status,
+    .configure = ecp5_configure,
+    .reconfigure = ecp5_reconfigure,
+};
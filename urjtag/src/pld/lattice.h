@@ -0,0 +1,73 @@
+/*
+ * $Id$
+ *
+ * Copyright (C) 2026 UrJTAG contributors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA
+ * 02111-1307, USA.
+ *
+ * Documentation:
+ * [1] Lattice Semiconductor, "ECP5 and ECP5-5G sysCONFIG Usage Guide",
+ *     FPGA-TN-02039, 2018
+ *
+ */
+
+#ifndef URJ_PLD_LATTICE_H
+#define URJ_PLD_LATTICE_H
+
+#include <urjtag/pld.h>
+
+/* bits 11-0 of the IDCODE: manufacturer 0x021 and the mandatory 1 */
+#define LATTICE_MANUFACTURER    0x043
+
+#define ECP5_IR_LEN             8
+
+/* bits 27-12 of the IDCODE: LFE5U(M)-25, -45 and -85; the -12 is a -25 */
+#define ECP5_FAMILY(id)         ((((id) >> 12) & 0xfffc) == 0x1110 \
+                                 && (((id) >> 12) & 0x3) != 0)
+
+#define ECP5_ISC_ENABLE         "11000110"
+#define ECP5_ISC_DISABLE        "00100110"
+#define ECP5_ISC_ERASE          "00001110"
+#define ECP5_LSC_READ_STATUS    "00111100"
+#define ECP5_LSC_INIT_ADDRESS   "01000110"
+#define ECP5_LSC_BITSTREAM_BURST "01111010"
+#define ECP5_LSC_REFRESH        "01111001"
+#define ECP5_USERCODE           "11000000"
+
+/* delays of the Diamond SVF files, in microseconds */
+#define ECP5_CONFIG_DELAY       10000
+#define ECP5_DISABLE_DELAY      200000
+
+/* status register, see [1] */
+#define ECP5_STATUS_INVALID_CMD     URJ_BIT(28)
+#define ECP5_STATUS_ID_ERROR        URJ_BIT(27)
+#define ECP5_STATUS_EXEC_ERROR      URJ_BIT(26)
+#define ECP5_STATUS_BSE_ERROR(s)    (((s) >> 23) & 0x7)
+#define ECP5_STATUS_STD_PREAMBLE    URJ_BIT(21)
+#define ECP5_STATUS_FAIL            URJ_BIT(13)
+#define ECP5_STATUS_BUSY            URJ_BIT(12)
+#define ECP5_STATUS_READ_ENABLE     URJ_BIT(11)
+#define ECP5_STATUS_WRITE_ENABLE    URJ_BIT(10)
+#define ECP5_STATUS_ISC_ENABLE      URJ_BIT(9)
+#define ECP5_STATUS_DONE            URJ_BIT(8)
+
+/* bitstream preamble */
+#define ECP5_PREAMBLE_0         0xbd
+#define ECP5_PREAMBLE_1         0xb3
+
+extern const urj_pld_driver_t urj_pld_ecp5_driver;
+
+#endif /* URJ_PLD_LATTICE_H */
@@ -37,34 +37,32 @@
 #include <urjtag/part.h>
 #include <urjtag/tap_register.h>
 #include "xilinx.h"
+#include "altera.h"
+#include "lattice.h"
 
 const urj_pld_driver_t * const urj_pld_drivers[] = {
     &urj_pld_xc3s_driver,
     &urj_pld_xc6s_driver,
     &urj_pld_xc4v_driver,
+    &urj_pld_altera_driver,
+    &urj_pld_ecp5_driver,
     NULL
 };
 
-static const urj_pld_driver_t *pld_driver = NULL;
-static urj_pld_t pld;
-
-static int
-set_pld_driver (urj_chain_t *chain, urj_part_t *part)
+static const urj_pld_driver_t *
+find_pld_driver (urj_pld_t *pld, urj_chain_t *chain, urj_part_t *part)
 {
     int i;
     uint32_t idcode;
 
-    pld_driver = NULL;
-    pld.chain = chain;
-    pld.part = part;
+    pld->chain = chain;
+    pld->part = part;
+    pld->priv = NULL;
 
     for (i = 0; urj_pld_drivers[i] != NULL; i++)
     {
-        if (urj_pld_drivers[i]->detect (&pld) == URJ_STATUS_OK)
-        {
-            pld_driver = urj_pld_drivers[i];
-            return URJ_STATUS_OK;
-        }
+        if (urj_pld_drivers[i]->detect (pld) == URJ_STATUS_OK)
+            return urj_pld_drivers[i];
     }
 
     idcode = urj_tap_register_get_value (part->id);
@@ -74,20 +72,23 @@ set_pld_driver (urj_chain_t *chain, urj_part_t *part)
 
     urj_error_set (URJ_ERROR_UNSUPPORTED, _("PLD not supported"));
 
-    return URJ_STATUS_FAIL;
+    return NULL;
 }
 
 int
 urj_pld_configure (urj_chain_t *chain, FILE *pld_file)
 {
     urj_part_t *part;
+    urj_pld_t pld;
+    const urj_pld_driver_t *pld_driver;
 
     part = urj_tap_chain_active_part (chain);
 
     if (part == NULL)
         return URJ_STATUS_FAIL;
 
-    if (set_pld_driver (chain, part) != URJ_STATUS_OK)
+    pld_driver = find_pld_driver (&pld, chain, part);
+    if (pld_driver == NULL)
         return URJ_STATUS_FAIL;
 
     if (pld_driver->configure == NULL)
@@ -104,13 +105,16 @@ int
 urj_pld_reconfigure (urj_chain_t *chain)
 {
     urj_part_t *part;
+    urj_pld_t pld;
+    const urj_pld_driver_t *pld_driver;
 
     part = urj_tap_chain_active_part (chain);
 
     if (part == NULL)
         return URJ_STATUS_FAIL;
 
-    if (set_pld_driver (chain, part) != URJ_STATUS_OK)
+    pld_driver = find_pld_driver (&pld, chain, part);
+    if (pld_driver == NULL)
         return URJ_STATUS_FAIL;
 
     if (pld_driver->reconfigure == NULL)
@@ -127,13 +131,16 @@ int
 urj_pld_print_status (urj_chain_t *chain)
 {
     urj_part_t *part;
+    urj_pld_t pld;
+    const urj_pld_driver_t *pld_driver;
 
     part = urj_tap_chain_active_part (chain);
 
     if (part == NULL)
         return URJ_STATUS_FAIL;
 
-    if (set_pld_driver (chain, part) != URJ_STATUS_OK)
+    pld_driver = find_pld_driver (&pld, chain, part);
+    if (pld_driver == NULL)
         return URJ_STATUS_FAIL;
 
     if (pld_driver->print_status == NULL)
@@ -150,6 +157,8 @@ int
 urj_pld_read_register (urj_chain_t *chain, uint32_t reg)
 {
     urj_part_t *part;
+    urj_pld_t pld;
+    const urj_pld_driver_t *pld_driver;
     uint32_t value;
 
     part = urj_tap_chain_active_part (chain);
@@ -157,7 +166,8 @@ urj_pld_read_register (urj_chain_t *chain, uint32_t reg)
     if (part == NULL)
         return URJ_STATUS_FAIL;
 
-    if (set_pld_driver (chain, part) != URJ_STATUS_OK)
+    pld_driver = find_pld_driver (&pld, chain, part);
+    if (pld_driver == NULL)
         return URJ_STATUS_FAIL;
 
     if (pld_driver->read_register == NULL)
@@ -180,13 +190,16 @@ int
 urj_pld_write_register (urj_chain_t *chain, uint32_t reg, uint32_t data)
 {
     urj_part_t *part;
+    urj_pld_t pld;
+    const urj_pld_driver_t *pld_driver;
 
     part = urj_tap_chain_active_part (chain);
 
     if (part == NULL)
         return URJ_STATUS_FAIL;
 
-    if (set_pld_driver (chain, part) != URJ_STATUS_OK)
+    pld_driver = find_pld_driver (&pld, chain, part);
+    if (pld_driver == NULL)
         return URJ_STATUS_FAIL;
 
     if (pld_driver->write_register == NULL)
@@ -0,0 +1,213 @@
+/*
+ * $Id$
+ *
+ * Copyright (C) 2026 UrJTAG contributors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA
+ * 02111-1307, USA.
+ *
+ * Streaming of configuration data into a PLD. A bitstream is one long DR
+ * scan; instead of loading all of it into a data register of the part
+ * first, it is handed to the cable in fixed chunks as it is read from the
+ * file. Only the last bit, which goes with TMS = 1, and the BYPASS bits of
+ * the parts between the PLD and TDI are kept back until the end.
+ */
+
+#include <sysdep.h>
+
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <urjtag/error.h>
+#include <urjtag/log.h>
+#include <urjtag/tap.h>
+#include <urjtag/part.h>
+#include <urjtag/chain.h>
+#include <urjtag/tap_register.h>
+#include <urjtag/data_register.h>
+#include <urjtag/part_instruction.h>
+#include "stream.h"
+
+int
+urj_pld_instruction_define (urj_part_t *part, const char *iname,
+                            const char *code, const char *dr_name,
+                            int dr_len)
+{
+    if (urj_part_find_instruction (part, iname) != NULL)
+        return URJ_STATUS_OK;
+
+    if (urj_part_find_data_register (part, dr_name) == NULL
+        && urj_part_data_register_define (part, dr_name, dr_len)
+            != URJ_STATUS_OK)
+        return URJ_STATUS_FAIL;
+
+    if (urj_part_instruction_define (part, iname, code, dr_name) == NULL)
+        return URJ_STATUS_FAIL;
+
+    return URJ_STATUS_OK;
+}
+
+int
+urj_pld_set_ir_and_shift (urj_pld_t *pld, const char *iname)
+{
+    urj_part_set_instruction (pld->part, iname);
+    if (pld->part->active_instruction == NULL)
+    {
+        urj_error_set (URJ_ERROR_PLD, "unknown instruction '%s'", iname);
+        return URJ_STATUS_FAIL;
+    }
+
+    return urj_tap_chain_shift_instructions (pld->chain);
+}
+
+void
+urj_pld_run_test (urj_pld_t *pld, int n, long usecs)
+{
+    urj_tap_chain_defer_clock (pld->chain, 0, 0, n);
+    if (usecs > 0)
+    {
+        urj_tap_chain_flush (pld->chain);
+        usleep (usecs);
+    }
+}
+
+int
+urj_pld_stream_open (urj_pld_stream_t *s, urj_pld_t *pld, int msb_first)
+{
+    urj_parts_t *ps = pld->chain->parts;
+    int i;
+
+    s->chain = pld->chain;
+    s->msb_first = msb_first;
+    s->bits = 0;
+    s->queued = 0;
+    s->bytes = 0;
+
+    /* part 0 is next to TDO */
+    s->pad = 0;
+    for (i = 0; i < ps->len; i++)
+        if (ps->parts[i] == pld->part)
+            s->pad = ps->len - 1 - i;
+
+    s->chunk = urj_tap_register_alloc (URJ_PLD_STREAM_CHUNK * 8);
+    if (s->chunk == NULL)
+        return URJ_STATUS_FAIL;
+
+    urj_tap_capture_dr (s->chain);
+
+    return URJ_STATUS_OK;
+}
+
+/* hand a full chunk to the cable, in Shift-DR */
+static void
+stream_chunk (urj_pld_stream_t *s)
+{
+    urj_tap_defer_shift_register (s->chain, s->chunk, NULL,
+                                  URJ_CHAIN_EXITMODE_SHIFT);
+    s->bits = 0;
+
+    /* keep the cable queue bounded for large bitstreams */
+    if (++s->queued == URJ_PLD_STREAM_FLUSH)
+    {
+        urj_tap_chain_flush (s->chain);
+        s->queued = 0;
+    }
+}
+
+int
+urj_pld_stream_write (urj_pld_stream_t *s, const uint8_t *data, size_t len)
+{
+    char *bit;
+    size_t u;
+    int b;
+
+    for (u = 0; u < len; u++)
+    {
+        /* the last bits of the stream must stay for close */
+        if (s->bits == s->chunk->len)
+            stream_chunk (s);
+
+        bit = s->chunk->data + s->bits;
+        if (s->msb_first)
+            for (b = 7; b >= 0; b--)
+                *bit++ = (data[u] >> b) & 1;
+        else
+            for (b = 0; b < 8; b++)
+                *bit++ = (data[u] >> b) & 1;
+        s->bits += 8;
+    }
+    s->bytes += len;
+
+    return URJ_STATUS_OK;
+}
+
+int
+urj_pld_stream_file (urj_pld_stream_t *s, FILE *f)
+{
+    uint8_t buf[URJ_PLD_STREAM_CHUNK];
+    size_t n;
+
+    while ((n = fread (buf, 1, sizeof buf, f)) > 0)
+        urj_pld_stream_write (s, buf, n);
+
+    if (ferror (f))
+    {
+        urj_error_IO_set (_("Cannot read bitstream"));
+        return URJ_STATUS_FAIL;
+    }
+
+    return URJ_STATUS_OK;
+}
+
+int
+urj_pld_stream_close (urj_pld_stream_t *s)
+{
+    urj_tap_register_t *tail;
+    int i, status = URJ_STATUS_OK;
+
+    /* push the data through the BYPASS registers towards TDO */
+    for (i = 0; i < s->pad; i++)
+    {
+        if (s->bits == s->chunk->len)
+            stream_chunk (s);
+        s->chunk->data[s->bits++] = 0;
+    }
+
+    if (s->bits == 0)
+    {
+        /* nothing to shift: Exit1-DR, Update-DR, Run-Test/Idle */
+        urj_tap_chain_defer_clock (s->chain, 1, 0, 2);
+        urj_tap_chain_defer_clock (s->chain, 0, 0, 1);
+    }
+    else if ((tail = urj_tap_register_alloc (s->bits)) != NULL)
+    {
+        memcpy (tail->data, s->chunk->data, s->bits);
+        urj_tap_defer_shift_register (s->chain, tail, NULL,
+                                      URJ_CHAIN_EXITMODE_IDLE);
+        urj_tap_register_free (tail);
+    }
+    else
+        status = URJ_STATUS_FAIL;
+
+    urj_tap_chain_flush (s->chain);
+
+    urj_log (URJ_LOG_LEVEL_DETAIL, "%s: %ld bytes\n", __func__, s->bytes);
+
+    urj_tap_register_free (s->chunk);
+    s->chunk = NULL;
+
+    return status;
+}
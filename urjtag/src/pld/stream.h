@@ -0,0 +1,78 @@
+/*
+ * $Id$
+ *
+ * Copyright (C) 2026 UrJTAG contributors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA
+ * 02111-1307, USA.
+ *
+ */
+
+#ifndef URJ_PLD_STREAM_H
+#define URJ_PLD_STREAM_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include <urjtag/types.h>
+#include <urjtag/pld.h>
+
+/** bytes of configuration data per deferred cable transfer */
+#define URJ_PLD_STREAM_CHUNK    4096
+/** chunks queued at the cable before the queue is flushed */
+#define URJ_PLD_STREAM_FLUSH    16
+
+typedef struct
+{
+    urj_chain_t *chain;
+    int msb_first;
+    /** BYPASS registers between the part and TDI */
+    int pad;
+    urj_tap_register_t *chunk;
+    /** bits held in chunk */
+    int bits;
+    int queued;
+    long bytes;
+}
+urj_pld_stream_t;
+
+/**
+ * Define instruction iname with the given code on the part unless it is
+ * already known, e.g. from the data files. Its data register dr_name is
+ * created with dr_len bits if it does not exist yet.
+ */
+int urj_pld_instruction_define (urj_part_t *part, const char *iname,
+                                const char *code, const char *dr_name,
+                                int dr_len);
+/** Load instruction iname into the part, all other parts keep theirs */
+int urj_pld_set_ir_and_shift (urj_pld_t *pld, const char *iname);
+/** Clock usecs microseconds worth of at least n TCKs in Run-Test/Idle */
+void urj_pld_run_test (urj_pld_t *pld, int n, long usecs);
+
+/**
+ * Start a DR scan into the current instruction of pld->part. The data
+ * goes to the cable in chunks, every byte LSB or MSB first; the last bit
+ * is held back for Exit1-DR until urj_pld_stream_close().
+ */
+int urj_pld_stream_open (urj_pld_stream_t *s, urj_pld_t *pld, int msb_first);
+int urj_pld_stream_write (urj_pld_stream_t *s, const uint8_t *data,
+                          size_t len);
+/** Stream the rest of file f */
+int urj_pld_stream_file (urj_pld_stream_t *s, FILE *f);
+/** End the DR scan in Run-Test/Idle and flush the cable */
+int urj_pld_stream_close (urj_pld_stream_t *s);
+
+#endif /* URJ_PLD_STREAM_H */
@@ -693,6 +693,8 @@ xlx_detect_xc3s (urj_pld_t *pld)
 
     /* get fpga family from idcode */
     idcode = urj_tap_register_get_value (part->id);
+    if ((idcode & 0xfff) != XILINX_MANUFACTURER)
+        return URJ_STATUS_FAIL;
     family = (idcode >> 21) & 0x7f;
 
     switch (family)
@@ -717,6 +719,8 @@ xlx_detect_xc4v (urj_pld_t *pld)
 
     /* get fpga family from idcode */
     idcode = urj_tap_register_get_value (part->id);
+    if ((idcode & 0xfff) != XILINX_MANUFACTURER)
+        return URJ_STATUS_FAIL;
     family = (idcode >> 21) & 0x7f;
 
     switch (family)
@@ -739,6 +743,8 @@ xlx_detect_xc6s (urj_pld_t *pld)
 
     /* get fpga family from idcode */
     idcode = urj_tap_register_get_value (part->id);
+    if ((idcode & 0xfff) != XILINX_MANUFACTURER)
+        return URJ_STATUS_FAIL;
     family = (idcode >> 21) & 0x7f;
 
     switch (family)
@@ -38,6 +38,9 @@
 #define XILINX_XC4V_REG_STAT 7
 #define XILINX_XC6S_REG_STAT 8
 
+/* bits 11-0 of the IDCODE: manufacturer 0x049 and the mandatory 1 */
+#define XILINX_MANUFACTURER     0x093
+
 #define XILINX_FAMILY_XC2V      0x08
 #define XILINX_FAMILY_XC3S      0x0A
 #define XILINX_FAMILY_XC4VLX    0x0B
@@ -61,14 +61,13 @@ BOOL urj_jam_rlc_key_char (int ch, JAME_RLC_BLOCK_TYPE *block_type,
                        int *count_size);
 int urj_jam_extract_bool_run_length (JAMS_HEAP_RECORD *heap_record,
                                  char *statement_buffer);
-int urj_jam_extract_bool_compressed (JAMS_HEAP_RECORD *heap_record,
-                                 char *statement_buffer);
 int urj_jam_get_real_char (void);
 int urj_jam_read_bool_comma_sep (JAMS_HEAP_RECORD *heap_record);
 int urj_jam_read_bool_binary (JAMS_HEAP_RECORD *heap_record);
 int urj_jam_read_bool_hex (JAMS_HEAP_RECORD *heap_record);
 int urj_jam_read_bool_run_length (JAMS_HEAP_RECORD *heap_record);
 int urj_jam_read_bool_compressed (JAMS_HEAP_RECORD *heap_record);
+int urj_jam_load_deferred_array (JAMS_HEAP_RECORD *heap_record);
 int urj_jam_read_boolean_array_data (JAMS_HEAP_RECORD *heap_record,
                                  char *statement_buffer);
 int urj_jam_extract_int_comma_sep (JAMS_HEAP_RECORD *heap_record,
@@ -406,22 +405,10 @@ urj_jam_6bit_char (int ch)
 /*                                                                          */
 /****************************************************************************/
 {
-    int result = 0;
-
-    if ((ch >= '0') && (ch <= '9'))
-        result = (ch - '0');
-    else if ((ch >= 'A') && (ch <= 'Z'))
-        result = (ch + 10 - 'A');
-    else if ((ch >= 'a') && (ch <= 'z'))
-        result = (ch + 36 - 'a');
-    else if (ch == '_')
-        result = 62;
-    else if (ch == '@')
-        result = 63;
-    else
-        result = -1;            /* illegal character */
+    if ((ch < 0) || (ch > 0xff))
+        return -1;              /* EOF */
 
-    return result;
+    return urj_jam_6bit_table[ch];
 }
 
 /****************************************************************************/
@@ -606,131 +593,6 @@ JAM_RETURN_TYPE urj_jam_extract_bool_run_length
 /****************************************************************************/
 /*                                                                          */
 
-JAM_RETURN_TYPE urj_jam_extract_bool_compressed
-    (JAMS_HEAP_RECORD *heap_record, char *statement_buffer)
-/*                                                                          */
-/*  Description:    Extracts Boolean array data from statement buffer.      */
-/*                  Works on data encoded using ACA representation.         */
-/*                                                                          */
-/*  Returns:        JAMC_SUCCESS for success, else appropriate error code   */
-/*                                                                          */
-/****************************************************************************/
-{
-    int bit = 0;
-    int word = 0;
-    int value = 0;
-    int index = 0;
-    int index2 = 0;
-    int32_t uncompressed_length = 0L;
-    char *ch_data = NULL;
-    int32_t out_size = 0L;
-    int32_t address = 0L;
-    int32_t *heap_data = &heap_record->data[0];
-    JAM_RETURN_TYPE status = JAMC_SUCCESS;
-
-    /* remove all white space */
-    while (statement_buffer[index] != JAMC_NULL_CHAR)
-    {
-        if (!isspace (statement_buffer[index]))
-        {
-            statement_buffer[index2] = statement_buffer[index];
-            ++index2;
-        }
-        ++index;
-    }
-    statement_buffer[index2] = JAMC_NULL_CHAR;
-
-    /* convert 6-bit encoded characters to binary -- in the same buffer */
-    index = 0;
-    while ((status == JAMC_SUCCESS) &&
-           (statement_buffer[index] != JAMC_NULL_CHAR) &&
-           (statement_buffer[index] != JAMC_SEMICOLON_CHAR))
-    {
-        value = urj_jam_6bit_char (statement_buffer[index]);
-        statement_buffer[index] = 0;
-
-        if (value == -1)
-        {
-            status = JAMC_SYNTAX_ERROR;
-        }
-        else
-        {
-            for (bit = 0; bit < 6; ++bit)
-            {
-                if (value & (1 << (bit % 6)))
-                {
-                    statement_buffer[address >> 3] |= (1L << (address & 7));
-                }
-                else
-                {
-                    statement_buffer[address >> 3] &=
-                        ~(unsigned int) (1 << (address & 7));
-                }
-                ++address;
-            }
-        }
-
-        ++index;
-    }
-
-    if ((status == JAMC_SUCCESS) &&
-        (statement_buffer[index] != JAMC_SEMICOLON_CHAR))
-    {
-        status = JAMC_SYNTAX_ERROR;
-    }
-
-    /*
-     *      We need two memory buffers:
-     *
-     *      in   (length of compressed bitstream)
-     *      out  (length of uncompressed bitstream)
-     *
-     *      The statement buffer is re-used for the "in" buffer.  The "out"
-     *      buffer is inside the heap record.
-     */
-
-    if (status == JAMC_SUCCESS)
-    {
-        /*
-         *      Uncompress the data
-         */
-        out_size = (heap_record->dimension >> 3) +
-            ((heap_record->dimension & 7) ? 1 : 0);
-
-        uncompressed_length = urj_jam_uncompress (statement_buffer,
-                                              (address >> 3) +
-                                              ((address & 7) ? 1 : 0),
-                                              (char *) heap_data, out_size,
-                                              urj_jam_version);
-
-        if (uncompressed_length != out_size)
-        {
-            status = JAMC_SYNTAX_ERROR;
-        }
-        else
-        {
-            /* convert data from bytes into 32-bit words */
-            out_size = (heap_record->dimension >> 5) +
-                ((heap_record->dimension & 0x1f) ? 1 : 0);
-            ch_data = (char *) heap_data;
-
-            for (word = 0; word < out_size; ++word)
-            {
-                heap_data[word] =
-                    ((((int32_t) ch_data[(word * 4) + 3]) & 0xff) << 24L) |
-                    ((((int32_t) ch_data[(word * 4) + 2]) & 0xff) << 16L) |
-                    ((((int32_t) ch_data[(word * 4) + 1]) & 0xff) << 8L) |
-                    (((int32_t) ch_data[word * 4]) & 0xff);
-            }
-        }
-    }
-
-    return status;
-}
-
-/****************************************************************************/
-/*                                                                          */
-
 int
 urj_jam_get_real_char (void)
 /*                                                                          */
@@ -1144,93 +1006,41 @@ JAM_RETURN_TYPE
 urj_jam_read_bool_compressed (JAMS_HEAP_RECORD *heap_record)
 /*                                                                          */
 /*  Description:    Reads Boolean array data directly from input stream.    */
-/*                  Works on data encoded using ACA representation.         */
+/*                  Works on data encoded using ACA representation.  The    */
+/*                  encoded text is decoded in place in the program buffer, */
+/*                  so no temporary copy of the compressed data is made.    */
 /*                                                                          */
 /*  Returns:        JAMC_SUCCESS for success, else appropriate error code   */
 /*                                                                          */
 /****************************************************************************/
 {
-    int ch = 0;
-    int bit = 0;
     int word = 0;
-    int value = 0;
     int32_t uncompressed_length = 0L;
-    char *in = NULL;
-    char *ch_data = NULL;
-    int32_t in_size = 0L;
+    unsigned char *ch_data = NULL;
     int32_t out_size = 0L;
-    int32_t address = 0L;
-    BOOL done = false;
     int32_t *heap_data = &heap_record->data[0];
     JAM_RETURN_TYPE status = JAMC_SUCCESS;
 
-    if (urj_jam_seek (heap_record->position) != 0)
+    if ((urj_jam_program == NULL) || (heap_record->position < 0L) ||
+        (heap_record->position >= urj_jam_program_size))
     {
         status = JAMC_IO_ERROR;
     }
 
-    /*
-     *      We need two memory buffers:
-     *
-     *      in   (length of compressed bitstream)
-     *      out  (length of uncompressed bitstream)
-     *
-     *      The "out" buffer is inside the heap record.  The "in" buffer
-     *      resides in temporary storage above the last heap record.
-     */
-
-    out_size = (heap_record->dimension >> 3) +
-        ((heap_record->dimension & 7) ? 1 : 0);
-    in = urj_jam_get_temp_workspace (out_size + (out_size / 10) + 100);
-    if (in == NULL)
-    {
-        status = JAMC_OUT_OF_MEMORY;
-    }
-
-    while ((status == JAMC_SUCCESS) && (!done))
-    {
-        ch = urj_jam_get_real_char ();
-
-        if (ch == JAMC_SEMICOLON_CHAR)
-        {
-            done = true;
-        }
-        else
-        {
-            value = urj_jam_6bit_char (ch);
-
-            if (value == -1)
-            {
-                status = JAMC_SYNTAX_ERROR;
-            }
-            else
-            {
-                for (bit = 0; bit < 6; ++bit)
-                {
-                    if (value & (1 << (bit % 6)))
-                    {
-                        in[address >> 3] |= (1L << (address & 7));
-                    }
-                    else
-                    {
-                        in[address >> 3] &=
-                            ~(unsigned int) (1 << (address & 7));
-                    }
-                    ++address;
-                }
-            }
-        }
-    }
-
-    if (done && (status == JAMC_SUCCESS))
+    if (status == JAMC_SUCCESS)
     {
         /*
-         *      Uncompress the data
+         *      Uncompress the data.  The "out" buffer is inside the heap
+         *      record.
          */
-        in_size = (address >> 3) + ((address & 7) ? 1 : 0);
+        out_size = (heap_record->dimension >> 3) +
+            ((heap_record->dimension & 7) ? 1 : 0);
+
         uncompressed_length =
-            urj_jam_uncompress (in, in_size, (char *) heap_data, out_size,
-                            urj_jam_version);
+            urj_jam_uncompress (&urj_jam_program[heap_record->position],
+                                urj_jam_program_size - heap_record->position,
+                                (char *) heap_data, out_size,
+                                urj_jam_version);
 
         if (uncompressed_length != out_size)
         {
@@ -1241,21 +1051,49 @@ urj_jam_read_bool_compressed (JAMS_HEAP_RECORD *heap_record)
             /* convert data from bytes into 32-bit words */
             out_size = (heap_record->dimension >> 5) +
                 ((heap_record->dimension & 0x1f) ? 1 : 0);
-            ch_data = (char *) heap_data;
+            ch_data = (unsigned char *) heap_data;
 
             for (word = 0; word < out_size; ++word)
             {
-                heap_data[word] =
-                    ((((int32_t) ch_data[(word * 4) + 3]) & 0xff) << 24L) |
-                    ((((int32_t) ch_data[(word * 4) + 2]) & 0xff) << 16L) |
-                    ((((int32_t) ch_data[(word * 4) + 1]) & 0xff) << 8L) |
-                    (((int32_t) ch_data[word * 4]) & 0xff);
+                heap_data[word] = (int32_t)
+                    (((uint32_t) ch_data[(word * 4) + 3] << 24) |
+                     ((uint32_t) ch_data[(word * 4) + 2] << 16) |
+                     ((uint32_t) ch_data[(word * 4) + 1] << 8) |
+                     (uint32_t) ch_data[word * 4]);
             }
         }
     }
 
-    if (in != NULL)
-        urj_jam_free_temp_workspace (in);
+    return status;
+}
+
+/****************************************************************************/
+/*                                                                          */
+
+JAM_RETURN_TYPE
+urj_jam_load_deferred_array (JAMS_HEAP_RECORD *heap_record)
+/*                                                                          */
+/*  Description:    ACA compressed arrays are not uncompressed when they    */
+/*                  are declared, only their position in the file is        */
+/*                  recorded.  This uncompresses the data of such an array  */
+/*                  on its first use; arrays that are never referenced by   */
+/*                  the executed action are never uncompressed.             */
+/*                                                                          */
+/*  Returns:        JAMC_SUCCESS for success, else appropriate error code   */
+/*                                                                          */
+/****************************************************************************/
+{
+    JAM_RETURN_TYPE status = JAMC_SUCCESS;
+
+    if ((heap_record != NULL) && heap_record->deferred)
+    {
+        status = urj_jam_read_bool_compressed (heap_record);
+
+        if (status == JAMC_SUCCESS)
+        {
+            heap_record->deferred = false;
+        }
+    }
 
     return status;
 }
@@ -1291,6 +1129,7 @@ JAM_RETURN_TYPE urj_jam_read_boolean_array_data
     BOOL found_space = false;
     BOOL found_keyword = false;
     BOOL data_complete = false;
+    BOOL deferred = false;
     JAME_BOOLEAN_REP representation = JAM_ILLEGAL_REP;
     JAM_RETURN_TYPE status = JAMC_SUCCESS;
 
@@ -1357,6 +1196,10 @@ JAM_RETURN_TYPE urj_jam_read_boolean_array_data
     else
     {
         heap_record->rep = representation;
+
+        /* ACA data is only located now, it is uncompressed on first use */
+        deferred = heap_record->cached ||
+            (representation == JAM_BOOL_COMPRESSED);
     }
 
     if ((status == JAMC_SUCCESS) && (urj_jam_version == 2))
@@ -1373,7 +1216,7 @@ JAM_RETURN_TYPE urj_jam_read_boolean_array_data
     /*
      *      See if all the initialization data is present in the statement buffer
      */
-    if ((status == JAMC_SUCCESS) && !heap_record->cached)
+    if ((status == JAMC_SUCCESS) && !deferred)
     {
         while ((statement_buffer[index] != JAMC_NULL_CHAR) &&
                (statement_buffer[index] != JAMC_SEMICOLON_CHAR) &&
@@ -1392,7 +1235,7 @@ JAM_RETURN_TYPE urj_jam_read_boolean_array_data
      *      If data is not all present in the statement buffer, or if data
      *      will be cached, find the position of the data in the input file
      */
-    if ((status == JAMC_SUCCESS) && ((!data_complete) || heap_record->cached))
+    if ((status == JAMC_SUCCESS) && ((!data_complete) || deferred))
     {
         /*
          *      Get position offset of initialization data
@@ -1498,7 +1341,7 @@ JAM_RETURN_TYPE urj_jam_read_boolean_array_data
         /*
          *      If data will not be cached, read it in from the file now.
          */
-        if ((status == JAMC_SUCCESS) && !heap_record->cached)
+        if ((status == JAMC_SUCCESS) && !deferred)
         {
             /*
              *      Data is present, and will not be cached.  Read it in.
@@ -1521,10 +1364,6 @@ JAM_RETURN_TYPE urj_jam_read_boolean_array_data
                 status = urj_jam_read_bool_run_length (heap_record);
                 break;
 
-            case JAM_BOOL_COMPRESSED:
-                status = urj_jam_read_bool_compressed (heap_record);
-                break;
-
             default:
                 status = JAMC_INTERNAL_ERROR;
             }
@@ -1544,7 +1383,7 @@ JAM_RETURN_TYPE urj_jam_read_boolean_array_data
         }
     }
 
-    if ((status == JAMC_SUCCESS) && data_complete && !heap_record->cached)
+    if ((status == JAMC_SUCCESS) && data_complete && !deferred)
     {
         /*
          *      Data is present, and will not be cached.  Extract it from buffer.
@@ -1575,12 +1414,6 @@ JAM_RETURN_TYPE urj_jam_read_boolean_array_data
                                              &statement_buffer[data_offset]);
             break;
 
-        case JAM_BOOL_COMPRESSED:
-            status =
-                urj_jam_extract_bool_compressed (heap_record,
-                                             &statement_buffer[data_offset]);
-            break;
-
         default:
             status = JAMC_INTERNAL_ERROR;
         }
@@ -1599,6 +1432,11 @@ JAM_RETURN_TYPE urj_jam_read_boolean_array_data
         status = urj_jam_reverse_boolean_array_hex (heap_record);
     }
 
+    if ((status == JAMC_SUCCESS) && (representation == JAM_BOOL_COMPRESSED))
+    {
+        heap_record->deferred = true;
+    }
+
     return status;
 }
 
@@ -19,6 +19,8 @@ JAM_RETURN_TYPE urj_jam_read_boolean_array_data
 JAM_RETURN_TYPE urj_jam_read_integer_array_data
     (JAMS_HEAP_RECORD *heap_record, char *statement_buffer);
 
+JAM_RETURN_TYPE urj_jam_load_deferred_array (JAMS_HEAP_RECORD *heap_record);
+
 JAM_RETURN_TYPE urj_jam_get_array_value
     (JAMS_SYMBOL_RECORD *symbol_record, int32_t index, int32_t *value);
 
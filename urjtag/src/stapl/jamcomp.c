@@ -14,120 +14,221 @@
 /*                                                                          */
 /****************************************************************************/
 
+#include <ctype.h>
 #include <stdint.h>
+#include <string.h>
 #include "jamexprt.h"
 #include "jamdefs.h"
 #include "jamcomp.h"
 
-#define SHORT_BITS          16
 #define CHAR_BITS           8
 #define DATA_BLOB_LENGTH    3
 #define MATCH_DATA_LENGTH   8192
 
-short urj_jam_bits_required (short n);
-short urj_jam_read_packed (char *buffer, int32_t length, short bits);
-int32_t urj_jam_uncompress (char *in, int32_t in_length, char *out,
-                        int32_t out_length, int version);
+/*
+ *      Bit reader for the ASCII ACA stream.  Six data bits are packed per
+ *      character, least significant bit first, and are pulled from the
+ *      text into a 64-bit accumulator a character at a time.
+ */
+typedef struct
+{
+    const unsigned char *text;
+    const unsigned char *end;
+    uint64_t acc;               /* bits not consumed yet, LSB first */
+    int avail;                  /* number of valid bits in acc */
+    BOOL done;                  /* end of encoded text reached */
+    BOOL error;                 /* illegal character or buffer overrun */
+    uint32_t total;             /* number of bits read from the text */
+} JAMS_ACA_READER;
+
+/*
+ *      Numeric value of each character of the 6-bit encoding used by the
+ *      RLC and ACA representations, or -1 for characters outside of it.
+ */
+const signed char urj_jam_6bit_table[256] = {
+#define JAM_NO_6BIT_X16 -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1
+    JAM_NO_6BIT_X16, JAM_NO_6BIT_X16, JAM_NO_6BIT_X16,
+    /* '0'..'9' */
+    0, 1, 2, 3, 4, 5, 6, 7, 8, 9, -1, -1, -1, -1, -1, -1,
+    /* '@', 'A'..'O' */
+    63, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20, 21, 22, 23, 24,
+    /* 'P'..'Z', '_' */
+    25, 26, 27, 28, 29, 30, 31, 32, 33, 34, 35, -1, -1, -1, -1, 62,
+    /* 'a'..'o' */
+    -1, 36, 37, 38, 39, 40, 41, 42, 43, 44, 45, 46, 47, 48, 49, 50,
+    /* 'p'..'z' */
+    51, 52, 53, 54, 55, 56, 57, 58, 59, 60, 61, -1, -1, -1, -1, -1,
+    JAM_NO_6BIT_X16, JAM_NO_6BIT_X16, JAM_NO_6BIT_X16, JAM_NO_6BIT_X16, JAM_NO_6BIT_X16, JAM_NO_6BIT_X16, JAM_NO_6BIT_X16, JAM_NO_6BIT_X16
+#undef JAM_NO_6BIT_X16
+};
+
+int32_t urj_jam_uncompressed_length (const char *in, int32_t in_length);
+int32_t urj_jam_uncompress (const char *in, int32_t in_length, char *out,
+                            int32_t out_length, int version);
 
 /****************************************************************************/
 /*                                                                          */
 
-short
-urj_jam_bits_required (short n)
+static void
+urj_jam_aca_fill (JAMS_ACA_READER *reader)
 /*                                                                          */
-/*  Description:    Calculate the minimum number of bits required to        */
-/*                  represent n.                                            */
+/*  Description:    Refills the accumulator of "reader" from the encoded    */
+/*                  text, skipping white space and comments.  Decoding      */
+/*                  stops at a semicolon, a NUL or the end of the text.     */
+/*                  The bits of the last partial byte read as zeros.        */
 /*                                                                          */
-/*  Returns:        Number of bits.                                         */
+/*  Returns:        Nothing                                                 */
 /*                                                                          */
 /****************************************************************************/
 {
-    short result = SHORT_BITS;
+    const unsigned char *p = reader->text;
+    int value;
 
-    if (n == 0)
-        result = 1;
-    else
+    while ((reader->avail <= 64 - 6) && !reader->done)
     {
-        /* Look for the highest non-zero bit position */
-        while ((n & (1 << (SHORT_BITS - 1))) == 0)
+        if ((p >= reader->end) || (*p == JAMC_SEMICOLON_CHAR) ||
+            (*p == JAMC_NULL_CHAR))
+        {
+            /* pad up to the next byte boundary, like the packed stream */
+            reader->avail += (int) ((CHAR_BITS - (reader->total % CHAR_BITS))
+                                    % CHAR_BITS);
+            reader->done = true;
+        }
+        else if ((value = urj_jam_6bit_table[*p]) >= 0)
         {
-            n = (short) (n << 1);
-            --result;
+            reader->acc |= (uint64_t) value << reader->avail;
+            reader->avail += 6;
+            reader->total += 6;
+            ++p;
+        }
+        else if (*p == JAMC_COMMENT_CHAR)
+        {
+            while ((p < reader->end) && (*p != JAMC_NEWLINE_CHAR) &&
+                   (*p != JAMC_RETURN_CHAR) && (*p != JAMC_NULL_CHAR))
+            {
+                ++p;
+            }
+        }
+        else if (isspace (*p))
+        {
+            ++p;
+        }
+        else
+        {
+            reader->error = true;
+            reader->done = true;
         }
     }
 
-    return result;
+    reader->text = p;
 }
 
 /****************************************************************************/
 /*                                                                          */
 
-short
-urj_jam_read_packed (char *buffer, int32_t length, short bits)
+static int32_t
+urj_jam_aca_read (JAMS_ACA_READER *reader, int bits)
 /*                                                                          */
-/*  Description:    Read the next value from the input array "buffer".      */
-/*                  Read only "bits" bits from the array. The amount of     */
-/*                  bits that have already been read from "buffer" is       */
-/*                  stored internally to this function.                     */
+/*  Description:    Reads the next "bits" bits (at most 32) of the stream.  */
 /*                                                                          */
-/*  Returns:        Up to 16 bit value. -1 if buffer overrun.               */
+/*  Returns:        Value read, or -1 if the stream is exhausted or bad.    */
 /*                                                                          */
 /****************************************************************************/
 {
-    short result = -1;
-    static int32_t index = 0L;
-    static short bits_avail = 0;
-    short shift = 0;
+    int32_t result;
 
-    /* If buffer is NULL then initialize. */
-    if (buffer == NULL)
+    if (reader->avail < bits)
     {
-        index = 0;
-        bits_avail = CHAR_BITS;
-    }
-    else
-    {
-        result = 0;
-        while (result != -1 && bits > 0)
-        {
-            result =
-                (short) (result |
-                         (((buffer[index] >> (CHAR_BITS - bits_avail)) &
-                           (0xFF >> (CHAR_BITS - bits_avail))) << shift));
+        urj_jam_aca_fill (reader);
 
-            if (bits <= bits_avail)
-            {
-                result =
-                    (short) (result &
-                             (0xFFFF >> (SHORT_BITS - (bits + shift))));
-                bits_avail = (short) (bits_avail - bits);
-                bits = 0;
-            }
-            else
-            {
-                /* Check for buffer overflow. */
-                if (++index >= length)
-                    result = -1;
-                else
-                {
-                    shift = (short) (shift + bits_avail);
-                    bits = (short) (bits - bits_avail);
-                    bits_avail = CHAR_BITS;
-                }
-            }
+        if ((reader->avail < bits) || reader->error)
+        {
+            reader->error = true;
+            return -1;
         }
     }
 
+    result = (int32_t) (reader->acc & (((uint64_t) 1 << bits) - 1));
+    reader->acc >>= bits;
+    reader->avail -= bits;
+
     return result;
 }
 
 /****************************************************************************/
 /*                                                                          */
 
+static void
+urj_jam_aca_init (JAMS_ACA_READER *reader, const char *in, int32_t in_length)
+/*                                                                          */
+/*  Description:    Starts reading the ACA stream "in".                     */
+/*                                                                          */
+/*  Returns:        Nothing                                                 */
+/*                                                                          */
+/****************************************************************************/
+{
+    reader->text = (const unsigned char *) in;
+    reader->end = reader->text + in_length;
+    reader->acc = 0;
+    reader->avail = 0;
+    reader->done = false;
+    reader->error = false;
+    reader->total = 0;
+}
+
+/****************************************************************************/
+/*                                                                          */
+
+static int32_t
+urj_jam_aca_read_length (JAMS_ACA_READER *reader)
+/*                                                                          */
+/*  Description:    Reads the uncompressed length, the first DWORD of the   */
+/*                  stream.                                                 */
+/*                                                                          */
+/*  Returns:        Length in bytes, or -1 if the stream is bad.            */
+/*                                                                          */
+/****************************************************************************/
+{
+    int32_t low = urj_jam_aca_read (reader, 16);
+    int32_t high = urj_jam_aca_read (reader, 16);
+
+    if ((low < 0) || (high < 0) || (high & 0x8000))
+        return -1;
+
+    return (high << 16) | low;
+}
+
+/****************************************************************************/
+/*                                                                          */
+
+int32_t
+urj_jam_uncompressed_length (const char *in, int32_t in_length)
+/*                                                                          */
+/*  Description:    Gets the length of the data in "in" once uncompressed.  */
+/*                                                                          */
+/*  Returns:        Length in bytes, or -1 if "in" isn't ACA data.          */
+/*                                                                          */
+/****************************************************************************/
+{
+    JAMS_ACA_READER reader;
+
+    urj_jam_aca_init (&reader, in, in_length);
+
+    return urj_jam_aca_read_length (&reader);
+}
+
+/****************************************************************************/
+/*                                                                          */
+
 int32_t urj_jam_uncompress
-    (char *in, int32_t in_length, char *out, int32_t out_length, int version)
+    (const char *in, int32_t in_length, char *out, int32_t out_length,
+     int version)
 /*                                                                          */
-/*  Description:    Uncompress data in "in" and write result to "out".      */
+/*  Description:    Uncompress the ASCII ACA data in "in" and write the     */
+/*                  result to "out".  The 6-bit characters are decoded on   */
+/*                  the fly, so the encoded text can be taken straight from */
+/*                  the program buffer.  "in" ends at the first semicolon   */
+/*                  or NUL, or after in_length characters.                  */
 /*                                                                          */
 /*  Returns:        Length of uncompressed data. -1 if:                     */
 /*                      1) out_length is too small                          */
@@ -136,70 +237,89 @@ int32_t urj_jam_uncompress
 /*                                                                          */
 /****************************************************************************/
 {
-    int32_t i, j, data_length = 0L;
-    short offset, length;
+    JAMS_ACA_READER reader;
+    int32_t i, n, src, data_length;
+    int32_t offset, length, value;
     int32_t match_data_length = MATCH_DATA_LENGTH;
+    int offset_bits = 1;
 
     if (version == 2)
         --match_data_length;
 
-    urj_jam_read_packed (NULL, 0, 0);
-    for (i = 0; i < out_length; ++i)
-        out[i] = 0;
+    urj_jam_aca_init (&reader, in, in_length);
 
     /* Read number of bytes in data. */
-    for (i = 0; i < sizeof (in_length); ++i)
-    {
-        data_length =
-            data_length | ((int32_t)
-                           urj_jam_read_packed (in, in_length,
-                                            CHAR_BITS) << (int32_t) (i *
-                                                                     CHAR_BITS));
-    }
+    data_length = urj_jam_aca_read_length (&reader);
+
+    if ((data_length < 0) || (data_length > out_length))
+        return -1;
 
-    if (data_length > out_length)
-        data_length = -1L;
-    else
+    i = 0;
+    while (i < data_length)
     {
-        i = 0;
-        while (i < data_length)
+        /* A 0 bit indicates literal data. */
+        value = urj_jam_aca_read (&reader, 1);
+
+        if (value == 0)
+        {
+            n = data_length - i;
+            if (n > DATA_BLOB_LENGTH)
+                n = DATA_BLOB_LENGTH;
+
+            value = urj_jam_aca_read (&reader, (int) n * CHAR_BITS);
+            if (value < 0)
+                return -1;
+
+            for (; n > 0; --n)
+            {
+                out[i++] = (char) value;
+                value >>= CHAR_BITS;
+            }
+        }
+        else if (value == 1)
         {
-            /* A 0 bit indicates literal data. */
-            if (urj_jam_read_packed (in, in_length, 1) == 0)
+            /* A 1 bit indicates offset/length to follow. */
+            while ((offset_bits < 16) &&
+                   ((i > match_data_length ? match_data_length : i) >=
+                    (1L << offset_bits)))
             {
-                for (j = 0; j < DATA_BLOB_LENGTH; ++j)
-                {
-                    if (i < data_length)
-                    {
-                        out[i] =
-                            (char) urj_jam_read_packed (in, in_length, CHAR_BITS);
-                        i++;
-                    }
-                }
+                ++offset_bits;
             }
-            else
+
+            offset = urj_jam_aca_read (&reader, offset_bits);
+            length = urj_jam_aca_read (&reader, CHAR_BITS);
+
+            if ((offset <= 0) || (offset > i) || (length < 0))
+                return -1;
+
+            if (length > data_length - i)
+                length = data_length - i;
+
+            /*
+             *      Copy the match in blocks.  For overlapping matches the
+             *      source is periodic, so each block can be twice as long
+             *      as the previous one.
+             */
+            src = i - offset;
+            while (length > 0)
             {
-                /* A 1 bit indicates offset/length to follow. */
-                offset =
-                    urj_jam_read_packed (in, in_length,
-                                     urj_jam_bits_required ((short)
-                                                        (i >
-                                                         match_data_length ?
-                                                         match_data_length :
-                                                         i)));
-                length = urj_jam_read_packed (in, in_length, CHAR_BITS);
-
-                for (j = 0; j < length; ++j)
-                {
-                    if (i < data_length)
-                    {
-                        out[i] = out[i - offset];
-                        i++;
-                    }
-                }
+                n = i - src;
+                if (n > length)
+                    n = length;
+
+                memcpy (&out[i], &out[src], (size_t) n);
+                i += n;
+                length -= n;
             }
         }
+        else
+        {
+            return -1;
+        }
     }
 
+    if (data_length < out_length)
+        memset (&out[data_length], 0, (size_t) (out_length - data_length));
+
     return data_length;
 }
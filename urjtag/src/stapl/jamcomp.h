@@ -14,7 +14,12 @@
 
 #include <stdint.h>
 
+extern const signed char urj_jam_6bit_table[256];
+
+int32_t urj_jam_uncompressed_length (const char *in, int32_t in_length);
+
 int32_t urj_jam_uncompress
-    (char *in, int32_t in_length, char *out, int32_t out_length, int version);
+    (const char *in, int32_t in_length, char *out, int32_t out_length,
+     int version);
 
 #endif /* INC_JAMCOMP_H */
@@ -18,6 +18,8 @@
 #include <stdlib.h>
 #include <stdbool.h>
 
+#include <urjtag/types.h>
+
 /* The code supposes that BOOL type is 4 bytes long instead of 1 byte as
   in the case of bool */
 typedef int BOOL;
@@ -29,7 +31,8 @@ typedef int BOOL;
 /****************************************************************************/
 
 /* maximum quantities of some items */
-#define JAMC_MAX_SYMBOL_COUNT 1021      /* should be a prime number */
+#define JAMC_MAX_SYMBOL_COUNT 1024      /* must be a power of two */
+#define JAMC_INITIAL_SYMBOL_COUNT 256   /* must be a power of two */
 #define JAMC_MAX_NESTING_DEPTH 128
 
 /* maximum JTAG IR and DR lengths (in bits) */
@@ -158,16 +161,16 @@ typedef enum
 /*                                                                          */
 /****************************************************************************/
 
-extern char *urj_jam_workspace;
+extern URJ_THREAD_LOCAL char *urj_jam_workspace;
 
-extern int32_t urj_jam_workspace_size;
+extern URJ_THREAD_LOCAL int32_t urj_jam_workspace_size;
 
-extern char *urj_jam_program;
+extern URJ_THREAD_LOCAL char *urj_jam_program;
 
-extern int32_t urj_jam_program_size;
+extern URJ_THREAD_LOCAL int32_t urj_jam_program_size;
 
-extern char **urj_jam_init_list;
+extern URJ_THREAD_LOCAL char **urj_jam_init_list;
 
-extern JAME_PHASE_TYPE urj_jam_phase;
+extern URJ_THREAD_LOCAL JAME_PHASE_TYPE urj_jam_phase;
 
 #endif /* INC_JAMDEFS_H */
@@ -38,56 +38,59 @@
 /****************************************************************************/
 
 /* pointer to memory buffer for variable, symbol and stack storage */
-char *urj_jam_workspace = NULL;
+URJ_THREAD_LOCAL char *urj_jam_workspace = NULL;
 
 /* size of available memory buffer */
-int32_t urj_jam_workspace_size = 0L;
+URJ_THREAD_LOCAL int32_t urj_jam_workspace_size = 0L;
 
 /* pointer to Jam program text */
-char *urj_jam_program = NULL;
+URJ_THREAD_LOCAL char *urj_jam_program = NULL;
 
 /* size of program buffer */
-int32_t urj_jam_program_size = 0L;
+URJ_THREAD_LOCAL int32_t urj_jam_program_size = 0L;
 
 /* current position in input stream */
-int32_t urj_jam_current_file_position = 0L;
+URJ_THREAD_LOCAL int32_t urj_jam_current_file_position = 0L;
 
 /* position in input stream of the beginning of the current statement */
-int32_t urj_jam_current_statement_position = 0L;
+URJ_THREAD_LOCAL int32_t urj_jam_current_statement_position = 0L;
 
 /* position of the beginning of the next statement (the one after the */
 /* current statement, but not necessarily the next one to be executed) */
-int32_t urj_jam_next_statement_position = 0L;
+URJ_THREAD_LOCAL int32_t urj_jam_next_statement_position = 0L;
 
 /* name of desired action (Jam 2.0 only) */
-char *urj_jam_action = NULL;
+URJ_THREAD_LOCAL char *urj_jam_action = NULL;
 
 /* pointer to initialization list */
-char **urj_jam_init_list = NULL;
+URJ_THREAD_LOCAL char **urj_jam_init_list = NULL;
 
 /* buffer for constant literal boolean array data */
 #define JAMC_MAX_LITERAL_ARRAYS 4
-int32_t urj_jam_literal_array_buffer[JAMC_MAX_LITERAL_ARRAYS];
+URJ_THREAD_LOCAL int32_t urj_jam_literal_array_buffer[JAMC_MAX_LITERAL_ARRAYS];
 
 /* buffer for constant literal ACA array data */
-int32_t *urj_jam_literal_aca_buffer[JAMC_MAX_LITERAL_ARRAYS];
+URJ_THREAD_LOCAL int32_t *urj_jam_literal_aca_buffer[JAMC_MAX_LITERAL_ARRAYS];
 
 /* number of vector signals */
-int urj_jam_vector_signal_count = 0;
+URJ_THREAD_LOCAL int urj_jam_vector_signal_count = 0;
 
 /* version of Jam language used:  0 = unknown */
-int urj_jam_version = 0;
+URJ_THREAD_LOCAL int urj_jam_version = 0;
+
+/* number of statements executed since urj_jam_execute() was entered */
+URJ_THREAD_LOCAL uint32_t urj_jam_statement_count = 0L;
 
 /* phase of Jam execution */
-JAME_PHASE_TYPE urj_jam_phase = JAM_UNKNOWN_PHASE;
+URJ_THREAD_LOCAL JAME_PHASE_TYPE urj_jam_phase = JAM_UNKNOWN_PHASE;
 
 /* current procedure or data block */
-JAMS_SYMBOL_RECORD *urj_jam_current_block = NULL;
+URJ_THREAD_LOCAL JAMS_SYMBOL_RECORD *urj_jam_current_block = NULL;
 
 /* this global flag indicates that we are processing the items in */
 /* the "uses" list for a procedure, executing the data blocks if */
 /* they have not yet been initialized, but not calling any procedures */
-BOOL urj_jam_checking_uses_list = false;
+URJ_THREAD_LOCAL BOOL urj_jam_checking_uses_list = false;
 
 /* function prototypes for forward reference */
 int urj_jam_get_statement (char *statement_buffer, char *label_buffer);
@@ -813,8 +816,8 @@ JAM_RETURN_TYPE urj_jam_convert_literal_binary
 
         if (rev_index > 1)
         {
-            long_ptr =
-                (int32_t *) (((int32_t) statement_buffer) & 0xfffffffcL);
+            long_ptr = (int32_t *)
+                (((uintptr_t) statement_buffer) & ~(uintptr_t) 3);
         }
         else if (arg < JAMC_MAX_LITERAL_ARRAYS)
         {
@@ -946,8 +949,8 @@ JAM_RETURN_TYPE urj_jam_convert_literal_array
 
         if (rev_index > 1)
         {
-            long_ptr =
-                (int32_t *) (((int32_t) statement_buffer) & 0xfffffffcL);
+            long_ptr = (int32_t *)
+                (((uintptr_t) statement_buffer) & ~(uintptr_t) 3);
         }
         else if (arg < JAMC_MAX_LITERAL_ARRAYS)
         {
@@ -994,19 +997,13 @@ JAM_RETURN_TYPE urj_jam_convert_literal_aca
 /*                                                                          */
 /****************************************************************************/
 {
-    int bit = 0;
-    int value = 0;
-    int index = 0;
-    int index2 = 0;
     int i = 0;
-    int j = 0;
     int long_count = 0;
-    int32_t binary_compressed_length = 0L;
+    int32_t text_length = 0L;
     int32_t uncompressed_length = 0L;
-    char *buffer = NULL;
+    unsigned char *buffer = NULL;
     int32_t *long_ptr = NULL;
     int32_t out_size = 0L;
-    int32_t address = 0L;
     JAM_RETURN_TYPE status = JAMC_SUCCESS;
 
     if ((arg < 0) || (arg >= JAMC_MAX_LITERAL_ARRAYS))
@@ -1014,74 +1011,24 @@ JAM_RETURN_TYPE urj_jam_convert_literal_aca
         status = JAMC_INTERNAL_ERROR;
     }
 
-    /* remove all white space */
-    while (statement_buffer[index] != JAMC_NULL_CHAR)
-    {
-        if ((!isspace (statement_buffer[index])) &&
-            (statement_buffer[index] != JAMC_TAB_CHAR) &&
-            (statement_buffer[index] != JAMC_RETURN_CHAR) &&
-            (statement_buffer[index] != JAMC_NEWLINE_CHAR))
-        {
-            statement_buffer[index2] = statement_buffer[index];
-            ++index2;
-        }
-        ++index;
-    }
-    statement_buffer[index2] = JAMC_NULL_CHAR;
+    /*
+     *      The encoded text is decoded straight from the statement buffer;
+     *      white space is skipped by the decoder.  Get uncompressed length
+     *      from first DWORD of compressed data.
+     */
+    text_length = (int32_t) strlen (statement_buffer);
 
-    /* convert 6-bit encoded characters to binary -- in the same buffer */
-    index = 0;
-    while ((status == JAMC_SUCCESS) &&
-           (isalnum (statement_buffer[index]) ||
-            (statement_buffer[index] == JAMC_AT_CHAR) ||
-            (statement_buffer[index] == JAMC_UNDERSCORE_CHAR)))
+    if (status == JAMC_SUCCESS)
     {
-        value = urj_jam_6bit_char (statement_buffer[index]);
-        statement_buffer[index] = 0;
+        uncompressed_length =
+            urj_jam_uncompressed_length (statement_buffer, text_length);
 
-        if (value == -1)
+        if (uncompressed_length < 0L)
         {
             status = JAMC_SYNTAX_ERROR;
         }
-        else
-        {
-            for (bit = 0; bit < 6; ++bit)
-            {
-                if (value & (1 << (bit % 6)))
-                {
-                    statement_buffer[address >> 3] |= (1L << (address & 7));
-                }
-                else
-                {
-                    statement_buffer[address >> 3] &=
-                        ~(unsigned int) (1 << (address & 7));
-                }
-                ++address;
-            }
-        }
-
-        ++index;
-    }
-
-    if ((status == JAMC_SUCCESS) &&
-        (statement_buffer[index] != JAMC_NULL_CHAR))
-    {
-        status = JAMC_SYNTAX_ERROR;
     }
 
-    /* Compute length of binary data string in statement_buffer */
-    binary_compressed_length = (address >> 3) + ((address & 7) ? 1 : 0);
-
-    /* Get uncompressed length from first DWORD of compressed data */
-    uncompressed_length = ((((int32_t) statement_buffer[3] << 24L) &
-                            0xff000000L) | (((int32_t) statement_buffer[2] <<
-                                             16L) & 0x00ff0000L) | (((int32_t)
-                                                                     statement_buffer
-                                                                     [1] <<
-                                                                     8L) &
-                                                                    0x0000ff00L)
-                           | (((int32_t) statement_buffer[0]) & 0x000000ffL));
-
     /* Allocate memory for literal binary data */
     if (status == JAMC_SUCCESS)
     {
@@ -1095,13 +1042,16 @@ JAM_RETURN_TYPE urj_jam_convert_literal_aca
     }
 
     /* Uncompress encoded binary into literal binary data */
-    out_size = urj_jam_uncompress (statement_buffer,
-                               binary_compressed_length,
-                               buffer, uncompressed_length, urj_jam_version);
-
-    if (out_size != uncompressed_length)
+    if (status == JAMC_SUCCESS)
     {
-        status = JAMC_SYNTAX_ERROR;
+        out_size = urj_jam_uncompress (statement_buffer, text_length,
+                                       (char *) buffer, uncompressed_length,
+                                       urj_jam_version);
+
+        if (out_size != uncompressed_length)
+        {
+            status = JAMC_SYNTAX_ERROR;
+        }
     }
 
     if (status == JAMC_SUCCESS)
@@ -1110,14 +1060,16 @@ JAM_RETURN_TYPE urj_jam_convert_literal_aca
          *      Convert uncompressed data to array of int32_t integers
          */
         long_count = (out_size + 3) / 4;        /* number of longs */
+        buffer[out_size] = 0;
+        buffer[out_size + 1] = 0;
+        buffer[out_size + 2] = 0;
 
         for (i = 0; i < long_count; ++i)
         {
-            j = i * 4;
-            long_ptr[i] = ((((int32_t) buffer[j + 3] << 24L) & 0xff000000L) |
-                           (((int32_t) buffer[j + 2] << 16L) & 0x00ff0000L) |
-                           (((int32_t) buffer[j + 1] << 8L) & 0x0000ff00L) |
-                           (((int32_t) buffer[j]) & 0x000000ffL));
+            long_ptr[i] = (int32_t) (((uint32_t) buffer[i * 4 + 3] << 24) |
+                                     ((uint32_t) buffer[i * 4 + 2] << 16) |
+                                     ((uint32_t) buffer[i * 4 + 1] << 8) |
+                                     (uint32_t) buffer[i * 4]);
         }
 
         urj_jam_literal_aca_buffer[arg] = long_ptr;
@@ -1128,6 +1080,10 @@ JAM_RETURN_TYPE urj_jam_convert_literal_aca
         if (length != NULL)
             *length = uncompressed_length * 8L;
     }
+    else if (long_ptr != NULL)
+    {
+        free (long_ptr);
+    }
 
     if (buffer != NULL)
         free (buffer);
@@ -2612,7 +2568,7 @@ urj_jam_process_boolean (char *statement_buffer)
 
                     if (status == JAMC_SUCCESS)
                     {
-                        symbol_record->value = (int32_t) heap_record;
+                        symbol_record->value = (intptr_t) heap_record;
 
                         /*
                          *      Initialize heap data for array
@@ -2633,7 +2589,7 @@ urj_jam_process_boolean (char *statement_buffer)
 
                     if (status == JAMC_SUCCESS)
                     {
-                        symbol_record->value = (int32_t) heap_record;
+                        symbol_record->value = (intptr_t) heap_record;
                     }
                 }
             }
@@ -4594,7 +4550,7 @@ urj_jam_process_integer (char *statement_buffer)
 
                     if (status == JAMC_SUCCESS)
                     {
-                        symbol_record->value = (int32_t) heap_record;
+                        symbol_record->value = (intptr_t) heap_record;
 
                         status = urj_jam_read_integer_array_data (heap_record,
                                                               &statement_buffer
@@ -4612,7 +4568,7 @@ urj_jam_process_integer (char *statement_buffer)
 
                     if (status == JAMC_SUCCESS)
                     {
-                        symbol_record->value = (int32_t) heap_record;
+                        symbol_record->value = (intptr_t) heap_record;
                     }
                 }
             }
@@ -6932,7 +6888,7 @@ urj_jam_process_procedure (char *statement_buffer)
 
                     if (status == JAMC_SUCCESS)
                     {
-                        symbol_record->value = (int32_t) heap_record;
+                        symbol_record->value = (intptr_t) heap_record;
                         strcpy ((char *) heap_record->data,
                                     &statement_buffer[index]);
                     }
@@ -8250,6 +8206,8 @@ JAM_RETURN_TYPE urj_jam_execute_statement
     JAME_INSTRUCTION instruction_code = JAM_ILLEGAL_INSTR;
     JAM_RETURN_TYPE status = JAMC_SUCCESS;
 
+    ++urj_jam_statement_count;
+
     instruction_code = urj_jam_get_instruction (statement_buffer);
 
     switch (instruction_code)
@@ -8499,6 +8457,7 @@ JAM_RETURN_TYPE urj_jam_execute
     urj_jam_version = 0;
     urj_jam_phase = JAM_UNKNOWN_PHASE;
     urj_jam_current_block = NULL;
+    urj_jam_statement_count = 0L;
 
     for (i = 0; i < JAMC_MAX_LITERAL_ARRAYS; ++i)
     {
@@ -8506,13 +8465,19 @@ JAM_RETURN_TYPE urj_jam_execute
     }
 
     /*
-     *      Ensure that workspace is DWORD aligned
+     *      Ensure that workspace is pointer aligned
      */
     if (urj_jam_workspace != NULL)
     {
-        urj_jam_workspace_size -= (((int32_t) urj_jam_workspace) & 3L);
-        urj_jam_workspace_size &= (~3L);
-        urj_jam_workspace = (char *) (((int32_t) urj_jam_workspace + 3L) & (~3L));
+        uintptr_t align = sizeof (void *) - 1;
+        uintptr_t misalign = (uintptr_t) urj_jam_workspace & align;
+
+        if (misalign != 0)
+        {
+            urj_jam_workspace_size -= (int32_t) (align + 1 - misalign);
+            urj_jam_workspace += align + 1 - misalign;
+        }
+        urj_jam_workspace_size &= ~(int32_t) align;
     }
 
     /*
@@ -129,15 +129,15 @@ struct
     {"FLOOR", 5, FLOOR_TOK}
 };
 
-char urj_jam_ch = '\0';             /* next character from input file */
-int urj_jam_strptr = 0;
-int urj_jam_token = 0;
-char urj_jam_token_buffer[MAX_BUFFER_LENGTH];
-int urj_jam_token_buffer_index;
-char urj_jam_parse_string[MAX_BUFFER_LENGTH];
-int32_t urj_jam_parse_value = 0;
-int urj_jam_expression_type = 0;
-JAMS_SYMBOL_RECORD *urj_jam_array_symbol_rec = NULL;
+URJ_THREAD_LOCAL char urj_jam_ch = '\0';             /* next character from input file */
+URJ_THREAD_LOCAL int urj_jam_strptr = 0;
+URJ_THREAD_LOCAL int urj_jam_token = 0;
+URJ_THREAD_LOCAL char urj_jam_token_buffer[MAX_BUFFER_LENGTH];
+URJ_THREAD_LOCAL int urj_jam_token_buffer_index;
+URJ_THREAD_LOCAL char urj_jam_parse_string[MAX_BUFFER_LENGTH];
+URJ_THREAD_LOCAL int32_t urj_jam_parse_value = 0;
+URJ_THREAD_LOCAL int urj_jam_expression_type = 0;
+URJ_THREAD_LOCAL JAMS_SYMBOL_RECORD *urj_jam_array_symbol_rec = NULL;
 
 #define YYMAXDEPTH 300          /* This fixes a stack depth problem on  */
                         /* all platforms.                       */
@@ -192,15 +192,16 @@ typedef struct EXP_STACK
     int32_t val;
     int32_t loper;              /* left and right operands for DIV */
     int32_t roper;              /* we save it for CEIL/FLOOR's use */
+    JAMS_SYMBOL_RECORD *symbol_rec;     /* for JAM_ARRAY_REFERENCE */
 } EXPN_STACK;
 
 #define YYSTYPE EXPN_STACK      /* must be a #define for yacc */
 
-YYSTYPE urj_jam_null_expression = { 0, 0, 0, 0, 0 };
+URJ_THREAD_LOCAL YYSTYPE urj_jam_null_expression = { 0, 0, 0, 0, 0, NULL };
 
-JAM_RETURN_TYPE urj_jam_return_code = JAMC_SUCCESS;
+URJ_THREAD_LOCAL JAM_RETURN_TYPE urj_jam_return_code = JAMC_SUCCESS;
 
-JAME_EXPRESSION_TYPE urj_jam_expr_type = JAM_ILLEGAL_EXPR_TYPE;
+URJ_THREAD_LOCAL JAME_EXPRESSION_TYPE urj_jam_expr_type = JAM_ILLEGAL_EXPR_TYPE;
 
 #define NULL_EXP urj_jam_null_expression    /* .. for 1 operand operators */
 
@@ -237,7 +238,7 @@ int urj_jam_yylex (void);
 #ifndef YYSTYPE
 #define YYSTYPE int
 #endif
-YYSTYPE urj_jam_yylval, urj_jam_yyval;
+URJ_THREAD_LOCAL YYSTYPE urj_jam_yylval, urj_jam_yyval;
 #define YYERRCODE 256
 
 /* # line 333 "jamexp.y" */
@@ -807,7 +808,7 @@ urj_jam_exp_eval (OPERATOR_TYPE otype, YYSTYPE op1, YYSTYPE op2)
             ((op2.type == JAM_INTEGER_EXPR)
              || (op2.type == JAM_INT_OR_BOOL_EXPR)))
         {
-            symbol_rec = (JAMS_SYMBOL_RECORD *) op1.val;
+            symbol_rec = op1.symbol_rec;
             urj_jam_return_code =
                 urj_jam_get_array_value (symbol_rec, op2.val, &rtn.val);
 
@@ -876,7 +877,7 @@ urj_jam_exp_eval (OPERATOR_TYPE otype, YYSTYPE op1, YYSTYPE op2)
     case ARRAY_ALL:
         if (op1.type == JAM_ARRAY_REFERENCE)
         {
-            symbol_rec = (JAMS_SYMBOL_RECORD *) op1.val;
+            symbol_rec = op1.symbol_rec;
 
             if ((symbol_rec != NULL) &&
                 ((symbol_rec->type == JAM_BOOLEAN_ARRAY_WRITABLE) ||
@@ -1201,6 +1202,7 @@ urj_jam_yylex (void)
 /*                                                                      */
 {
     JAMS_SYMBOL_RECORD *symbol_rec = NULL;
+    JAMS_SYMBOL_RECORD *array_rec = NULL;
     int32_t val = 0L;
     JAME_EXPRESSION_TYPE type = JAM_ILLEGAL_EXPR_TYPE;
     int token_length;
@@ -1272,9 +1274,9 @@ urj_jam_yylex (void)
             case JAM_INTEGER_ARRAY_INITIALIZED:
             case JAM_BOOLEAN_ARRAY_INITIALIZED:
                 /* Success, swap token to be an ARRAY_TOK, */
-                /* save pointer to symbol record in value field */
+                /* save pointer to symbol record in symbol_rec field */
                 urj_jam_token = ARRAY_TOK;
-                val = (int32_t) symbol_rec;
+                array_rec = symbol_rec;
                 type = JAM_ARRAY_REFERENCE;
                 urj_jam_array_symbol_rec = symbol_rec;
                 break;
@@ -1299,6 +1301,7 @@ urj_jam_yylex (void)
     urj_jam_yylval.child_otype = 0;
     urj_jam_yylval.loper = 0;
     urj_jam_yylval.roper = 0;
+    urj_jam_yylval.symbol_rec = array_rec;
 
     return urj_jam_token;
 }
@@ -1532,10 +1535,10 @@ static const int jam_yydef[] = {
 #define YYACCEPT return(0)
 #define YYABORT return(1)
 
-static YYSTYPE jam_yyv[YYMAXDEPTH];
-static int token = -1;                 /* input token */
-static int errct = 0;                  /* error count */
-static int errfl = 0;                  /* error flag */
+static URJ_THREAD_LOCAL YYSTYPE jam_yyv[YYMAXDEPTH];
+static URJ_THREAD_LOCAL int token = -1;                 /* input token */
+static URJ_THREAD_LOCAL int errct = 0;                  /* error count */
+static URJ_THREAD_LOCAL int errfl = 0;                  /* error flag */
 
 int
 urj_jam_yyparse (void)
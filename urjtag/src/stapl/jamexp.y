@@ -130,15 +130,15 @@ struct
     {"FLOOR", 5, FLOOR_TOK}
 };
 
-char urj_jam_ch = '\0';             /* next character from input file */
-int urj_jam_strptr = 0;
-int urj_jam_token = 0;
-char urj_jam_token_buffer[MAX_BUFFER_LENGTH];
-int urj_jam_token_buffer_index;
-char urj_jam_parse_string[MAX_BUFFER_LENGTH];
-int32_t urj_jam_parse_value = 0;
-int urj_jam_expression_type = 0;
-JAMS_SYMBOL_RECORD *urj_jam_array_symbol_rec = NULL;
+URJ_THREAD_LOCAL char urj_jam_ch = '\0';             /* next character from input file */
+URJ_THREAD_LOCAL int urj_jam_strptr = 0;
+URJ_THREAD_LOCAL int urj_jam_token = 0;
+URJ_THREAD_LOCAL char urj_jam_token_buffer[MAX_BUFFER_LENGTH];
+URJ_THREAD_LOCAL int urj_jam_token_buffer_index;
+URJ_THREAD_LOCAL char urj_jam_parse_string[MAX_BUFFER_LENGTH];
+URJ_THREAD_LOCAL int32_t urj_jam_parse_value = 0;
+URJ_THREAD_LOCAL int urj_jam_expression_type = 0;
+URJ_THREAD_LOCAL JAMS_SYMBOL_RECORD *urj_jam_array_symbol_rec = NULL;
 
 #define YYMAXDEPTH 300          /* This fixes a stack depth problem on  */
                         /* all platforms.                       */
@@ -196,17 +196,18 @@ typedef struct EXP_STACK
     int32_t val;
     int32_t loper;              /* left and right operands for DIV */
     int32_t roper;              /* we save it for CEIL/FLOOR's use */
+    JAMS_SYMBOL_RECORD *symbol_rec;     /* for JAM_ARRAY_REFERENCE */
 } EXPN_STACK;
 
 #define URJ_JAM_YYSTYPE EXPN_STACK      /* must be a #define for yacc */
 }
 
 %code {
-YYSTYPE urj_jam_null_expression = { 0, 0, 0, 0, 0 };
+URJ_THREAD_LOCAL YYSTYPE urj_jam_null_expression = { 0, 0, 0, 0, 0, NULL };
 
-JAM_RETURN_TYPE urj_jam_return_code = JAMC_SUCCESS;
+URJ_THREAD_LOCAL JAM_RETURN_TYPE urj_jam_return_code = JAMC_SUCCESS;
 
-JAME_EXPRESSION_TYPE urj_jam_expr_type = JAM_ILLEGAL_EXPR_TYPE;
+URJ_THREAD_LOCAL JAME_EXPRESSION_TYPE urj_jam_expr_type = JAM_ILLEGAL_EXPR_TYPE;
 
 #define NULL_EXP urj_jam_null_expression    /* .. for 1 operand operators */
 
@@ -247,7 +248,7 @@ int urj_jam_yylex (void);
 #define UNARY_PLUS 279
 #endif // DELME_OLD_TOKEN_VALUES
 
-YYSTYPE urj_jam_yylval, urj_jam_yyval;
+URJ_THREAD_LOCAL YYSTYPE urj_jam_yylval, urj_jam_yyval;
 int32_t urj_jam_convert_bool_to_int (int32_t *data, int32_t msb, int32_t lsb);
 EXPN_STACK urj_jam_exp_eval (OPERATOR_TYPE otype, EXPN_STACK op1, EXPN_STACK op2);
 void urj_jam_exp_lexer (void);
@@ -848,7 +849,7 @@ urj_jam_exp_eval (OPERATOR_TYPE otype, YYSTYPE op1, YYSTYPE op2)
             ((op2.type == JAM_INTEGER_EXPR)
              || (op2.type == JAM_INT_OR_BOOL_EXPR)))
         {
-            symbol_rec = (JAMS_SYMBOL_RECORD *) op1.val;
+            symbol_rec = op1.symbol_rec;
             urj_jam_return_code =
                 urj_jam_get_array_value (symbol_rec, op2.val, &rtn.val);
 
@@ -917,7 +918,7 @@ urj_jam_exp_eval (OPERATOR_TYPE otype, YYSTYPE op1, YYSTYPE op2)
     case ARRAY_ALL:
         if (op1.type == JAM_ARRAY_REFERENCE)
         {
-            symbol_rec = (JAMS_SYMBOL_RECORD *) op1.val;
+            symbol_rec = op1.symbol_rec;
 
             if ((symbol_rec != NULL) &&
                 ((symbol_rec->type == JAM_BOOLEAN_ARRAY_WRITABLE) ||
@@ -1242,6 +1243,7 @@ urj_jam_yylex (void)
 /*                                                                      */
 {
     JAMS_SYMBOL_RECORD *symbol_rec = NULL;
+    JAMS_SYMBOL_RECORD *array_rec = NULL;
     int32_t val = 0L;
     JAME_EXPRESSION_TYPE type = JAM_ILLEGAL_EXPR_TYPE;
     int token_length;
@@ -1313,9 +1315,9 @@ urj_jam_yylex (void)
             case JAM_INTEGER_ARRAY_INITIALIZED:
             case JAM_BOOLEAN_ARRAY_INITIALIZED:
                 /* Success, swap token to be an ARRAY_TOK, */
-                /* save pointer to symbol record in value field */
+                /* save pointer to symbol record in symbol_rec field */
                 urj_jam_token = ARRAY_TOK;
-                val = (int32_t) symbol_rec;
+                array_rec = symbol_rec;
                 type = JAM_ARRAY_REFERENCE;
                 urj_jam_array_symbol_rec = symbol_rec;
                 break;
@@ -1340,6 +1342,7 @@ urj_jam_yylex (void)
     urj_jam_yylval.child_otype = 0;
     urj_jam_yylval.loper = 0;
     urj_jam_yylval.roper = 0;
+    urj_jam_yylval.symbol_rec = array_rec;
 
     return urj_jam_token;
 }
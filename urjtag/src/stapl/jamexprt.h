@@ -25,6 +25,8 @@
 #include <ctype.h>
 #include <string.h>
 
+#include <urjtag/types.h>
+
 /****************************************************************************/
 /*                                                                          */
 /*  Return codes from most JAM functions                                    */
@@ -59,6 +61,20 @@
 #define JAMC_SCOPE_ERROR       23
 #define JAMC_ACTION_NOT_FOUND  24
 
+/****************************************************************************/
+/*                                                                          */
+/*  Global variables                                                        */
+/*                                                                          */
+/****************************************************************************/
+
+/*
+ *  The player keeps its state in the globals of its modules; they are
+ *  per thread, so that players on different threads do not interfere.
+ */
+
+/* number of statements executed by the last call to urj_jam_execute() */
+extern URJ_THREAD_LOCAL uint32_t urj_jam_statement_count;
+
 /****************************************************************************/
 /*                                                                          */
 /*  Function Prototypes                                                     */
@@ -26,11 +26,15 @@
 /*                                                                          */
 /****************************************************************************/
 
-JAMS_HEAP_RECORD *urj_jam_heap = NULL;
+URJ_THREAD_LOCAL JAMS_HEAP_RECORD *urj_jam_heap = NULL;
 
-void *urj_jam_heap_top = NULL;
+URJ_THREAD_LOCAL void *urj_jam_heap_top = NULL;
 
-int32_t urj_jam_heap_records = 0L;
+URJ_THREAD_LOCAL int32_t urj_jam_heap_records = 0L;
+
+/* round a heap record size up so that the following record is aligned */
+#define JAM_HEAP_ALIGN(size) \
+    (((size) + sizeof (void *) - 1) & ~(sizeof (void *) - 1))
 
 /****************************************************************************/
 /*                                                                          */
@@ -65,8 +69,7 @@ urj_jam_init_heap (void)
         /*
          *      Check that there is some memory available for the heap
          */
-        if (((int32_t) urj_jam_heap) > (((int32_t) urj_jam_workspace_size) +
-                                    ((int32_t) urj_jam_workspace)))
+        if ((char *) urj_jam_heap > urj_jam_workspace + urj_jam_workspace_size)
         {
             status = JAMC_OUT_OF_MEMORY;
         }
@@ -175,21 +178,20 @@ JAM_RETURN_TYPE urj_jam_add_heap_record
         {
             heap_ptr = (JAMS_HEAP_RECORD *) urj_jam_heap_top;
 
-            urj_jam_heap_top = (void *) ((int32_t) heap_ptr +
-                                     (int32_t) sizeof (JAMS_HEAP_RECORD) +
-                                     space_needed);
+            /* keep the next record pointer-aligned on 64-bit hosts */
+            urj_jam_heap_top = (void *) ((char *) heap_ptr +
+                                     JAM_HEAP_ALIGN (sizeof (JAMS_HEAP_RECORD) +
+                                                     space_needed));
 
-            if ((int32_t) urj_jam_heap_top > (int32_t) urj_jam_symbol_bottom)
+            if ((char *) urj_jam_heap_top > (char *) urj_jam_symbol_bottom)
             {
                 status = JAMC_OUT_OF_MEMORY;
             }
         }
         else
         {
-            heap_ptr = (JAMS_HEAP_RECORD *) malloc ((unsigned int)
-                                                        (sizeof
-                                                         (JAMS_HEAP_RECORD) +
-                                                         space_needed));
+            heap_ptr = (JAMS_HEAP_RECORD *) malloc (sizeof (JAMS_HEAP_RECORD) +
+                                                    (size_t) space_needed);
 
             if (heap_ptr == NULL)
             {
@@ -210,6 +212,7 @@ JAM_RETURN_TYPE urj_jam_add_heap_record
         heap_ptr->symbol_record = symbol_record;
         heap_ptr->dimension = dimension;
         heap_ptr->cached = cached;
+        heap_ptr->deferred = false;
         heap_ptr->position = 0L;
 
         if (urj_jam_workspace != NULL)
@@ -257,14 +260,14 @@ urj_jam_get_temp_workspace (int32_t size)
 
     if (urj_jam_workspace != NULL)
     {
-        if (((int32_t) urj_jam_heap_top) + size <= (int32_t) urj_jam_symbol_bottom)
+        if ((char *) urj_jam_heap_top + size <= (char *) urj_jam_symbol_bottom)
         {
             temp_workspace = urj_jam_heap_top;
         }
     }
     else
     {
-        temp_workspace = malloc ((unsigned int) size);
+        temp_workspace = malloc ((size_t) size);
     }
 
     return temp_workspace;
@@ -49,6 +49,7 @@ typedef struct JAMS_HEAP_STRUCT
     JAMS_SYMBOL_RECORD *symbol_record;
     JAME_BOOLEAN_REP rep;       /* data representation format */
     BOOL cached;                /* true if array data is cached */
+    BOOL deferred;              /* true until ACA data is uncompressed */
     int32_t dimension;          /* number of elements in array */
     int32_t position;           /* position in file of initialization data */
     int32_t data[1];            /* first word of data (or cache buffer) */
@@ -61,9 +62,9 @@ typedef struct JAMS_HEAP_STRUCT
 /*                                                                          */
 /****************************************************************************/
 
-extern JAMS_HEAP_RECORD *urj_jam_heap;
+extern URJ_THREAD_LOCAL JAMS_HEAP_RECORD *urj_jam_heap;
 
-extern void *urj_jam_heap_top;
+extern URJ_THREAD_LOCAL void *urj_jam_heap_top;
 
 /****************************************************************************/
 /*                                                                          */
@@ -16,7 +16,7 @@
 #include "jamsym.h"
 #include "jamstack.h"
 #include <stdint.h>
-JAMS_STACK_RECORD *urj_jam_stack = 0;
+URJ_THREAD_LOCAL JAMS_STACK_RECORD *urj_jam_stack = 0;
 
 /****************************************************************************/
 /*                                                                          */
@@ -49,7 +49,7 @@ typedef struct
 /*                                                                          */
 /****************************************************************************/
 
-extern JAMS_STACK_RECORD *urj_jam_stack;
+extern URJ_THREAD_LOCAL JAMS_STACK_RECORD *urj_jam_stack;
 
 /****************************************************************************/
 /*                                                                          */
@@ -13,6 +13,10 @@
 /*                  structures.  Actual symbols now live at the top of the  */
 /*                  workspace, and grow dynamically downwards in memory.    */
 /*                                                                          */
+/*                  1.2 replaced the chained hash table by an open          */
+/*                  addressing table that grows on demand, and cached the   */
+/*                  results of USES list scope checks.                      */
+/*                                                                          */
 /****************************************************************************/
 
 #include <stdint.h>
@@ -21,6 +25,7 @@
 #include "jamsym.h"
 #include "jamheap.h"
 #include "jamutil.h"
+#include "jamarray.h"
 
 /****************************************************************************/
 /*                                                                          */
@@ -28,15 +33,41 @@
 /*                                                                          */
 /****************************************************************************/
 
-JAMS_SYMBOL_RECORD **urj_jam_symbol_table = NULL;
-
-void *urj_jam_symbol_bottom = NULL;
+URJ_THREAD_LOCAL JAMS_SYMBOL_RECORD **urj_jam_symbol_table = NULL;
+
+URJ_THREAD_LOCAL void *urj_jam_symbol_bottom = NULL;
+
+/*
+ *      The symbol table is an open addressing hash table with linear
+ *      probing.  Its size is a power of two.  With a workspace buffer the
+ *      table has a fixed size of JAMC_MAX_SYMBOL_COUNT slots; otherwise it
+ *      starts at JAMC_INITIAL_SYMBOL_COUNT slots and doubles whenever it
+ *      gets three quarters full.  All records are also kept on a list
+ *      through their "next" field, so they can be freed without scanning
+ *      the table.
+ */
+static URJ_THREAD_LOCAL int32_t jam_symbol_table_size = 0L;
+static URJ_THREAD_LOCAL int32_t jam_symbol_count = 0L;
+static URJ_THREAD_LOCAL JAMS_SYMBOL_RECORD *jam_symbol_list = NULL;
+
+/*
+ *      (block, parent) pairs already found to be in scope, so that symbols
+ *      of a DATA block referenced from a procedure do not need the USES
+ *      list to be parsed again on every reference.
+ */
+#define JAMC_SCOPE_CACHE_SIZE 8
+static URJ_THREAD_LOCAL struct
+{
+    JAMS_SYMBOL_RECORD *block;
+    JAMS_SYMBOL_RECORD *parent;
+} jam_scope_cache[JAMC_SCOPE_CACHE_SIZE];
+static URJ_THREAD_LOCAL int jam_scope_cache_next = 0;
 
 int urj_jam_init_symbol_table (void);
 void urj_jam_free_symbol_table (void);
 int urj_jam_check_init_list (char *name, int32_t *value);
-int urj_jam_hash (const char *name);
-int urj_jam_add_symbol (JAME_SYMBOL_TYPE type, char *name, int32_t value,
+uint32_t urj_jam_hash (const char *name);
+int urj_jam_add_symbol (JAME_SYMBOL_TYPE type, char *name, intptr_t value,
                     int32_t position);
 int urj_jam_get_symbol_record (char *name, JAMS_SYMBOL_RECORD **symbol_record);
 int urj_jam_get_symbol_value (JAME_SYMBOL_TYPE type, char *name, int32_t *value);
@@ -57,15 +88,20 @@ urj_jam_init_symbol_table (void)
 /*                                                                          */
 /****************************************************************************/
 {
-    int index = 0;
     JAM_RETURN_TYPE status = JAMC_SUCCESS;
 
+    jam_symbol_count = 0L;
+    jam_symbol_list = NULL;
+    jam_scope_cache_next = 0;
+    memset (jam_scope_cache, 0, sizeof (jam_scope_cache));
+
     if (urj_jam_workspace != NULL)
     {
         urj_jam_symbol_table = (JAMS_SYMBOL_RECORD **) urj_jam_workspace;
+        jam_symbol_table_size = JAMC_MAX_SYMBOL_COUNT;
 
-        urj_jam_symbol_bottom = (void *) (((int32_t) urj_jam_workspace) +
-                                      ((int32_t) urj_jam_workspace_size));
+        urj_jam_symbol_bottom = (void *) (urj_jam_workspace +
+                                          urj_jam_workspace_size);
 
         if (urj_jam_workspace_size < (JAMC_MAX_SYMBOL_COUNT * sizeof (void *)))
         {
@@ -74,9 +110,9 @@ urj_jam_init_symbol_table (void)
     }
     else
     {
-        urj_jam_symbol_table =
-            (JAMS_SYMBOL_RECORD **)
-            malloc ((JAMC_MAX_SYMBOL_COUNT * sizeof (void *)));
+        jam_symbol_table_size = JAMC_INITIAL_SYMBOL_COUNT;
+        urj_jam_symbol_table = (JAMS_SYMBOL_RECORD **)
+            malloc (jam_symbol_table_size * sizeof (void *));
 
         if (urj_jam_symbol_table == NULL)
         {
@@ -86,10 +122,8 @@ urj_jam_init_symbol_table (void)
 
     if (status == JAMC_SUCCESS)
     {
-        for (index = 0; index < JAMC_MAX_SYMBOL_COUNT; ++index)
-        {
-            urj_jam_symbol_table[index] = NULL;
-        }
+        memset (urj_jam_symbol_table, 0,
+                jam_symbol_table_size * sizeof (void *));
     }
 
     return status;
@@ -98,25 +132,69 @@ urj_jam_init_symbol_table (void)
 void
 urj_jam_free_symbol_table (void)
 {
-    int hash = 0;
     JAMS_SYMBOL_RECORD *symbol_record = NULL;
     JAMS_SYMBOL_RECORD *next = NULL;
 
     if ((urj_jam_symbol_table != NULL) && (urj_jam_workspace == NULL))
     {
-        for (hash = 0; hash < JAMC_MAX_SYMBOL_COUNT; ++hash)
+        symbol_record = jam_symbol_list;
+        while (symbol_record != NULL)
         {
-            symbol_record = urj_jam_symbol_table[hash];
-            while (symbol_record != NULL)
-            {
-                next = symbol_record->next;
-                free (symbol_record);
-                symbol_record = next;
-            }
+            next = symbol_record->next;
+            free (symbol_record);
+            symbol_record = next;
         }
 
         free (urj_jam_symbol_table);
     }
+
+    urj_jam_symbol_table = NULL;
+    jam_symbol_list = NULL;
+    jam_symbol_count = 0L;
+}
+
+/****************************************************************************/
+/*                                                                          */
+
+static JAM_RETURN_TYPE
+urj_jam_grow_symbol_table (void)
+/*                                                                          */
+/*  Description:    Doubles the size of the symbol table and re-inserts     */
+/*                  all symbol records.  Only used without a workspace      */
+/*                  buffer.                                                 */
+/*                                                                          */
+/*  Returns:        JAMC_SUCCESS for success, or JAMC_OUT_OF_MEMORY         */
+/*                                                                          */
+/****************************************************************************/
+{
+    int32_t size = jam_symbol_table_size * 2;
+    int32_t slot = 0L;
+    JAMS_SYMBOL_RECORD **table = NULL;
+    JAMS_SYMBOL_RECORD *symbol_record = NULL;
+
+    table = (JAMS_SYMBOL_RECORD **) calloc ((size_t) size, sizeof (void *));
+
+    if (table == NULL)
+    {
+        return JAMC_OUT_OF_MEMORY;
+    }
+
+    for (symbol_record = jam_symbol_list; symbol_record != NULL;
+         symbol_record = symbol_record->next)
+    {
+        slot = (int32_t) (symbol_record->hash & (uint32_t) (size - 1));
+        while (table[slot] != NULL)
+        {
+            slot = (slot + 1) & (size - 1);
+        }
+        table[slot] = symbol_record;
+    }
+
+    free (urj_jam_symbol_table);
+    urj_jam_symbol_table = table;
+    jam_symbol_table_size = size;
+
+    return JAMC_SUCCESS;
 }
 
 /****************************************************************************/
@@ -204,38 +282,73 @@ urj_jam_check_init_list (char *name, int32_t *value)
 /****************************************************************************/
 /*                                                                          */
 
-int
+uint32_t
 urj_jam_hash (const char *name)
 /*                                                                          */
-/*  Description:    Calcluates 'hash value' for a symbolic name.  This is   */
-/*                  a pseudo-random number which is used as an offset into  */
-/*                  the symbol table, as the initial position for the       */
-/*                  symbol record.                                          */
+/*  Description:    Calculates 'hash value' for a symbolic name:  32-bit    */
+/*                  FNV-1a followed by a final avalanche step, so that the  */
+/*                  low bits used to index the table are well mixed.        */
 /*                                                                          */
-/*  Returns:        An integer between 0 and JAMC_MAX_SYMBOL_COUNT-1        */
+/*  Returns:        32-bit hash value                                       */
 /*                                                                          */
 /****************************************************************************/
 {
     int ch_index = 0;
-    int hash = 0;
+    uint32_t hash = 2166136261U;
 
     while ((ch_index < JAMC_MAX_NAME_LENGTH) && (name[ch_index] != '\0'))
     {
-        hash <<= 1;
-        hash += (name[ch_index] & 0x1f);
+        hash ^= (unsigned char) name[ch_index];
+        hash *= 16777619U;
         ++ch_index;
     }
-    if (hash < 0)
-        hash = 0 - hash;
 
-    return hash % JAMC_MAX_SYMBOL_COUNT;
+    hash ^= hash >> 16;
+    hash *= 0x85ebca6bU;
+    hash ^= hash >> 13;
+    hash *= 0xc2b2ae35U;
+    hash ^= hash >> 16;
+
+    return hash;
+}
+
+/****************************************************************************/
+/*                                                                          */
+
+static JAMS_SYMBOL_RECORD **
+urj_jam_find_symbol_slot (const char *name, uint32_t hash)
+/*                                                                          */
+/*  Description:    Probes the symbol table for "name".                     */
+/*                                                                          */
+/*  Returns:        Pointer to the slot holding the symbol record, or to    */
+/*                  the empty slot where it would be inserted.              */
+/*                                                                          */
+/****************************************************************************/
+{
+    int32_t mask = jam_symbol_table_size - 1;
+    int32_t slot = (int32_t) (hash & (uint32_t) mask);
+    JAMS_SYMBOL_RECORD *symbol_record = NULL;
+
+    while ((symbol_record = urj_jam_symbol_table[slot]) != NULL)
+    {
+        if ((symbol_record->hash == hash) &&
+            ((symbol_record->name == name) ||
+             (strcmp (symbol_record->name, name) == 0)))
+        {
+            break;
+        }
+
+        slot = (slot + 1) & mask;
+    }
+
+    return &urj_jam_symbol_table[slot];
 }
 
 /****************************************************************************/
 /*                                                                          */
 
 JAM_RETURN_TYPE urj_jam_add_symbol
-    (JAME_SYMBOL_TYPE type, char *name, int32_t value, int32_t position)
+    (JAME_SYMBOL_TYPE type, char *name, intptr_t value, int32_t position)
 /*                                                                          */
 /*  Description:    Adds a new symbol to the symbol table.  If the symbol   */
 /*                  name already exists in the symbol table, it is an error */
@@ -251,15 +364,13 @@ JAM_RETURN_TYPE urj_jam_add_symbol
 /*                                                                          */
 /****************************************************************************/
 {
-    char r, l;
     int ch_index = 0;
-    int hash = 0;
+    uint32_t hash = 0;
     int32_t init_list_value = 0L;
-    int match = false;
     int identical_redeclaration = false;
     JAM_RETURN_TYPE status = JAMC_SUCCESS;
     JAMS_SYMBOL_RECORD *symbol_record = NULL;
-    JAMS_SYMBOL_RECORD *prev_symbol_record = NULL;
+    JAMS_SYMBOL_RECORD **slot = NULL;
 
     /*
      *      Check for legal characters in name, and legal name length
@@ -276,85 +387,64 @@ JAM_RETURN_TYPE urj_jam_add_symbol
     }
 
     /*
-     *      Get hash key for this name
-     */
-    hash = urj_jam_hash (name);
-
-    /*
-     *      Get pointer to first symbol record corresponding to this hash key
+     *      Get hash key for this name, and look for a duplicate entry
      */
-    symbol_record = urj_jam_symbol_table[hash];
+    if (status == JAMC_SUCCESS)
+    {
+        hash = urj_jam_hash (name);
+        slot = urj_jam_find_symbol_slot (name, hash);
+        symbol_record = *slot;
+    }
 
-    /*
-     *      Then check for duplicate entry in symbol table
-     */
-    while ((status == JAMC_SUCCESS) && (symbol_record != NULL) &&
-           (!identical_redeclaration))
+    if ((status == JAMC_SUCCESS) && (symbol_record != NULL))
     {
-        match = true;
-        ch_index = 0;
-        do
+        /*
+         *      Check if symbol was already declared identically
+         *      (same name, type, and source position)
+         */
+        if ((symbol_record->position == position) &&
+            (urj_jam_phase == JAM_DATA_PHASE))
         {
-            r = symbol_record->name[ch_index];
-            l = name[ch_index];
-            match = (r == l);
-            ++ch_index;
+            if ((type == JAM_INTEGER_ARRAY_WRITABLE) &&
+                (symbol_record->type == JAM_INTEGER_ARRAY_INITIALIZED))
+            {
+                type = JAM_INTEGER_ARRAY_INITIALIZED;
+            }
+
+            if ((type == JAM_BOOLEAN_ARRAY_WRITABLE) &&
+                (symbol_record->type == JAM_BOOLEAN_ARRAY_INITIALIZED))
+            {
+                type = JAM_BOOLEAN_ARRAY_INITIALIZED;
+            }
         }
-        while (match && (r != '\0') && (l != '\0'));
 
-        if (match)
+        if ((symbol_record->type == type) &&
+            (symbol_record->position == position))
         {
             /*
-             *      Check if symbol was already declared identically
-             *      (same name, type, and source position)
+             *      For identical redeclaration, simply assign the value
              */
-            if ((symbol_record->position == position) &&
-                (urj_jam_phase == JAM_DATA_PHASE))
-            {
-                if ((type == JAM_INTEGER_ARRAY_WRITABLE) &&
-                    (symbol_record->type == JAM_INTEGER_ARRAY_INITIALIZED))
-                {
-                    type = JAM_INTEGER_ARRAY_INITIALIZED;
-                }
+            identical_redeclaration = true;
 
-                if ((type == JAM_BOOLEAN_ARRAY_WRITABLE) &&
-                    (symbol_record->type == JAM_BOOLEAN_ARRAY_INITIALIZED))
-                {
-                    type = JAM_BOOLEAN_ARRAY_INITIALIZED;
-                }
+            if (urj_jam_version != 2)
+            {
+                symbol_record->value = value;
             }
-
-            if ((symbol_record->type == type) &&
-                (symbol_record->position == position))
+            else
             {
-                /*
-                 *      For identical redeclaration, simply assign the value
-                 */
-                identical_redeclaration = true;
-
-                if (urj_jam_version != 2)
+                if ((type != JAM_PROCEDURE_BLOCK) &&
+                    (type != JAM_DATA_BLOCK) &&
+                    (urj_jam_current_block != NULL) &&
+                    (urj_jam_current_block->type == JAM_PROCEDURE_BLOCK))
                 {
                     symbol_record->value = value;
                 }
-                else
-                {
-                    if ((type != JAM_PROCEDURE_BLOCK) &&
-                        (type != JAM_DATA_BLOCK) &&
-                        (urj_jam_current_block != NULL) &&
-                        (urj_jam_current_block->type == JAM_PROCEDURE_BLOCK))
-                    {
-                        symbol_record->value = value;
-                    }
-                }
-            }
-            else
-            {
-                status = JAMC_REDEFINED_SYMBOL;
             }
         }
-
-        prev_symbol_record = symbol_record;
-        symbol_record = symbol_record->next;
+        else
+        {
+            status = JAMC_REDEFINED_SYMBOL;
+        }
     }
 
     /*
@@ -379,21 +469,43 @@ JAM_RETURN_TYPE urj_jam_add_symbol
         }
 
         /*
-         *      Add the symbol
+         *      Make room in the table: a fixed table must keep one empty
+         *      slot to terminate probing, a dynamic one is kept at most
+         *      three quarters full.
          */
         if (urj_jam_workspace != NULL)
+        {
+            if (jam_symbol_count + 1 >= jam_symbol_table_size)
+            {
+                status = JAMC_OUT_OF_MEMORY;
+            }
+        }
+        else if ((jam_symbol_count + 1) * 4 > jam_symbol_table_size * 3)
+        {
+            status = urj_jam_grow_symbol_table ();
+
+            if (status == JAMC_SUCCESS)
+            {
+                slot = urj_jam_find_symbol_slot (name, hash);
+            }
+        }
+
+        /*
+         *      Add the symbol
+         */
+        if ((status == JAMC_SUCCESS) && (urj_jam_workspace != NULL))
         {
             urj_jam_symbol_bottom = (void *)
-                (((int32_t) urj_jam_symbol_bottom) - sizeof (JAMS_SYMBOL_RECORD));
+                ((char *) urj_jam_symbol_bottom - sizeof (JAMS_SYMBOL_RECORD));
 
             symbol_record = (JAMS_SYMBOL_RECORD *) urj_jam_symbol_bottom;
 
-            if ((int32_t) urj_jam_heap_top > (int32_t) urj_jam_symbol_bottom)
+            if ((char *) urj_jam_heap_top > (char *) urj_jam_symbol_bottom)
             {
                 status = JAMC_OUT_OF_MEMORY;
             }
         }
-        else
+        else if (status == JAMC_SUCCESS)
         {
             symbol_record = (JAMS_SYMBOL_RECORD *)
                 malloc (sizeof (JAMS_SYMBOL_RECORD));
@@ -410,25 +522,15 @@ JAM_RETURN_TYPE urj_jam_add_symbol
             symbol_record->value = value;
             symbol_record->position = position;
             symbol_record->parent = urj_jam_current_block;
-            symbol_record->next = NULL;
+            symbol_record->hash = hash;
+            symbol_record->next = jam_symbol_list;
+            jam_symbol_list = symbol_record;
 
-            if (prev_symbol_record == NULL)
-            {
-                urj_jam_symbol_table[hash] = symbol_record;
-            }
-            else
-            {
-                prev_symbol_record->next = symbol_record;
-            }
+            /* ch_index is the length of the name, checked above */
+            memcpy (symbol_record->name, name, (size_t) ch_index + 1);
 
-            ch_index = 0;
-            while ((ch_index < JAMC_MAX_NAME_LENGTH) &&
-                   (name[ch_index] != '\0'))
-            {
-                symbol_record->name[ch_index] = name[ch_index];
-                ++ch_index;
-            }
-            symbol_record->name[ch_index] = '\0';
+            *slot = symbol_record;
+            ++jam_symbol_count;
         }
     }
 
@@ -448,50 +550,22 @@ JAM_RETURN_TYPE urj_jam_get_symbol_record
 /*                                                                          */
 /****************************************************************************/
 {
-    char r, l;
     char save_ch = 0;
     int ch_index = 0;
-    int hash = 0;
     int name_begin = 0;
     int name_end = 0;
-    int match = false;
+    int i = 0;
     JAMS_SYMBOL_RECORD *tmp_symbol_record = NULL;
     JAM_RETURN_TYPE status = JAMC_UNDEFINED_SYMBOL;
 
-    /*
-     *      Get hash key for this name
-     */
-    hash = urj_jam_hash (name);
-
-    /*
-     *      Get pointer to first symbol record corresponding to this hash key
-     */
-    tmp_symbol_record = urj_jam_symbol_table[hash];
-
     /*
      *      Search for name in symbol table
      */
-    while ((!match) && (tmp_symbol_record != NULL))
-    {
-        match = true;
-        ch_index = 0;
-        do
-        {
-            r = tmp_symbol_record->name[ch_index];
-            l = name[ch_index];
-            match = (r == l);
-            ++ch_index;
-        }
-        while (match && (r != '\0') && (l != '\0'));
+    tmp_symbol_record = *urj_jam_find_symbol_slot (name, urj_jam_hash (name));
 
-        if (match)
-        {
-            status = JAMC_SUCCESS;
-        }
-        else
-        {
-            tmp_symbol_record = tmp_symbol_record->next;
-        }
+    if (tmp_symbol_record != NULL)
+    {
+        status = JAMC_SUCCESS;
     }
 
     /*
@@ -531,6 +605,18 @@ JAM_RETURN_TYPE urj_jam_get_symbol_record
                 parent_name = parent->name;
             }
 
+            /* USES lists do not change, so earlier results can be reused */
+            for (i = 0; i < JAMC_SCOPE_CACHE_SIZE; ++i)
+            {
+                if ((jam_scope_cache[i].parent == parent) &&
+                    (jam_scope_cache[i].block == urj_jam_current_block))
+                {
+                    status = JAMC_SUCCESS;
+                    parent_name = NULL;
+                    break;
+                }
+            }
+
             if ((urj_jam_current_block != NULL) &&
                 (urj_jam_current_block->type == JAM_PROCEDURE_BLOCK))
             {
@@ -579,6 +665,15 @@ JAM_RETURN_TYPE urj_jam_get_symbol_record
                         uses_list[name_end] = save_ch;
                     }
                 }
+
+                if (status == JAMC_SUCCESS)
+                {
+                    jam_scope_cache[jam_scope_cache_next].block =
+                        urj_jam_current_block;
+                    jam_scope_cache[jam_scope_cache_next].parent = parent;
+                    jam_scope_cache_next =
+                        (jam_scope_cache_next + 1) % JAMC_SCOPE_CACHE_SIZE;
+                }
             }
         }
     }
@@ -594,6 +689,18 @@ JAM_RETURN_TYPE urj_jam_get_symbol_record
             *symbol_record = tmp_symbol_record;
         }
     }
+
+    /*
+     *      Compressed arrays are uncompressed when first referenced
+     */
+    if ((status == JAMC_SUCCESS) &&
+        (tmp_symbol_record->type == JAM_BOOLEAN_ARRAY_INITIALIZED) &&
+        (tmp_symbol_record->value != 0))
+    {
+        status = urj_jam_load_deferred_array ((JAMS_HEAP_RECORD *)
+                                              tmp_symbol_record->value);
+    }
+
     return status;
 }
 
@@ -625,7 +732,7 @@ JAM_RETURN_TYPE urj_jam_get_symbol_value
         {
             if (value != NULL)
             {
-                *value = symbol_record->value;
+                *value = (int32_t) symbol_record->value;
             }
             else
             {
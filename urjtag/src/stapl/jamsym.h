@@ -42,10 +42,11 @@ typedef struct JAMS_SYMBOL_STRUCT
 {
     char name[JAMC_MAX_NAME_LENGTH + 1];
     JAME_SYMBOL_TYPE type;
-    int32_t value;
+    intptr_t value;             /* scalar value, or heap record pointer */
     int32_t position;
     struct JAMS_SYMBOL_STRUCT *parent;
-    struct JAMS_SYMBOL_STRUCT *next;
+    struct JAMS_SYMBOL_STRUCT *next;    /* next record allocated */
+    uint32_t hash;              /* urj_jam_hash() of name */
 } JAMS_SYMBOL_RECORD;
 
 /****************************************************************************/
@@ -54,15 +55,15 @@ typedef struct JAMS_SYMBOL_STRUCT
 /*                                                                          */
 /****************************************************************************/
 
-extern JAMS_SYMBOL_RECORD **urj_jam_symbol_table;
+extern URJ_THREAD_LOCAL JAMS_SYMBOL_RECORD **urj_jam_symbol_table;
 
-extern void *urj_jam_symbol_bottom;
+extern URJ_THREAD_LOCAL void *urj_jam_symbol_bottom;
 
-extern JAMS_SYMBOL_RECORD *urj_jam_current_block;
+extern URJ_THREAD_LOCAL JAMS_SYMBOL_RECORD *urj_jam_current_block;
 
-extern int urj_jam_version;
+extern URJ_THREAD_LOCAL int urj_jam_version;
 
-extern BOOL urj_jam_checking_uses_list;
+extern URJ_THREAD_LOCAL BOOL urj_jam_checking_uses_list;
 
 /****************************************************************************/
 /*                                                                          */
@@ -75,7 +76,7 @@ JAM_RETURN_TYPE urj_jam_init_symbol_table (void);
 void urj_jam_free_symbol_table (void);
 
 JAM_RETURN_TYPE urj_jam_add_symbol
-    (JAME_SYMBOL_TYPE type, char *name, int32_t value, int32_t position);
+    (JAME_SYMBOL_TYPE type, char *name, intptr_t value, int32_t position);
 
 JAM_RETURN_TYPE urj_jam_get_symbol_value
     (JAME_SYMBOL_TYPE type, char *name, int32_t *value);
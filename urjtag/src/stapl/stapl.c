@@ -22,6 +22,8 @@
  *
  */
 
+#include <sysdep.h>
+
 #include <stdbool.h>
 #include <stdlib.h>
 #include <sys/stat.h>
@@ -31,18 +33,28 @@
 #include "jamutil.h"
 #include <urjtag/chain.h>
 #include <urjtag/cable.h>
+#include <urjtag/stapl.h>
 
 /***********************************************************************
 *   Global variables
 ***********************************************************************/
-/* UrJTAG */
-static urj_cable_t *current_cable;
-static urj_chain_t *current_chain;
+/* state of one urj_stapl_run() call */
+typedef struct
+{
+    urj_chain_t *chain;
+    urj_cable_t *cable;
+    /* file buffer for JAM input file */
+    char *file_buffer;
+    int32_t file_pointer;
+    int32_t file_length;
+}
+stapl_context_t;
 
-/* file buffer for JAM input file */
-static char *file_buffer = NULL;
-static int32_t file_pointer = 0L;
-static int32_t file_length = 0L;
+/* the run in progress on this thread, for the callbacks of the player */
+static URJ_THREAD_LOCAL stapl_context_t *context;
+
+/* statistics of the last run in this thread */
+static URJ_THREAD_LOCAL urj_stapl_stats_t run_stats;
 
 int urj_jam_getc (void);
 int urj_jam_seek (int32_t offset);
@@ -54,15 +66,16 @@ void urj_jam_export_boolean_array (char *key, unsigned char *data, int32_t count
 void urj_jam_flush_and_delay (int32_t microseconds);
 int urj_stapl_run (urj_chain_t *chain, char *STAPL_file_name,
                    char *STAPL_action);
+void urj_stapl_get_stats (urj_stapl_stats_t *stats);
 
 int
 urj_jam_getc (void)
 {
     int ch = EOF;
 
-    if (file_pointer < file_length)
+    if (context->file_pointer < context->file_length)
     {
-        ch = (int) file_buffer[file_pointer++];
+        ch = (int) context->file_buffer[context->file_pointer++];
     }
 
     return ch;
@@ -73,9 +86,9 @@ urj_jam_seek (int32_t offset)
 {
     int return_code = EOF;
 
-    if ((offset >= 0L) && (offset < file_length))
+    if ((offset >= 0L) && (offset < context->file_length))
     {
-        file_pointer = offset;
+        context->file_pointer = offset;
         return_code = 0;
     }
 
@@ -90,11 +103,11 @@ urj_jam_jtag_io (int tms, int tdi, int read_tdo)
 
     if (read_tdo)
     {
-        urj_tap_cable_defer_get_tdo (current_cable);
-        tdo = urj_tap_cable_get_tdo_late (current_cable);
+        urj_tap_cable_defer_get_tdo (context->cable);
+        tdo = urj_tap_cable_get_tdo_late (context->cable);
     }
 
-    urj_tap_chain_defer_clock (current_chain, tms ? 0x01 : 0, tdi ? 0x01 : 0,
+    urj_tap_chain_defer_clock (context->chain, tms ? 0x01 : 0, tdi ? 0x01 : 0,
                                1);
 
     return tdo;
@@ -109,6 +122,8 @@ urj_jam_jtag_io_transfer (int count, char *tdi, char *tdo)
     char *temp_in;
     char *temp_out;
 
+    run_stats.scan_bits += count;
+
     // if no data are requested, only schedule tdo transmit
     if (tdo == NULL)
     {
@@ -133,19 +148,19 @@ urj_jam_jtag_io_transfer (int count, char *tdi, char *tdo)
             }
 
             /* loop in the SHIFT-DR(IR) state, TMS set to 0 */
-            urj_tap_cable_defer_transfer (current_cable, count - 1,
+            urj_tap_cable_defer_transfer (context->cable, count - 1,
                                           temp_in, temp_out);
 
 
             // get the last bit in register and change TMS to 1
-            urj_tap_cable_defer_get_tdo (current_cable);
-            urj_tap_chain_defer_clock (current_chain, 1, temp_in[count - 1],
+            urj_tap_cable_defer_get_tdo (context->cable);
+            urj_tap_chain_defer_clock (context->chain, 1, temp_in[count - 1],
                                        1);
 
-            urj_tap_cable_flush (current_cable, URJ_TAP_CABLE_COMPLETELY);
+            urj_tap_cable_flush (context->cable, URJ_TAP_CABLE_COMPLETELY);
 
-            urj_tap_cable_transfer_late (current_cable, temp_out);
-            temp_out[count - 1] = urj_tap_cable_get_tdo_late (current_cable);
+            urj_tap_cable_transfer_late (context->cable, temp_out);
+            temp_out[count - 1] = urj_tap_cable_get_tdo_late (context->cable);
 
 
             // code bits back into bytes for Jam STAPL Player
@@ -268,7 +283,7 @@ urj_jam_export_boolean_array (char *key, unsigned char *data, int32_t count)
 void
 urj_jam_flush_and_delay (int32_t microseconds)
 {
-    urj_tap_cable_flush (current_cable, URJ_TAP_CABLE_COMPLETELY);
+    urj_tap_cable_flush (context->cable, URJ_TAP_CABLE_COMPLETELY);
     usleep (microseconds);
 }
 
@@ -386,8 +401,11 @@ urj_stapl_run (urj_chain_t *chain, char *STAPL_file_name, char *STAPL_action)
     int32_t workspace_size = 0;
     const char *exit_string = NULL;
     int reset_jtag = 1;
+    stapl_context_t ctx = { 0 };
 
     init_list[0] = NULL;
+    memset (&run_stats, 0, sizeof run_stats);
+    run_stats.exec_result = JAMC_IO_ERROR;
 
     /* print out the version string and copyright message */
     urj_log (URJ_LOG_LEVEL_NORMAL,
@@ -417,8 +435,9 @@ urj_stapl_run (urj_chain_t *chain, char *STAPL_file_name, char *STAPL_action)
     }
     else
     {
-        current_chain = chain;
-        current_cable = chain->cable;
+        ctx.chain = chain;
+        ctx.cable = chain->cable;
+        context = &ctx;
     }
 
     if (help || (filename == NULL))
@@ -444,7 +463,7 @@ urj_stapl_run (urj_chain_t *chain, char *STAPL_file_name, char *STAPL_action)
     {
         /* get length of file */
         if (stat (filename, &sbuf) == 0)
-            file_length = sbuf.st_size;
+            ctx.file_length = sbuf.st_size;
 
         if ((fp = fopen (filename, "rb")) == NULL)
         {
@@ -458,19 +477,19 @@ urj_stapl_run (urj_chain_t *chain, char *STAPL_file_name, char *STAPL_action)
              *  Read entire file into a buffer
              */
 
-            file_buffer = (char *) malloc ((size_t) file_length);
+            ctx.file_buffer = (char *) malloc ((size_t) ctx.file_length);
 
-            if (file_buffer == NULL)
+            if (ctx.file_buffer == NULL)
             {
                 urj_log (URJ_LOG_LEVEL_ERROR,
                          "Error: can't allocate memory (%d Kbytes)\n",
-                         (int) (file_length / 1024L));
+                         (int) (ctx.file_length / 1024L));
                 exit_status = 1;
             }
             else
             {
-                if (fread (file_buffer, 1, (size_t) file_length, fp) !=
-                    (size_t) file_length)
+                if (fread (ctx.file_buffer, 1, (size_t) ctx.file_length, fp) !=
+                    (size_t) ctx.file_length)
                 {
                     urj_log (URJ_LOG_LEVEL_ERROR,
                              "Error reading file \"%s\"\n", filename);
@@ -486,7 +505,7 @@ urj_stapl_run (urj_chain_t *chain, char *STAPL_file_name, char *STAPL_action)
             /*
              *  Check CRC
              */
-            crc_result = urj_jam_check_crc (file_buffer, file_length,
+            crc_result = urj_jam_check_crc (ctx.file_buffer, ctx.file_length,
                                         &expected_crc, &actual_crc);
 
             switch (crc_result)
@@ -518,7 +537,7 @@ urj_stapl_run (urj_chain_t *chain, char *STAPL_file_name, char *STAPL_action)
             /*
              *  Dump out NOTE fields
              */
-            while (urj_jam_get_note (file_buffer, file_length,
+            while (urj_jam_get_note (ctx.file_buffer, ctx.file_length,
                                  &offset, key, value, 256) == 0)
             {
                 urj_log (URJ_LOG_LEVEL_DETAIL, "NOTE \"%s\" = \"%s\"\n", key,
@@ -528,13 +547,17 @@ urj_stapl_run (urj_chain_t *chain, char *STAPL_file_name, char *STAPL_action)
             // Execute the JAM program
             time (&start_time);
 
-            exec_result = urj_jam_execute (file_buffer, file_length,
+            exec_result = urj_jam_execute (ctx.file_buffer, ctx.file_length,
                                        workspace, workspace_size, action,
                                        init_list, reset_jtag, &error_line,
                                        &exit_code, &format_version);
 
             time (&end_time);
 
+            run_stats.exec_result = exec_result;
+            run_stats.exit_code = exit_code;
+            run_stats.statements = urj_jam_statement_count;
+
             if (exec_result == JAMC_SUCCESS)
             {
                 if (format_version == 2)
@@ -590,10 +613,17 @@ urj_stapl_run (urj_chain_t *chain, char *STAPL_file_name, char *STAPL_action)
 
     if (workspace != NULL)
         free (workspace);
-    if (file_buffer != NULL)
-        free (file_buffer);
+    if (ctx.file_buffer != NULL)
+        free (ctx.file_buffer);
+    context = NULL;
 
     urj_log (URJ_LOG_LEVEL_NORMAL, "STAPL execution finished \n");
 
     return URJ_STATUS_OK;
 }
+
+void
+urj_stapl_get_stats (urj_stapl_stats_t *stats)
+{
+    *stats = run_stats;
+}
@@ -33,12 +33,8 @@
 #include <string.h>
 #include <ctype.h>
 #include <math.h>
-#include <signal.h>
 #include <unistd.h>
 #include <sys/types.h>
-#ifndef SA_ONESHOT
-#define SA_ONESHOT SA_RESETHAND
-#endif
 
 #include <urjtag/error.h>
 #include <urjtag/cable.h>
@@ -64,6 +60,9 @@
    Better buffering is achieved with urj_tap_chain_defer_clock. */
 #define CHAIN_CLOCK urj_tap_chain_defer_clock
 
+/* TDO mismatches of the last urj_svf_run() in this thread */
+static URJ_THREAD_LOCAL int svf_mismatches;
+
 /* define for debug messages */
 #undef DEBUG
 
@@ -483,6 +482,7 @@ urj_svf_compare_tdo (urj_svf_parser_priv_t *priv, char *tdo, char *mask,
         urj_log (URJ_LOG_LEVEL_DEBUG, "Mask     : %s\n", mask_bit);
         urj_log (URJ_LOG_LEVEL_DEBUG, "TDO data : %s\n", reg->string);
 
+        priv->mismatch_occurred++;
         if (priv->svf_stop_on_mismatch)
             result = URJ_STATUS_FAIL;
     }
@@ -627,16 +627,6 @@ urj_svf_hxr (enum generic_irdr_coding ir_dr, struct ths_params *params)
     return URJ_STATUS_OK;
 }
 
-#ifdef HAVE_SIGACTION_SA_ONESHOT
-static int max_time_reached;
-static void
-sigalrm_handler (int signal)
-{
-    max_time_reached = 1;
-}
-#endif
-
-
 /* ***************************************************************************
  * urj_svf_runtest(params)
  *
@@ -717,10 +707,11 @@ urj_svf_runtest (urj_chain_t *chain, urj_svf_parser_priv_t *priv,
 
     urj_svf_goto_state (chain, priv->runtest_run_state);
 
-#ifndef HAVE_SIGACTION_SA_ONESHOT
+    /* MAXIMUM is a deadline of this player alone, as several of them may
+       run at once in threads of their own */
     if (params->max_time > 0.0)
     {
-        double maxt = urj_lib_frealtime () + params->max_time;
+        long double maxt = urj_lib_frealtime () + params->max_time;
 
         while (run_count-- > 0 && urj_lib_frealtime () < maxt)
         {
@@ -732,55 +723,6 @@ urj_svf_runtest (urj_chain_t *chain, urj_svf_parser_priv_t *priv,
 
     urj_svf_goto_state (chain, priv->runtest_end_state);
 
-#else
-    /* set up the timer for max_time */
-    if (params->max_time > 0.0)
-    {
-        struct sigaction sa;
-        unsigned max_time;
-
-        sa.sa_handler = sigalrm_handler;
-        sa.sa_flags = SA_ONESHOT;
-        sigemptyset (&sa.sa_mask);
-        if (sigaction (SIGALRM, &sa, NULL) != 0)
-        {
-            perror ("sigaction");
-            exit (EXIT_FAILURE);
-        }
-
-        max_time = floor (params->max_time / 1000000);
-        if (max_time == 0)
-        {
-            max_time = 1;
-        }
-        ualarm (max_time, 0);
-    }
-
-    if (params->max_time > 0.0)
-        while (run_count-- > 0 && !max_time_reached)
-        {
-            urj_tap_chain_clock (chain, 0, 0, 1);
-        }
-    else
-        CHAIN_CLOCK (chain, 0, 0, run_count);
-
-    urj_svf_goto_state (chain, priv->runtest_end_state);
-
-    /* stop the timer */
-    if (params->max_time > 0.0)
-    {
-        struct sigaction sa;
-        sa.sa_handler = SIG_IGN;
-        sa.sa_flags = 0;
-        sigemptyset (&sa.sa_mask);
-        if (sigaction (SIGALRM, &sa, NULL) != 0)
-        {
-            perror ("sigaction");
-            exit (EXIT_FAILURE);
-        }
-    }
-#endif
-
     return URJ_STATUS_OK;
 }
 
@@ -975,10 +917,6 @@ urj_svf_sxr (urj_chain_t *chain, urj_svf_parser_priv_t *priv,
         break;
     }
 
-    /* log mismatches */
-    if (result != URJ_STATUS_OK)
-        priv->mismatch_occurred = 1;
-
     return result;
 }
 
@@ -1116,6 +1054,8 @@ urj_svf_run (urj_chain_t *chain, FILE *SVF_FILE, int stop_on_mismatch,
     int num_lines;
     uint32_t old_frequency;
 
+    svf_mismatches = 0;
+
     if (chain == NULL || chain->cable == NULL)
         return  URJ_STATUS_FAIL;
 
@@ -1240,6 +1180,7 @@ urj_svf_run (urj_chain_t *chain, FILE *SVF_FILE, int stop_on_mismatch,
         urj_svf_bison_deinit (&priv);
     }
 
+    svf_mismatches = priv.mismatch_occurred;
     if (priv.mismatch_occurred > 0)
         urj_log (URJ_LOG_LEVEL_DETAIL,
                  _("Mismatches occurred between scanned device output and expected TDO values.\n"));
@@ -1269,3 +1210,10 @@ urj_svf_run (urj_chain_t *chain, FILE *SVF_FILE, int stop_on_mismatch,
 
     return URJ_STATUS_OK;
 }
+
+
+int
+urj_svf_get_mismatches (void)
+{
+    return svf_mismatches;
+}
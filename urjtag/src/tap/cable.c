@@ -42,6 +42,8 @@
 #include <urjtag/chain.h>
 #include <urjtag/tap.h>
 #include <urjtag/cable.h>
+#include <urjtag/trace.h>
+#include <urjtag/usbconn.h>
 
 #include "cable.h"
 
@@ -108,9 +110,51 @@ urj_tap_cable_init (urj_cable_t *cable)
 void
 urj_tap_cable_flush (urj_cable_t *cable, urj_cable_flush_amount_t how_much)
 {
+    if (how_much == URJ_TAP_CABLE_OPTIONALLY)
+        cable->perf.optional_flushes++;
+    else
+        cable->perf.flushes++;
+
+    if (URJ_TRACE_ON ()
+        && (how_much != URJ_TAP_CABLE_OPTIONALLY || cable->todo.num_items))
+    {
+        urj_trace_event (URJ_TRACE_BEGIN, "cable", "flush",
+                         "\"how_much\":%d,\"items\":%d", (int) how_much,
+                         cable->todo.num_items);
+        cable->driver->flush (cable, how_much);
+        urj_trace_event (URJ_TRACE_END, "cable", "flush",
+                         "\"items\":%d", cable->todo.num_items);
+        return;
+    }
+
     cable->driver->flush (cable, how_much);
 }
 
+void
+urj_tap_cable_get_perf (const urj_cable_t *cable, urj_cable_perf_t *perf)
+{
+    const urj_usbconn_perf_t *usb;
+
+    *perf = cable->perf;
+    if (cable->driver->device_type != URJ_CABLE_DEVICE_USB)
+        return;
+
+    usb = &cable->link.usb->perf;
+    perf->usb_writes += usb->writes;
+    perf->usb_write_bytes += usb->write_bytes;
+    perf->usb_reads += usb->reads;
+    perf->usb_read_bytes += usb->read_bytes;
+    perf->usb_read_time += usb->read_time;
+}
+
+void
+urj_tap_cable_perf_reset (urj_cable_t *cable)
+{
+    memset (&cable->perf, 0, sizeof cable->perf);
+    if (cable->driver->device_type == URJ_CABLE_DEVICE_USB)
+        memset (&cable->link.usb->perf, 0, sizeof cable->link.usb->perf);
+}
+
 void
 urj_tap_cable_done (urj_cable_t *cable)
 {
@@ -237,6 +281,15 @@ urj_tap_cable_add_queue_item (urj_cable_t *cable, urj_cable_queue_info_t *q)
     q->next_free = j;
     q->num_items++;
 
+    if (q == &cable->todo)
+    {
+        cable->perf.queued++;
+        if (q->num_items > cable->perf.queue_high_water)
+            cable->perf.queue_high_water = q->num_items;
+        urj_trace (URJ_TRACE_COUNTER, "cable", "queue", "\"items\":%d",
+                   q->num_items);
+    }
+
     // urj_log (URJ_LOG_LEVEL_DEBUG, "add_queue_item to %p: %d\n", q, i);
     return i;
 }
@@ -286,6 +339,7 @@ urj_tap_cable_purge_queue (urj_cable_queue_info_t *q, int io)
         i++;
         if (i >= q->max_items)
             i = 0;
+        q->next_item = i;
         q->num_items--;
     }
 
@@ -548,8 +602,8 @@ urj_tap_cable_create (urj_chain_t *chain, const urj_cable_driver_t *driver)
 {
     urj_cable_t *cable;
 
-    if (urj_bus)
-        urj_bus_buses_delete (urj_bus);
+    if (chain->bus)
+        urj_bus_buses_delete (chain->bus);
 
     urj_tap_chain_disconnect (chain);
 
@@ -685,6 +739,12 @@ static const urj_param_descr_t cable_param[] =
     { URJ_CABLE_PARAM_KEY_INDEX,        URJ_PARAM_TYPE_LU,      "index", },
     { URJ_CABLE_PARAM_KEY_TRST,         URJ_PARAM_TYPE_LU,      "trst", },
     { URJ_CABLE_PARAM_KEY_RESET,        URJ_PARAM_TYPE_LU,      "reset", },
+    { URJ_CABLE_PARAM_KEY_CONFIG,       URJ_PARAM_TYPE_STRING,  "config", },
+    { URJ_CABLE_PARAM_KEY_PROFILE,      URJ_PARAM_TYPE_STRING,  "profile", },
+    { URJ_CABLE_PARAM_KEY_LATENCY,      URJ_PARAM_TYPE_LU,      "latency", },
+    { URJ_CABLE_PARAM_KEY_BANDWIDTH,    URJ_PARAM_TYPE_LU,      "bandwidth", },
+    { URJ_CABLE_PARAM_KEY_BUFFER,       URJ_PARAM_TYPE_LU,      "buffer", },
+    { URJ_CABLE_PARAM_KEY_REALTIME,     URJ_PARAM_TYPE_LU,      "realtime", },
 };
 
 const urj_param_list_t urj_cable_param_list =
@@ -307,9 +307,11 @@ urj_tap_cable_cx_xfer (urj_tap_cable_cx_cmd_root_t *cmd_root,
     uint32_t bytes_to_recv;
 
     bytes_to_recv = 0;
+    cable->perf.cx_xfers++;
 
     while (cmd)
     {
+        cable->perf.cx_cmds++;
         /* Step 1: copy command bytes buffered for sending them later
            through the usbconn driver */
         bytes_to_recv += cmd->to_recv;
@@ -39,15 +39,6 @@
 
 #include <urjtag/cmd.h>
 
-static void
-print_vector (urj_log_level_t ll, int len, char *vec)
-{
-    int i;
-    for (i = 0; i < len; i++)
-        urj_log (ll, "%c", vec[i] ? '1' : '0');
-}
-
-
 void
 urj_tap_cable_generic_disconnect (urj_cable_t *cable)
 {
@@ -94,18 +85,11 @@ do_one_queued_action (urj_cable_t *cable)
     {
         int j;
 
-        if (cable->done.num_items >= cable->done.max_items)
-        {
-            if (cable->todo.data[i].action == URJ_TAP_CABLE_GET_TDO
-                || cable->todo.data[i].action == URJ_TAP_CABLE_GET_SIGNAL
-                || cable->todo.data[i].action == URJ_TAP_CABLE_TRANSFER)
-            {
-                urj_error_set (URJ_ERROR_OUT_OF_BOUNDS,
-                               _("No space in cable activity results queue"));
-                urj_tap_cable_purge_queue (&cable->done, 1);
-                /* @@@@ RFHH shouldn't we bail out? */
-            }
-        }
+        cable->perf.flushed_items++;
+        cable->perf.flush_batches++;
+
+        /* the results queue grows in urj_tap_cable_add_queue_item(), deferred
+           scans may leave many results in it before they are picked up */
 
         switch (cable->todo.data[i].action)
         {
@@ -304,18 +288,15 @@ urj_tap_cable_generic_flush_using_transfer (urj_cable_t *cable,
 
             /* Step 3: Do the transfer */
 
+            cable->perf.flushed_items += n;
+            cable->perf.flush_batches++;
+
             /* @@@@ RFHH check result */
             r = cable->driver->transfer (cable, bits, in, out);
-            urj_log (URJ_LOG_LEVEL_DETAIL, "in: ");
-            print_vector (URJ_LOG_LEVEL_DETAIL, bits, in);
-            urj_log (URJ_LOG_LEVEL_DETAIL, "\n");
+            urj_log_bits (URJ_LOG_LEVEL_DETAIL, "in: ", bits, in);
             // @@@@ RFHH here always: out != NULL
             if (out)
-            {
-                urj_log (URJ_LOG_LEVEL_DETAIL, "out: ");
-                print_vector (URJ_LOG_LEVEL_DETAIL, bits, out);
-                urj_log (URJ_LOG_LEVEL_DETAIL, "\n");
-            }
+                urj_log_bits (URJ_LOG_LEVEL_DETAIL, "out: ", bits, out);
 
             /* Step 4: Pick results from transfer */
 
@@ -37,16 +37,6 @@
 #include "generic.h"
 #include "generic_parport.h"
 
-#ifdef UNUSED   // @@@@ RFHH
-static void
-print_vector (urj_log_level_t ll, int len, char *vec)
-{
-    int i;
-    for (i = 0; i < len; i++)
-        urj_log (ll, "%c", vec[i] ? '1' : '0');
-}
-#endif
-
 int
 urj_tap_cable_generic_parport_connect (urj_cable_t *cable,
                                        urj_cable_parport_devtype_t devtype,
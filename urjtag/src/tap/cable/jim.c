@@ -49,16 +49,26 @@ jim_cable_connect (urj_cable_t *cable, const urj_param_t *params[])
 {
     jim_cable_params_t *cable_params;
     urj_jim_state_t *s;
+    const char *chain_file = NULL;
+    int i;
 
-    if (urj_param_num (params) > 0)
-    {
-        urj_error_set (URJ_ERROR_SYNTAX, _("too many arguments"));
-        return URJ_STATUS_FAIL;
-    }
+    if (params != NULL)
+        for (i = 0; params[i] != NULL; i++)
+        {
+            switch (params[i]->key)
+            {
+            case URJ_CABLE_PARAM_KEY_CONFIG:
+                chain_file = params[i]->value.string;
+                break;
+            default:
+                urj_error_set (URJ_ERROR_SYNTAX, _("unknown parameter"));
+                return URJ_STATUS_FAIL;
+            }
+        }
 
     urj_warning (_("JTAG target simulator JIM - work in progress!\n"));
 
-    s = urj_jim_init ();
+    s = urj_jim_init_chain (chain_file);
     if (!s)
     {
         // retain error state
@@ -123,6 +133,16 @@ jim_cable_clock (urj_cable_t *cable, int tms, int tdi, int n)
     }
 }
 
+static int
+jim_cable_transfer (urj_cable_t *cable, int len, const char *in, char *out)
+{
+    jim_cable_params_t *jcp = cable->params;
+
+    urj_jim_shift (jcp->s, len, NULL, in, out);
+
+    return len;
+}
+
 static int
 jim_cable_get_tdo (urj_cable_t *cable)
 {
@@ -153,7 +173,8 @@ jim_cable_set_trst (urj_cable_t *cable, int mask, int val)
 static void
 jim_cable_help (urj_log_level_t ll, const char *cablename)
 {
-    urj_log (ll, _("Usage: cable %s\n"), cablename);
+    urj_log (ll, _("Usage: cable %s [config=<chain description file>]\n"),
+             cablename);
 }
 
 const urj_cable_driver_t urj_tap_cable_jim_driver = {
@@ -168,7 +189,7 @@ const urj_cable_driver_t urj_tap_cable_jim_driver = {
     urj_tap_cable_generic_set_frequency,
     jim_cable_clock,
     jim_cable_get_tdo,
-    urj_tap_cable_generic_transfer,
+    jim_cable_transfer,
     jim_cable_set_trst,
     jim_cable_get_trst,
     urj_tap_cable_generic_flush_using_transfer,
@@ -257,15 +257,7 @@ usbblaster_transfer_schedule (urj_cable_t *cable, int len, const char *in,
     urj_tap_cable_cx_cmd_queue (cmd_root, 0);
     urj_tap_cable_cx_cmd_push (cmd_root, OTHERS);       /* TCK low */
 
-#if 0
-    {
-        int o;
-        urj_log (URJ_LOG_LEVEL_COMM, "%d in: ", len);
-        for (o = 0; o < len; o++)
-            urj_log (URJ_LOG_LEVEL_COMM, "%c", in[o] ? '1' : '0');
-        urj_log (URJ_LOG_LEVEL_COMM, "\n");
-    }
-#endif
+    urj_log_bits (URJ_LOG_LEVEL_ALL, "in: ", len, in);
 
     while (len - in_offset >= 8)
     {
@@ -353,15 +345,7 @@ usbblaster_transfer_finish (urj_cable_t *cable, int len, char *out)
         out[out_offset++] =
             (urj_tap_cable_cx_xfer_recv (cable) & (1 << TDO)) ? 1 : 0;
 
-#if 0
-    {
-        int o;
-        urj_log (URJ_LOG_LEVEL_COMM, "%d out: ", len);
-        for (o = 0; o < len; o++)
-            urj_log (URJ_LOG_LEVEL_COMM, "%c", out[o] ? '1' : '0');
-        urj_log (URJ_LOG_LEVEL_COMM, "\n");
-    }
-#endif
+    urj_log_bits (URJ_LOG_LEVEL_ALL, "out: ", len, out);
 
     return 0;
 }
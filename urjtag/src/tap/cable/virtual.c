@@ -0,0 +1,450 @@
+/*
+ * $Id$
+ *
+ * Virtual cable driver with a USB link model, for throughput benchmarks
+ *
+ * Copyright (C) 2026 UrJTAG contributors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA
+ * 02111-1307, USA.
+ *
+ * The scans are executed on the JIM target simulator, like with the "jim"
+ * cable. In addition, every operation is translated into the number of
+ * bytes a real adapter would exchange with the host, and the bytes are
+ * collected into USB transactions the way a queueing driver does: a
+ * transaction goes out when the adapter buffer is full, when a result is
+ * needed right away, or when the queue is flushed. Each transaction costs
+ * a fixed latency plus the transfer time at the link bandwidth (or the
+ * shift time at TCK, whichever is longer).
+ *
+ * The modeled time is only accounted, never slept, so that benchmark runs
+ * are fast and reproducible; see urj_tap_cable_virtual_stats(). With
+ * "realtime=1" the cable also waits for the modeled time, like a driver
+ * blocked in its USB transfers; this shows how several cables driven at
+ * once overlap their link times.
+ */
+
+#include <sysdep.h>
+
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <urjtag/cable.h>
+#include <urjtag/chain.h>
+#include <urjtag/jim.h>
+
+#include "generic.h"
+
+/* how a particular adapter encodes JTAG operations into USB traffic */
+typedef struct
+{
+    const char *name;
+    unsigned long latency_us;   /* per transaction */
+    unsigned long bandwidth;    /* bytes/s, 0 = unlimited */
+    unsigned long buffer;       /* bytes per transaction */
+    unsigned long tck_hz;       /* maximum TCK, 0 = unlimited */
+    int data_bits_per_byte;     /* TDI bits per byte in shift commands */
+    int cmd_bytes;              /* overhead per shift/readback command */
+    int tms_clocks_per_cmd;     /* TCK cycles per TMS command */
+    int tms_cmd_bytes;          /* bytes per TMS command */
+}
+virtual_profile_t;
+
+static const virtual_profile_t virtual_profiles[] = {
+    /* MPSSE: 3 byte header per byte shift, TMS commands carry 7 clocks */
+    { "ft2232d",    1000,   750000, 4096,  6000000, 8, 3, 7, 3 },
+    { "ft2232h",     125,  3750000, 4096, 30000000, 8, 3, 7, 3 },
+    /* byte shift mode with one header per transfer, bit-bang otherwise */
+    { "usbblaster", 1000,   750000,   64,  6000000, 8, 1, 1, 2 },
+    /* TMS and TDI vectors, 2 bits per clock on the way out */
+    { "jlink",      1000,  1000000, 2048, 12000000, 4, 4, 4, 1 },
+    /* no link costs at all: the simulator's own speed */
+    { "none",          0,        0, 4096,        0, 8, 0, 1, 0 },
+};
+
+#define NR_PROFILES (sizeof virtual_profiles / sizeof virtual_profiles[0])
+
+/* private parameters of this cable driver */
+typedef struct
+{
+    urj_jim_state_t *s;
+    virtual_profile_t p;
+    int flush_depth;
+    unsigned long pending_out;  /* bytes of the transaction being built */
+    unsigned long pending_in;
+    uint64_t pending_clocks;
+    int realtime;
+    uint64_t sleep_ns;          /* modeled time not yet waited for */
+    urj_cable_virtual_stats_t stats;
+}
+virtual_cable_params_t;
+
+static const virtual_profile_t *
+virtual_find_profile (const char *name)
+{
+    size_t i;
+
+    for (i = 0; i < NR_PROFILES; i++)
+        if (strcasecmp (virtual_profiles[i].name, name) == 0)
+            return &virtual_profiles[i];
+
+    return NULL;
+}
+
+/* send the transaction being built and wait for its answer */
+static void
+virtual_link_flush (urj_cable_t *cable)
+{
+    virtual_cable_params_t *vcp = cable->params;
+    unsigned long tck = vcp->p.tck_hz;
+    uint64_t xfer_ns = 0, shift_ns = 0, link_ns;
+
+    if (vcp->pending_out == 0 && vcp->pending_in == 0)
+        return;
+
+    if (cable->frequency != 0 && (tck == 0 || cable->frequency < tck))
+        tck = cable->frequency;
+    if (vcp->p.bandwidth != 0)
+        xfer_ns = (uint64_t) (vcp->pending_out + vcp->pending_in)
+            * 1000000000 / vcp->p.bandwidth;
+    if (tck != 0)
+        shift_ns = vcp->pending_clocks * 1000000000 / tck;
+
+    vcp->stats.transactions++;
+    cable->perf.usb_writes++;
+    cable->perf.usb_write_bytes += vcp->pending_out;
+    if (vcp->pending_in != 0)
+    {
+        vcp->stats.round_trips++;
+        cable->perf.usb_reads++;
+        cable->perf.usb_read_bytes += vcp->pending_in;
+    }
+    vcp->stats.bytes_out += vcp->pending_out;
+    vcp->stats.bytes_in += vcp->pending_in;
+    link_ns = (uint64_t) vcp->p.latency_us * 1000
+        + (xfer_ns > shift_ns ? xfer_ns : shift_ns);
+    vcp->stats.link_ns += link_ns;
+
+    /* wait in steps of at least a millisecond, short sleeps overshoot */
+    if (vcp->realtime)
+    {
+        vcp->sleep_ns += link_ns;
+        if (vcp->sleep_ns >= 1000000)
+        {
+            usleep (vcp->sleep_ns / 1000);
+            vcp->sleep_ns %= 1000;
+        }
+    }
+
+    vcp->pending_out = 0;
+    vcp->pending_in = 0;
+    vcp->pending_clocks = 0;
+}
+
+/* account one operation; a result that is needed now ends the transaction */
+static void
+virtual_account (urj_cable_t *cable, unsigned long out, unsigned long in,
+                 unsigned long clocks)
+{
+    virtual_cable_params_t *vcp = cable->params;
+
+    if (vcp->pending_out + vcp->pending_in + out + in > vcp->p.buffer)
+        virtual_link_flush (cable);
+
+    vcp->pending_out += out;
+    vcp->pending_in += in;
+    vcp->pending_clocks += clocks;
+    vcp->stats.clocks += clocks;
+
+    if (in != 0 && vcp->flush_depth == 0)
+        virtual_link_flush (cable);
+}
+
+static int
+virtual_cable_connect (urj_cable_t *cable, const urj_param_t *params[])
+{
+    virtual_cable_params_t *cable_params;
+    const virtual_profile_t *profile = &virtual_profiles[0];
+    const char *chain_file = NULL;
+    long latency = -1, bandwidth = -1, buffer = -1;
+    int realtime = 0;
+    urj_jim_state_t *s;
+    int i;
+
+    if (params != NULL)
+        for (i = 0; params[i] != NULL; i++)
+        {
+            switch (params[i]->key)
+            {
+            case URJ_CABLE_PARAM_KEY_CONFIG:
+                chain_file = params[i]->value.string;
+                break;
+            case URJ_CABLE_PARAM_KEY_PROFILE:
+                profile = virtual_find_profile (params[i]->value.string);
+                if (profile == NULL)
+                {
+                    urj_error_set (URJ_ERROR_INVALID,
+                                   _("unknown link profile '%s'"),
+                                   params[i]->value.string);
+                    return URJ_STATUS_FAIL;
+                }
+                break;
+            case URJ_CABLE_PARAM_KEY_LATENCY:
+                latency = params[i]->value.lu;
+                break;
+            case URJ_CABLE_PARAM_KEY_BANDWIDTH:
+                bandwidth = params[i]->value.lu;
+                break;
+            case URJ_CABLE_PARAM_KEY_BUFFER:
+                buffer = params[i]->value.lu;
+                break;
+            case URJ_CABLE_PARAM_KEY_REALTIME:
+                realtime = params[i]->value.lu != 0;
+                break;
+            default:
+                urj_error_set (URJ_ERROR_SYNTAX, _("unknown parameter"));
+                return URJ_STATUS_FAIL;
+            }
+        }
+
+    s = urj_jim_init_chain (chain_file);
+    if (!s)
+    {
+        // retain error state
+        return URJ_STATUS_FAIL;
+    }
+
+    cable_params = calloc (1, sizeof (virtual_cable_params_t));
+    if (!cable_params)
+    {
+        urj_error_set (URJ_ERROR_OUT_OF_MEMORY, _("calloc(%zd,%zd) fails"),
+                       (size_t) 1, sizeof (virtual_cable_params_t));
+        urj_jim_free (s);
+        return URJ_STATUS_FAIL;
+    }
+
+    cable_params->s = s;
+    cable_params->p = *profile;
+    if (latency >= 0)
+        cable_params->p.latency_us = latency;
+    if (bandwidth >= 0)
+        cable_params->p.bandwidth = bandwidth;
+    if (buffer > 0)
+        cable_params->p.buffer = buffer;
+    cable_params->realtime = realtime;
+
+    cable->params = cable_params;
+    cable->chain = NULL;
+
+    urj_log (URJ_LOG_LEVEL_NORMAL,
+             _("Virtual cable: %s link, %lu us latency, %lu bytes/s, %lu byte buffer\n"),
+             cable_params->p.name, cable_params->p.latency_us,
+             cable_params->p.bandwidth, cable_params->p.buffer);
+
+    return URJ_STATUS_OK;
+}
+
+static void
+virtual_cable_disconnect (urj_cable_t *cable)
+{
+    urj_tap_cable_done (cable);
+    urj_tap_chain_disconnect (cable->chain);
+}
+
+static void
+virtual_cable_free (urj_cable_t *cable)
+{
+    if (cable->params != NULL)
+    {
+        urj_jim_free (((virtual_cable_params_t *) (cable->params))->s);
+        free (cable->params);
+    }
+    free (cable);
+}
+
+static void
+virtual_cable_done (urj_cable_t *cable)
+{
+    virtual_cable_params_t *vcp = cable->params;
+
+    virtual_link_flush (cable);
+    urj_log (URJ_LOG_LEVEL_DETAIL,
+             "virtual: %llu transactions, %llu round trips, %llu bytes out, %llu bytes in, %.6f s link time\n",
+             (unsigned long long) vcp->stats.transactions,
+             (unsigned long long) vcp->stats.round_trips,
+             (unsigned long long) vcp->stats.bytes_out,
+             (unsigned long long) vcp->stats.bytes_in,
+             vcp->stats.link_ns / 1e9);
+}
+
+static int
+virtual_cable_init (urj_cable_t *cable)
+{
+    return URJ_STATUS_OK;
+}
+
+static void
+virtual_cable_set_frequency (urj_cable_t *cable, uint32_t new_frequency)
+{
+    /* nothing to calibrate, the link model limits TCK */
+    cable->frequency = new_frequency;
+}
+
+static void
+virtual_cable_clock (urj_cable_t *cable, int tms, int tdi, int n)
+{
+    virtual_cable_params_t *vcp = cable->params;
+    int per_cmd = vcp->p.tms_clocks_per_cmd;
+    int i;
+
+    for (i = 0; i < n; i++)
+    {
+        urj_jim_tck_rise (vcp->s, tms, tdi);
+        urj_jim_tck_fall (vcp->s);
+    }
+
+    virtual_account (cable, (unsigned long) (n + per_cmd - 1) / per_cmd
+                     * vcp->p.tms_cmd_bytes, 0, n);
+}
+
+static int
+virtual_cable_transfer (urj_cable_t *cable, int len, const char *in,
+                        char *out)
+{
+    virtual_cable_params_t *vcp = cable->params;
+    int bits = vcp->p.data_bits_per_byte;
+
+    urj_jim_shift (vcp->s, len, NULL, in, out);
+
+    virtual_account (cable, vcp->p.cmd_bytes + (len + bits - 1) / bits,
+                     out != NULL ? (len + 7) / 8 : 0, len);
+
+    return len;
+}
+
+static int
+virtual_cable_get_tdo (urj_cable_t *cable)
+{
+    virtual_cable_params_t *vcp = cable->params;
+
+    virtual_account (cable, vcp->p.cmd_bytes, 1, 0);
+
+    return urj_jim_get_tdo (vcp->s);
+}
+
+static int
+virtual_cable_get_signal (urj_cable_t *cable, urj_pod_sigsel_t sig)
+{
+    virtual_cable_params_t *vcp = cable->params;
+
+    virtual_account (cable, vcp->p.cmd_bytes, 1, 0);
+
+    return urj_jim_get_trst (vcp->s);
+}
+
+static int
+virtual_cable_set_signal (urj_cable_t *cable, int mask, int val)
+{
+    virtual_cable_params_t *vcp = cable->params;
+
+    virtual_account (cable, vcp->p.cmd_bytes, 0, 0);
+    urj_jim_set_trst (vcp->s, val);
+
+    return urj_jim_get_trst (vcp->s);
+}
+
+static void
+virtual_cable_flush (urj_cable_t *cable, urj_cable_flush_amount_t how_much)
+{
+    virtual_cable_params_t *vcp = cable->params;
+
+    /* keep collecting until somebody needs the results */
+    if (how_much == URJ_TAP_CABLE_OPTIONALLY)
+        return;
+
+    vcp->flush_depth++;
+    urj_tap_cable_generic_flush_one_by_one (cable, how_much);
+    vcp->flush_depth--;
+
+    if (vcp->flush_depth == 0)
+        virtual_link_flush (cable);
+}
+
+int
+urj_tap_cable_virtual_stats (urj_cable_t *cable,
+                             urj_cable_virtual_stats_t *stats, int reset)
+{
+    virtual_cable_params_t *vcp;
+
+    if (cable == NULL || cable->driver != &urj_tap_cable_virtual_driver)
+    {
+        urj_error_set (URJ_ERROR_INVALID, _("not a virtual cable"));
+        return URJ_STATUS_FAIL;
+    }
+
+    vcp = cable->params;
+    virtual_link_flush (cable);
+    if (stats != NULL)
+        *stats = vcp->stats;
+    if (reset)
+        memset (&vcp->stats, 0, sizeof vcp->stats);
+
+    return URJ_STATUS_OK;
+}
+
+static void
+virtual_cable_help (urj_log_level_t ll, const char *cablename)
+{
+    size_t i;
+
+    urj_log (ll,
+             _("Usage: cable %s [config=<chain description file>] [profile=PROFILE]\n"
+               "              [latency=USEC] [bandwidth=BYTES_PER_S] [buffer=BYTES]\n"
+               "              [realtime=1]\n"
+               "\n"
+               "PROFILE   USB adapter whose link is modeled (default %s)\n"
+               "LATENCY   fixed cost per USB transaction in microseconds\n"
+               "BANDWIDTH link bandwidth in bytes per second, 0 for unlimited\n"
+               "BUFFER    adapter buffer size, i.e. maximum bytes per transaction\n"
+               "REALTIME  1 to wait for the modeled link time, not only count it\n"
+               "\n"
+               "Profiles:\n"),
+             cablename, virtual_profiles[0].name);
+    for (i = 0; i < NR_PROFILES; i++)
+        urj_log (ll, "  %-10s %5lu us  %8lu bytes/s  %5lu bytes\n",
+                 virtual_profiles[i].name, virtual_profiles[i].latency_us,
+                 virtual_profiles[i].bandwidth, virtual_profiles[i].buffer);
+    urj_log (ll, "\n");
+}
+
+const urj_cable_driver_t urj_tap_cable_virtual_driver = {
+    "virtual",
+    N_("Virtual cable with USB link model on the JIM simulator"),
+    URJ_CABLE_DEVICE_OTHER,
+    { .other = virtual_cable_connect, },
+    virtual_cable_disconnect,
+    virtual_cable_free,
+    virtual_cable_init,
+    virtual_cable_done,
+    virtual_cable_set_frequency,
+    virtual_cable_clock,
+    virtual_cable_get_tdo,
+    virtual_cable_transfer,
+    virtual_cable_set_signal,
+    virtual_cable_get_signal,
+    virtual_cable_flush,
+    virtual_cable_help
+};
@@ -647,10 +647,7 @@ xpc_ext_transfer (urj_cable_t *cable, int len, const char *in, char *out)
     urj_log (URJ_LOG_LEVEL_DETAIL, "---\n");
     urj_log (URJ_LOG_LEVEL_DETAIL, "transfer size %d, %s output\n", len,
             (out != NULL) ? "with" : "without");
-    urj_log (URJ_LOG_LEVEL_DETAIL, "tdi: ");
-    for (i = 0; i < len; i++)
-        urj_log (URJ_LOG_LEVEL_DETAIL, "%c", in[i] ? '1' : '0');
-    urj_log (URJ_LOG_LEVEL_DETAIL, "\n");
+    urj_log_bits (URJ_LOG_LEVEL_DETAIL, "tdi: ", len, in);
 #endif
 
     xts.xpcu =
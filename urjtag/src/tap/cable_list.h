@@ -107,6 +107,9 @@ _URJ_CABLE(ts7800)
 #ifdef ENABLE_CABLE_USBBLASTER
 _URJ_CABLE(usbblaster)
 #endif
+#ifdef ENABLE_JIM
+_URJ_CABLE(virtual)
+#endif
 #ifdef ENABLE_CABLE_VSLLINK
 _URJ_CABLE(vsllink)
 #endif
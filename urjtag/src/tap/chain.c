@@ -37,11 +37,20 @@
 #include <urjtag/bsdl.h>
 
 #include <urjtag/chain.h>
+#include <urjtag/trace.h>
 
 urj_chain_t *
 urj_tap_chain_alloc (void)
 {
-    urj_chain_t *chain = malloc (sizeof (urj_chain_t));
+    urj_chain_t *chain;
+
+    if (urj_trace_from_env () != URJ_STATUS_OK)
+    {
+        urj_warning ("%s\n", urj_error_describe ());
+        urj_error_reset ();
+    }
+
+    chain = malloc (sizeof (urj_chain_t));
     if (!chain)
     {
         urj_error_set (URJ_ERROR_OUT_OF_MEMORY, "malloc(%zd) fails",
@@ -53,6 +62,11 @@ urj_tap_chain_alloc (void)
     chain->parts = NULL;
     chain->total_instr_len = 0;
     chain->active_part = 0;
+    chain->buses.len = 0;
+    chain->buses.buses = NULL;
+    chain->bus = NULL;
+    chain->gang = NULL;
+    chain->gang_len = 0;
     URJ_BSDL_GLOBS_INIT (chain->bsdl);
     urj_tap_state_init (chain);
 
@@ -65,6 +79,8 @@ urj_tap_chain_free (urj_chain_t *chain)
     if (!chain)
         return;
 
+    urj_tap_chain_gang_free (chain);
+    urj_bus_buses_free (chain);
     urj_tap_chain_disconnect (chain);
 
     urj_part_parts_free (chain->parts);
@@ -242,10 +258,10 @@ urj_tap_chain_get_pod_signal (urj_chain_t *chain, urj_pod_sigsel_t sig)
     return urj_tap_cable_get_signal (chain->cable, sig);
 }
 
-int
-urj_tap_chain_shift_instructions_mode (urj_chain_t *chain,
-                                       int capture_output, int capture,
-                                       int chain_exit)
+static int
+urj_tap_chain_defer_shift_instructions_mode (urj_chain_t *chain,
+                                             int capture_output, int capture,
+                                             int chain_exit)
 {
     int i;
     urj_parts_t *ps;
@@ -283,6 +299,31 @@ urj_tap_chain_shift_instructions_mode (urj_chain_t *chain,
                 (i + 1) == ps->len ? chain_exit : URJ_CHAIN_EXITMODE_SHIFT);
     }
 
+    return URJ_STATUS_OK;
+}
+
+int
+urj_tap_chain_defer_shift_instructions (urj_chain_t *chain)
+{
+    return urj_tap_chain_defer_shift_instructions_mode (chain, 0, 1,
+                                                        URJ_CHAIN_EXITMODE_IDLE);
+}
+
+int
+urj_tap_chain_shift_instructions_mode (urj_chain_t *chain,
+                                       int capture_output, int capture,
+                                       int chain_exit)
+{
+    int i;
+    urj_parts_t *ps;
+
+    if (urj_tap_chain_defer_shift_instructions_mode (chain, capture_output,
+                                                     capture, chain_exit)
+        != URJ_STATUS_OK)
+        return URJ_STATUS_FAIL;
+
+    ps = chain->parts;
+
     if (capture_output)
     {
         for (i = 0; i < ps->len; i++)
@@ -311,9 +352,9 @@ urj_tap_chain_shift_instructions (urj_chain_t *chain)
 }
 
 int
-urj_tap_chain_shift_data_registers_mode (urj_chain_t *chain,
-                                         int capture_output, int capture,
-                                         int chain_exit)
+urj_tap_chain_defer_shift_data_registers (urj_chain_t *chain,
+                                          int capture_output, int capture,
+                                          int chain_exit)
 {
     int i;
     urj_parts_t *ps;
@@ -358,16 +399,37 @@ urj_tap_chain_shift_data_registers_mode (urj_chain_t *chain,
                 (i + 1) == ps->len ? chain_exit : URJ_CHAIN_EXITMODE_SHIFT);
     }
 
-    if (capture_output)
+    return URJ_STATUS_OK;
+}
+
+void
+urj_tap_chain_shift_data_registers_output (urj_chain_t *chain,
+                                           int chain_exit)
+{
+    urj_parts_t *ps = chain->parts;
+    int i;
+
+    for (i = 0; i < ps->len; i++)
     {
-        for (i = 0; i < ps->len; i++)
-        {
-            urj_tap_shift_register_output (chain,
-                    ps->parts[i]->active_instruction->data_register->in,
-                    ps->parts[i]->active_instruction->data_register->out,
-                    (i + 1) == ps->len ? chain_exit : URJ_CHAIN_EXITMODE_SHIFT);
-        }
+        urj_tap_shift_register_output (chain,
+                ps->parts[i]->active_instruction->data_register->in,
+                ps->parts[i]->active_instruction->data_register->out,
+                (i + 1) == ps->len ? chain_exit : URJ_CHAIN_EXITMODE_SHIFT);
     }
+}
+
+int
+urj_tap_chain_shift_data_registers_mode (urj_chain_t *chain,
+                                         int capture_output, int capture,
+                                         int chain_exit)
+{
+    if (urj_tap_chain_defer_shift_data_registers (chain, capture_output,
+                                                  capture, chain_exit)
+        != URJ_STATUS_OK)
+        return URJ_STATUS_FAIL;
+
+    if (capture_output)
+        urj_tap_chain_shift_data_registers_output (chain, chain_exit);
     else
     {
         /* give the cable driver a chance to flush if it's considered useful */
@@ -543,7 +543,7 @@ urj_tap_detect (urj_chain_t *chain, int maxirlen)
     int i;
     urj_bus_t *abus;
 
-    urj_bus_buses_free ();
+    urj_bus_buses_free (chain);
     urj_part_parts_free (chain->parts);
     chain->parts = NULL;
     if (urj_tap_detect_parts (chain, urj_get_data_dir (), maxirlen) == -1)
@@ -569,9 +569,9 @@ urj_tap_detect (urj_chain_t *chain, int maxirlen)
     urj_tap_chain_shift_instructions (chain);
 
     // Initialize all the buses
-    for (i = 0; i < urj_buses.len; i++)
+    for (i = 0; i < chain->buses.len; i++)
     {
-        abus = urj_buses.buses[i];
+        abus = chain->buses.buses[i];
         if (abus->driver->init)
         {
             if (abus->driver->init (abus) != URJ_STATUS_OK)
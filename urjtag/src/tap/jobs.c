@@ -0,0 +1,169 @@
+/*
+ * $Id$
+ *
+ * Copyright (C) 2026 UrJTAG contributors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA
+ * 02111-1307, USA.
+ *
+ * Jobs on several chains at once. All state of a job lives in its chain,
+ * the chain's cable and buses, or is per thread (the error state), so the
+ * jobs need no locking as long as no two of them share a chain.
+ *
+ * A gang is a chain plus further chains on other cables that hold the same
+ * targets; gang jobs run on all of them together.
+ */
+
+#include <sysdep.h>
+
+#include <stdlib.h>
+
+#ifdef HAVE_PTHREAD
+#include <pthread.h>
+#endif
+
+#include <urjtag/error.h>
+#include <urjtag/log.h>
+#include <urjtag/chain.h>
+
+static void
+chain_job_run (urj_chain_job_t *job)
+{
+    urj_error_reset ();
+    job->result = job->run (job->chain, job->data);
+    job->error = urj_error_state;
+    urj_error_reset ();
+}
+
+#ifdef HAVE_PTHREAD
+static void *
+chain_job_thread (void *arg)
+{
+    chain_job_run (arg);
+    return NULL;
+}
+#endif
+
+int
+urj_tap_chain_run_jobs (urj_chain_job_t *jobs, int n)
+{
+    int i, failed;
+#ifdef HAVE_PTHREAD
+    pthread_t *threads;
+    int *started;
+
+    threads = calloc (n, sizeof *threads);
+    started = calloc (n, sizeof *started);
+    if (threads == NULL || started == NULL)
+    {
+        free (threads);
+        free (started);
+        urj_error_set (URJ_ERROR_OUT_OF_MEMORY, "calloc(%d,%zd) fails",
+                       n, sizeof *threads);
+        /* none of the jobs ran, so none may look successful */
+        for (i = 0; i < n; i++)
+        {
+            jobs[i].result = URJ_STATUS_FAIL;
+            jobs[i].error = urj_error_state;
+        }
+        return URJ_STATUS_FAIL;
+    }
+
+    for (i = 0; i < n; i++)
+        started[i] = pthread_create (&threads[i], NULL, chain_job_thread,
+                                     &jobs[i]) == 0;
+
+    /* a job without a thread runs here while the others go on */
+    for (i = 0; i < n; i++)
+        if (!started[i])
+        {
+            urj_log (URJ_LOG_LEVEL_DEBUG,
+                     "no thread for job %d, running it directly\n", i);
+            chain_job_run (&jobs[i]);
+        }
+
+    for (i = 0; i < n; i++)
+        if (started[i])
+            pthread_join (threads[i], NULL);
+
+    free (threads);
+    free (started);
+#else
+    for (i = 0; i < n; i++)
+        chain_job_run (&jobs[i]);
+#endif
+
+    failed = 0;
+    for (i = 0; i < n; i++)
+        if (jobs[i].result != URJ_STATUS_OK && !failed++)
+            urj_error_state = jobs[i].error;
+
+    return failed ? URJ_STATUS_FAIL : URJ_STATUS_OK;
+}
+
+urj_chain_t *
+urj_tap_chain_gang_add (urj_chain_t *chain, const char *drivername,
+                        char *params[])
+{
+    urj_chain_t **gang;
+    urj_chain_t *member;
+
+    gang = realloc (chain->gang, (chain->gang_len + 1) * sizeof *gang);
+    if (gang == NULL)
+    {
+        urj_error_set (URJ_ERROR_OUT_OF_MEMORY, "realloc(%s,%zd) fails",
+                       "chain->gang", (chain->gang_len + 1) * sizeof *gang);
+        return NULL;
+    }
+    chain->gang = gang;
+
+    member = urj_tap_chain_alloc ();
+    if (member == NULL)
+        return NULL;
+
+    if (urj_tap_chain_connect (member, drivername, params) != URJ_STATUS_OK)
+    {
+        urj_tap_chain_free (member);
+        return NULL;
+    }
+
+    chain->gang[chain->gang_len++] = member;
+
+    return member;
+}
+
+void
+urj_tap_chain_gang_free (urj_chain_t *chain)
+{
+    int i;
+
+    for (i = 0; i < chain->gang_len; i++)
+        urj_tap_chain_free (chain->gang[i]);
+    free (chain->gang);
+    chain->gang = NULL;
+    chain->gang_len = 0;
+}
+
+int
+urj_tap_chain_gang_run (urj_chain_t *chain, urj_chain_job_t *jobs)
+{
+    int i;
+
+    jobs[0].chain = chain;
+    for (i = 0; i < chain->gang_len; i++)
+        jobs[i + 1].chain = chain->gang[i];
+
+    return urj_tap_chain_run_jobs (jobs, chain->gang_len + 1);
+}
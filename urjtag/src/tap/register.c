@@ -99,6 +99,16 @@ urj_tap_register_realloc (urj_tap_register_t *tr, int new_len)
         return NULL;
     }
 
+    tr->string = realloc (tr->string, new_len + 1);
+
+    if (!tr->string)
+    {
+        urj_error_set (URJ_ERROR_OUT_OF_MEMORY, "realloc(%d) fails",
+                       new_len + 1);
+        return NULL;
+    }
+    tr->string[new_len] = '\0';
+
     if (tr->len < new_len)
         memset (tr->data + tr->len, 0, (new_len - tr->len));
 
@@ -25,6 +25,7 @@
 
 #include <urjtag/tap_state.h>
 #include <urjtag/chain.h>
+#include <urjtag/trace.h>
 
 static const char *
 urj_tap_state_name (int state)
@@ -52,6 +53,12 @@ urj_tap_state_name (int state)
     }
 }
 
+static void
+urj_tap_state_trace (int state)
+{
+    urj_trace (URJ_TRACE_INSTANT, "tap", urj_tap_state_name (state), NULL);
+}
+
 static void
 urj_tap_state_dump (int state)
 {
@@ -89,6 +96,8 @@ urj_tap_state_done (urj_chain_t *chain)
 int
 urj_tap_state_reset (urj_chain_t *chain)
 {
+    if (chain->state != URJ_TAP_STATE_TEST_LOGIC_RESET)
+        urj_tap_state_trace (URJ_TAP_STATE_TEST_LOGIC_RESET);
     urj_tap_state_dump (URJ_TAP_STATE_TEST_LOGIC_RESET);
     return chain->state = URJ_TAP_STATE_TEST_LOGIC_RESET;
 }
@@ -105,6 +114,7 @@ urj_tap_state_set_trst (urj_chain_t *chain, int old_trst, int new_trst)
             chain->state = URJ_TAP_STATE_TEST_LOGIC_RESET;
         else
             chain->state = URJ_TAP_STATE_UNKNOWN_STATE;
+        urj_tap_state_trace (chain->state);
     }
 
     urj_tap_state_dump (chain->state);
@@ -200,6 +210,8 @@ urj_tap_state_clock (urj_chain_t *chain, int tms)
         }
     }
 
+    if (chain->state != oldstate)
+        urj_tap_state_trace (chain->state);
     urj_tap_state_dump_2 (oldstate, chain->state, tms);
     return chain->state;
 }
@@ -27,6 +27,8 @@
 #include <string.h>
 #include <stddef.h>
 
+#include <urjtag/fclock.h>
+#include <urjtag/trace.h>
 #include <urjtag/usbconn.h>
 
 #include "usbconn.h"
@@ -52,17 +54,39 @@ urj_tap_usbconn_close (urj_usbconn_t *conn)
 int
 urj_tap_usbconn_read (urj_usbconn_t *conn, uint8_t *buf, int len)
 {
-    if (conn->driver->read)
-        return conn->driver->read (conn, buf, len);
-    else
+    long double start;
+    int r;
+
+    if (!conn->driver->read)
         return 0;
+
+    urj_trace (URJ_TRACE_BEGIN, "usb", "read", "\"len\":%d", len);
+    start = urj_lib_frealtime ();
+    r = conn->driver->read (conn, buf, len);
+    conn->perf.read_time += urj_lib_frealtime () - start;
+    urj_trace (URJ_TRACE_END, "usb", "read", "\"bytes\":%d", r);
+    conn->perf.reads++;
+    if (r > 0)
+        conn->perf.read_bytes += r;
+
+    return r;
 }
 
 int
 urj_tap_usbconn_write (urj_usbconn_t *conn, uint8_t *buf, int len, int recv)
 {
-    if (conn->driver->write)
-        return conn->driver->write (conn, buf, len, recv);
-    else
+    int r;
+
+    if (!conn->driver->write)
         return 0;
+
+    urj_trace (URJ_TRACE_BEGIN, "usb", "write", "\"len\":%d,\"recv\":%d",
+               len, recv);
+    r = conn->driver->write (conn, buf, len, recv);
+    urj_trace (URJ_TRACE_END, "usb", "write", "\"bytes\":%d", r);
+    conn->perf.writes++;
+    if (r > 0)
+        conn->perf.write_bytes += r;
+
+    return r;
 }
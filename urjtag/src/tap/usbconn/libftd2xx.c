@@ -350,6 +350,7 @@ usbconn_ftd2xx_connect (urj_usbconn_cable_t *template,
     c->params = p;
     c->driver = &urj_tap_usbconn_ftd2xx_driver;
     c->cable = NULL;
+    memset (&c->perf, 0, sizeof c->perf);
 
     /* do a test open with the specified cable paramters,
        there's no other way to detect the presence of the specified
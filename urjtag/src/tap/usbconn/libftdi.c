@@ -322,6 +322,7 @@ usbconn_ftdi_connect (urj_usbconn_cable_t *template,
     c->params = p;
     c->driver = &urj_tap_usbconn_ftdi_driver;
     c->cable = NULL;
+    memset (&c->perf, 0, sizeof c->perf);
 
     /* do a test open with the specified cable paramters,
        alternatively we could use libusb to detect the presence of the
@@ -170,6 +170,7 @@ usbconn_libusb_connect (urj_usbconn_cable_t *template,
     libusb_conn->params = libusb_params;
     libusb_conn->driver = &urj_tap_usbconn_libusb_driver;
     libusb_conn->cable = NULL;
+    memset (&libusb_conn->perf, 0, sizeof libusb_conn->perf);
 
     return libusb_conn;
 }
@@ -0,0 +1,236 @@
+/**
+ * \author SPDX-FileCopyrightText: 2026 UrJTAG contributors
+ *
+ * \copyright SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * \file bench_cable.c
+ * \brief Throughput of a flash workload over modeled USB adapters.
+ *
+ * Test idea:
+ * * connect "cable virtual profile=<p> config=<file>" for every link profile,
+ *   with a some_cpu and a CFI NOR flash as the chain
+ * * detect, define some_cpu from some_cpu.jtag, "initbus" and "detectflash"
+ * * "flashmem" and "readmem" a random image and compare the data
+ * * report host time next to the modeled link time, transactions and bytes,
+ *   and check that the profiles rank as the adapters do
+ * * check that the cable performance counters ("perf") see the same
+ *   round trips as the link model
+ *
+ * The image size can be changed with URJ_BENCH_CABLE_KB.
+ */
+
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <urjtag/cable.h>
+#include <urjtag/chain.h>
+#include <urjtag/error.h>
+#include <urjtag/log.h>
+#include <urjtag/parse.h>
+#include <urjtag/tap.h>
+
+#include "tap/basic.h"
+
+#define CHAIN_FILE "bench_cable.jim"
+#define IMAGE_FILE "bench_cable.bin"
+#define READ_FILE  "bench_cable.out"
+
+static const char * const ProfileAry[] = {
+   "none", "ft2232d", "ft2232h", "usbblaster", "jlink",
+};
+
+#define NR_PROFILES (sizeof ProfileAry / sizeof ProfileAry[0])
+/// Number of tests per ProfileAry element.
+#define BENCH_NRCHK 5
+
+static double now(void)
+{
+   struct timespec ts;
+
+   clock_gettime(CLOCK_MONOTONIC, &ts);
+   return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static void write_files(long size)
+{
+   FILE *f = fopen(CHAIN_FILE, "w");
+   uint32_t x = 54321;
+   long i;
+
+   if (f == NULL)
+      bail("cannot create " CHAIN_FILE);
+   fprintf(f, "some_cpu flash=1\n");
+   fclose(f);
+
+   f = fopen(IMAGE_FILE, "wb");
+   if (f == NULL)
+      bail("cannot create " IMAGE_FILE);
+   for (i = 0; i < size; ++i)
+   {
+      x = x * 1103515245 + 12345;
+      fputc(x >> 16, f);
+   }
+   fclose(f);
+}
+
+static int same_files(const char *a, const char *b, long size)
+{
+   FILE *fa = fopen(a, "rb");
+   FILE *fb = fopen(b, "rb");
+   int same = fa != NULL && fb != NULL;
+   long i;
+
+   for (i = 0; same && i < size; ++i)
+      same = getc(fa) == getc(fb);
+   if (same)
+      same = getc(fb) == EOF;
+   if (fa)
+      fclose(fa);
+   if (fb)
+      fclose(fb);
+
+   return same;
+}
+
+static int run(urj_chain_t *chain, const char *fmt, ...)
+{
+   char line[1024];
+   va_list ap;
+
+   va_start(ap, fmt);
+   vsnprintf(line, sizeof line, fmt, ap);
+   va_end(ap);
+
+   if (urj_parse_line(chain, line) != URJ_STATUS_OK)
+   {
+      diag("'%s' failed: %s", line, urj_error_describe());
+      urj_error_reset();
+      return 0;
+   }
+   return 1;
+}
+
+static void report(const char *profile, const char *what, long bytes,
+                   double dt, const urj_cable_virtual_stats_t *st)
+{
+   double link = st->link_ns / 1e9;
+
+   if (dt <= 0)
+      dt = 1e-9;
+   diag("%-10s %-8s %ld bytes, host %.3f s, link %.3f s (%.0f bytes/s), "
+        "%llu transactions, %llu round trips, %llu/%llu bytes out/in",
+        profile, what, bytes, dt, link, link > 0 ? bytes / link : 0.0,
+        (unsigned long long) st->transactions,
+        (unsigned long long) st->round_trips,
+        (unsigned long long) st->bytes_out,
+        (unsigned long long) st->bytes_in);
+}
+
+/// Runs the workload over one profile; returns the link statistics of readmem.
+static urj_cable_virtual_stats_t run_bench(const char *srcdir,
+                                           const char *profile, long size)
+{
+   char profile_param[64];
+   char path[1024];
+   char *cable_params[] = { profile_param, "config=" CHAIN_FILE, NULL };
+   urj_cable_virtual_stats_t st;
+   urj_cable_perf_t perf;
+   urj_chain_t *chain;
+   int ok_setup, ok_flash, ok_read;
+   double t0;
+
+   memset(&st, 0, sizeof st);
+   snprintf(profile_param, sizeof profile_param, "profile=%s", profile);
+   snprintf(path, sizeof path, "%s/jim/some_cpu.jtag", srcdir);
+
+   chain = urj_tap_chain_alloc();
+   if (chain == NULL)
+      bail("urj_tap_chain_alloc() failed");
+   ok_setup = urj_tap_chain_connect(chain, "virtual", cable_params)
+      == URJ_STATUS_OK;
+   ok(ok_setup, "%s: connect", profile);
+   if (!ok_setup)
+   {
+      diag("%s", urj_error_describe());
+      urj_error_reset();
+      urj_tap_chain_free(chain);
+      skip_block(BENCH_NRCHK - 1, "%s: no cable", profile);
+      return st;
+   }
+
+   ok_setup = urj_tap_detect(chain, 0) == URJ_STATUS_OK
+      && run(chain, "part 0")
+      && urj_parse_include(chain, path, 1) == URJ_STATUS_OK
+      && run(chain, "initbus prototype amsb=A(31) alsb=A(0) dmsb=D(15) "
+             "dlsb=D(0) cs=CS oe=OE we=WE amode=8")
+      && run(chain, "detectflash 0");
+   ok(ok_setup, "%s: detectflash", profile);
+
+   urj_tap_cable_virtual_stats(chain->cable, NULL, 1);
+   t0 = now();
+   ok_flash = ok_setup && run(chain, "flashmem 0 %s noverify", IMAGE_FILE);
+   urj_tap_cable_virtual_stats(chain->cable, &st, 1);
+   report(profile, "flashmem", size, now() - t0, &st);
+
+   run(chain, "perf reset");
+   t0 = now();
+   ok_read = ok_flash && run(chain, "readmem 0 0x%lx %s", size, READ_FILE);
+   urj_tap_cable_virtual_stats(chain->cable, &st, 1);
+   report(profile, "readmem", size, now() - t0, &st);
+   ok(ok_flash && ok_read, "%s: flashmem and readmem", profile);
+   urj_tap_cable_get_perf(chain->cable, &perf);
+   ok(perf.usb_reads == st.round_trips
+      && perf.usb_read_bytes == st.bytes_in
+      && perf.flushes > 0,
+      "%s: perf counters", profile);
+
+   ok(same_files(IMAGE_FILE, READ_FILE, size), "%s: data read back", profile);
+
+   urj_tap_chain_free(chain);
+   remove(READ_FILE);
+
+   return st;
+}
+
+int main(void)
+{
+   const char *srcdir = getenv("srcdir");
+   const char *env_kb = getenv("URJ_BENCH_CABLE_KB");
+   long size = (env_kb ? strtol(env_kb, NULL, 0) : 16) * 1024;
+   urj_cable_virtual_stats_t st[NR_PROFILES];
+   size_t i;
+
+   if (srcdir == NULL)
+      srcdir = ".";
+   if (size < 2)
+      size = 2;
+   if (size > 1024 * 1024)
+      bail("image of %ld bytes does not fit into the flash", size);
+
+   urj_log_state.level = URJ_LOG_LEVEL_SILENT;
+
+   if (urj_tap_cable_find("virtual") == NULL)
+      skip_all("virtual cable not available");
+
+   plan(NR_PROFILES * BENCH_NRCHK + 3);
+
+   write_files(size);
+
+   for (i = 0; i < NR_PROFILES; ++i)
+      st[i] = run_bench(srcdir, ProfileAry[i], size);
+
+   /* ProfileAry: none, ft2232d, ft2232h, usbblaster, jlink */
+   ok(st[0].link_ns == 0, "no link costs without a link");
+   ok(st[1].link_ns > st[2].link_ns, "FT2232H is faster than FT2232D");
+   ok(st[3].transactions > st[2].transactions,
+      "USB-Blaster needs more transactions than FT2232H");
+
+   remove(CHAIN_FILE);
+   remove(IMAGE_FILE);
+
+   return 0;
+}
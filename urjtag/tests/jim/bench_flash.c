@@ -0,0 +1,210 @@
+/**
+ * \author SPDX-FileCopyrightText: 2026 UrJTAG contributors
+ *
+ * \copyright SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * \file bench_flash.c
+ * \brief End-to-end flash benchmark on a configured JIM chain.
+ *
+ * Test idea:
+ * * describe a chain of some_cpu with a CFI NOR flash and two generic TAPs
+ *   in a file and connect it with "cable jim config=<file>"
+ * * detect the chain and give the parts their definitions (some_cpu.jtag,
+ *   BYPASS only for the generic TAPs), so no BSDL support is needed
+ * * "initbus prototype", "detectflash", then time "flashmem" and "readmem"
+ *   of a random image and compare the data read back
+ *
+ * The image size and flash size can be changed with URJ_BENCH_FLASH_KB and
+ * URJ_BENCH_FLASH_MB.
+ */
+
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <urjtag/chain.h>
+#include <urjtag/error.h>
+#include <urjtag/log.h>
+#include <urjtag/parse.h>
+#include <urjtag/part.h>
+#include <urjtag/tap.h>
+
+#include "tap/basic.h"
+
+#define CHAIN_FILE "bench_flash.jim"
+#define IMAGE_FILE "bench_flash.bin"
+#define READ_FILE  "bench_flash.out"
+
+/// Generic TAPs after some_cpu (part 0): IR length of parts 1, 2, ...
+static const int GenericIrLen[] = { 5, 8 };
+
+#define NR_GENERIC (sizeof GenericIrLen / sizeof GenericIrLen[0])
+
+static double now(void)
+{
+   struct timespec ts;
+
+   clock_gettime(CLOCK_MONOTONIC, &ts);
+   return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static void write_chain_file(long flash_mb)
+{
+   FILE *f = fopen(CHAIN_FILE, "w");
+
+   if (f == NULL)
+      bail("cannot create " CHAIN_FILE);
+   fprintf(f, "# written by bench_flash\n");
+   fprintf(f, "some_cpu flash=%ld\n", flash_mb);
+   fprintf(f, "generic ir=%d idcode=0x0a1b2c3d bsr=96\n", GenericIrLen[0]);
+   fprintf(f, "generic ir=%d\n", GenericIrLen[1]);
+   fclose(f);
+}
+
+static void write_image(long size)
+{
+   FILE *f = fopen(IMAGE_FILE, "wb");
+   uint32_t x = 12345;
+   long i;
+
+   if (f == NULL)
+      bail("cannot create " IMAGE_FILE);
+   for (i = 0; i < size; ++i)
+   {
+      x = x * 1103515245 + 12345;
+      fputc(x >> 16, f);
+   }
+   fclose(f);
+}
+
+static int same_files(const char *a, const char *b, long size)
+{
+   FILE *fa = fopen(a, "rb");
+   FILE *fb = fopen(b, "rb");
+   int same = fa != NULL && fb != NULL;
+   long i;
+
+   for (i = 0; same && i < size; ++i)
+      same = getc(fa) == getc(fb);
+   if (same)
+      same = getc(fb) == EOF;
+   if (fa)
+      fclose(fa);
+   if (fb)
+      fclose(fb);
+
+   return same;
+}
+
+static int run(urj_chain_t *chain, const char *fmt, ...)
+{
+   char line[1024];
+   va_list ap;
+
+   va_start(ap, fmt);
+   vsnprintf(line, sizeof line, fmt, ap);
+   va_end(ap);
+
+   if (urj_parse_line(chain, line) != URJ_STATUS_OK)
+   {
+      diag("'%s' failed: %s", line, urj_error_describe());
+      urj_error_reset();
+      return 0;
+   }
+   return 1;
+}
+
+static void define_parts(urj_chain_t *chain, const char *srcdir)
+{
+   char path[1024];
+   char ones[33];
+   size_t i;
+
+   for (i = 0; i < NR_GENERIC; ++i)
+   {
+      memset(ones, '1', GenericIrLen[i]);
+      ones[GenericIrLen[i]] = '\0';
+      if (!run(chain, "part %d", (int) i + 1)
+          || !run(chain, "register BR 1")
+          || !run(chain, "instruction length %d", GenericIrLen[i])
+          || !run(chain, "instruction BYPASS %s BR", ones)
+          || !run(chain, "instruction BYPASS"))
+         bail("cannot define generic part %d", (int) i + 1);
+   }
+
+   snprintf(path, sizeof path, "%s/jim/some_cpu.jtag", srcdir);
+   if (!run(chain, "part 0")
+       || urj_parse_include(chain, path, 1) != URJ_STATUS_OK)
+      bail("cannot define some_cpu");
+}
+
+static void report(const char *what, long bytes, double dt)
+{
+   if (dt <= 0)
+      dt = 1e-9;
+   diag("%s: %ld bytes, %.3f s, %.0f bytes/s", what, bytes, dt, bytes / dt);
+}
+
+int main(void)
+{
+   const char *srcdir = getenv("srcdir");
+   const char *env_kb = getenv("URJ_BENCH_FLASH_KB");
+   const char *env_mb = getenv("URJ_BENCH_FLASH_MB");
+   long size = (env_kb ? strtol(env_kb, NULL, 0) : 256) * 1024;
+   long flash_mb = env_mb ? strtol(env_mb, NULL, 0) : 4;
+   char *cable_params[] = { "config=" CHAIN_FILE, NULL };
+   urj_chain_t *chain;
+   double t0;
+   int ok_flash, ok_read;
+
+   if (srcdir == NULL)
+      srcdir = ".";
+   if (size < 2)
+      size = 2;
+   if (size > flash_mb * 1024 * 1024)
+      bail("image of %ld bytes does not fit into %ld MByte", size, flash_mb);
+
+   urj_log_state.level = URJ_LOG_LEVEL_SILENT;
+
+   write_chain_file(flash_mb);
+   write_image(size);
+
+   chain = urj_tap_chain_alloc();
+   if (chain == NULL)
+      bail("urj_tap_chain_alloc() failed");
+   if (urj_tap_chain_connect(chain, "jim", cable_params) != URJ_STATUS_OK)
+      skip_all("JIM cable not available");
+
+   plan(5);
+
+   ok(urj_tap_detect(chain, 0) == URJ_STATUS_OK && chain->parts != NULL
+      && chain->parts->len == 1 + (int) NR_GENERIC, "detect");
+   define_parts(chain, srcdir);
+
+   ok(run(chain, "initbus prototype amsb=A(31) alsb=A(0) dmsb=D(15) "
+          "dlsb=D(0) cs=CS oe=OE we=WE amode=8")
+      && run(chain, "detectflash 0"), "detectflash");
+
+   t0 = now();
+   ok_flash = run(chain, "flashmem 0 %s noverify", IMAGE_FILE);
+   report("flashmem", size, now() - t0);
+   ok(ok_flash, "flashmem");
+
+   t0 = now();
+   ok_read = run(chain, "readmem 0 0x%lx %s", size, READ_FILE);
+   report("readmem", size, now() - t0);
+   ok(ok_read, "readmem");
+
+   ok(same_files(IMAGE_FILE, READ_FILE, size), "data read back");
+
+   urj_tap_chain_free(chain);
+
+   remove(CHAIN_FILE);
+   remove(IMAGE_FILE);
+   remove(READ_FILE);
+
+   return 0;
+}
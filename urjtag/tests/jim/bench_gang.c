@@ -0,0 +1,202 @@
+/**
+ * \author SPDX-FileCopyrightText: 2026 UrJTAG contributors
+ *
+ * \copyright SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * \file bench_gang.c
+ * \brief Aggregate throughput of a gang of modeled FT2232H channels.
+ *
+ * Test idea:
+ * * connect NR_CHANNELS "cable virtual profile=ft2232h realtime=1" as a
+ *   gang, each with a some_cpu and a CFI NOR flash as the chain
+ * * "gang detect" and set up the flash on all channels
+ * * "flashmem" an image on one channel after the other, then on all
+ *   channels at once with "gang flashmem"
+ * * read the flash of every channel back: all of them hold the image
+ * * report the host times; with URJ_BENCH_GANG_STRICT set, also check that
+ *   the channels overlap their link times when they run at once, i.e. that
+ *   the aggregate throughput grows with the number of channels. This is
+ *   left out by default, as loaded machines and valgrind skew the times.
+ *
+ * The image size can be changed with URJ_BENCH_GANG_KB.
+ */
+
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <urjtag/cable.h>
+#include <urjtag/chain.h>
+#include <urjtag/error.h>
+#include <urjtag/log.h>
+#include <urjtag/parse.h>
+
+#include "tap/basic.h"
+
+#define NR_CHANNELS 4
+#define CHAIN_FILE  "bench_gang.jim"
+#define IMAGE_FILE  "bench_gang.bin"
+#define DUMP_FILE   "bench_gang.dmp"
+#define CABLE       "virtual profile=ft2232h realtime=1 config=" CHAIN_FILE
+
+static double now(void)
+{
+   struct timespec ts;
+
+   clock_gettime(CLOCK_MONOTONIC, &ts);
+   return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static void write_files(long size)
+{
+   FILE *f = fopen(CHAIN_FILE, "w");
+   uint32_t x = 12345;
+   long i;
+
+   if (f == NULL)
+      bail("cannot create " CHAIN_FILE);
+   fprintf(f, "some_cpu flash=1\n");
+   fclose(f);
+
+   f = fopen(IMAGE_FILE, "wb");
+   if (f == NULL)
+      bail("cannot create " IMAGE_FILE);
+   for (i = 0; i < size; ++i)
+   {
+      x = x * 1103515245 + 12345;
+      fputc(x >> 16, f);
+   }
+   fclose(f);
+}
+
+static int run(urj_chain_t *chain, const char *fmt, ...)
+{
+   char line[1024];
+   va_list ap;
+
+   va_start(ap, fmt);
+   vsnprintf(line, sizeof line, fmt, ap);
+   va_end(ap);
+
+   if (urj_parse_line(chain, line) != URJ_STATUS_OK)
+   {
+      diag("'%s' failed: %s", line, urj_error_describe());
+      urj_error_reset();
+      return 0;
+   }
+   return 1;
+}
+
+/* whether the flash of chain holds the image of size bytes */
+static int holds_image(urj_chain_t *chain, long size)
+{
+   FILE *a, *b;
+   long i;
+   int ca = 0, cb = 0;
+
+   if (!run(chain, "readmem 0 %ld " DUMP_FILE, size))
+      return 0;
+   a = fopen(IMAGE_FILE, "rb");
+   b = fopen(DUMP_FILE, "rb");
+   for (i = 0; a != NULL && b != NULL && i < size; i++)
+   {
+      ca = fgetc(a);
+      cb = fgetc(b);
+      if (ca != cb)
+      {
+         diag("byte %ld: 0x%02x, expected 0x%02x", i, cb, ca);
+         break;
+      }
+   }
+   if (a != NULL)
+      fclose(a);
+   if (b != NULL)
+      fclose(b);
+
+   return i == size;
+}
+
+int main(void)
+{
+   const char *srcdir = getenv("srcdir");
+   const char *env_kb = getenv("URJ_BENCH_GANG_KB");
+   const char *strict = getenv("URJ_BENCH_GANG_STRICT");
+   long size = (env_kb ? strtol(env_kb, NULL, 0) : 1) * 1024;
+   char path[1024];
+   urj_chain_t *chain;
+   double t0, t_seq, t_par;
+   int i, ok_seq, ok_par, done;
+
+   if (srcdir == NULL)
+      srcdir = ".";
+   if (size < 2)
+      size = 2;
+   if (size > 1024 * 1024)
+      bail("image of %ld bytes does not fit into the flash", size);
+   snprintf(path, sizeof path, "%s/jim/some_cpu.jtag", srcdir);
+
+   urj_log_state.level = URJ_LOG_LEVEL_SILENT;
+
+   if (urj_tap_cable_find("virtual") == NULL)
+      skip_all("virtual cable not available");
+
+   plan(5);
+
+   write_files(size);
+
+   chain = urj_tap_chain_alloc();
+   if (chain == NULL)
+      bail("urj_tap_chain_alloc() failed");
+
+   ok(run(chain, "cable " CABLE)
+      && run(chain, "gang add " CABLE)
+      && run(chain, "gang add " CABLE)
+      && run(chain, "gang add " CABLE)
+      && run(chain, "gang detect")
+      && run(chain, "gang run part 0")
+      && run(chain, "gang run include %s", path)
+      && run(chain, "gang run initbus prototype amsb=A(31) alsb=A(0) "
+             "dmsb=D(15) dlsb=D(0) cs=CS oe=OE we=WE amode=8")
+      && run(chain, "gang run detectflash 0"), "%d channels set up",
+      NR_CHANNELS);
+
+   t0 = now();
+   ok_seq = run(chain, "flashmem 0 %s noverify", IMAGE_FILE);
+   for (i = 0; ok_seq && i < chain->gang_len; ++i)
+      ok_seq = run(chain->gang[i], "flashmem 0 %s noverify", IMAGE_FILE);
+   t_seq = now() - t0;
+   ok(ok_seq, "one channel after the other");
+   diag("sequential: %d x %ld bytes in %.3f s (%.0f bytes/s)",
+        NR_CHANNELS, size, t_seq, NR_CHANNELS * size / t_seq);
+
+   t0 = now();
+   ok_par = run(chain, "gang flashmem 0 %s noverify", IMAGE_FILE);
+   t_par = now() - t0;
+   ok(ok_par, "all channels at once");
+   diag("gang:       %d x %ld bytes in %.3f s (%.0f bytes/s)",
+        NR_CHANNELS, size, t_par, NR_CHANNELS * size / t_par);
+
+   done = ok_par && holds_image(chain, size);
+   for (i = 0; done && i < chain->gang_len; ++i)
+      done = holds_image(chain->gang[i], size);
+   ok(done, "all channels hold the image");
+
+   diag("channels at once are %.1f times faster",
+        t_par > 0 ? t_seq / t_par : 0.0);
+   if (strict != NULL)
+      ok(ok_seq && ok_par && t_par < t_seq * 0.6,
+         "channels overlap their link times");
+   else
+      skip("timing check, set URJ_BENCH_GANG_STRICT to run it");
+
+   urj_tap_chain_free(chain);
+
+   remove(CHAIN_FILE);
+   remove(IMAGE_FILE);
+   remove(DUMP_FILE);
+
+   return 0;
+}
@@ -0,0 +1,229 @@
+/**
+ * \author SPDX-FileCopyrightText: 2026 UrJTAG contributors
+ *
+ * \copyright SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * \file bfin_mem.c
+ * \brief Check the block memory engine of the Blackfin support.
+ *
+ * Test idea:
+ * * connect a "virtual" cable to a JIM Blackfin, set it up as a BF537
+ *   through tests/jim/bfin.jtag and enter emulation: this calibrates the
+ *   wait clocks
+ * * "bfin readmem" fails before emulation is entered
+ * * "bfin writemem" an image and "bfin readmem" it back: the data must
+ *   match, also for a range that does not start or end on a word boundary,
+ *   and P0 and R0 keep their values
+ * * reading 2048 words costs a few round trips, not a few per word
+ * * with slow memory, the wait clocks calibrated with register moves are
+ *   too few; the transfers must still be right and raise them
+ */
+
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <urjtag/bfin.h>
+#include <urjtag/cable.h>
+#include <urjtag/chain.h>
+#include <urjtag/error.h>
+#include <urjtag/log.h>
+#include <urjtag/parse.h>
+#include <urjtag/part.h>
+#include <urjtag/tap.h>
+
+#include "tap/basic.h"
+
+#define CHAIN_FILE "bfin_mem.jim"
+#define IMAGE_FILE "bfin_mem.bin"
+#define DUMP_FILE  "bfin_mem.dmp"
+
+#define RAM_ADR    0x100
+#define IMAGE_SIZE 8192
+/// within the image, neither start nor end on a word boundary
+#define ODD_ADR    0x2003
+#define ODD_SIZE   1001
+
+static int run(urj_chain_t *chain, const char *fmt, ...)
+{
+   char line[1024];
+   va_list ap;
+
+   va_start(ap, fmt);
+   vsnprintf(line, sizeof line, fmt, ap);
+   va_end(ap);
+
+   if (urj_parse_line(chain, line) != URJ_STATUS_OK)
+   {
+      diag("'%s' failed: %s", line, urj_error_describe());
+      urj_error_reset();
+      return 0;
+   }
+   return 1;
+}
+
+static void write_image(int size, int seed)
+{
+   FILE *f = fopen(IMAGE_FILE, "wb");
+   int i;
+
+   if (f == NULL)
+      bail("cannot create " IMAGE_FILE);
+   for (i = 0; i < size; ++i)
+      fputc(i * 37 + (i >> 8) + seed, f);
+   fclose(f);
+}
+
+/* whether the image and the dump are the same */
+static int same_files(int size)
+{
+   FILE *a, *b;
+   int ca, cb, i;
+
+   a = fopen(IMAGE_FILE, "rb");
+   b = fopen(DUMP_FILE, "rb");
+   if (a == NULL || b == NULL)
+   {
+      if (a != NULL)
+         fclose(a);
+      if (b != NULL)
+         fclose(b);
+      return 0;
+   }
+   for (i = 0; i < size; i++)
+   {
+      ca = fgetc(a);
+      cb = fgetc(b);
+      if (ca != cb)
+      {
+         diag("byte %d: 0x%02x, expected 0x%02x", i, cb, ca);
+         break;
+      }
+   }
+   fclose(a);
+   fclose(b);
+
+   return i == size;
+}
+
+/* a chain with one Blackfin described by config, set up as a BF537 */
+static urj_chain_t *connect(const char *config)
+{
+   const char *srcdir = getenv("srcdir");
+   char *cable_params[] = { "profile=ft2232h", "config=" CHAIN_FILE, NULL };
+   urj_part_init_func_t init;
+   char path[1024];
+   urj_chain_t *chain;
+   urj_part_t *part;
+   FILE *f;
+
+   if (srcdir == NULL)
+      srcdir = ".";
+   snprintf(path, sizeof path, "%s/jim/bfin.jtag", srcdir);
+
+   f = fopen(CHAIN_FILE, "w");
+   if (f == NULL)
+      bail("cannot create " CHAIN_FILE);
+   fprintf(f, "%s\n", config);
+   fclose(f);
+
+   chain = urj_tap_chain_alloc();
+   if (chain == NULL)
+      bail("urj_tap_chain_alloc() failed");
+   if (urj_tap_chain_connect(chain, "virtual", cable_params) != URJ_STATUS_OK)
+      bail("cannot connect the virtual cable");
+   if (urj_tap_detect(chain, 0) != URJ_STATUS_OK || chain->parts == NULL
+       || chain->parts->len != 1
+       || urj_parse_include(chain, path, 1) != URJ_STATUS_OK)
+      bail("cannot detect the Blackfin");
+
+   /* what detect does for a part from the data directory */
+   part = chain->parts->parts[0];
+   strcpy(part->part_name, "BF537");
+   init = urj_part_find_init(part->part_name);
+   if (init == NULL)
+      bail("no init function for the BF537");
+   part->params = malloc(sizeof (urj_part_params_t));
+   if (part->params == NULL)
+      bail("out of memory");
+   init(part);
+
+   return chain;
+}
+
+int main(void)
+{
+   urj_cable_virtual_stats_t stats;
+   urj_chain_t *chain;
+   int done, wait;
+
+   urj_log_state.level = URJ_LOG_LEVEL_SILENT;
+
+   if (urj_tap_cable_find("virtual") == NULL)
+      skip_all("virtual cable not available");
+
+   plan(11);
+
+   chain = connect("bfin ram=256");
+
+   ok(!run(chain, "bfin readmem 0x%x 16 " DUMP_FILE, RAM_ADR),
+      "bfin readmem fails outside emulation");
+
+   done = run(chain, "bfin emulation enter");
+   wait = BFIN_PART_WAIT_CLOCKS(chain->parts->parts[0]);
+   diag("calibrated wait clocks: %d", wait);
+   ok(done && wait > 0, "bfin emulation enter calibrates the wait clocks");
+
+   part_register_set(chain, 0, BFIN_REG_P0, 0x12345678);
+   part_register_set(chain, 0, BFIN_REG_R0, 0x9abcdef0);
+
+   write_image(IMAGE_SIZE, 0);
+   ok(run(chain, "bfin writemem 0x%x %d " IMAGE_FILE, RAM_ADR, IMAGE_SIZE),
+      "bfin writemem");
+
+   urj_tap_cable_virtual_stats(chain->cable, &stats, 1);
+   done = run(chain, "bfin readmem 0x%x %d " DUMP_FILE, RAM_ADR, IMAGE_SIZE);
+   urj_tap_cable_virtual_stats(chain->cable, &stats, 1);
+   ok(done && same_files(IMAGE_SIZE), "bfin readmem reads the image back");
+   ok(stats.round_trips > 0 && stats.round_trips * 8 < IMAGE_SIZE / 4,
+      "%lu round trips for %d words", stats.round_trips, IMAGE_SIZE / 4);
+
+   write_image(ODD_SIZE, 55);
+   done = run(chain, "bfin writemem 0x%x %d " IMAGE_FILE, ODD_ADR, ODD_SIZE)
+      && run(chain, "bfin readmem 0x%x %d " DUMP_FILE, ODD_ADR, ODD_SIZE);
+   ok(done && same_files(ODD_SIZE), "%d bytes at 0x%x", ODD_SIZE, ODD_ADR);
+
+   ok(part_register_get(chain, 0, BFIN_REG_P0) == 0x12345678
+      && part_register_get(chain, 0, BFIN_REG_R0) == 0x9abcdef0,
+      "P0 and R0 are kept");
+
+   urj_tap_chain_free(chain);
+
+   /* memory accesses take 60 more TCKs than register moves */
+   chain = connect("bfin ram=256 mem=60");
+
+   done = run(chain, "bfin emulation enter");
+   wait = BFIN_PART_WAIT_CLOCKS(chain->parts->parts[0]);
+   ok(done && wait > 0 && wait < 60, "%d wait clocks for register moves",
+      wait);
+
+   write_image(IMAGE_SIZE, 99);
+   ok(run(chain, "bfin writemem 0x%x %d " IMAGE_FILE, RAM_ADR, IMAGE_SIZE),
+      "bfin writemem to slow memory");
+   ok(run(chain, "bfin readmem 0x%x %d " DUMP_FILE, RAM_ADR, IMAGE_SIZE)
+      && same_files(IMAGE_SIZE), "bfin readmem from slow memory");
+   diag("wait clocks after the transfers: %d",
+        BFIN_PART_WAIT_CLOCKS(chain->parts->parts[0]));
+   ok(BFIN_PART_WAIT_CLOCKS(chain->parts->parts[0]) >= 60,
+      "the transfers raised the wait clocks");
+
+   urj_tap_chain_free(chain);
+
+   remove(CHAIN_FILE);
+   remove(IMAGE_FILE);
+   remove(DUMP_FILE);
+
+   return 0;
+}
@@ -0,0 +1,187 @@
+/**
+ * \author SPDX-FileCopyrightText: 2026 UrJTAG contributors
+ *
+ * \copyright SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * \file bfin_smp.c
+ * \brief Check the chain-wide scans for several Blackfin cores.
+ *
+ * Test idea:
+ * * connect a "virtual" cable to a JIM chain with two Blackfin cores, as
+ *   on a BF561, and set both up through tests/jim/bfin.jtag
+ * * "bfin emulation enter all" halts both cores
+ * * chain_register_set() and chain_register_get() write and read a
+ *   different value on each core, for a data register and for one that
+ *   goes through R0, and cost fewer round trips than the same accesses
+ *   core by core
+ * * "bfin emulation singlestep all" steps both cores once
+ * * "bfin emulation return all" lets both cores run again
+ */
+
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <urjtag/bfin.h>
+#include <urjtag/cable.h>
+#include <urjtag/chain.h>
+#include <urjtag/error.h>
+#include <urjtag/log.h>
+#include <urjtag/parse.h>
+#include <urjtag/part.h>
+#include <urjtag/tap.h>
+
+#include "tap/basic.h"
+
+#define CHAIN_FILE "bfin_smp.jim"
+
+static int run(urj_chain_t *chain, const char *fmt, ...)
+{
+   char line[1024];
+   va_list ap;
+
+   va_start(ap, fmt);
+   vsnprintf(line, sizeof line, fmt, ap);
+   va_end(ap);
+
+   if (urj_parse_line(chain, line) != URJ_STATUS_OK)
+   {
+      diag("'%s' failed: %s", line, urj_error_describe());
+      urj_error_reset();
+      return 0;
+   }
+   return 1;
+}
+
+/* whether both cores are in emulation mode */
+static int both_halted(urj_chain_t *chain)
+{
+   chain_dbgstat_get(chain);
+   return part_dbgstat_is_emuready(chain, 0)
+      && part_dbgstat_is_emuready(chain, 1);
+}
+
+int main(void)
+{
+   const char *srcdir = getenv("srcdir");
+   char *cable_params[] = { "profile=ft2232h", "config=" CHAIN_FILE, NULL };
+   urj_cable_virtual_stats_t stats;
+   urj_part_init_func_t init;
+   uint32_t values[2], r0[2], pc[2];
+   unsigned long core_rt, chain_rt;
+   char path[1024];
+   urj_chain_t *chain;
+   urj_part_t *part;
+   FILE *f;
+   int n;
+
+   if (srcdir == NULL)
+      srcdir = ".";
+   snprintf(path, sizeof path, "%s/jim/bfin.jtag", srcdir);
+
+   urj_log_state.level = URJ_LOG_LEVEL_SILENT;
+
+   if (urj_tap_cable_find("virtual") == NULL)
+      skip_all("virtual cable not available");
+
+   plan(8);
+
+   f = fopen(CHAIN_FILE, "w");
+   if (f == NULL)
+      bail("cannot create " CHAIN_FILE);
+   fprintf(f, "bfin ram=64\nbfin ram=64\n");
+   fclose(f);
+
+   chain = urj_tap_chain_alloc();
+   if (chain == NULL)
+      bail("urj_tap_chain_alloc() failed");
+   if (urj_tap_chain_connect(chain, "virtual", cable_params) != URJ_STATUS_OK)
+      bail("cannot connect the virtual cable");
+   if (urj_tap_detect(chain, 0) != URJ_STATUS_OK || chain->parts == NULL
+       || chain->parts->len != 2)
+      bail("cannot detect the Blackfin cores");
+
+   /* what detect does for parts from the data directory */
+   init = urj_part_find_init("BF561");
+   if (init == NULL)
+      bail("no init function for the BF561");
+   for (n = 0; n < 2; n++)
+   {
+      if (!run(chain, "part %d", n)
+          || urj_parse_include(chain, path, 1) != URJ_STATUS_OK)
+         bail("cannot set up core %d", n);
+      part = chain->parts->parts[n];
+      strcpy(part->part_name, "BF561");
+      part->params = malloc(sizeof (urj_part_params_t));
+      if (part->params == NULL)
+         bail("out of memory");
+      init(part);
+   }
+   run(chain, "part 0");
+
+   ok(run(chain, "bfin emulation enter all") && both_halted(chain),
+      "bfin emulation enter all halts both cores");
+
+   values[0] = 0x11111111;
+   values[1] = 0x22222222;
+   chain_register_set(chain, BFIN_REG_R3, values);
+   values[0] = values[1] = 0;
+   chain_register_get(chain, BFIN_REG_R3, values);
+   ok(values[0] == 0x11111111 && values[1] == 0x22222222,
+      "R3 of each core: 0x%08x 0x%08x", values[0], values[1]);
+
+   values[0] = 0x66666666;
+   values[1] = 0x77777777;
+   chain_register_set(chain, BFIN_REG_R0, values);
+   values[0] = 0x33333333;
+   values[1] = 0x44444444;
+   chain_register_set(chain, BFIN_REG_I0, values);
+   values[0] = values[1] = 0;
+   chain_register_get(chain, BFIN_REG_I0, values);
+   chain_register_get(chain, BFIN_REG_R0, r0);
+   ok(values[0] == 0x33333333 && values[1] == 0x44444444
+      && r0[0] == 0x66666666 && r0[1] == 0x77777777,
+      "I0 of each core: 0x%08x 0x%08x, R0 kept", values[0], values[1]);
+
+   part_register_set(chain, 0, BFIN_REG_R3, 0x55555555);
+   ok(part_register_get(chain, 1, BFIN_REG_R3) == 0x22222222,
+      "part_register_set() leaves the other core alone");
+
+   urj_tap_cable_virtual_stats(chain->cable, &stats, 1);
+   for (n = 0; n < 2; n++)
+      values[n] = part_register_get(chain, n, BFIN_REG_R3);
+   urj_tap_cable_virtual_stats(chain->cable, &stats, 1);
+   core_rt = stats.round_trips;
+   chain_register_get(chain, BFIN_REG_R3, values);
+   urj_tap_cable_virtual_stats(chain->cable, &stats, 1);
+   chain_rt = stats.round_trips;
+   diag("R3 of both cores: %lu round trips core by core, %lu at once",
+        core_rt, chain_rt);
+   ok(chain_rt > 0 && chain_rt < core_rt,
+      "chain_register_get() costs fewer round trips");
+
+   chain_emupc_get(chain, 0);
+   for (n = 0; n < 2; n++)
+      pc[n] = BFIN_PART_EMUPC(chain->parts->parts[n]);
+   ok(run(chain, "bfin emulation singlestep all") && both_halted(chain)
+      && part_dbgstat_emucause(chain, 0) == 0x8
+      && part_dbgstat_emucause(chain, 1) == 0x8,
+      "bfin emulation singlestep all keeps both cores halted");
+   chain_emupc_get(chain, 0);
+   ok(BFIN_PART_EMUPC(chain->parts->parts[0]) == pc[0] + 2
+      && BFIN_PART_EMUPC(chain->parts->parts[1]) == pc[1] + 2,
+      "both cores stepped one instruction");
+
+   run(chain, "bfin emulation return all");
+   chain_dbgstat_get(chain);
+   ok(!part_dbgstat_is_emuack(chain, 0) && !part_dbgstat_is_emuack(chain, 1),
+      "bfin emulation return all lets both cores run");
+
+   urj_tap_chain_free(chain);
+
+   remove(CHAIN_FILE);
+
+   return 0;
+}
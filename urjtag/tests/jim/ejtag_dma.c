@@ -0,0 +1,197 @@
+/**
+ * \author SPDX-FileCopyrightText: 2026 UrJTAG contributors
+ *
+ * \copyright SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * \file ejtag_dma.c
+ * \brief Check the batched DMA transfers of the ejtag_dma bus driver.
+ *
+ * Test idea:
+ * * connect a "virtual" cable to a JIM chain with two MIPS processors, one
+ *   with instant DMA transfers and one with transfers of 40 TCK cycles, set
+ *   both up through tests/jim/mips.jtag and "initbus ejtag_dma"
+ * * "writemem" a different image through each bus and "readmem" both back:
+ *   the data must match, so the two buses do not share their registers
+ * * reading a block of 1024 words costs a few round trips, not a few per
+ *   word
+ * * "readmem" from a mapped address ends in Derr and fails
+ */
+
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <urjtag/bus.h>
+#include <urjtag/cable.h>
+#include <urjtag/chain.h>
+#include <urjtag/error.h>
+#include <urjtag/log.h>
+#include <urjtag/parse.h>
+#include <urjtag/part.h>
+#include <urjtag/tap.h>
+
+#include "tap/basic.h"
+
+#define CHAIN_FILE "ejtag_dma.jim"
+#define IMAGE_FILE "ejtag_dma%d.bin"
+#define DUMP_FILE  "ejtag_dma.dmp"
+
+/// kseg1, over the RAM of the processors
+#define RAM_ADR    0xa0000100
+#define IMAGE_SIZE 4096
+/// kseg2, mapped
+#define MAPPED_ADR 0xc0000000
+
+static int run(urj_chain_t *chain, const char *fmt, ...)
+{
+   char line[1024];
+   va_list ap;
+
+   va_start(ap, fmt);
+   vsnprintf(line, sizeof line, fmt, ap);
+   va_end(ap);
+
+   if (urj_parse_line(chain, line) != URJ_STATUS_OK)
+   {
+      diag("'%s' failed: %s", line, urj_error_describe());
+      urj_error_reset();
+      return 0;
+   }
+   return 1;
+}
+
+static void write_files(void)
+{
+   char name[64];
+   FILE *f = fopen(CHAIN_FILE, "w");
+   int i, n;
+
+   if (f == NULL)
+      bail("cannot create " CHAIN_FILE);
+   fprintf(f, "mips ram=64 dma=0\nmips ram=64 dma=40\n");
+   fclose(f);
+
+   for (n = 0; n < 2; n++)
+   {
+      snprintf(name, sizeof name, IMAGE_FILE, n);
+      f = fopen(name, "wb");
+      if (f == NULL)
+         bail("cannot create %s", name);
+      for (i = 0; i < IMAGE_SIZE; ++i)
+         fputc(i * 37 + (i >> 8) + n * 101, f);
+      fclose(f);
+   }
+}
+
+/* whether image n and the dump are the same */
+static int same_files(int n)
+{
+   char name[64];
+   FILE *a, *b;
+   int ca, cb, i;
+
+   snprintf(name, sizeof name, IMAGE_FILE, n);
+   a = fopen(name, "rb");
+   b = fopen(DUMP_FILE, "rb");
+   if (a == NULL || b == NULL)
+   {
+      if (a != NULL)
+         fclose(a);
+      if (b != NULL)
+         fclose(b);
+      return 0;
+   }
+   for (i = 0; i < IMAGE_SIZE; i++)
+   {
+      ca = fgetc(a);
+      cb = fgetc(b);
+      if (ca != cb)
+      {
+         diag("byte %d: 0x%02x, expected 0x%02x", i, cb, ca);
+         break;
+      }
+   }
+   fclose(a);
+   fclose(b);
+
+   return i == IMAGE_SIZE;
+}
+
+int main(void)
+{
+   const char *srcdir = getenv("srcdir");
+   char *cable_params[] = { "profile=ft2232h", "config=" CHAIN_FILE, NULL };
+   urj_cable_virtual_stats_t stats;
+   char path[1024];
+   urj_chain_t *chain;
+   int done, n;
+
+   if (srcdir == NULL)
+      srcdir = ".";
+   snprintf(path, sizeof path, "%s/jim/mips.jtag", srcdir);
+
+   urj_log_state.level = URJ_LOG_LEVEL_SILENT;
+
+   if (urj_tap_cable_find("virtual") == NULL)
+      skip_all("virtual cable not available");
+
+   plan(6);
+
+   write_files();
+
+   chain = urj_tap_chain_alloc();
+   if (chain == NULL)
+      bail("urj_tap_chain_alloc() failed");
+   if (urj_tap_chain_connect(chain, "virtual", cable_params) != URJ_STATUS_OK)
+      bail("cannot connect the virtual cable");
+
+   done = urj_tap_detect(chain, 0) == URJ_STATUS_OK && chain->parts != NULL
+      && chain->parts->len == 2;
+   for (n = 0; done && n < 2; n++)
+      done = run(chain, "part %d", n)
+         && urj_parse_include(chain, path, 1) == URJ_STATUS_OK;
+   for (n = 0; done && n < 2; n++)
+      done = run(chain, "part %d", n) && run(chain, "initbus ejtag_dma");
+   ok(done && chain->buses.len == 2, "initbus ejtag_dma on both processors");
+
+   done = 1;
+   for (n = 0; done && n < 2; n++)
+      done = run(chain, "bus %d", n)
+         && run(chain, "writemem 0x%x %d " IMAGE_FILE, RAM_ADR, IMAGE_SIZE, n);
+   ok(done, "writemem through both buses");
+
+   for (n = 0; n < 2; n++)
+   {
+      urj_tap_cable_virtual_stats(chain->cable, &stats, 1);
+      done = run(chain, "bus %d", n)
+         && run(chain, "readmem 0x%x %d " DUMP_FILE, RAM_ADR, IMAGE_SIZE);
+      urj_tap_cable_virtual_stats(chain->cable, &stats, 1);
+      ok(done && same_files(n), "readmem through bus %d", n);
+      diag("bus %d: %d bytes: %lu round trips to read", n, IMAGE_SIZE,
+           stats.round_trips);
+      if (n == 0)
+         ok(stats.round_trips > 0
+            && stats.round_trips * 8 < IMAGE_SIZE / 4,
+            "%lu round trips for %d words", stats.round_trips,
+            IMAGE_SIZE / 4);
+   }
+
+   ok(!run(chain, "readmem 0x%x 16 " DUMP_FILE, MAPPED_ADR),
+      "readmem from a mapped address fails");
+
+   urj_tap_chain_free(chain);
+
+   remove(CHAIN_FILE);
+   remove(DUMP_FILE);
+   for (n = 0; n < 2; n++)
+   {
+      char name[64];
+
+      snprintf(name, sizeof name, IMAGE_FILE, n);
+      remove(name);
+   }
+
+   return 0;
+}
@@ -0,0 +1,201 @@
+/**
+ * \author SPDX-FileCopyrightText: 2026 UrJTAG contributors
+ *
+ * \copyright SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * \file ejtag_fastdata.c
+ * \brief Check the FASTDATA block transfers of the ejtag bus driver.
+ *
+ * Test idea:
+ * * connect a "virtual" cable to a JIM chain with a MIPS processor, set
+ *   it up through tests/jim/mips.jtag and "initbus ejtag"
+ * * "writemem" an image to the 32 bit area and a part of it to the 8 bit
+ *   area and "readmem" both back: the data must match
+ * * with FASTDATA, a block of 256 words costs a few round trips; without
+ *   it (fastdata=0, the self-test fails and the driver falls back to one
+ *   PrAcc run per word) many more
+ * * the same with processors that fetch 0 and 2 instructions ahead
+ */
+
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <urjtag/bus.h>
+#include <urjtag/cable.h>
+#include <urjtag/chain.h>
+#include <urjtag/error.h>
+#include <urjtag/log.h>
+#include <urjtag/parse.h>
+#include <urjtag/tap.h>
+
+#include "tap/basic.h"
+
+#define CHAIN_FILE "ejtag_fastdata.jim"
+#define IMAGE_FILE "ejtag_fastdata.bin"
+#define DUMP_FILE  "ejtag_fastdata.dmp"
+
+/// the 32 bit and the 8 bit area of the ejtag bus, over the same RAM
+#define WORD_ADR   0x40000100
+#define BYTE_ADR   0x00004003
+#define IMAGE_SIZE 8192
+#define BYTE_SIZE  1000
+
+typedef struct
+{
+   unsigned long write;
+   unsigned long read;
+}
+round_trips_t;
+
+static int run(urj_chain_t *chain, const char *fmt, ...)
+{
+   char line[1024];
+   va_list ap;
+
+   va_start(ap, fmt);
+   vsnprintf(line, sizeof line, fmt, ap);
+   va_end(ap);
+
+   if (urj_parse_line(chain, line) != URJ_STATUS_OK)
+   {
+      diag("'%s' failed: %s", line, urj_error_describe());
+      urj_error_reset();
+      return 0;
+   }
+   return 1;
+}
+
+static void write_files(int lag, int fastdata)
+{
+   FILE *f = fopen(CHAIN_FILE, "w");
+   int i;
+
+   if (f == NULL)
+      bail("cannot create " CHAIN_FILE);
+   fprintf(f, "mips ram=64 lag=%d fastdata=%d\n", lag, fastdata);
+   fclose(f);
+
+   f = fopen(IMAGE_FILE, "wb");
+   if (f == NULL)
+      bail("cannot create " IMAGE_FILE);
+   for (i = 0; i < IMAGE_SIZE; ++i)
+      fputc(i * 41 + (i >> 8) + lag, f);
+   fclose(f);
+}
+
+/* whether the first len bytes of the image and the dump are the same */
+static int same_files(int len)
+{
+   FILE *a = fopen(IMAGE_FILE, "rb");
+   FILE *b = fopen(DUMP_FILE, "rb");
+   int ca, cb, n;
+
+   if (a == NULL || b == NULL)
+   {
+      if (a != NULL)
+         fclose(a);
+      if (b != NULL)
+         fclose(b);
+      return 0;
+   }
+   for (n = 0; n < len; n++)
+   {
+      ca = fgetc(a);
+      cb = fgetc(b);
+      if (ca != cb)
+      {
+         diag("byte %d: 0x%02x, expected 0x%02x", n, cb, ca);
+         break;
+      }
+   }
+   fclose(a);
+   fclose(b);
+
+   return n == len;
+}
+
+/* write and dump the image, return the round trips */
+static round_trips_t transfer(const char *path, int lag, int fastdata)
+{
+   char *cable_params[] = { "profile=ft2232h", "config=" CHAIN_FILE, NULL };
+   urj_cable_virtual_stats_t stats;
+   round_trips_t rt = { 0, 0 };
+   urj_chain_t *chain;
+   int done;
+
+   write_files(lag, fastdata);
+
+   chain = urj_tap_chain_alloc();
+   if (chain == NULL)
+      bail("urj_tap_chain_alloc() failed");
+   if (urj_tap_chain_connect(chain, "virtual", cable_params) != URJ_STATUS_OK)
+      bail("cannot connect the virtual cable");
+
+   done = urj_tap_detect(chain, 0) == URJ_STATUS_OK
+      && urj_parse_include(chain, path, 1) == URJ_STATUS_OK
+      && run(chain, "initbus ejtag") && chain->bus != NULL;
+   if (done)
+   {
+      urj_tap_cable_virtual_stats(chain->cable, &stats, 1);
+      done = run(chain, "writemem 0x%x %d %s", WORD_ADR, IMAGE_SIZE,
+                 IMAGE_FILE);
+      urj_tap_cable_virtual_stats(chain->cable, &stats, 1);
+      rt.write = stats.round_trips;
+   }
+   ok(done, "lag=%d fastdata=%d: initbus and writemem", lag, fastdata);
+
+   done = run(chain, "readmem 0x%x %d %s", WORD_ADR, IMAGE_SIZE, DUMP_FILE);
+   urj_tap_cable_virtual_stats(chain->cable, &stats, 1);
+   rt.read = stats.round_trips;
+   ok(done && same_files(IMAGE_SIZE), "lag=%d fastdata=%d: readmem",
+      lag, fastdata);
+
+   ok(run(chain, "writemem 0x%x %d %s", BYTE_ADR, BYTE_SIZE, IMAGE_FILE)
+      && run(chain, "readmem 0x%x %d %s", BYTE_ADR, BYTE_SIZE, DUMP_FILE)
+      && same_files(BYTE_SIZE), "lag=%d fastdata=%d: bytes", lag, fastdata);
+
+   diag("lag=%d fastdata=%d: %d bytes: %lu round trips to write, %lu to read",
+        lag, fastdata, IMAGE_SIZE, rt.write, rt.read);
+
+   urj_tap_chain_free(chain);
+
+   remove(CHAIN_FILE);
+   remove(IMAGE_FILE);
+   remove(DUMP_FILE);
+
+   return rt;
+}
+
+int main(void)
+{
+   const char *srcdir = getenv("srcdir");
+   char path[1024];
+   round_trips_t fast, slow;
+
+   if (srcdir == NULL)
+      srcdir = ".";
+   snprintf(path, sizeof path, "%s/jim/mips.jtag", srcdir);
+
+   urj_log_state.level = URJ_LOG_LEVEL_SILENT;
+
+   if (urj_tap_cable_find("virtual") == NULL)
+      skip_all("virtual cable not available");
+
+   plan(14);
+
+   fast = transfer(path, 1, 1);
+   slow = transfer(path, 1, 0);
+   ok(fast.write > 0 && fast.write * 10 < slow.write,
+      "writes with FASTDATA: %lu vs. %lu round trips", fast.write,
+      slow.write);
+   ok(fast.read > 0 && fast.read * 10 < slow.read,
+      "reads with FASTDATA: %lu vs. %lu round trips", fast.read, slow.read);
+
+   transfer(path, 0, 1);
+   transfer(path, 2, 1);
+
+   return 0;
+}
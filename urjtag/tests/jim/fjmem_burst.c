@@ -0,0 +1,196 @@
+/**
+ * \author SPDX-FileCopyrightText: 2026 UrJTAG contributors
+ *
+ * \copyright SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * \file fjmem_burst.c
+ * \brief Check the read bursts of the fjmem bus driver.
+ *
+ * Test idea:
+ * * connect a "virtual" cable to a JIM chain with an FPGA that has the fjmem
+ *   core in USER1 between two generic TAPs in BYPASS
+ * * "initbus fjmem", "writemem" an image and "readmem" it back: the data
+ *   must match, and with bursts the dump costs a few round trips per 256
+ *   words instead of one per word
+ * * the same with a core without bursts (burst=0), where the driver has to
+ *   fall back to single reads
+ */
+
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <urjtag/bus.h>
+#include <urjtag/cable.h>
+#include <urjtag/chain.h>
+#include <urjtag/error.h>
+#include <urjtag/log.h>
+#include <urjtag/parse.h>
+#include <urjtag/tap.h>
+
+#include "tap/basic.h"
+
+#define CHAIN_FILE "fjmem_burst.jim"
+#define IMAGE_FILE "fjmem_burst.bin"
+#define DUMP_FILE  "fjmem_burst.dmp"
+
+#define IMAGE_ADR  0x102
+#define IMAGE_SIZE 6000
+
+/// IR lengths of the generic TAPs, parts 0 and 2
+static const int GenericIrLen[] = { 5, 8 };
+
+static int run(urj_chain_t *chain, const char *fmt, ...)
+{
+   char line[1024];
+   va_list ap;
+
+   va_start(ap, fmt);
+   vsnprintf(line, sizeof line, fmt, ap);
+   va_end(ap);
+
+   if (urj_parse_line(chain, line) != URJ_STATUS_OK)
+   {
+      diag("'%s' failed: %s", line, urj_error_describe());
+      urj_error_reset();
+      return 0;
+   }
+   return 1;
+}
+
+static void write_files(int burst)
+{
+   FILE *f = fopen(CHAIN_FILE, "w");
+   int i;
+
+   if (f == NULL)
+      bail("cannot create " CHAIN_FILE);
+   fprintf(f, "generic ir=%d\n", GenericIrLen[0]);
+   fprintf(f, "fpga fjmem=16 burst=%d\n", burst);
+   fprintf(f, "generic ir=%d\n", GenericIrLen[1]);
+   fclose(f);
+
+   f = fopen(IMAGE_FILE, "wb");
+   if (f == NULL)
+      bail("cannot create " IMAGE_FILE);
+   for (i = 0; i < IMAGE_SIZE; ++i)
+      fputc(i * 37 + (i >> 8), f);
+   fclose(f);
+}
+
+static int define_parts(urj_chain_t *chain, const char *path)
+{
+   char ones[33];
+   int i;
+
+   for (i = 0; i < 2; ++i)
+   {
+      memset(ones, '1', GenericIrLen[i]);
+      ones[GenericIrLen[i]] = '\0';
+      if (!run(chain, "part %d", 2 * i)
+          || !run(chain, "register BR 1")
+          || !run(chain, "instruction length %d", GenericIrLen[i])
+          || !run(chain, "instruction BYPASS %s BR", ones)
+          || !run(chain, "instruction BYPASS"))
+         return 0;
+   }
+
+   return run(chain, "part 1")
+      && urj_parse_include(chain, path, 1) == URJ_STATUS_OK;
+}
+
+static int same_files(void)
+{
+   FILE *a = fopen(IMAGE_FILE, "rb");
+   FILE *b = fopen(DUMP_FILE, "rb");
+   int ca, cb, n = 0;
+
+   if (a == NULL || b == NULL)
+   {
+      if (a != NULL)
+         fclose(a);
+      if (b != NULL)
+         fclose(b);
+      return 0;
+   }
+   do
+   {
+      ca = fgetc(a);
+      cb = fgetc(b);
+      if (ca != cb)
+         diag("byte %d: 0x%02x, expected 0x%02x", n, cb, ca);
+      n++;
+   }
+   while (ca == cb && ca != EOF);
+   fclose(a);
+   fclose(b);
+
+   return ca == cb;
+}
+
+/* write and dump the image, return the round trips of the dump */
+static unsigned long dump(const char *path, int burst)
+{
+   char *cable_params[] = { "profile=ft2232h", "config=" CHAIN_FILE, NULL };
+   urj_cable_virtual_stats_t stats;
+   urj_chain_t *chain;
+   int ok_dump;
+
+   write_files(burst);
+
+   chain = urj_tap_chain_alloc();
+   if (chain == NULL)
+      bail("urj_tap_chain_alloc() failed");
+   if (urj_tap_chain_connect(chain, "virtual", cable_params) != URJ_STATUS_OK)
+      bail("cannot connect the virtual cable");
+
+   ok(urj_tap_detect(chain, 0) == URJ_STATUS_OK
+      && define_parts(chain, path)
+      && run(chain, "initbus fjmem opcode=000010")
+      && run(chain, "writemem 0x%x %d %s", IMAGE_ADR, IMAGE_SIZE, IMAGE_FILE),
+      "burst=%d: initbus and writemem", burst);
+
+   urj_tap_cable_virtual_stats(chain->cable, &stats, 1);
+   ok_dump = run(chain, "readmem 0x%x %d %s", IMAGE_ADR, IMAGE_SIZE,
+                 DUMP_FILE);
+   urj_tap_cable_virtual_stats(chain->cable, &stats, 1);
+   ok(ok_dump && same_files(), "burst=%d: readmem", burst);
+   diag("burst=%d: %d bytes: %lu round trips", burst, IMAGE_SIZE,
+        (unsigned long) stats.round_trips);
+
+   urj_tap_chain_free(chain);
+
+   remove(CHAIN_FILE);
+   remove(IMAGE_FILE);
+   remove(DUMP_FILE);
+
+   return stats.round_trips;
+}
+
+int main(void)
+{
+   const char *srcdir = getenv("srcdir");
+   char path[1024];
+   unsigned long rt;
+
+   if (srcdir == NULL)
+      srcdir = ".";
+   snprintf(path, sizeof path, "%s/jim/fpga.jtag", srcdir);
+
+   urj_log_state.level = URJ_LOG_LEVEL_SILENT;
+
+   if (urj_tap_cable_find("virtual") == NULL)
+      skip_all("virtual cable not available");
+
+   plan(6);
+
+   rt = dump(path, 1);
+   ok(rt < 2 * (IMAGE_SIZE / 2 / 256 + 8), "bursts of up to 256 words");
+
+   rt = dump(path, 0);
+   ok(rt >= IMAGE_SIZE / 2, "one round trip per word without bursts");
+
+   return 0;
+}
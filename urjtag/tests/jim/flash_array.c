@@ -0,0 +1,140 @@
+/**
+ * \author SPDX-FileCopyrightText: 2026 UrJTAG contributors
+ *
+ * \copyright SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * \file flash_array.c
+ * \brief Check programming of a 2 x 16 bit CFI flash array.
+ *
+ * Test idea:
+ * * connect a "virtual" cable to a JIM chain with a some_cpu and two x16
+ *   CFI NOR flashes side by side on a 32 bit bus, "initbus prototype" and
+ *   "detectflash"
+ * * "flashmem" an image with verify, check that the 2 x 16 bit driver took
+ *   the chips and read a word back, whose halves come from different chips
+ * * "flashmem" it again without verify and check that the chips programmed
+ *   their write buffers together: the run costs a quarter of the round trips
+ *   on a modeled USB adapter that programming word by word would, at one
+ *   status poll per bus word
+ */
+
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <urjtag/bus.h>
+#include <urjtag/cable.h>
+#include <urjtag/chain.h>
+#include <urjtag/error.h>
+#include <urjtag/flash.h>
+#include <urjtag/log.h>
+#include <urjtag/parse.h>
+#include <urjtag/tap.h>
+
+#include "tap/basic.h"
+
+#define CHAIN_FILE "flash_array.jim"
+#define IMAGE_FILE "flash_array.bin"
+
+#define IMAGE_SIZE 8192
+/// bytes 4 to 7 of the image (i * 29) as one little-endian word
+#define WORD ((203u << 24) | (174 << 16) | (145 << 8) | 116)
+
+static int run(urj_chain_t *chain, const char *fmt, ...)
+{
+   char line[1024];
+   va_list ap;
+
+   va_start(ap, fmt);
+   vsnprintf(line, sizeof line, fmt, ap);
+   va_end(ap);
+
+   if (urj_parse_line(chain, line) != URJ_STATUS_OK)
+   {
+      diag("'%s' failed: %s", line, urj_error_describe());
+      urj_error_reset();
+      return 0;
+   }
+   return 1;
+}
+
+static void write_files(void)
+{
+   FILE *f = fopen(CHAIN_FILE, "w");
+   int i;
+
+   if (f == NULL)
+      bail("cannot create " CHAIN_FILE);
+   fprintf(f, "some_cpu flash=1 chips=2\n");
+   fclose(f);
+
+   f = fopen(IMAGE_FILE, "wb");
+   if (f == NULL)
+      bail("cannot create " IMAGE_FILE);
+   for (i = 0; i < IMAGE_SIZE; ++i)
+      fputc(i * 29, f);
+   fclose(f);
+}
+
+int main(void)
+{
+   const char *srcdir = getenv("srcdir");
+   char *cable_params[] = { "profile=ft2232h", "config=" CHAIN_FILE, NULL };
+   urj_cable_virtual_stats_t stats;
+   char path[1024];
+   urj_chain_t *chain;
+   uint32_t word;
+
+   if (srcdir == NULL)
+      srcdir = ".";
+   snprintf(path, sizeof path, "%s/jim/some_cpu.jtag", srcdir);
+
+   urj_log_state.level = URJ_LOG_LEVEL_SILENT;
+
+   write_files();
+
+   chain = urj_tap_chain_alloc();
+   if (chain == NULL)
+      bail("urj_tap_chain_alloc() failed");
+   if (urj_tap_cable_find("virtual") == NULL
+       || urj_tap_chain_connect(chain, "virtual", cable_params) != URJ_STATUS_OK)
+      skip_all("virtual cable not available");
+
+   plan(5);
+
+   ok(urj_tap_detect(chain, 0) == URJ_STATUS_OK
+      && run(chain, "part 0")
+      && urj_parse_include(chain, path, 1) == URJ_STATUS_OK
+      && run(chain, "initbus prototype amsb=A(31) alsb=A(0) dmsb=D(31) "
+             "dlsb=D(0) cs=CS oe=OE we=WE amode=8")
+      && run(chain, "detectflash 0"), "detectflash");
+   if (chain->bus == NULL)
+      bail("no bus");
+
+   ok(run(chain, "flashmem 0 %s", IMAGE_FILE), "flashmem with verify");
+   ok(chain->bus->flash_driver != NULL
+      && chain->bus->flash_driver->bus_width == 4, "32 bit driver");
+
+   word = URJ_BUS_READ(chain->bus, 4);
+   if (word != WORD)
+      diag("word 0x%08lx, expected 0x%08lx", (unsigned long) word,
+           (unsigned long) WORD);
+   ok(word == WORD, "both halves of a word");
+
+   urj_tap_cable_virtual_stats(chain->cable, &stats, 1);
+   if (!run(chain, "flashmem 0 %s noverify", IMAGE_FILE))
+      stats.round_trips = IMAGE_SIZE;
+   else
+      urj_tap_cable_virtual_stats(chain->cable, &stats, 1);
+   diag("%d bus words: %lu round trips", IMAGE_SIZE / 4,
+        (unsigned long) stats.round_trips);
+   ok(stats.round_trips < IMAGE_SIZE / 16, "chips program buffers together");
+
+   urj_tap_chain_free(chain);
+
+   remove(CHAIN_FILE);
+   remove(IMAGE_FILE);
+
+   return 0;
+}
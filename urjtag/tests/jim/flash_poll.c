@@ -0,0 +1,146 @@
+/**
+ * \author SPDX-FileCopyrightText: 2026 UrJTAG contributors
+ *
+ * \copyright SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * \file flash_poll.c
+ * \brief Check the queued repeated reads that flash status polling uses.
+ *
+ * Test idea:
+ * * connect a "virtual" cable to a JIM chain with a some_cpu and a CFI NOR
+ *   flash, "initbus prototype" and "detectflash"
+ * * "flashmem" a small image, which polls the status after every erase
+ *   and program
+ * * read a word of the image with urj_bus_read_repeat() and check that
+ *   every read gives the word and that all reads together cost one round
+ *   trip on a modeled USB adapter, where single URJ_BUS_READ cost one each
+ */
+
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <urjtag/bus.h>
+#include <urjtag/cable.h>
+#include <urjtag/chain.h>
+#include <urjtag/error.h>
+#include <urjtag/log.h>
+#include <urjtag/parse.h>
+#include <urjtag/tap.h>
+
+#include "tap/basic.h"
+
+#define CHAIN_FILE "flash_poll.jim"
+#define IMAGE_FILE "flash_poll.bin"
+
+#define NR_READS 16
+/// bytes 2 and 3 of the image as one little-endian word
+#define WORD ((39 << 8) | 26)
+
+static int run(urj_chain_t *chain, const char *fmt, ...)
+{
+   char line[1024];
+   va_list ap;
+
+   va_start(ap, fmt);
+   vsnprintf(line, sizeof line, fmt, ap);
+   va_end(ap);
+
+   if (urj_parse_line(chain, line) != URJ_STATUS_OK)
+   {
+      diag("'%s' failed: %s", line, urj_error_describe());
+      urj_error_reset();
+      return 0;
+   }
+   return 1;
+}
+
+static void write_files(void)
+{
+   FILE *f = fopen(CHAIN_FILE, "w");
+   int i;
+
+   if (f == NULL)
+      bail("cannot create " CHAIN_FILE);
+   fprintf(f, "some_cpu flash=1\n");
+   fclose(f);
+
+   f = fopen(IMAGE_FILE, "wb");
+   if (f == NULL)
+      bail("cannot create " IMAGE_FILE);
+   for (i = 0; i < 4096; ++i)
+      fputc(i * 13, f);
+   fclose(f);
+}
+
+int main(void)
+{
+   const char *srcdir = getenv("srcdir");
+   char *cable_params[] = { "profile=ft2232h", "config=" CHAIN_FILE, NULL };
+   urj_cable_virtual_stats_t stats;
+   char path[1024];
+   urj_chain_t *chain;
+   uint32_t data[NR_READS];
+   uint32_t word;
+   uint64_t repeat_trips, single_trips;
+   int i, same;
+
+   if (srcdir == NULL)
+      srcdir = ".";
+   snprintf(path, sizeof path, "%s/jim/some_cpu.jtag", srcdir);
+
+   urj_log_state.level = URJ_LOG_LEVEL_SILENT;
+
+   write_files();
+
+   chain = urj_tap_chain_alloc();
+   if (chain == NULL)
+      bail("urj_tap_chain_alloc() failed");
+   if (urj_tap_cable_find("virtual") == NULL
+       || urj_tap_chain_connect(chain, "virtual", cable_params) != URJ_STATUS_OK)
+      skip_all("virtual cable not available");
+
+   plan(5);
+
+   ok(urj_tap_detect(chain, 0) == URJ_STATUS_OK
+      && run(chain, "part 0")
+      && urj_parse_include(chain, path, 1) == URJ_STATUS_OK
+      && run(chain, "initbus prototype amsb=A(31) alsb=A(0) dmsb=D(15) "
+             "dlsb=D(0) cs=CS oe=OE we=WE amode=8")
+      && run(chain, "detectflash 0"), "detectflash");
+   if (chain->bus == NULL)
+      bail("no bus");
+
+   ok(run(chain, "flashmem 0 %s", IMAGE_FILE), "flashmem polls the status");
+
+   word = URJ_BUS_READ(chain->bus, 2);
+
+   urj_tap_cable_virtual_stats(chain->cable, &stats, 1);
+   ok(urj_bus_read_repeat(chain->bus, 2, data, NR_READS) == URJ_STATUS_OK,
+      "urj_bus_read_repeat");
+   urj_tap_cable_virtual_stats(chain->cable, &stats, 1);
+   repeat_trips = stats.round_trips;
+   for (i = 0, same = 1; i < NR_READS; ++i)
+      same = same && data[i] == word;
+   if (!same || word != WORD)
+      diag("word %lu, reads %lu .. %lu", (unsigned long) word,
+           (unsigned long) data[0], (unsigned long) data[NR_READS - 1]);
+   ok(same && word == WORD, "every read gives the word");
+
+   for (i = 0; i < NR_READS; ++i)
+      (void) URJ_BUS_READ(chain->bus, 2);
+   urj_tap_cable_virtual_stats(chain->cable, &stats, 1);
+   single_trips = stats.round_trips;
+   diag("%d reads: %lu round trips repeated, %lu single", NR_READS,
+        (unsigned long) repeat_trips, (unsigned long) single_trips);
+   ok(repeat_trips == 1 && single_trips >= NR_READS,
+      "one round trip for all repeated reads");
+
+   urj_tap_chain_free(chain);
+
+   remove(CHAIN_FILE);
+   remove(IMAGE_FILE);
+
+   return 0;
+}
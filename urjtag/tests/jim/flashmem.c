@@ -0,0 +1,221 @@
+/**
+ * \author SPDX-FileCopyrightText: 2026 UrJTAG contributors
+ *
+ * \copyright SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * \file flashmem.c
+ * \brief Check the block-wise "flashmem" on a JIM chain.
+ *
+ * Test idea:
+ * * connect a JIM chain with a some_cpu and a 1 MByte CFI NOR flash
+ * * "flashmem diff" an image of several erase blocks, an odd number of
+ *   bytes and a stretch of 0xFF padding with verify; check in the trace
+ *   that the blank flash was not erased, read the image back and check
+ *   that the last word was padded with the erased state
+ * * "flashmem diff" the same image again and check in the trace that no
+ *   block was erased, then change one byte and check that exactly one
+ *   block was erased and the data read back
+ * * "flashmem" without diff erases every block it writes
+ * * check that an image that runs past the end of the flash is refused
+ *   before anything is erased
+ */
+
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <urjtag/chain.h>
+#include <urjtag/error.h>
+#include <urjtag/log.h>
+#include <urjtag/parse.h>
+#include <urjtag/tap.h>
+#include <urjtag/trace.h>
+
+#include "tap/basic.h"
+
+#define CHAIN_FILE "flashmem.jim"
+#define IMAGE_FILE "flashmem.bin"
+#define READ_FILE  "flashmem.out"
+#define TRACE_FILE "flashmem.json"
+
+/// a bit more than one 64 KByte block, and odd
+#define IMAGE_SIZE (65536 + 4097)
+/// 0xFF padding inside the image, not aligned to anything
+#define PAD_START  30001
+#define PAD_END    50003
+
+static int run(urj_chain_t *chain, const char *fmt, ...)
+{
+   char line[1024];
+   va_list ap;
+
+   va_start(ap, fmt);
+   vsnprintf(line, sizeof line, fmt, ap);
+   va_end(ap);
+
+   if (urj_parse_line(chain, line) != URJ_STATUS_OK)
+   {
+      diag("'%s' failed: %s", line, urj_error_describe());
+      urj_error_reset();
+      return 0;
+   }
+   return 1;
+}
+
+static void write_files(void)
+{
+   FILE *f = fopen(CHAIN_FILE, "w");
+   uint32_t x = 4711;
+   int i;
+
+   if (f == NULL)
+      bail("cannot create " CHAIN_FILE);
+   fprintf(f, "some_cpu flash=1\n");
+   fclose(f);
+
+   f = fopen(IMAGE_FILE, "wb");
+   if (f == NULL)
+      bail("cannot create " IMAGE_FILE);
+   for (i = 0; i < IMAGE_SIZE; ++i)
+   {
+      x = x * 1103515245 + 12345;
+      fputc(i >= PAD_START && i < PAD_END ? 0xFF : (int) (x >> 16), f);
+   }
+   fclose(f);
+}
+
+/// change the byte at @offset of the image
+static void patch_image(long offset)
+{
+   FILE *f = fopen(IMAGE_FILE, "r+b");
+   int c;
+
+   if (f == NULL)
+      bail("cannot open " IMAGE_FILE);
+   fseek(f, offset, SEEK_SET);
+   c = getc(f);
+   fseek(f, offset, SEEK_SET);
+   fputc(c ^ 0x5a, f);
+   fclose(f);
+}
+
+/// run "flashmem [diff]" with a trace and count the erase events in it
+static int traced_erases(urj_chain_t *chain, const char *mode)
+{
+   char buf[256];
+   FILE *f;
+   int n = 0;
+
+   if (urj_trace_start(TRACE_FILE) != URJ_STATUS_OK)
+      bail("cannot create " TRACE_FILE);
+   if (!run(chain, "flashmem %s 0x10000 %s", mode, IMAGE_FILE))
+      n = -1;
+   urj_trace_stop();
+
+   f = fopen(TRACE_FILE, "rb");
+   if (f == NULL)
+      bail("cannot open " TRACE_FILE);
+   while (n >= 0 && fgets(buf, sizeof buf, f) != NULL)
+      if (strstr(buf, "\"name\":\"erase\",\"cat\":\"flash\",\"ph\":\"B\""))
+         ++n;
+   fclose(f);
+
+   return n;
+}
+
+/// compare the image with what was read back, plus one padding byte
+static int check_read_back(void)
+{
+   FILE *fa = fopen(IMAGE_FILE, "rb");
+   FILE *fb = fopen(READ_FILE, "rb");
+   int same = fa != NULL && fb != NULL;
+   long i;
+
+   for (i = 0; same && i < IMAGE_SIZE; ++i)
+      same = getc(fa) == getc(fb);
+   if (same)
+      same = getc(fb) == 0xFF && getc(fb) == EOF;
+   if (fa)
+      fclose(fa);
+   if (fb)
+      fclose(fb);
+
+   return same;
+}
+
+/// check that the flash read back is still in the erased state
+static int check_erased(void)
+{
+   FILE *f = fopen(READ_FILE, "rb");
+   int erased = f != NULL && getc(f) == 0xFF && getc(f) == 0xFF;
+
+   if (f)
+      fclose(f);
+
+   return erased;
+}
+
+int main(void)
+{
+   const char *srcdir = getenv("srcdir");
+   char *cable_params[] = { "config=" CHAIN_FILE, NULL };
+   char path[1024];
+   urj_chain_t *chain;
+   int r;
+
+   if (srcdir == NULL)
+      srcdir = ".";
+   snprintf(path, sizeof path, "%s/jim/some_cpu.jtag", srcdir);
+
+   urj_log_state.level = URJ_LOG_LEVEL_SILENT;
+
+   write_files();
+
+   chain = urj_tap_chain_alloc();
+   if (chain == NULL)
+      bail("urj_tap_chain_alloc() failed");
+   if (urj_tap_chain_connect(chain, "jim", cable_params) != URJ_STATUS_OK)
+      skip_all("JIM cable not available");
+
+   plan(10);
+
+   ok(urj_tap_detect(chain, 0) == URJ_STATUS_OK
+      && run(chain, "part 0")
+      && urj_parse_include(chain, path, 1) == URJ_STATUS_OK
+      && run(chain, "initbus prototype amsb=A(31) alsb=A(0) dmsb=D(15) "
+             "dlsb=D(0) cs=CS oe=OE we=WE amode=8")
+      && run(chain, "detectflash 0"), "detectflash");
+
+   is_int(0, traced_erases(chain, "diff"),
+          "diff of blank flash erases nothing");
+   ok(run(chain, "readmem 0x10000 0x%x %s", IMAGE_SIZE + 1, READ_FILE)
+      && check_read_back(), "data and padding read back");
+
+   is_int(0, traced_erases(chain, "diff"), "diff of the same image erases nothing");
+   patch_image(65536 + 1000);
+   is_int(1, traced_erases(chain, "diff"), "diff of a changed byte erases one block");
+   ok(run(chain, "readmem 0x10000 0x%x %s", IMAGE_SIZE + 1, READ_FILE)
+      && check_read_back(), "changed data read back");
+
+   is_int(2, traced_erases(chain, ""), "flashmem erases every block");
+   ok(run(chain, "readmem 0x10000 0x%x %s", IMAGE_SIZE + 1, READ_FILE)
+      && check_read_back(), "data read back after flashmem");
+
+   r = urj_parse_line(chain, "flashmem 0xf0000 " IMAGE_FILE);
+   is_int(URJ_ERROR_OUT_OF_BOUNDS, urj_error_get(), "image past the end");
+   urj_error_reset();
+   ok(r != URJ_STATUS_OK && run(chain, "readmem 0xf0000 2 " READ_FILE)
+      && check_erased(),
+      "image past the end refused");
+
+   urj_tap_chain_free(chain);
+
+   remove(CHAIN_FILE);
+   remove(IMAGE_FILE);
+   remove(READ_FILE);
+   remove(TRACE_FILE);
+
+   return 0;
+}
@@ -0,0 +1,130 @@
+/**
+ * \author SPDX-FileCopyrightText: 2026 UrJTAG contributors
+ *
+ * \copyright SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * \file gang.c
+ * \brief Gang-program one image into several JIM targets.
+ *
+ * Test idea:
+ * * connect a JIM chain with a some_cpu and a CFI NOR flash, and "gang add"
+ *   further JIM cables with the same chain
+ * * "gang detect", set up the bus with "gang run", then "gang flashmem" an
+ *   image with verify
+ * * check that all targets pass, and that a target with a different chain
+ *   makes "gang detect" fail
+ */
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <urjtag/chain.h>
+#include <urjtag/error.h>
+#include <urjtag/log.h>
+#include <urjtag/parse.h>
+
+#include "tap/basic.h"
+
+#define NR_TARGETS 3
+#define CHAIN_FILE "gang.jim"
+#define OTHER_FILE "gang_other.jim"
+#define IMAGE_FILE "gang.bin"
+
+static int run(urj_chain_t *chain, const char *fmt, ...)
+{
+   char line[1024];
+   va_list ap;
+
+   va_start(ap, fmt);
+   vsnprintf(line, sizeof line, fmt, ap);
+   va_end(ap);
+
+   if (urj_parse_line(chain, line) != URJ_STATUS_OK)
+   {
+      diag("'%s' failed: %s", line, urj_error_describe());
+      urj_error_reset();
+      return 0;
+   }
+   return 1;
+}
+
+static void write_files(void)
+{
+   FILE *f = fopen(CHAIN_FILE, "w");
+   int i;
+
+   if (f == NULL)
+      bail("cannot create " CHAIN_FILE);
+   fprintf(f, "some_cpu flash=1\n");
+   fclose(f);
+
+   f = fopen(OTHER_FILE, "w");
+   if (f == NULL)
+      bail("cannot create " OTHER_FILE);
+   fprintf(f, "some_cpu flash=1\nsome_cpu flash=1\n");
+   fclose(f);
+
+   f = fopen(IMAGE_FILE, "wb");
+   if (f == NULL)
+      bail("cannot create " IMAGE_FILE);
+   for (i = 0; i < 1024; ++i)
+      fputc(i * 13, f);
+   fclose(f);
+}
+
+int main(void)
+{
+   const char *srcdir = getenv("srcdir");
+   char *cable_params[] = { "config=" CHAIN_FILE, NULL };
+   char path[1024];
+   char detect[] = "gang detect";
+   urj_chain_t *chain;
+   int i, ok_add;
+
+   if (srcdir == NULL)
+      srcdir = ".";
+   snprintf(path, sizeof path, "%s/jim/some_cpu.jtag", srcdir);
+
+   urj_log_state.level = URJ_LOG_LEVEL_SILENT;
+
+   write_files();
+
+   chain = urj_tap_chain_alloc();
+   if (chain == NULL)
+      bail("urj_tap_chain_alloc() failed");
+   if (urj_tap_chain_connect(chain, "jim", cable_params) != URJ_STATUS_OK)
+      skip_all("JIM cable not available");
+
+   plan(5);
+
+   ok_add = 1;
+   for (i = 1; i < NR_TARGETS; ++i)
+      ok_add = ok_add && run(chain, "gang add jim config=" CHAIN_FILE);
+   ok(ok_add && chain->gang_len == NR_TARGETS - 1, "targets added");
+
+   ok(run(chain, "gang detect"), "all targets detected alike");
+
+   ok(run(chain, "gang run part 0")
+      && run(chain, "gang run include %s", path)
+      && run(chain, "gang run initbus prototype amsb=A(31) alsb=A(0) "
+             "dmsb=D(15) dlsb=D(0) cs=CS oe=OE we=WE amode=8")
+      && run(chain, "gang run detectflash 0"), "bus set up on all targets");
+
+   ok(run(chain, "gang flashmem 0 %s", IMAGE_FILE),
+      "image programmed and verified on all targets");
+
+   run(chain, "gang add jim config=" OTHER_FILE);
+   ok(urj_parse_line(chain, detect) == URJ_STATUS_FAIL,
+      "target with another chain rejected");
+   urj_error_reset();
+
+   urj_tap_chain_free(chain);
+
+   remove(CHAIN_FILE);
+   remove(OTHER_FILE);
+   remove(IMAGE_FILE);
+
+   return 0;
+}
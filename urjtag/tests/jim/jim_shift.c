@@ -0,0 +1,113 @@
+/**
+ * \author SPDX-FileCopyrightText: 2026 UrJTAG contributors
+ *
+ * \copyright SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * \file jim_shift.c
+ * \brief Check urj_jim_shift() against bit by bit simulation.
+ *
+ * Test idea:
+ * * set up two identical JIM chains of two some_cpu devices
+ * * drive one with urj_jim_tck_rise()/urj_jim_tck_fall() per clock and the
+ *   other with urj_jim_shift() on chunks of random length
+ * * use random TMS/TDI with rare TMS = 1, so that all TAP states and long
+ *   Shift-IR/Shift-DR runs through IR, IDCODE, BSR and BYPASS are visited
+ * * compare TDO for every clock and all shift registers at the end
+ */
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <urjtag/jim.h>
+#include <urjtag/log.h>
+
+#include "tap/basic.h"
+
+#define NR_CLOCKS 200000
+
+static urj_jim_state_t *two_cpus(void)
+{
+   urj_jim_state_t *s = urj_jim_init();
+   urj_jim_device_t *dev;
+
+   if (s == NULL)
+      bail("urj_jim_init() failed");
+   dev = urj_jim_some_cpu();
+   if (dev == NULL)
+      bail("urj_jim_some_cpu() failed");
+   dev->prev = s->last_device_in_chain;
+   s->last_device_in_chain = dev;
+
+   return s;
+}
+
+static int same_sregs(urj_jim_state_t *a, urj_jim_state_t *b)
+{
+   urj_jim_device_t *da, *db;
+   int i;
+
+   for (da = a->last_device_in_chain, db = b->last_device_in_chain;
+        da && db; da = da->prev, db = db->prev)
+   {
+      if (da->tap_state != db->tap_state || da->tdo != db->tdo)
+         return 0;
+      for (i = 0; i < da->num_sregs; i++)
+         if (memcmp(da->sreg[i].reg, db->sreg[i].reg,
+                    (da->sreg[i].len + 31) / 32 * sizeof(uint32_t)) != 0)
+            return 0;
+   }
+
+   return da == NULL && db == NULL;
+}
+
+int main(void)
+{
+   static char tms[NR_CLOCKS], tdi[NR_CLOCKS];
+   static char tdo_ref[NR_CLOCKS], tdo[NR_CLOCKS];
+   urj_jim_state_t *ref, *fast;
+   long shifting = 0;
+   int i, n;
+
+   urj_log_state.level = URJ_LOG_LEVEL_SILENT;
+
+   plan(3);
+
+   srand(4711);
+   for (i = 0; i < NR_CLOCKS; i++)
+   {
+      tms[i] = (rand() % 64) == 0;
+      tdi[i] = rand() & 1;
+   }
+
+   ref = two_cpus();
+   fast = two_cpus();
+
+   for (i = 0; i < NR_CLOCKS; i++)
+   {
+      if (ref->last_device_in_chain->tap_state == URJ_JIM_SHIFT_DR
+          || ref->last_device_in_chain->tap_state == URJ_JIM_SHIFT_IR)
+         shifting++;
+      tdo_ref[i] = urj_jim_get_tdo(ref);
+      urj_jim_tck_rise(ref, tms[i], tdi[i]);
+      urj_jim_tck_fall(ref);
+   }
+
+   for (i = 0; i < NR_CLOCKS; i += n)
+   {
+      n = 1 + rand() % 1000;
+      if (n > NR_CLOCKS - i)
+         n = NR_CLOCKS - i;
+      urj_jim_shift(fast, n, &tms[i], &tdi[i], &tdo[i]);
+   }
+
+   diag("%ld of %d clocks in Shift-DR/Shift-IR", shifting, NR_CLOCKS);
+   ok(shifting > NR_CLOCKS / 4, "random TMS often shifts");
+   ok(memcmp(tdo_ref, tdo, sizeof tdo) == 0, "TDO matches for every clock");
+   ok(same_sregs(ref, fast), "TAP states and shift registers match");
+
+   urj_jim_free(ref);
+   urj_jim_free(fast);
+
+   return 0;
+}
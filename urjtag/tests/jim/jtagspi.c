@@ -0,0 +1,162 @@
+/**
+ * \author SPDX-FileCopyrightText: 2026 UrJTAG contributors
+ *
+ * \copyright SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * \file jtagspi.c
+ * \brief Check the jtagspi bus driver against the simulated bridge.
+ *
+ * Test idea:
+ * * connect a "virtual" cable to a JIM chain with an FPGA that has the
+ *   JTAG-to-SPI bridge in USER1 between two generic TAPs in BYPASS, so that
+ *   the bridge bits have an offset on both sides
+ * * "initbus jtagspi" and "detectflash", which reads SFDP through the bridge
+ * * "flashmem" an image over two 4 KiB sectors with verify and read a byte
+ *   of the second sector back
+ * * "flashmem" it again without verify: with one DR scan per SPI command,
+ *   the run costs only a few round trips per page
+ */
+
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <urjtag/bus.h>
+#include <urjtag/cable.h>
+#include <urjtag/chain.h>
+#include <urjtag/error.h>
+#include <urjtag/flash.h>
+#include <urjtag/log.h>
+#include <urjtag/parse.h>
+#include <urjtag/tap.h>
+
+#include "tap/basic.h"
+
+#define CHAIN_FILE "jtagspi.jim"
+#define IMAGE_FILE "jtagspi.bin"
+
+#define IMAGE_SIZE 5000
+#define BYTE_ADR 4321
+
+/// IR lengths of the generic TAPs, parts 0 and 2
+static const int GenericIrLen[] = { 5, 8 };
+
+static int run(urj_chain_t *chain, const char *fmt, ...)
+{
+   char line[1024];
+   va_list ap;
+
+   va_start(ap, fmt);
+   vsnprintf(line, sizeof line, fmt, ap);
+   va_end(ap);
+
+   if (urj_parse_line(chain, line) != URJ_STATUS_OK)
+   {
+      diag("'%s' failed: %s", line, urj_error_describe());
+      urj_error_reset();
+      return 0;
+   }
+   return 1;
+}
+
+static void write_files(void)
+{
+   FILE *f = fopen(CHAIN_FILE, "w");
+   int i;
+
+   if (f == NULL)
+      bail("cannot create " CHAIN_FILE);
+   fprintf(f, "generic ir=%d\n", GenericIrLen[0]);
+   fprintf(f, "fpga spi=1\n");
+   fprintf(f, "generic ir=%d\n", GenericIrLen[1]);
+   fclose(f);
+
+   f = fopen(IMAGE_FILE, "wb");
+   if (f == NULL)
+      bail("cannot create " IMAGE_FILE);
+   for (i = 0; i < IMAGE_SIZE; ++i)
+      fputc(i * 29, f);
+   fclose(f);
+}
+
+static int define_parts(urj_chain_t *chain, const char *path)
+{
+   char ones[33];
+   int i;
+
+   for (i = 0; i < 2; ++i)
+   {
+      memset(ones, '1', GenericIrLen[i]);
+      ones[GenericIrLen[i]] = '\0';
+      if (!run(chain, "part %d", 2 * i)
+          || !run(chain, "register BR 1")
+          || !run(chain, "instruction length %d", GenericIrLen[i])
+          || !run(chain, "instruction BYPASS %s BR", ones)
+          || !run(chain, "instruction BYPASS"))
+         return 0;
+   }
+
+   return run(chain, "part 1")
+      && urj_parse_include(chain, path, 1) == URJ_STATUS_OK;
+}
+
+int main(void)
+{
+   const char *srcdir = getenv("srcdir");
+   char *cable_params[] = { "profile=ft2232h", "config=" CHAIN_FILE, NULL };
+   urj_cable_virtual_stats_t stats;
+   char path[1024];
+   urj_chain_t *chain;
+   uint32_t byte;
+
+   if (srcdir == NULL)
+      srcdir = ".";
+   snprintf(path, sizeof path, "%s/jim/fpga.jtag", srcdir);
+
+   urj_log_state.level = URJ_LOG_LEVEL_SILENT;
+
+   write_files();
+
+   chain = urj_tap_chain_alloc();
+   if (chain == NULL)
+      bail("urj_tap_chain_alloc() failed");
+   if (urj_tap_cable_find("virtual") == NULL
+       || urj_tap_chain_connect(chain, "virtual", cable_params) != URJ_STATUS_OK)
+      skip_all("virtual cable not available");
+
+   plan(4);
+
+   ok(urj_tap_detect(chain, 0) == URJ_STATUS_OK
+      && define_parts(chain, path)
+      && run(chain, "initbus jtagspi opcode=000010")
+      && run(chain, "detectflash 0"), "detectflash");
+   if (chain->bus == NULL)
+      bail("no bus");
+
+   ok(run(chain, "flashmem 0 %s", IMAGE_FILE), "flashmem with verify");
+
+   byte = URJ_BUS_READ(chain->bus, BYTE_ADR);
+   if (byte != ((BYTE_ADR * 29) & 0xFF))
+      diag("byte 0x%02lx, expected 0x%02x", (unsigned long) byte,
+           (BYTE_ADR * 29) & 0xFF);
+   ok(byte == ((BYTE_ADR * 29) & 0xFF), "read back");
+
+   urj_tap_cable_virtual_stats(chain->cable, &stats, 1);
+   if (!run(chain, "flashmem 0 %s noverify", IMAGE_FILE))
+      stats.round_trips = IMAGE_SIZE;
+   else
+      urj_tap_cable_virtual_stats(chain->cable, &stats, 1);
+   diag("%d bytes: %lu round trips", IMAGE_SIZE,
+        (unsigned long) stats.round_trips);
+   ok(stats.round_trips < 4 * (IMAGE_SIZE / 256 + 1) + 16,
+      "one DR scan per SPI command");
+
+   urj_tap_chain_free(chain);
+
+   remove(CHAIN_FILE);
+   remove(IMAGE_FILE);
+
+   return 0;
+}
@@ -0,0 +1,161 @@
+/**
+ * \author SPDX-FileCopyrightText: 2026 UrJTAG contributors
+ *
+ * \copyright SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * \file parallel_chains.c
+ * \brief Program flash on several JIM chains at once.
+ *
+ * Test idea:
+ * * connect NR_CHAINS JIM chains, each with a some_cpu and a CFI NOR flash
+ * * run one job per chain with urj_tap_chain_run_jobs(): detect, "initbus",
+ *   "detectflash" and "flashmem" an image with verify, where each chain gets
+ *   an image of its own
+ * * check that all jobs succeed, that each chain has its own bus and flash,
+ *   and that a failing job is reported without disturbing the others
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <urjtag/chain.h>
+#include <urjtag/bus.h>
+#include <urjtag/error.h>
+#include <urjtag/log.h>
+#include <urjtag/parse.h>
+#include <urjtag/tap.h>
+
+#include "tap/basic.h"
+
+#define NR_CHAINS  4
+#define CHAIN_FILE "parallel_chains.jim"
+
+static char include_path[1024];
+
+static int run(urj_chain_t *chain, const char *line)
+{
+   char buf[256];
+
+   /* urj_parse_line() tokenizes in place */
+   snprintf(buf, sizeof buf, "%s", line);
+   return urj_parse_line(chain, buf);
+}
+
+static int program(urj_chain_t *chain, void *data)
+{
+   char line[256];
+
+   snprintf(line, sizeof line, "flashmem 0 %s", (const char *) data);
+
+   if (urj_tap_detect(chain, 0) != URJ_STATUS_OK
+       || run(chain, "part 0") != URJ_STATUS_OK
+       || urj_parse_include(chain, include_path, 1) != URJ_STATUS_OK
+       || run(chain, "initbus prototype amsb=A(31) alsb=A(0) dmsb=D(15) "
+              "dlsb=D(0) cs=CS oe=OE we=WE amode=8") != URJ_STATUS_OK
+       || run(chain, "detectflash 0") != URJ_STATUS_OK)
+      return URJ_STATUS_FAIL;
+
+   return run(chain, line);
+}
+
+static void write_files(char names[][32])
+{
+   FILE *f = fopen(CHAIN_FILE, "w");
+   int i, j;
+
+   if (f == NULL)
+      bail("cannot create " CHAIN_FILE);
+   fprintf(f, "some_cpu flash=1\n");
+   fclose(f);
+
+   for (i = 0; i < NR_CHAINS; ++i)
+   {
+      snprintf(names[i], 32, "parallel_chains%d.bin", i);
+      f = fopen(names[i], "wb");
+      if (f == NULL)
+         bail("cannot create %s", names[i]);
+      for (j = 0; j < 512; ++j)
+         fputc(j * (i + 3), f);
+      fclose(f);
+   }
+}
+
+int main(void)
+{
+   const char *srcdir = getenv("srcdir");
+   char *cable_params[] = { "config=" CHAIN_FILE, NULL };
+   char names[NR_CHAINS][32];
+   urj_chain_t *chains[NR_CHAINS];
+   urj_chain_job_t jobs[NR_CHAINS];
+   int i, ok_all, distinct;
+
+   if (srcdir == NULL)
+      srcdir = ".";
+   snprintf(include_path, sizeof include_path, "%s/jim/some_cpu.jtag",
+            srcdir);
+
+   urj_log_state.level = URJ_LOG_LEVEL_SILENT;
+
+   write_files(names);
+
+   for (i = 0; i < NR_CHAINS; ++i)
+   {
+      chains[i] = urj_tap_chain_alloc();
+      if (chains[i] == NULL)
+         bail("urj_tap_chain_alloc() failed");
+      if (urj_tap_chain_connect(chains[i], "jim", cable_params)
+          != URJ_STATUS_OK)
+         skip_all("JIM cable not available");
+   }
+
+   plan(4);
+
+   memset(jobs, 0, sizeof jobs);
+   for (i = 0; i < NR_CHAINS; ++i)
+   {
+      jobs[i].chain = chains[i];
+      jobs[i].run = program;
+      jobs[i].data = names[i];
+   }
+   is_int(urj_tap_chain_run_jobs(jobs, NR_CHAINS), URJ_STATUS_OK,
+          "all jobs succeed");
+
+   ok_all = 1;
+   distinct = 1;
+   for (i = 0; i < NR_CHAINS; ++i)
+   {
+      if (jobs[i].result != URJ_STATUS_OK)
+      {
+         diag("chain %d: %s", i, jobs[i].error.msg);
+         ok_all = 0;
+      }
+      if (chains[i]->bus == NULL || chains[i]->bus->cfi_array == NULL
+          || chains[i]->buses.len != 1)
+         distinct = 0;
+      else if (i > 0 && (chains[i]->bus == chains[i - 1]->bus
+                         || chains[i]->bus->cfi_array
+                            == chains[i - 1]->bus->cfi_array))
+         distinct = 0;
+   }
+   ok(ok_all, "each job programmed and verified its image");
+   ok(distinct, "each chain has its own bus and flash");
+
+   /* the second job names a missing image */
+   jobs[1].data = "parallel_chains.missing";
+   ok(urj_tap_chain_run_jobs(jobs, NR_CHAINS) == URJ_STATUS_FAIL
+      && jobs[0].result == URJ_STATUS_OK && jobs[1].result != URJ_STATUS_OK
+      && jobs[2].result == URJ_STATUS_OK && jobs[3].result == URJ_STATUS_OK
+      && urj_error_get() == jobs[1].error.errnum,
+      "a failing job is reported alone");
+   urj_error_reset();
+
+   for (i = 0; i < NR_CHAINS; ++i)
+   {
+      urj_tap_chain_free(chains[i]);
+      remove(names[i]);
+   }
+   remove(CHAIN_FILE);
+
+   return 0;
+}
@@ -0,0 +1,267 @@
+/**
+ * \author SPDX-FileCopyrightText: 2026 UrJTAG contributors
+ *
+ * \copyright SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * \file pld_stream.c
+ * \brief Check the streaming Altera and Lattice ECP5 pld drivers.
+ *
+ * Test idea:
+ * * connect a "virtual" cable to a JIM chain with a Cyclone and an ECP5
+ *   and set them up through tests/jim/cyclone.jtag and tests/jim/ecp5.jtag
+ * * "pld load" of an .rbf into the Cyclone and of a .bit into the ECP5:
+ *   the USERCODE of the simulated FPGAs is the CRC-32 of what they got, so
+ *   it must match the file; this also checks that the bit order is right
+ *   and that the data got through the BYPASS register of the other part
+ * * the bitstream goes to the adapter packed, in a few transactions
+ * * a .bit longer than the ECP5 memory ends in a preamble error of the
+ *   part, which "pld status" decodes
+ * * a .sof, a .bit without preamble and a short ECP5 bitstream are refused
+ * * "pld reconfigure" unconfigures both (they have no flash to boot from)
+ */
+
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <urjtag/cable.h>
+#include <urjtag/chain.h>
+#include <urjtag/data_register.h>
+#include <urjtag/error.h>
+#include <urjtag/log.h>
+#include <urjtag/parse.h>
+#include <urjtag/part.h>
+#include <urjtag/part_instruction.h>
+#include <urjtag/tap.h>
+#include <urjtag/tap_register.h>
+
+#include "tap/basic.h"
+
+#define CHAIN_FILE "pld_stream.jim"
+#define RBF_FILE   "pld_stream.rbf"
+#define BIT_FILE   "pld_stream.bit"
+
+/// configuration memory of both FPGAs, in KByte
+#define SIZE       16
+
+#define CYCLONE    0
+#define ECP5       1
+
+static int run(urj_chain_t *chain, const char *fmt, ...)
+{
+   char line[1024];
+   va_list ap;
+
+   va_start(ap, fmt);
+   vsnprintf(line, sizeof line, fmt, ap);
+   va_end(ap);
+
+   if (urj_parse_line(chain, line) != URJ_STATUS_OK)
+   {
+      diag("'%s' failed: %s", line, urj_error_describe());
+      urj_error_reset();
+      return 0;
+   }
+   return 1;
+}
+
+static char log_text[4096];
+static size_t log_len;
+
+static int log_capture(const char *fmt, va_list ap)
+{
+   int n = vsnprintf(log_text + log_len, sizeof log_text - log_len, fmt, ap);
+
+   if (n > 0)
+      log_len += (size_t) n < sizeof log_text - log_len
+         ? (size_t) n : sizeof log_text - log_len - 1;
+   return n;
+}
+
+/* the output of "pld status" */
+static const char *pld_status(urj_chain_t *chain)
+{
+   int (*out_vprintf)(const char *, va_list) = urj_log_state.out_vprintf;
+
+   log_len = 0;
+   log_text[0] = '\0';
+   urj_log_state.level = URJ_LOG_LEVEL_NORMAL;
+   urj_log_state.out_vprintf = log_capture;
+   run(chain, "pld status");
+   urj_log_state.out_vprintf = out_vprintf;
+   urj_log_state.level = URJ_LOG_LEVEL_SILENT;
+
+   return log_text;
+}
+
+static uint32_t crc32(const uint8_t *data, size_t len)
+{
+   uint32_t crc = 0xffffffff;
+   size_t i;
+   int k;
+
+   for (i = 0; i < len; i++)
+   {
+      crc ^= data[i];
+      for (k = 0; k < 8; k++)
+         crc = (crc >> 1) ^ ((crc & 1) ? 0xedb88320 : 0);
+   }
+   return ~crc;
+}
+
+/* a bitstream of len bytes: 0xff padding, the ECP5 preamble, noise */
+static void make_bitstream(uint8_t *data, size_t len, int seed)
+{
+   size_t i;
+
+   for (i = 0; i < len; i++)
+      data[i] = i * 37 + (i >> 8) + seed;
+   memset(data, 0xff, 16);
+   data[16] = 0xbd;
+   data[17] = 0xb3;
+}
+
+static void write_file(const char *name, const char *header, size_t hlen,
+                       const uint8_t *data, size_t len)
+{
+   FILE *f = fopen(name, "wb");
+
+   if (f == NULL)
+      bail("cannot create %s", name);
+   fwrite(header, 1, hlen, f);
+   fwrite(data, 1, len, f);
+   fclose(f);
+}
+
+static uint32_t usercode(urj_chain_t *chain, int n)
+{
+   urj_part_t *part = chain->parts->parts[n];
+
+   if (!run(chain, "part %d", n) || !run(chain, "instruction USERCODE")
+       || !run(chain, "shift ir") || !run(chain, "shift dr"))
+      return 0xdeadbeef;
+
+   return urj_tap_register_get_value(
+      part->active_instruction->data_register->out);
+}
+
+int main(void)
+{
+   static const char header[] = "\xff\x00" "Part: LFE5U-45F-6CABGA256\0"
+      "Date: 2026/10/18\0";
+   const char *srcdir = getenv("srcdir");
+   char *cable_params[] = { "profile=ft2232h", "config=" CHAIN_FILE, NULL };
+   static uint8_t data[SIZE * 1024];
+   urj_cable_virtual_stats_t stats;
+   char path[1024];
+   urj_chain_t *chain;
+   uint32_t uc;
+   FILE *f;
+   int done;
+
+   if (srcdir == NULL)
+      srcdir = ".";
+
+   urj_log_state.level = URJ_LOG_LEVEL_SILENT;
+
+   if (urj_tap_cable_find("virtual") == NULL)
+      skip_all("virtual cable not available");
+
+   plan(13);
+
+   f = fopen(CHAIN_FILE, "w");
+   if (f == NULL)
+      bail("cannot create " CHAIN_FILE);
+   fprintf(f, "cyclone size=%d\necp5 size=%d\n", SIZE, SIZE);
+   fclose(f);
+
+   chain = urj_tap_chain_alloc();
+   if (chain == NULL)
+      bail("urj_tap_chain_alloc() failed");
+   if (urj_tap_chain_connect(chain, "virtual", cable_params) != URJ_STATUS_OK)
+      bail("cannot connect the virtual cable");
+   if (urj_tap_detect(chain, 0) != URJ_STATUS_OK || chain->parts == NULL
+       || chain->parts->len != 2)
+      bail("cannot detect the FPGAs");
+
+   snprintf(path, sizeof path, "%s/jim/cyclone.jtag", srcdir);
+   if (!run(chain, "part %d", CYCLONE)
+       || urj_parse_include(chain, path, 1) != URJ_STATUS_OK)
+      bail("cannot set up the cyclone");
+   snprintf(path, sizeof path, "%s/jim/ecp5.jtag", srcdir);
+   if (!run(chain, "part %d", ECP5)
+       || urj_parse_include(chain, path, 1) != URJ_STATUS_OK)
+      bail("cannot set up the ecp5");
+
+   make_bitstream(data, sizeof data, 0);
+   write_file(RBF_FILE, "", 0, data, sizeof data);
+   run(chain, "part %d", CYCLONE);
+   urj_tap_cable_virtual_stats(chain->cable, &stats, 1);
+   done = run(chain, "pld load " RBF_FILE);
+   urj_tap_cable_virtual_stats(chain->cable, &stats, 1);
+   ok(done, "pld load of an .rbf");
+   uc = usercode(chain, CYCLONE);
+   ok(uc == crc32(data, sizeof data), "cyclone usercode 0x%08x", uc);
+   diag("%lu bytes to the adapter in %lu transactions for %d KByte",
+        (unsigned long) stats.bytes_out, (unsigned long) stats.transactions,
+        SIZE);
+   ok(stats.bytes_out < 2 * sizeof data && stats.transactions < 16,
+      "the bitstream goes to the adapter packed");
+
+   write_file(RBF_FILE, "SOF\0", 4, data, 64);
+   run(chain, "part %d", CYCLONE);
+   ok(!run(chain, "pld load " RBF_FILE), "a .sof is refused");
+
+   ok(run(chain, "pld reconfigure") && usercode(chain, CYCLONE) == 0xffffffff,
+      "pld reconfigure unconfigures the cyclone");
+
+   make_bitstream(data, sizeof data, 7);
+   write_file(BIT_FILE, header, sizeof header - 1, data, sizeof data);
+   run(chain, "part %d", ECP5);
+   ok(run(chain, "pld load " BIT_FILE), "pld load of a .bit");
+   uc = usercode(chain, ECP5);
+   ok(uc == crc32(data, sizeof data), "ecp5 usercode 0x%08x", uc);
+   ok(usercode(chain, CYCLONE) == 0xffffffff, "the cyclone was left alone");
+
+   run(chain, "part %d", ECP5);
+   ok(run(chain, "pld status"), "pld status");
+
+   /* the part keeps the last SIZE KByte, which lack the preamble */
+   write_file(BIT_FILE, header, sizeof header - 1, data, sizeof data);
+   f = fopen(BIT_FILE, "ab");
+   if (f == NULL)
+      bail("cannot append to " BIT_FILE);
+   fwrite(data, 1, 1024, f);
+   fclose(f);
+   run(chain, "part %d", ECP5);
+   ok(!run(chain, "pld load " BIT_FILE), "a too long .bit fails");
+   run(chain, "part %d", ECP5);
+   ok(strstr(pld_status(chain), "BSE_ERROR    4 (preamble error)") != NULL
+      && strstr(log_text, "FAIL         1") != NULL
+      && strstr(log_text, "DONE         0") != NULL,
+      "pld status decodes the preamble error");
+
+   data[16] = 0;
+   write_file(BIT_FILE, header, sizeof header - 1, data, sizeof data);
+   run(chain, "part %d", ECP5);
+   done = run(chain, "pld load " BIT_FILE);
+   data[16] = 0xbd;
+   write_file(BIT_FILE, header, sizeof header - 1, data, sizeof data - 1024);
+   run(chain, "part %d", ECP5);
+   ok(!done && !run(chain, "pld load " BIT_FILE),
+      "a .bit without preamble or too short is refused");
+
+   run(chain, "part %d", ECP5);
+   ok(run(chain, "pld reconfigure") && usercode(chain, ECP5) == 0,
+      "pld reconfigure unconfigures the ecp5");
+
+   urj_tap_chain_free(chain);
+
+   remove(CHAIN_FILE);
+   remove(RBF_FILE);
+   remove(BIT_FILE);
+
+   return 0;
+}
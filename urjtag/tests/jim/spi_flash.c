@@ -0,0 +1,135 @@
+/**
+ * \author SPDX-FileCopyrightText: 2026 UrJTAG contributors
+ *
+ * \copyright SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * \file spi_flash.c
+ * \brief Check the SPI bus and the SPI NOR flash driver.
+ *
+ * Test idea:
+ * * connect a "virtual" cable to a JIM chain with a some_cpu and an SPI NOR
+ *   flash on four of its pins, "initbus spi" and "detectflash", which reads
+ *   the geometry from SFDP
+ * * "flashmem" an image over two 4 KiB sectors with verify and read a byte
+ *   of the second sector back
+ * * "flashmem" it again without verify and check that the SPI clocks went
+ *   to the cable per transaction: the run costs fewer round trips on a
+ *   modeled USB adapter than the image has bytes
+ */
+
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <urjtag/bus.h>
+#include <urjtag/cable.h>
+#include <urjtag/chain.h>
+#include <urjtag/error.h>
+#include <urjtag/flash.h>
+#include <urjtag/log.h>
+#include <urjtag/parse.h>
+#include <urjtag/tap.h>
+
+#include "tap/basic.h"
+
+#define CHAIN_FILE "spi_flash.jim"
+#define IMAGE_FILE "spi_flash.bin"
+
+#define IMAGE_SIZE 5000
+#define BYTE_ADR 4321
+
+static int run(urj_chain_t *chain, const char *fmt, ...)
+{
+   char line[1024];
+   va_list ap;
+
+   va_start(ap, fmt);
+   vsnprintf(line, sizeof line, fmt, ap);
+   va_end(ap);
+
+   if (urj_parse_line(chain, line) != URJ_STATUS_OK)
+   {
+      diag("'%s' failed: %s", line, urj_error_describe());
+      urj_error_reset();
+      return 0;
+   }
+   return 1;
+}
+
+static void write_files(void)
+{
+   FILE *f = fopen(CHAIN_FILE, "w");
+   int i;
+
+   if (f == NULL)
+      bail("cannot create " CHAIN_FILE);
+   fprintf(f, "some_cpu spi=1\n");
+   fclose(f);
+
+   f = fopen(IMAGE_FILE, "wb");
+   if (f == NULL)
+      bail("cannot create " IMAGE_FILE);
+   for (i = 0; i < IMAGE_SIZE; ++i)
+      fputc(i * 29, f);
+   fclose(f);
+}
+
+int main(void)
+{
+   const char *srcdir = getenv("srcdir");
+   char *cable_params[] = { "profile=ft2232h", "config=" CHAIN_FILE, NULL };
+   urj_cable_virtual_stats_t stats;
+   char path[1024];
+   urj_chain_t *chain;
+   uint32_t byte;
+
+   if (srcdir == NULL)
+      srcdir = ".";
+   snprintf(path, sizeof path, "%s/jim/some_cpu.jtag", srcdir);
+
+   urj_log_state.level = URJ_LOG_LEVEL_SILENT;
+
+   write_files();
+
+   chain = urj_tap_chain_alloc();
+   if (chain == NULL)
+      bail("urj_tap_chain_alloc() failed");
+   if (urj_tap_cable_find("virtual") == NULL
+       || urj_tap_chain_connect(chain, "virtual", cable_params) != URJ_STATUS_OK)
+      skip_all("virtual cable not available");
+
+   plan(4);
+
+   ok(urj_tap_detect(chain, 0) == URJ_STATUS_OK
+      && run(chain, "part 0")
+      && urj_parse_include(chain, path, 1) == URJ_STATUS_OK
+      && run(chain, "initbus spi sck=D(1) mosi=D(2) miso=D(0) ncs=CS")
+      && run(chain, "detectflash 0"), "detectflash");
+   if (chain->bus == NULL)
+      bail("no bus");
+
+   ok(run(chain, "flashmem 0 %s", IMAGE_FILE), "flashmem with verify");
+
+   byte = URJ_BUS_READ(chain->bus, BYTE_ADR);
+   if (byte != ((BYTE_ADR * 29) & 0xFF))
+      diag("byte 0x%02lx, expected 0x%02x", (unsigned long) byte,
+           (BYTE_ADR * 29) & 0xFF);
+   ok(byte == ((BYTE_ADR * 29) & 0xFF), "read back");
+
+   urj_tap_cable_virtual_stats(chain->cable, &stats, 1);
+   if (!run(chain, "flashmem 0 %s noverify", IMAGE_FILE))
+      stats.round_trips = IMAGE_SIZE;
+   else
+      urj_tap_cable_virtual_stats(chain->cable, &stats, 1);
+   diag("%d bytes: %lu round trips", IMAGE_SIZE,
+        (unsigned long) stats.round_trips);
+   ok(stats.round_trips < IMAGE_SIZE / 16, "SPI transactions batched");
+
+   urj_tap_chain_free(chain);
+
+   remove(CHAIN_FILE);
+   remove(IMAGE_FILE);
+
+   return 0;
+}
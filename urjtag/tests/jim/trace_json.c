@@ -0,0 +1,181 @@
+/**
+ * \author SPDX-FileCopyrightText: 2026 UrJTAG contributors
+ *
+ * \copyright SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * \file trace_json.c
+ * \brief Check the trace-event output of the "trace" command.
+ *
+ * Test idea:
+ * * connect a JIM chain with a some_cpu and a CFI NOR flash
+ * * "trace <file>", then detect, "initbus", "detectflash" and "flashmem"
+ *   a small image with verify, then "trace off"
+ * * check that the file is a complete JSON array, that begin and end events
+ *   pair up and that cable, TAP, bus and flash events were recorded
+ */
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <urjtag/chain.h>
+#include <urjtag/error.h>
+#include <urjtag/log.h>
+#include <urjtag/parse.h>
+#include <urjtag/tap.h>
+#include <urjtag/trace.h>
+
+#include "tap/basic.h"
+
+#define CHAIN_FILE "trace_json.jim"
+#define IMAGE_FILE "trace_json.bin"
+#define TRACE_FILE "trace_json.json"
+
+struct sEventSpec {
+   /// text that must occur in the trace
+   const char *text;
+   /// test description
+   const char *what;
+};
+
+static const struct sEventSpec EventSpecAry[] = {
+   { "\"cat\":\"cable\",\"ph\":\"B\"", "cable flush events" },
+   { "\"name\":\"queue\",\"cat\":\"cable\",\"ph\":\"C\"", "queue counter" },
+   { "\"name\":\"SHIFT_DR\",\"cat\":\"tap\"", "TAP state events" },
+   { "\"name\":\"write\",\"cat\":\"bus\"", "bus write events" },
+   { "\"name\":\"read_next\",\"cat\":\"bus\"", "bus read events" },
+   { "\"name\":\"erase\",\"cat\":\"flash\"", "flash erase events" },
+   { "\"name\":\"program\",\"cat\":\"flash\"", "flash program events" },
+   { "\"name\":\"verify\",\"cat\":\"flash\"", "flash verify events" },
+};
+
+#define NR_EVENTS (sizeof EventSpecAry / sizeof EventSpecAry[0])
+
+static int run(urj_chain_t *chain, const char *fmt, ...)
+{
+   char line[1024];
+   va_list ap;
+
+   va_start(ap, fmt);
+   vsnprintf(line, sizeof line, fmt, ap);
+   va_end(ap);
+
+   if (urj_parse_line(chain, line) != URJ_STATUS_OK)
+   {
+      diag("'%s' failed: %s", line, urj_error_describe());
+      urj_error_reset();
+      return 0;
+   }
+   return 1;
+}
+
+static void write_files(void)
+{
+   FILE *f = fopen(CHAIN_FILE, "w");
+   int i;
+
+   if (f == NULL)
+      bail("cannot create " CHAIN_FILE);
+   fprintf(f, "some_cpu flash=1\n");
+   fclose(f);
+
+   f = fopen(IMAGE_FILE, "wb");
+   if (f == NULL)
+      bail("cannot create " IMAGE_FILE);
+   for (i = 0; i < 64; ++i)
+      fputc(i * 7, f);
+   fclose(f);
+}
+
+static char *read_trace(void)
+{
+   FILE *f = fopen(TRACE_FILE, "rb");
+   char *buf;
+   long size;
+
+   if (f == NULL)
+      bail("cannot open " TRACE_FILE);
+   fseek(f, 0, SEEK_END);
+   size = ftell(f);
+   fseek(f, 0, SEEK_SET);
+   buf = malloc(size + 1);
+   if (buf == NULL || fread(buf, 1, size, f) != (size_t) size)
+      bail("cannot read " TRACE_FILE);
+   buf[size] = '\0';
+   fclose(f);
+
+   return buf;
+}
+
+static int count(const char *buf, const char *text)
+{
+   int n = 0;
+
+   while ((buf = strstr(buf, text)) != NULL)
+   {
+      ++n;
+      ++buf;
+   }
+   return n;
+}
+
+int main(void)
+{
+   const char *srcdir = getenv("srcdir");
+   char *cable_params[] = { "config=" CHAIN_FILE, NULL };
+   char path[1024];
+   urj_chain_t *chain;
+   char *trace;
+   size_t len, i;
+   int ok_run;
+
+   if (srcdir == NULL)
+      srcdir = ".";
+   snprintf(path, sizeof path, "%s/jim/some_cpu.jtag", srcdir);
+
+   urj_log_state.level = URJ_LOG_LEVEL_SILENT;
+
+   write_files();
+
+   chain = urj_tap_chain_alloc();
+   if (chain == NULL)
+      bail("urj_tap_chain_alloc() failed");
+   if (urj_tap_chain_connect(chain, "jim", cable_params) != URJ_STATUS_OK)
+      skip_all("JIM cable not available");
+
+   plan(NR_EVENTS + 4);
+
+   ok_run = run(chain, "trace %s", TRACE_FILE)
+      && urj_tap_detect(chain, 0) == URJ_STATUS_OK
+      && run(chain, "part 0")
+      && urj_parse_include(chain, path, 1) == URJ_STATUS_OK
+      && run(chain, "initbus prototype amsb=A(31) alsb=A(0) dmsb=D(15) "
+             "dlsb=D(0) cs=CS oe=OE we=WE amode=8")
+      && run(chain, "detectflash 0")
+      && run(chain, "flashmem 0 %s", IMAGE_FILE);
+   ok(ok_run && run(chain, "trace off") && !URJ_TRACE_ON(),
+      "traced commands");
+
+   urj_tap_chain_free(chain);
+
+   trace = read_trace();
+   len = strlen(trace);
+   ok(strncmp(trace, "[\n{", 3) == 0 && len > 4
+      && strcmp(trace + len - 4, "}\n]\n") == 0, "JSON array");
+   is_int(count(trace, "\"ph\":\"B\""), count(trace, "\"ph\":\"E\""),
+          "begin and end events pair up");
+   is_int(count(trace, "{\"name\""), count(trace, "\"pid\":1,\"tid\":1"),
+          "all events complete");
+   for (i = 0; i < NR_EVENTS; ++i)
+      ok(strstr(trace, EventSpecAry[i].text) != NULL, "%s",
+         EventSpecAry[i].what);
+   diag("%d events", count(trace, "{\"name\""));
+
+   free(trace);
+   remove(CHAIN_FILE);
+   remove(IMAGE_FILE);
+   remove(TRACE_FILE);
+
+   return 0;
+}
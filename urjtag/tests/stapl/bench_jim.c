@@ -0,0 +1,183 @@
+/**
+ * \author SPDX-FileCopyrightText: 2026 UrJTAG contributors
+ *
+ * \copyright SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * \file bench_jim.c
+ * \brief Execution benchmark for the STAPL player on the JIM simulator.
+ *
+ * Test idea:
+ * * connect the "jim" cable and detect its chain, like "cable jim; detect"
+ * * run each STAPL program of the suite with urj_stapl_run()
+ * * check that the program succeeded and exited with code 0
+ * * report statements/s and scan bits/s so that regressions show up in the
+ *   test log
+ * * run the suite on NR_CHAINS chains at once with urj_tap_chain_run_jobs()
+ *   and check that every program succeeds on every chain
+ *
+ * The number of runs per program can be raised with URJ_BENCH_ITERATIONS.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <urjtag/chain.h>
+#include <urjtag/log.h>
+#include <urjtag/stapl.h>
+#include <urjtag/tap.h>
+
+#include "tap/basic.h"
+
+struct sBenchSpec {
+   /// STAPL file, relative to $srcdir
+   const char *file;
+   /// action to execute
+   const char *action;
+};
+
+static const struct sBenchSpec BenchSpecAry[] = {
+   { "stapl/idcode.stp", "-aREAD_IDCODE" },
+   { "stapl/bsr.stp",    "-aSAMPLE_LOOP" },
+   { "stapl/aca.stp",    "-aCHECK_ACA" },
+};
+
+#define BENCH_NRELM (sizeof BenchSpecAry / sizeof BenchSpecAry[0])
+/// Number of tests per BenchSpecAry element.
+#define BENCH_NRCHK 2
+/// Number of chains that run the suite at once.
+#define NR_CHAINS 3
+
+static const char *srcdir;
+
+static double now(void)
+{
+   struct timespec ts;
+
+   clock_gettime(CLOCK_MONOTONIC, &ts);
+   return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static void run_bench(urj_chain_t *chain, const struct sBenchSpec *pB,
+                      long iterations)
+{
+   char path[1024];
+   urj_stapl_stats_t stats;
+   uint64_t statements = 0, scan_bits = 0;
+   int failed = 0;
+   double t0, dt;
+   long i;
+
+   snprintf(path, sizeof path, "%s/%s", srcdir, pB->file);
+
+   t0 = now();
+   for (i = 0; i < iterations && !failed; ++i)
+   {
+      urj_stapl_run(chain, path, (char *) pB->action);
+      urj_stapl_get_stats(&stats);
+      failed = stats.exec_result != 0 || stats.exit_code != 0;
+      statements += stats.statements;
+      scan_bits += stats.scan_bits;
+   }
+   dt = now() - t0;
+
+   is_int(0, stats.exec_result, "%s: player return code", pB->file);
+   is_int(0, stats.exit_code, "%s: STAPL exit code", pB->file);
+
+   if (dt <= 0)
+      dt = 1e-9;
+   diag("%s: %ld run(s), %.3f s, %llu statements, %llu scan bits",
+        pB->file, i, dt, (unsigned long long) statements,
+        (unsigned long long) scan_bits);
+   diag("%s: %.0f statements/s, %.0f scan bits/s",
+        pB->file, statements / dt, scan_bits / dt);
+}
+
+/// job for urj_tap_chain_run_jobs(): run the whole suite on one chain
+static int run_suite(urj_chain_t *chain, void *data)
+{
+   char path[1024];
+   urj_stapl_stats_t stats;
+   size_t i;
+
+   (void) data;
+
+   for (i = 0; i < BENCH_NRELM; ++i)
+   {
+      snprintf(path, sizeof path, "%s/%s", srcdir, BenchSpecAry[i].file);
+      urj_stapl_run(chain, path, (char *) BenchSpecAry[i].action);
+      urj_stapl_get_stats(&stats);
+      if (stats.exec_result != 0 || stats.exit_code != 0)
+         return URJ_STATUS_FAIL;
+   }
+
+   return URJ_STATUS_OK;
+}
+
+static void run_parallel(char **cable_params)
+{
+   urj_chain_t *chains[NR_CHAINS];
+   urj_chain_job_t jobs[NR_CHAINS];
+   int i, failed = 0;
+
+   memset(jobs, 0, sizeof jobs);
+   for (i = 0; i < NR_CHAINS; ++i)
+   {
+      chains[i] = urj_tap_chain_alloc();
+      if (chains[i] == NULL
+          || urj_tap_chain_connect(chains[i], "jim", cable_params)
+             != URJ_STATUS_OK
+          || urj_tap_detect(chains[i], 0) != URJ_STATUS_OK)
+         bail("cannot set up JIM chain %d", i);
+      jobs[i].chain = chains[i];
+      jobs[i].run = run_suite;
+   }
+
+   if (urj_tap_chain_run_jobs(jobs, NR_CHAINS) != URJ_STATUS_OK)
+      failed = 1;
+   for (i = 0; i < NR_CHAINS; ++i)
+   {
+      if (jobs[i].result != URJ_STATUS_OK)
+         diag("chain %d failed", i);
+      urj_tap_chain_free(chains[i]);
+   }
+   ok(!failed, "suite on %d chains at once", NR_CHAINS);
+}
+
+int main(void)
+{
+   const char *env_iter = getenv("URJ_BENCH_ITERATIONS");
+   long iterations = env_iter ? strtol(env_iter, NULL, 0) : 1;
+   char *cable_params[] = { NULL };
+   urj_chain_t *chain;
+   size_t i;
+
+   srcdir = getenv("srcdir");
+   if (srcdir == NULL)
+      srcdir = ".";
+   if (iterations < 1)
+      iterations = 1;
+
+   urj_log_state.level = URJ_LOG_LEVEL_SILENT;
+
+   chain = urj_tap_chain_alloc();
+   if (chain == NULL)
+      bail("urj_tap_chain_alloc() failed");
+   if (urj_tap_chain_connect(chain, "jim", cable_params) != URJ_STATUS_OK)
+      skip_all("JIM cable not available");
+   if (urj_tap_detect(chain, 0) != URJ_STATUS_OK || chain->parts == NULL)
+      bail("cannot detect the JIM chain");
+
+   plan(BENCH_NRELM * BENCH_NRCHK + 1);
+
+   for (i = 0; i < BENCH_NRELM; ++i)
+      run_bench(chain, &BenchSpecAry[i], iterations);
+
+   run_parallel(cable_params);
+
+   urj_tap_chain_free(chain);
+
+   return 0;
+}
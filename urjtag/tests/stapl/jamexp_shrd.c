@@ -40,6 +40,7 @@ struct JAMS_HEAP_STRUCT2
     JAMS_SYMBOL_RECORD *symbol_record;
     JAME_BOOLEAN_REP rep;       /* data representation format */
     BOOL cached;                /* true if array data is cached */
+    BOOL deferred;              /* true until ACA data is uncompressed */
     int32_t dimension;          /* number of elements in array */
     int32_t position;           /* position in file of initialization data */
     int32_t data[2];            /* first word of data (or cache buffer) */
@@ -51,6 +52,7 @@ struct JAMS_HEAP_STRUCT3
     JAMS_SYMBOL_RECORD *symbol_record;
     JAME_BOOLEAN_REP rep;       /* data representation format */
     BOOL cached;                /* true if array data is cached */
+    BOOL deferred;              /* true until ACA data is uncompressed */
     int32_t dimension;          /* number of elements in array */
     int32_t position;           /* position in file of initialization data */
     int32_t data[3];            /* first word of data (or cache buffer) */